@@ -0,0 +1,1645 @@
+#include "common.hpp"
+#include "Renderer/Renderer.hpp"
+#include "Renderer/VertexBuffer.hpp"
+#include "Renderer/IndexBuffer.hpp"
+#include "Renderer/InstanceBuffer.hpp"
+#include "Renderer/CpuCulling.hpp"
+#include "Renderer/GpuCulling.hpp"
+#include "Renderer/GpuParticles.hpp"
+#include "Scene/TransformHierarchy.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/Percentile.hpp"
+#include "Mesh/MeshOptimizer.hpp"
+#include "Mesh/VertexPacking.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <tuple>
+#include <SDL3_image/SDL_image.h>
+
+
+// Scripted scenes run for a fixed number of frames, results are printed as JSON.
+// Only the results go to stdout, renderer diagnostics and errors go to stderr.
+// Headless by default so it runs on machines without a display or GPU, e.g. with
+// SDL_VIDEO_DRIVER=offscreen and a software Vulkan driver (lavapipe/SwiftShader).
+//
+//   sdlGPU_bench [--frames N] [--warmup N] [--scene name] [--windowed] [--output file.json]
+
+struct BenchOptions
+{
+	uint32_t Frames{600};
+	uint32_t WarmupFrames{60};
+	std::string Scene;           // empty runs every scene
+	bool Windowed{false};
+	std::string OutputPath;      // empty prints to stdout
+};
+
+// Scene-specific value reported with the results, e.g. a measured error
+struct BenchMetric
+{
+	const char* Name{nullptr};
+	double Value{0.0};
+};
+
+struct BenchResult
+{
+	std::string Scene;
+	uint32_t RecordThreads{1};
+	uint32_t Frames{0};
+	uint64_t ItemsPerFrame{0};   // draws, instances, bytes or vertices, see ItemName
+	const char* ItemName{"draws"};
+	double Seconds{0.0};
+	double AverageMS{0.0};
+	double P50MS{0.0};
+	double P95MS{0.0};
+	double P99MS{0.0};
+	double MaxMS{0.0};
+	float RenderScale{1.0f};     // dynamic resolution scale at the end of the run
+	DrawStats LastFrame{};
+	std::vector<BenchMetric> Metrics;
+};
+
+// Startup cost of the same number of shader and pipeline permutations, created one
+// after another on the main thread and through the async API on the worker pool
+struct PipelineCreationResult
+{
+	uint32_t Pipelines{0};       // per run, zero if not measured
+	uint32_t Workers{0};
+	double SerialMS{0.0};
+	double AsyncMS{0.0};
+};
+
+
+// Triangles spread over a grid so draws do not all land on the same pixels
+static std::vector<VertexPositionColor> MakeTriangles(uint32_t count, float size)
+{
+	std::vector<VertexPositionColor> vertices;
+	vertices.reserve(count * 3);
+
+	const uint32_t columns = std::max(1u, uint32_t(std::sqrt(float(count))));
+	for (uint32_t i = 0; i < count; i++)
+	{
+		float x = -1.0f + 2.0f * float(i % columns + 0.5f) / columns;
+		float y = -1.0f + 2.0f * float(i / columns % columns + 0.5f) / columns;
+		float shade = float(i % 7) / 6.0f;
+
+		vertices.push_back({ x - size, y - size, 0.0f, 1.0f, shade, 0.0f, 1.0f });
+		vertices.push_back({ x + size, y - size, 0.0f, 0.0f, 1.0f, shade, 1.0f });
+		vertices.push_back({ x, y + size, 0.0f, shade, 0.0f, 1.0f, 1.0f });
+	}
+	return vertices;
+}
+
+// Camera at the origin turned `degrees` around the y axis, for the culling scenes
+static Frustum TurningCameraFrustum(uint32_t degrees)
+{
+	glm::mat4 projection = glm::perspectiveZO(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 400.0f);
+	glm::mat4 view = glm::rotate(glm::mat4(1.0f), glm::radians(float(degrees % 360)), glm::vec3(0.0f, 1.0f, 0.0f));
+	return Frustum::FromViewProjection(projection * view);
+}
+
+
+class BenchScene
+{
+	public:
+		virtual ~BenchScene() = default;
+
+		virtual const char* GetName() const = 0;
+		virtual const char* GetItemName() const { return "draws"; }
+		virtual uint64_t GetItemsPerFrame() const = 0;
+		virtual std::vector<BenchMetric> GetMetrics() const { return {}; }
+
+		// Called between InitCommandBuffer and SubmitCommandBuffer
+		virtual void Frame(Renderer& renderer) = 0;
+};
+
+// Many small draws, spread over a few vertex buffers.
+// Indexed, every buffer gets a 16-bit index buffer of its own and the same
+// triangles are drawn through RenderPassDrawIndexed.
+class DrawsScene : public BenchScene
+{
+	public:
+		static constexpr uint32_t DRAW_COUNT = 20000;
+		static constexpr uint32_t BUFFER_COUNT = 16;
+
+		DrawsScene(Renderer& renderer, SDL_GPUGraphicsPipeline* pipeline, bool indexed = false)
+		{
+			m_Pipeline = pipeline;
+
+			std::vector<VertexPositionColor> vertices = MakeTriangles(DRAW_COUNT / BUFFER_COUNT, 0.004f);
+			for (uint32_t i = 0; i < BUFFER_COUNT; i++)
+			{
+				m_Buffers.push_back(std::make_unique<VertexBuffer>(renderer.Device, renderer.Uploader.get(), uint32_t(vertices.size() * sizeof(VertexPositionColor))));
+				m_Buffers.back()->UploadData(vertices.data(), uint32_t(vertices.size() * sizeof(VertexPositionColor)));
+			}
+
+			if (indexed)
+			{
+				std::vector<uint16_t> indices(vertices.size());
+				for (uint32_t i = 0; i < indices.size(); i++)
+					indices[i] = uint16_t(i);
+
+				for (uint32_t i = 0; i < BUFFER_COUNT; i++)
+				{
+					m_IndexBuffers.push_back(std::make_unique<IndexBuffer>(renderer.Device, renderer.Uploader.get(), uint32_t(indices.size()), SDL_GPU_INDEXELEMENTSIZE_16BIT));
+					m_IndexBuffers.back()->UploadData(indices.data(), uint32_t(indices.size()));
+				}
+			}
+			renderer.Uploader->FlushNow();
+		}
+
+		~DrawsScene() override
+		{
+			for (auto& buffer : m_Buffers)
+				buffer->Cleanup();
+			for (auto& buffer : m_IndexBuffers)
+				buffer->Cleanup();
+		}
+
+		const char* GetName() const override { return m_IndexBuffers.empty() ? "draws" : "draws_indexed"; }
+		uint64_t GetItemsPerFrame() const override { return DRAW_COUNT; }
+
+		void Frame(Renderer& renderer) override
+		{
+			const uint32_t trianglesPerBuffer = DRAW_COUNT / BUFFER_COUNT;
+			for (uint32_t i = 0; i < DRAW_COUNT; i++)
+			{
+				const uint32_t buffer = i % BUFFER_COUNT;
+				const uint32_t first = (i / BUFFER_COUNT % trianglesPerBuffer) * 3;
+				if (m_IndexBuffers.empty())
+					renderer.RenderPassDraw(m_Pipeline, m_Buffers[buffer].get(), 3, 1, first, 0);
+				else
+					renderer.RenderPassDrawIndexed(m_Pipeline, m_Buffers[buffer].get(), m_IndexBuffers[buffer].get(), 3, 1, first);
+			}
+		}
+
+	private:
+		SDL_GPUGraphicsPipeline* m_Pipeline{nullptr};
+		std::vector<std::unique_ptr<VertexBuffer>> m_Buffers;
+		std::vector<std::unique_ptr<IndexBuffer>> m_IndexBuffers;   // empty unless indexed
+};
+
+// The same triangles as one instanced draw, instances rewritten every frame
+class InstancingScene : public BenchScene
+{
+	public:
+		static constexpr uint32_t INSTANCE_COUNT = DrawsScene::DRAW_COUNT;
+
+		// `pipeline` reads the instances the way `input` binds them
+		InstancingScene(Renderer& renderer, SDL_GPUGraphicsPipeline* pipeline, InstanceInput input, const char* name)
+			: m_Vertices(renderer.Device, renderer.Uploader.get(), 3 * sizeof(VertexPositionColor)),
+			  m_Instances(renderer.Device, renderer.Uploader.get(), INSTANCE_COUNT)
+		{
+			m_Pipeline = pipeline;
+			m_Input = input;
+			m_Name = name;
+
+			std::vector<VertexPositionColor> triangle = MakeTriangles(1, 0.004f);
+			m_Vertices.UploadData(triangle.data(), uint32_t(triangle.size() * sizeof(VertexPositionColor)));
+			renderer.Uploader->FlushNow();
+		}
+
+		~InstancingScene() override
+		{
+			m_Instances.Cleanup();
+			m_Vertices.Cleanup();
+		}
+
+		const char* GetName() const override { return m_Name; }
+		const char* GetItemName() const override { return "instances"; }
+		uint64_t GetItemsPerFrame() const override { return INSTANCE_COUNT; }
+
+		void Frame(Renderer& renderer) override
+		{
+			const uint32_t columns = uint32_t(std::sqrt(float(INSTANCE_COUNT)));
+			InstanceData* instances = m_Instances.BeginFrame<InstanceData>(INSTANCE_COUNT);
+			for (uint32_t i = 0; i < INSTANCE_COUNT; i++)
+			{
+				InstanceData& instance = instances[i];
+				instance = InstanceData{};
+				instance.row0[0] = 1.0f;
+				instance.row0[3] = -1.0f + 2.0f * (i % columns + 0.5f) / columns;
+				instance.row1[1] = 1.0f;
+				instance.row1[3] = -1.0f + 2.0f * (i / columns % columns + 0.5f) / columns;
+				instance.row2[2] = 1.0f;
+				instance.r = instance.g = instance.b = instance.a = 1.0f;
+				instance.id = i;
+			}
+
+			renderer.RenderPassDrawInstanced(m_Pipeline, &m_Vertices, &m_Instances, m_Input, 3);
+		}
+
+	private:
+		SDL_GPUGraphicsPipeline* m_Pipeline{nullptr};
+		InstanceInput m_Input{InstanceInput::StorageBuffer};
+		const char* m_Name{nullptr};
+		VertexBuffer m_Vertices;
+		InstanceBuffer m_Instances;
+};
+
+// Streams a few MB of vertex data into a buffer every frame in small pieces
+class UploadsScene : public BenchScene
+{
+	public:
+		static constexpr uint32_t UPLOAD_SIZE = 16u * 1024u;
+		static constexpr uint32_t UPLOAD_COUNT = 256;
+
+		UploadsScene(Renderer& renderer, SDL_GPUGraphicsPipeline* pipeline)
+			: m_Buffer(renderer.Device, renderer.Uploader.get(), UPLOAD_SIZE * UPLOAD_COUNT)
+		{
+			m_Pipeline = pipeline;
+
+			std::vector<VertexPositionColor> vertices = MakeTriangles(UPLOAD_SIZE * UPLOAD_COUNT / (3 * sizeof(VertexPositionColor)), 0.002f);
+			m_Data.resize(UPLOAD_SIZE * UPLOAD_COUNT);
+			std::memcpy(m_Data.data(), vertices.data(), std::min(m_Data.size(), vertices.size() * sizeof(VertexPositionColor)));
+		}
+
+		~UploadsScene() override
+		{
+			m_Buffer.Cleanup();
+		}
+
+		const char* GetName() const override { return "uploads"; }
+		const char* GetItemName() const override { return "bytes"; }
+		uint64_t GetItemsPerFrame() const override { return uint64_t(UPLOAD_SIZE) * UPLOAD_COUNT; }
+
+		void Frame(Renderer& renderer) override
+		{
+			// Every other piece, so the uploader cannot fold them into a single copy
+			for (uint32_t pass = 0; pass < 2; pass++)
+			{
+				for (uint32_t i = pass; i < UPLOAD_COUNT; i += 2)
+					m_Buffer.UploadData(m_Data.data() + i * UPLOAD_SIZE, UPLOAD_SIZE, i * UPLOAD_SIZE);
+			}
+
+			const uint32_t vertexCount = UPLOAD_SIZE * UPLOAD_COUNT / sizeof(VertexPositionColor) / 3 * 3;
+			renderer.RenderPassDraw(m_Pipeline, &m_Buffer, vertexCount);
+		}
+
+	private:
+		SDL_GPUGraphicsPipeline* m_Pipeline{nullptr};
+		VertexBuffer m_Buffer;
+		std::vector<uint8_t> m_Data;
+};
+
+// Many small indexed meshes of varying size packed into one MeshPool, a few of them
+// replaced with meshes of another size every frame. With defragmentation a budgeted
+// Defragment runs after the draws, without it the pool splinters and grows.
+class MeshPoolScene : public BenchScene
+{
+	public:
+		static constexpr uint32_t MESH_COUNT = 2048;
+		static constexpr uint32_t MAX_TRIANGLES = 32;
+		static constexpr uint32_t REPLACED_PER_FRAME = 64;
+		static constexpr uint32_t BLOCK_VERTICES = 1u << 14;
+		static constexpr uint64_t DEFRAGMENT_BYTES = 256u * 1024u;
+
+		MeshPoolScene(Renderer& renderer, SDL_GPUGraphicsPipeline* pipeline, bool defragment)
+			: m_Pool(renderer.Device, renderer.Uploader.get(), uint32_t(sizeof(VertexPositionColor)),
+				SDL_GPU_INDEXELEMENTSIZE_32BIT, BLOCK_VERTICES, BLOCK_VERTICES)
+		{
+			m_Pipeline = pipeline;
+			m_Defragment = defragment;
+
+			// Every slot draws its own stretch of triangles, the first 3n of them for n triangles
+			m_Vertices = MakeTriangles(MESH_COUNT * MAX_TRIANGLES, 0.002f);
+			m_Indices.resize(MAX_TRIANGLES * 3);
+			for (uint32_t i = 0; i < m_Indices.size(); i++)
+				m_Indices[i] = i;
+
+			m_Meshes.resize(MESH_COUNT);
+			for (uint32_t slot = 0; slot < MESH_COUNT; slot++)
+				m_Meshes[slot] = CreateMesh(slot);
+			renderer.Uploader->FlushNow();
+		}
+
+		~MeshPoolScene() override
+		{
+			m_Pool.Cleanup();
+		}
+
+		const char* GetName() const override { return m_Defragment ? "mesh_pool_defragment" : "mesh_pool"; }
+		uint64_t GetItemsPerFrame() const override { return MESH_COUNT; }
+
+		std::vector<BenchMetric> GetMetrics() const override
+		{
+			auto usage = [](const GpuBufferPoolStats& stats)
+			{
+				return stats.ReservedBytes ? double(stats.UsedBytes) / double(stats.ReservedBytes) : 0.0;
+			};
+
+			const GpuBufferPoolStats vertices = m_Pool.GetVertexPool().GetStats();
+			const GpuBufferPoolStats indices = m_Pool.GetIndexPool().GetStats();
+			return {
+				{ "vertex_usage", usage(vertices) },
+				{ "vertex_fragmentation", double(vertices.Fragmentation) },
+				{ "vertex_blocks", double(vertices.Blocks) },
+				{ "index_usage", usage(indices) },
+				{ "index_fragmentation", double(indices.Fragmentation) },
+				{ "index_blocks", double(indices.Blocks) },
+				{ "moved_allocations", double(vertices.MovedAllocations + indices.MovedAllocations) },
+				{ "moved_bytes", double(vertices.MovedBytes + indices.MovedBytes) },
+			};
+		}
+
+		void Frame(Renderer& renderer) override
+		{
+			for (MeshHandle mesh : m_Meshes)
+				renderer.RenderPassDrawMesh(m_Pipeline, m_Pool, mesh);
+
+			// Freed ranges stay reserved until the draws above have finished
+			for (uint32_t i = 0; i < REPLACED_PER_FRAME; i++)
+			{
+				const uint32_t slot = Next() % MESH_COUNT;
+				m_Pool.DestroyMesh(m_Meshes[slot]);
+				m_Meshes[slot] = CreateMesh(slot);
+			}
+
+			// After the draws, the copies land before the next frame reads the new ranges
+			if (m_Defragment)
+				m_Pool.Defragment(DEFRAGMENT_BYTES);
+		}
+
+	private:
+		SDL_GPUGraphicsPipeline* m_Pipeline{nullptr};
+		MeshPool m_Pool;
+		std::vector<MeshHandle> m_Meshes;
+		std::vector<VertexPositionColor> m_Vertices;
+		std::vector<uint32_t> m_Indices;
+		bool m_Defragment{false};
+		uint32_t m_Seed{1};
+
+		uint32_t Next()
+		{
+			m_Seed = m_Seed * 1664525u + 1013904223u;
+			return m_Seed >> 8;
+		}
+
+		// 1 to MAX_TRIANGLES triangles, so freed ranges rarely fit the next mesh exactly
+		MeshHandle CreateMesh(uint32_t slot)
+		{
+			const uint32_t count = (1 + Next() % MAX_TRIANGLES) * 3;
+			std::span<const VertexPositionColor> vertices(m_Vertices.data() + slot * MAX_TRIANGLES * 3, count);
+			std::span<const uint32_t> indices(m_Indices.data(), count);
+			return m_Pool.CreateMesh(vertices, indices);
+		}
+};
+
+// Loads a few generated PNGs through the TextureManager and draws each on a quad of
+// its own. Frames are driven from the constructor until every texture is resident,
+// checking that no Update staged more than the upload budget.
+class TextureStreamingScene : public BenchScene
+{
+	public:
+		static constexpr uint32_t TEXTURE_COUNT = 8;
+		static constexpr uint32_t TEXTURE_SIZE = 1024;
+		static constexpr uint64_t RESIDENT_TIMEOUT_NS = 30'000'000'000ull;
+
+		TextureStreamingScene(Renderer& renderer, SDL_GPUGraphicsPipeline* pipeline)
+			: m_Quads(renderer.Device, renderer.Uploader.get(), TEXTURE_COUNT * 6 * sizeof(VertexPositionTexture))
+		{
+			m_Pipeline = pipeline;
+			m_TextureManager = renderer.Textures.get();
+
+			// 4x2 grid of quads, texture i on quad i
+			std::vector<VertexPositionTexture> vertices;
+			vertices.reserve(TEXTURE_COUNT * 6);
+			for (uint32_t i = 0; i < TEXTURE_COUNT; i++)
+			{
+				const float x = -1.0f + 0.5f * float(i % 4);
+				const float y = i < 4 ? 0.0f : -1.0f;
+				vertices.insert(vertices.end(), {
+					{ x, y, 0.0f, 0.0f, 1.0f }, { x + 0.5f, y, 0.0f, 1.0f, 1.0f }, { x, y + 1.0f, 0.0f, 0.0f, 0.0f },
+					{ x, y + 1.0f, 0.0f, 0.0f, 0.0f }, { x + 0.5f, y, 0.0f, 1.0f, 1.0f }, { x + 0.5f, y + 1.0f, 0.0f, 1.0f, 0.0f } });
+			}
+			m_Quads.UploadData(vertices.data(), uint32_t(vertices.size() * sizeof(VertexPositionTexture)));
+			renderer.Uploader->FlushNow();
+
+			for (uint32_t i = 0; i < TEXTURE_COUNT; i++)
+			{
+				m_Paths.push_back(std::string(BasePath) + "bench_texture_" + std::to_string(i) + ".png");
+				WriteTexture(m_Paths.back(), i);
+			}
+
+			const uint64_t start = SDL_GetTicksNS();
+			for (const std::string& path : m_Paths)
+				m_Textures.push_back(renderer.Textures->Load(path));
+
+			// Placeholders are drawn until the textures are in, like a game would
+			while (!std::all_of(m_Textures.begin(), m_Textures.end(), [&](TextureHandle texture) { return renderer.Textures->IsResident(texture); }))
+			{
+				if (std::any_of(m_Textures.begin(), m_Textures.end(), [&](TextureHandle texture) { return renderer.Textures->HasFailed(texture); }))
+					SDLException("Failed to load a generated benchmark texture");
+				if (SDL_GetTicksNS() - start > RESIDENT_TIMEOUT_NS)
+					SDLException("Generated benchmark textures did not become resident");
+
+				renderer.BeginFrame();
+				if (renderer.InitCommandBuffer())
+					Frame(renderer);
+				renderer.SubmitCommandBuffer();
+				m_FramesUntilResident++;
+
+				// Staged by the Update of the frame just recorded
+				m_MaxUploadedBytes = std::max(m_MaxUploadedBytes, renderer.Textures->GetStats().UploadedBytes);
+			}
+			m_MSUntilResident = (SDL_GetTicksNS() - start) / 1e6;
+
+			m_UploadBudget = renderer.Textures->GetUploadBudget();
+			if (m_MaxUploadedBytes > m_UploadBudget)
+				SDLException("Texture streaming staged more than the upload budget in one frame");
+		}
+
+		~TextureStreamingScene() override
+		{
+			for (TextureHandle texture : m_Textures)
+				m_TextureManager->Release(texture);
+			for (const std::string& path : m_Paths)
+				SDL_RemovePath(path.c_str());
+			m_Quads.Cleanup();
+		}
+
+		const char* GetName() const override { return "texture_streaming"; }
+		uint64_t GetItemsPerFrame() const override { return TEXTURE_COUNT; }
+
+		std::vector<BenchMetric> GetMetrics() const override
+		{
+			return {
+				{ "frames_until_resident", double(m_FramesUntilResident) },
+				{ "ms_until_resident", m_MSUntilResident },
+				{ "max_uploaded_bytes", double(m_MaxUploadedBytes) },
+				{ "upload_budget", double(m_UploadBudget) },
+			};
+		}
+
+		void Frame(Renderer& renderer) override
+		{
+			for (uint32_t i = 0; i < m_Textures.size(); i++)
+				renderer.RenderPassDrawTextured(m_Pipeline, &m_Quads, m_Textures[i], 6, i * 6);
+		}
+
+	private:
+		SDL_GPUGraphicsPipeline* m_Pipeline{nullptr};
+		TextureManager* m_TextureManager{nullptr};
+		VertexBuffer m_Quads;
+		std::vector<std::string> m_Paths;
+		std::vector<TextureHandle> m_Textures;
+		uint32_t m_FramesUntilResident{0};
+		double m_MSUntilResident{0.0};
+		uint64_t m_MaxUploadedBytes{0};
+		uint64_t m_UploadBudget{0};
+
+		// A gradient tinted per texture, so every file decodes to different pixels
+		static void WriteTexture(const std::string& path, uint32_t index)
+		{
+			SDL_Surface* surface = SDL_CreateSurface(TEXTURE_SIZE, TEXTURE_SIZE, SDL_PIXELFORMAT_RGBA32);
+			if (!surface)
+				SDLException("Failed to create benchmark texture surface");
+
+			for (uint32_t y = 0; y < TEXTURE_SIZE; y++)
+			{
+				uint8_t* row = static_cast<uint8_t*>(surface->pixels) + size_t(y) * surface->pitch;
+				for (uint32_t x = 0; x < TEXTURE_SIZE; x++)
+				{
+					row[x * 4 + 0] = uint8_t(x * 255 / (TEXTURE_SIZE - 1));
+					row[x * 4 + 1] = uint8_t(y * 255 / (TEXTURE_SIZE - 1));
+					row[x * 4 + 2] = uint8_t(index * 255 / (TEXTURE_COUNT - 1));
+					row[x * 4 + 3] = 255;
+				}
+			}
+
+			const bool saved = IMG_SavePNG(surface, path.c_str());
+			SDL_DestroySurface(surface);
+			if (!saved)
+				SDLException("Failed to write benchmark texture " + path);
+		}
+};
+
+// Draws that switch between many pipeline states, queued in an order that defeats batching
+// unless the draw queue sorts them
+class PipelineChurnScene : public BenchScene
+{
+	public:
+		static constexpr uint32_t DRAW_COUNT = 4096;
+		static constexpr uint32_t PIPELINE_COUNT = 16;
+
+		PipelineChurnScene(Renderer& renderer, SDL_GPUShader* vertexShader, SDL_GPUShader* fragmentShader)
+			: m_Vertices(renderer.Device, renderer.Uploader.get(), DRAW_COUNT * 3 * sizeof(VertexPositionColor))
+		{
+			m_Renderer = &renderer;
+
+			static constexpr SDL_GPUBlendFactor factors[] = {
+				SDL_GPU_BLENDFACTOR_ZERO, SDL_GPU_BLENDFACTOR_ONE,
+				SDL_GPU_BLENDFACTOR_SRC_ALPHA, SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA
+			};
+
+			for (uint32_t i = 0; i < PIPELINE_COUNT; i++)
+			{
+				PipelineDesc desc{};
+				desc.VertexShader = vertexShader;
+				desc.FragmentShader = fragmentShader;
+				desc.VertexInput = &VertexInputFor<VertexPositionColor>::State;
+				desc.Blend.enable_blend = true;
+				desc.Blend.src_color_blendfactor = factors[i % 4];
+				desc.Blend.dst_color_blendfactor = factors[i / 4 % 4];
+				desc.Blend.color_blend_op = SDL_GPU_BLENDOP_ADD;
+				desc.Blend.src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
+				desc.Blend.dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ZERO;
+				desc.Blend.alpha_blend_op = SDL_GPU_BLENDOP_ADD;
+
+				SDL_GPUGraphicsPipeline* pipeline = renderer.CreatePipeline(desc);
+				if (!pipeline)
+					SDLException("Failed to create benchmark pipeline");
+				m_Pipelines.push_back(pipeline);
+			}
+
+			std::vector<VertexPositionColor> vertices = MakeTriangles(DRAW_COUNT, 0.005f);
+			m_Vertices.UploadData(vertices.data(), uint32_t(vertices.size() * sizeof(VertexPositionColor)));
+			renderer.Uploader->FlushNow();
+		}
+
+		~PipelineChurnScene() override
+		{
+			for (SDL_GPUGraphicsPipeline* pipeline : m_Pipelines)
+				m_Renderer->ReleasePipeline(pipeline);
+			m_Vertices.Cleanup();
+		}
+
+		const char* GetName() const override { return "pipeline_churn"; }
+		uint64_t GetItemsPerFrame() const override { return DRAW_COUNT; }
+
+		void Frame(Renderer& renderer) override
+		{
+			for (uint32_t i = 0; i < DRAW_COUNT; i++)
+				renderer.RenderPassDraw(m_Pipelines[i % PIPELINE_COUNT], &m_Vertices, 3, 1, i * 3, 0);
+		}
+
+	private:
+		Renderer* m_Renderer{nullptr};
+		std::vector<SDL_GPUGraphicsPipeline*> m_Pipelines;
+		VertexBuffer m_Vertices;
+};
+
+// Full-screen layers that intersect each other, so no draw order avoids overdraw.
+// Shaded with an expensive fragment shader; compares depth testing in the worst order,
+// sorted front to back, and with a depth pre-pass that shades every pixel once.
+class OverdrawScene : public BenchScene
+{
+	public:
+		static constexpr uint32_t LAYER_COUNT = 16;
+
+		enum class Mode
+		{
+			BackToFront,
+			FrontToBack,
+			DepthPrepass,
+		};
+
+		OverdrawScene(Renderer& renderer, Mode mode, const char* name)
+			: m_Vertices(renderer.Device, renderer.Uploader.get(), LAYER_COUNT * 6 * sizeof(VertexPositionColor)),
+			  m_Positions(renderer.Device, renderer.Uploader.get(), LAYER_COUNT * 6 * sizeof(VertexPosition))
+		{
+			m_Renderer = &renderer;
+			m_Mode = mode;
+			m_Name = name;
+
+			m_VertexShader = renderer.LoadShader("PositionColor.vert");
+			m_FragmentShader = renderer.LoadShader("Overdraw.frag");
+			m_PositionShader = renderer.LoadShader("Position.vert");
+			m_DepthOnlyShader = renderer.LoadShader("DepthOnly.frag");
+			if (!m_VertexShader || !m_FragmentShader || !m_PositionShader || !m_DepthOnlyShader)
+				SDLException("Failed to load overdraw shaders");
+
+			PipelineDesc desc{};
+			desc.VertexShader = m_VertexShader;
+			desc.FragmentShader = m_FragmentShader;
+			desc.VertexInput = &VertexInputFor<VertexPositionColor>::State;
+			desc.DepthStencil = mode == Mode::DepthPrepass ? DepthState(SDL_GPU_COMPAREOP_EQUAL, false) : DepthState();
+			m_Pipeline = renderer.CreatePipeline(desc);
+
+			if (mode == Mode::DepthPrepass)
+			{
+				PipelineDesc depthDesc{};
+				depthDesc.VertexShader = m_PositionShader;
+				depthDesc.FragmentShader = m_DepthOnlyShader;
+				depthDesc.VertexInput = &VertexInputFor<VertexPosition>::State;
+				depthDesc.DepthStencil = DepthState();
+				depthDesc.Blend.enable_color_write_mask = true;
+				depthDesc.Blend.color_write_mask = 0;
+				m_DepthPipeline = renderer.CreatePipeline(depthDesc);
+			}
+
+			if (!m_Pipeline || (mode == Mode::DepthPrepass && !m_DepthPipeline))
+				SDLException("Failed to create overdraw pipelines");
+
+			// Layer i runs from depth (i + 0.5) / n on the left to a shuffled depth on the right
+			std::vector<VertexPositionColor> vertices;
+			std::vector<VertexPosition> positions;
+			for (uint32_t i = 0; i < LAYER_COUNT; i++)
+			{
+				const float left = (float(i) + 0.5f) / LAYER_COUNT;
+				const float right = (float(i * 7 % LAYER_COUNT) + 0.5f) / LAYER_COUNT;
+				const float shade = float(i) / (LAYER_COUNT - 1);
+				m_LayerDepths[i] = 0.5f * (left + right);
+
+				const VertexPosition corners[6] = {
+					{ -1.0f, -1.0f, left }, { 1.0f, -1.0f, right }, { 1.0f, 1.0f, right },
+					{ -1.0f, -1.0f, left }, { 1.0f, 1.0f, right }, { -1.0f, 1.0f, left },
+				};
+				for (const VertexPosition& corner : corners)
+				{
+					vertices.push_back({ corner.x, corner.y, corner.z, shade, 1.0f - shade, 0.5f, 1.0f });
+					positions.push_back(corner);
+				}
+			}
+
+			m_Vertices.UploadData(vertices.data(), uint32_t(vertices.size() * sizeof(VertexPositionColor)));
+			m_Positions.UploadData(positions.data(), uint32_t(positions.size() * sizeof(VertexPosition)));
+			renderer.Uploader->FlushNow();
+		}
+
+		~OverdrawScene() override
+		{
+			m_Renderer->ReleasePipeline(m_Pipeline);
+			m_Renderer->ReleasePipeline(m_DepthPipeline);
+			m_Renderer->ReleaseShader(m_VertexShader);
+			m_Renderer->ReleaseShader(m_FragmentShader);
+			m_Renderer->ReleaseShader(m_PositionShader);
+			m_Renderer->ReleaseShader(m_DepthOnlyShader);
+			m_Vertices.Cleanup();
+			m_Positions.Cleanup();
+		}
+
+		const char* GetName() const override { return m_Name; }
+
+		const char* GetItemName() const override { return "layers"; }
+		uint64_t GetItemsPerFrame() const override { return LAYER_COUNT; }
+
+		void Frame(Renderer& renderer) override
+		{
+			for (uint32_t i = 0; i < LAYER_COUNT; i++)
+			{
+				// Inverted depth queues the layers far to near, the worst case for early depth rejection
+				const float depth = m_Mode == Mode::BackToFront ? 1.0f - m_LayerDepths[i] : m_LayerDepths[i];
+				renderer.RenderPassDrawOpaque(m_Pipeline, &m_Vertices, 6, i * 6, depth, m_DepthPipeline, &m_Positions);
+			}
+		}
+
+	private:
+		Renderer* m_Renderer{nullptr};
+		Mode m_Mode{Mode::FrontToBack};
+		const char* m_Name{nullptr};
+
+		SDL_GPUShader* m_VertexShader{nullptr};
+		SDL_GPUShader* m_FragmentShader{nullptr};
+		SDL_GPUShader* m_PositionShader{nullptr};
+		SDL_GPUShader* m_DepthOnlyShader{nullptr};
+		SDL_GPUGraphicsPipeline* m_Pipeline{nullptr};
+		SDL_GPUGraphicsPipeline* m_DepthPipeline{nullptr};
+
+		VertexBuffer m_Vertices;
+		VertexBuffer m_Positions;
+		float m_LayerDepths[LAYER_COUNT]{};
+};
+
+// CPU only, packs float vertices into the quantized format every frame
+class VertexPackingScene : public BenchScene
+{
+	public:
+		static constexpr uint32_t VERTEX_COUNT = 1u << 20;
+
+		// Round-trip bounds. Halves round to nearest, so positions and UVs are within half
+		// a half-precision ulp, 2^-11 relative (absolute below the smallest normal half).
+		// Unorm8 colors are within half a step, octahedral snorm16 normals within 0.05 degrees.
+		static constexpr double MAX_POSITION_ERROR = 1.0 / 2048.0;
+		static constexpr double MAX_NORMAL_ERROR_DEGREES = 0.05;
+		static constexpr double MAX_COLOR_ERROR = 0.5 / 255.0 + 1e-6;
+		static constexpr double MAX_TEXCOORD_ERROR = 1.0 / 2048.0;
+
+		VertexPackingScene()
+		{
+			// Deterministic positions in a 200 unit cube, normals uniform on the sphere
+			m_Source.resize(VERTEX_COUNT);
+			m_Packed.resize(VERTEX_COUNT);
+			uint32_t seed = 1;
+			auto next = [&seed]{ seed = seed * 1664525u + 1013904223u; return float(seed >> 8) / float(1u << 24); };
+			for (uint32_t i = 0; i < VERTEX_COUNT; i++)
+			{
+				float nz = next() * 2.0f - 1.0f;
+				float angle = next() * 6.28318531f;
+				float ring = std::sqrt(std::max(0.0f, 1.0f - nz * nz));
+				m_Source[i] = { next() * 200.0f - 100.0f, next() * 200.0f - 100.0f, next() * 200.0f - 100.0f,
+					std::cos(angle) * ring, std::sin(angle) * ring, nz,
+					next(), next(), next(), next(), next(), next() };
+			}
+
+			// The SIMD kernels have to agree with the scalar reference exactly
+			std::vector<VertexPackedPositionNormalColorTexture> reference(VERTEX_COUNT);
+			VertexPacking::PackVertices(m_Packed.data(), m_Source.data(), m_Source.size());
+			VertexPacking::PackVerticesScalar(reference.data(), m_Source.data(), m_Source.size());
+			if (std::memcmp(m_Packed.data(), reference.data(), VERTEX_COUNT * sizeof(VertexPackedPositionNormalColorTexture)) != 0)
+				SDLException("Vertex packing disagrees with the scalar reference");
+
+			MeasureRoundTrip();
+			if (m_PositionError > MAX_POSITION_ERROR || m_NormalErrorDegrees > MAX_NORMAL_ERROR_DEGREES ||
+				m_ColorError > MAX_COLOR_ERROR || m_TexcoordError > MAX_TEXCOORD_ERROR)
+				SDLException("Vertex packing round-trip error out of bounds");
+		}
+
+		const char* GetName() const override { return "vertex_packing"; }
+		const char* GetItemName() const override { return "vertices"; }
+		uint64_t GetItemsPerFrame() const override { return VERTEX_COUNT; }
+
+		std::vector<BenchMetric> GetMetrics() const override
+		{
+			return {
+				{ "max_position_error", m_PositionError },
+				{ "max_normal_error_degrees", m_NormalErrorDegrees },
+				{ "max_color_error", m_ColorError },
+				{ "max_texcoord_error", m_TexcoordError },
+			};
+		}
+
+		void Frame(Renderer&) override
+		{
+			VertexPacking::PackVertices(m_Packed.data(), m_Source.data(), m_Source.size());
+		}
+
+	private:
+		std::vector<VertexPositionNormalColorTexture> m_Source;
+		std::vector<VertexPackedPositionNormalColorTexture> m_Packed;
+
+		double m_PositionError{0.0};        // relative
+		double m_NormalErrorDegrees{0.0};
+		double m_ColorError{0.0};           // absolute
+		double m_TexcoordError{0.0};        // relative
+
+		// Worst decode error of m_Packed against m_Source
+		void MeasureRoundTrip()
+		{
+			std::vector<VertexPositionNormalColorTexture> unpacked(VERTEX_COUNT);
+			VertexPacking::UnpackVertices(unpacked.data(), m_Packed.data(), m_Packed.size());
+
+			// Below the smallest normal half the error is absolute
+			auto relative = [](float expected, float actual)
+			{
+				return double(std::fabs(expected - actual)) / std::max(double(std::fabs(expected)), 1.0 / 16384.0);
+			};
+
+			for (uint32_t i = 0; i < VERTEX_COUNT; i++)
+			{
+				const VertexPositionNormalColorTexture& in = m_Source[i];
+				const VertexPositionNormalColorTexture& out = unpacked[i];
+
+				m_PositionError = std::max({ m_PositionError, relative(in.x, out.x), relative(in.y, out.y), relative(in.z, out.z) });
+
+				double cosine = double(in.nx) * out.nx + double(in.ny) * out.ny + double(in.nz) * out.nz;
+				m_NormalErrorDegrees = std::max(m_NormalErrorDegrees, std::acos(std::clamp(cosine, -1.0, 1.0)) * 180.0 / 3.14159265358979);
+
+				m_ColorError = std::max({ m_ColorError, double(std::fabs(in.r - out.r)), double(std::fabs(in.g - out.g)),
+					double(std::fabs(in.b - out.b)), double(std::fabs(in.a - out.a)) });
+
+				m_TexcoordError = std::max({ m_TexcoordError, relative(in.u, out.u), relative(in.v, out.v) });
+			}
+		}
+};
+
+// CPU only, runs the mesh optimizer on an unindexed 100x100 quad grid with its triangles
+// shuffled, so the input repeats every shared corner and has no cache locality at all
+class MeshOptimizerScene : public BenchScene
+{
+	public:
+		static constexpr uint32_t GRID_SIZE = 100;
+		static constexpr uint32_t TRIANGLE_COUNT = GRID_SIZE * GRID_SIZE * 2;
+
+		MeshOptimizerScene()
+		{
+			// Shared corners are bit-identical so welding finds them
+			auto corner = [](uint32_t x, uint32_t y)
+			{
+				const float u = float(x) / GRID_SIZE;
+				const float v = float(y) / GRID_SIZE;
+				return VertexPositionColor{ u * 2.0f - 1.0f, v * 2.0f - 1.0f, 0.0f, u, v, 1.0f, 1.0f };
+			};
+
+			m_Source.reserve(TRIANGLE_COUNT * 3);
+			for (uint32_t y = 0; y < GRID_SIZE; y++)
+			{
+				for (uint32_t x = 0; x < GRID_SIZE; x++)
+				{
+					m_Source.insert(m_Source.end(), { corner(x, y), corner(x + 1, y), corner(x, y + 1) });
+					m_Source.insert(m_Source.end(), { corner(x, y + 1), corner(x + 1, y), corner(x + 1, y + 1) });
+				}
+			}
+
+			// Deterministic Fisher-Yates over whole triangles
+			uint32_t seed = 1;
+			for (uint32_t i = TRIANGLE_COUNT - 1; i > 0; i--)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				const uint32_t j = (seed >> 8) % (i + 1);
+				std::swap_ranges(m_Source.begin() + i * 3, m_Source.begin() + i * 3 + 3, m_Source.begin() + j * 3);
+			}
+
+			Optimize();
+
+			// Welding has to find every shared corner and the reorder has to beat the shuffle
+			if (m_Report.VerticesAfter != (GRID_SIZE + 1) * (GRID_SIZE + 1) || m_Report.CacheAfter.ACMR >= m_Report.CacheBefore.ACMR)
+				SDLException("Mesh optimizer did not weld or reorder the grid");
+		}
+
+		const char* GetName() const override { return "mesh_optimizer"; }
+		const char* GetItemName() const override { return "triangles"; }
+		uint64_t GetItemsPerFrame() const override { return TRIANGLE_COUNT; }
+
+		std::vector<BenchMetric> GetMetrics() const override
+		{
+			return {
+				{ "vertices_before", double(m_Report.VerticesBefore) },
+				{ "vertices_after", double(m_Report.VerticesAfter) },
+				{ "acmr_before", m_Report.CacheBefore.ACMR },
+				{ "acmr_after", m_Report.CacheAfter.ACMR },
+				{ "atvr_before", m_Report.CacheBefore.ATVR },
+				{ "atvr_after", m_Report.CacheAfter.ATVR },
+			};
+		}
+
+		void Frame(Renderer&) override
+		{
+			Optimize();
+		}
+
+	private:
+		std::vector<VertexPositionColor> m_Source;
+		std::vector<VertexPositionColor> m_Vertices;
+		std::vector<uint32_t> m_Indices;
+		MeshOptimizer::MeshOptimizationReport m_Report{};
+
+		void Optimize()
+		{
+			m_Vertices = m_Source;
+			m_Indices.clear();
+			m_Report = MeshOptimizer::OptimizeMesh(m_Vertices, m_Indices);
+		}
+};
+
+
+// CPU only, frustum culls a million spheres with a camera turning in place
+class CullingScene : public BenchScene
+{
+	public:
+		static constexpr uint32_t OBJECT_COUNT = 1u << 20;
+
+		CullingScene(JobSystem* jobs, CpuCulling::Shape shape)
+		{
+			m_Jobs = jobs;
+			m_Shape = shape;
+
+			// Deterministic scatter over a 1000 unit cube
+			m_Culling.Reserve(OBJECT_COUNT);
+			uint32_t seed = 1;
+			auto next = [&seed]{ seed = seed * 1664525u + 1013904223u; return float(seed >> 8) / float(1u << 24); };
+			for (uint32_t i = 0; i < OBJECT_COUNT; i++)
+			{
+				glm::vec3 center(next() * 1000.0f - 500.0f, next() * 1000.0f - 500.0f, next() * 1000.0f - 500.0f);
+				glm::vec3 extents(0.5f + next() * 4.5f, 0.5f + next() * 4.5f, 0.5f + next() * 4.5f);
+				m_Culling.Add(center, glm::length(extents), extents);
+			}
+			m_Visible.resize(OBJECT_COUNT);
+
+			// The SIMD kernel has to agree with the scalar reference exactly
+			std::vector<uint32_t> reference(OBJECT_COUNT);
+			for (uint32_t frame = 0; frame < 8; frame++)
+			{
+				Frustum frustum = TurningCameraFrustum(frame * 45);
+				uint32_t count = Cull(frustum);
+				if (count != m_Culling.CullScalar(frustum, reference.data(), m_Shape) ||
+					!std::equal(m_Visible.begin(), m_Visible.begin() + count, reference.begin()))
+					SDLException("CPU culling disagrees with the scalar reference");
+			}
+		}
+
+		const char* GetName() const override
+		{
+			if (m_Jobs)
+				return m_Shape == CpuCulling::Shape::Sphere ? "culling_parallel" : "culling_boxes_parallel";
+			return m_Shape == CpuCulling::Shape::Sphere ? "culling" : "culling_boxes";
+		}
+		const char* GetItemName() const override { return "objects"; }
+		uint64_t GetItemsPerFrame() const override { return OBJECT_COUNT; }
+
+		void Frame(Renderer&) override
+		{
+			Cull(TurningCameraFrustum(m_Frame++));
+		}
+
+	private:
+		JobSystem* m_Jobs{nullptr};
+		CpuCulling::Shape m_Shape{CpuCulling::Shape::Sphere};
+		CpuCulling m_Culling;
+		std::vector<uint32_t> m_Visible;
+		uint32_t m_Frame{0};
+
+		uint32_t Cull(const Frustum& frustum)
+		{
+			if (m_Jobs)
+				return m_Culling.CullParallel(*m_Jobs, frustum, m_Visible.data(), m_Shape);
+			return m_Culling.Cull(frustum, m_Visible.data(), m_Shape);
+		}
+};
+
+
+// Culls spheres on the GPU and draws the visible ones with one indirect call, each
+// object a small triangle of its own. The camera turns in place like in CullingScene.
+class GpuCullingScene : public BenchScene
+{
+	public:
+		static constexpr uint32_t OBJECT_COUNT = 1u << 16;
+
+		GpuCullingScene(Renderer& renderer, SDL_GPUGraphicsPipeline* pipeline)
+			: m_Culling(&renderer, OBJECT_COUNT),
+			  m_Vertices(renderer.Device, renderer.Uploader.get(), OBJECT_COUNT * 3 * sizeof(VertexPositionColor)),
+			  m_Indices(renderer.Device, renderer.Uploader.get(), 3, SDL_GPU_INDEXELEMENTSIZE_16BIT)
+		{
+			m_Pipeline = pipeline;
+
+			// Same scatter as CullingScene, every object draws its own triangle through the vertex offset
+			std::vector<CullObject> objects(OBJECT_COUNT);
+			m_Reference.Reserve(OBJECT_COUNT);
+			uint32_t seed = 1;
+			auto next = [&seed]{ seed = seed * 1664525u + 1013904223u; return float(seed >> 8) / float(1u << 24); };
+			for (uint32_t i = 0; i < OBJECT_COUNT; i++)
+			{
+				glm::vec3 center(next() * 1000.0f - 500.0f, next() * 1000.0f - 500.0f, next() * 1000.0f - 500.0f);
+				glm::vec3 extents(0.5f + next() * 4.5f, 0.5f + next() * 4.5f, 0.5f + next() * 4.5f);
+				float radius = glm::length(extents);
+				m_Reference.Add(center, radius, extents);
+
+				objects[i] = CullObject{ { center.x, center.y, center.z }, radius, 3, 1, 0, int32_t(i * 3), 0, {} };
+			}
+			m_Culling.SetObjects(objects);
+
+			std::vector<VertexPositionColor> vertices = MakeTriangles(OBJECT_COUNT, 0.002f);
+			m_Vertices.UploadData(vertices.data(), uint32_t(vertices.size() * sizeof(VertexPositionColor)));
+			const uint16_t indices[3] = { 0, 1, 2 };
+			m_Indices.UploadData(indices, 3);
+			renderer.Uploader->FlushNow();
+
+			// The GPU count has to match the scalar reference on the same frusta. Frames are
+			// driven here, the compute results are only there once a frame was submitted.
+			std::vector<uint32_t> visible(OBJECT_COUNT);
+			for (uint32_t frame = 0; frame < 8; frame++)
+			{
+				Frustum frustum = TurningCameraFrustum(frame * 45);
+
+				// Compute runs even when the frame has no swapchain texture to draw to
+				renderer.BeginFrame();
+				const bool drawing = renderer.InitCommandBuffer();
+				m_Culling.Dispatch(frustum);
+				if (drawing)
+					m_Culling.Draw(m_Pipeline, &m_Vertices, &m_Indices);
+				renderer.SubmitCommandBuffer();
+
+				m_VisibleCount = m_Culling.ReadVisibleCount();
+				if (m_VisibleCount != m_Reference.CullScalar(frustum, visible.data()))
+					SDLException("GPU culling disagrees with the scalar reference");
+			}
+		}
+
+		~GpuCullingScene() override
+		{
+			m_Culling.Cleanup();
+			m_Indices.Cleanup();
+			m_Vertices.Cleanup();
+		}
+
+		const char* GetName() const override { return "gpu_culling"; }
+		const char* GetItemName() const override { return "objects"; }
+		uint64_t GetItemsPerFrame() const override { return OBJECT_COUNT; }
+
+		std::vector<BenchMetric> GetMetrics() const override
+		{
+			return { { "visible_objects", double(m_VisibleCount) } };
+		}
+
+		void Frame(Renderer&) override
+		{
+			m_Culling.Dispatch(TurningCameraFrustum(m_Frame++));
+			m_Culling.Draw(m_Pipeline, &m_Vertices, &m_Indices);
+		}
+
+	private:
+		SDL_GPUGraphicsPipeline* m_Pipeline{nullptr};
+		GpuCulling m_Culling;
+		CpuCulling m_Reference;
+		VertexBuffer m_Vertices;
+		IndexBuffer m_Indices;
+		uint32_t m_VisibleCount{0};   // of the last validated frame
+		uint32_t m_Frame{0};
+};
+
+
+// CPU only, a transform hierarchy where 1% of the nodes move every frame.
+// Nodes form an 8-ary tree, so the moving ones drag their subtrees along.
+class TransformsScene : public BenchScene
+{
+	public:
+		static constexpr uint32_t BRANCHING = 8;
+		static constexpr uint32_t MOVING_PERCENT = 1;
+
+		TransformsScene(Renderer& renderer, uint32_t nodeCount, const char* name)
+		{
+			m_Jobs = renderer.Jobs.get();
+			m_Name = name;
+
+			for (uint32_t i = 0; i < nodeCount; i++)
+			{
+				uint32_t node = m_Transforms.Add(i == 0 ? TransformHierarchy::NO_PARENT : (i - 1) / BRANCHING);
+				m_Transforms.SetPosition(node, glm::vec3(1.0f, 0.0f, 0.0f));
+			}
+			m_Transforms.Update();
+
+			// Written into this frame's upload like the app does, as long as it fits into a
+			// segment. 1M nodes are 48 MB, those go to plain memory.
+			if (uint64_t(nodeCount) * sizeof(ObjectTransform) <= renderer.Uploader->GetSegmentSize())
+				m_Buffer = std::make_unique<InstanceBuffer>(renderer.Device, renderer.Uploader.get(), nodeCount, uint32_t(sizeof(ObjectTransform)));
+			else
+				m_Output.resize(nodeCount);
+		}
+
+		~TransformsScene() override
+		{
+			if (m_Buffer)
+				m_Buffer->Cleanup();
+		}
+
+		const char* GetName() const override { return m_Name; }
+		const char* GetItemName() const override { return "nodes"; }
+		uint64_t GetItemsPerFrame() const override { return m_Transforms.GetCount(); }
+
+		void Frame(Renderer&) override
+		{
+			const uint32_t count = m_Transforms.GetCount();
+			const uint32_t moving = std::max(1u, count / 100 * MOVING_PERCENT);
+			const float angle = float(m_Frame++) * 0.01f;
+			for (uint32_t i = 0; i < moving; i++)
+			{
+				m_Seed = m_Seed * 1664525u + 1013904223u;
+				m_Transforms.SetRotation(m_Seed % count, glm::angleAxis(angle, glm::vec3(0.0f, 0.0f, 1.0f)));
+			}
+
+			ObjectTransform* output = m_Buffer ? m_Buffer->BeginFrame<ObjectTransform>(count) : m_Output.data();
+			m_Transforms.Update(output, m_Jobs);
+		}
+
+	private:
+		JobSystem* m_Jobs{nullptr};
+		const char* m_Name{nullptr};
+		TransformHierarchy m_Transforms;
+		std::unique_ptr<InstanceBuffer> m_Buffer;
+		std::vector<ObjectTransform> m_Output;
+		uint32_t m_Frame{0};
+		uint32_t m_Seed{1};
+};
+
+// GPU particles kept at capacity: every frame emits what expired, simulates and
+// compacts all of them in compute and draws the survivors with one indirect draw
+class ParticlesScene : public BenchScene
+{
+	public:
+		static constexpr float DELTA_TIME = 1.0f / 60.0f;   // fixed, so runs compare regardless of frame time
+
+		ParticlesScene(Renderer& renderer, uint32_t capacity, const char* name)
+			: m_Particles(&renderer, capacity)
+		{
+			m_Renderer = &renderer;
+			m_Name = name;
+
+			m_VertexShader = renderer.LoadShader("Particle.vert", 0, 0, 1);
+			m_FragmentShader = renderer.LoadShader("Particle.frag");
+			if (!m_VertexShader || !m_FragmentShader)
+				SDLException("Failed to load particle shaders");
+
+			// Additive, tested against the depth buffer but not written
+			PipelineDesc desc{};
+			desc.VertexShader = m_VertexShader;
+			desc.FragmentShader = m_FragmentShader;
+			desc.Blend.enable_blend = true;
+			desc.Blend.src_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
+			desc.Blend.dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
+			desc.Blend.color_blend_op = SDL_GPU_BLENDOP_ADD;
+			desc.Blend.src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
+			desc.Blend.dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
+			desc.Blend.alpha_blend_op = SDL_GPU_BLENDOP_ADD;
+			desc.DepthStencil = DepthState(SDL_GPU_COMPAREOP_LESS, false);
+			m_Pipeline = renderer.CreatePipeline(desc);
+			if (!m_Pipeline)
+				SDLException("Failed to create particle pipeline");
+
+			m_Emitter.SpawnRadius = 0.5f;
+			m_Emitter.Velocity = glm::vec3(0.0f, 4.0f, 0.0f);
+			m_Emitter.VelocitySpread = 2.0f;
+			m_Emitter.Drag = 0.1f;
+			m_Emitter.StartColor = glm::vec4(1.0f, 0.6f, 0.2f, 0.2f);
+			m_Emitter.EndColor = glm::vec4(0.2f, 0.2f, 1.0f, 0.0f);
+			m_Emitter.StartSize = 0.02f;
+			m_Emitter.EndSize = 0.005f;
+			m_Emitter.LifetimeMin = 1.0f;
+			m_Emitter.LifetimeMax = 3.0f;
+
+			// Replaces what expires on average, after a burst filling every slot
+			m_Emitter.Rate = float(capacity) / (0.5f * (m_Emitter.LifetimeMin + m_Emitter.LifetimeMax));
+			m_Particles.Burst(capacity);
+
+			// The bench renders at 1920x1080
+			m_View = glm::lookAt(glm::vec3(0.0f, 2.0f, 12.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+			m_Projection = glm::perspectiveZO(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+		}
+
+		~ParticlesScene() override
+		{
+			SDL_WaitForGPUIdle(m_Renderer->Device);
+			m_Particles.Cleanup();
+			m_Renderer->ReleasePipeline(m_Pipeline);
+			m_Renderer->ReleaseShader(m_VertexShader);
+			m_Renderer->ReleaseShader(m_FragmentShader);
+		}
+
+		const char* GetName() const override { return m_Name; }
+		const char* GetItemName() const override { return "particles"; }
+		uint64_t GetItemsPerFrame() const override { return m_Particles.GetCapacity(); }
+
+		void Frame(Renderer&) override
+		{
+			m_Particles.Update(m_Emitter, DELTA_TIME, m_View, m_Projection);
+			m_Particles.Draw(m_Pipeline);
+		}
+
+	private:
+		Renderer* m_Renderer{nullptr};
+		const char* m_Name{nullptr};
+
+		SDL_GPUShader* m_VertexShader{nullptr};
+		SDL_GPUShader* m_FragmentShader{nullptr};
+		SDL_GPUGraphicsPipeline* m_Pipeline{nullptr};
+
+		GpuParticles m_Particles;
+		ParticleEmitter m_Emitter{};
+		glm::mat4 m_View{1.0f};
+		glm::mat4 m_Projection{1.0f};
+};
+
+
+
+static BenchResult RunScene(Renderer& renderer, BenchScene& scene, const BenchOptions& options, uint32_t recordThreads)
+{
+	renderer.SetRecordThreadCount(recordThreads);
+
+	std::vector<uint64_t> frameTimes;
+	frameTimes.reserve(options.Frames);
+
+	// Measured from the end of the last warmup frame
+	uint64_t start = SDL_GetTicksNS();
+	uint64_t last = start;
+	for (uint32_t frame = 0; frame < options.WarmupFrames + options.Frames; frame++)
+	{
+		renderer.BeginFrame();
+
+		SDL_Event event;
+		while (SDL_PollEvent(&event))
+		{
+		}
+
+		if (renderer.InitCommandBuffer())
+			scene.Frame(renderer);
+		renderer.SubmitCommandBuffer();
+
+		uint64_t now = SDL_GetTicksNS();
+		if (frame >= options.WarmupFrames)
+			frameTimes.push_back(now - last);
+		else
+			start = now;
+		last = now;
+	}
+
+	// Throughput includes the GPU finishing the last frames
+	SDL_WaitForGPUIdle(renderer.Device);
+	uint64_t end = SDL_GetTicksNS();
+
+	BenchResult result{};
+	result.Scene = scene.GetName();
+	result.RecordThreads = renderer.GetRecordThreadCount();
+	result.Frames = options.Frames;
+	result.ItemsPerFrame = scene.GetItemsPerFrame();
+	result.ItemName = scene.GetItemName();
+	result.Seconds = (end - start) / 1e9;
+	result.LastFrame = renderer.GetDrawStats();
+	result.RenderScale = renderer.GetResolutionScale();
+	result.Metrics = scene.GetMetrics();
+
+	if (frameTimes.empty())
+		return result;
+
+	std::sort(frameTimes.begin(), frameTimes.end());
+	const uint32_t count = uint32_t(frameTimes.size());
+
+	uint64_t total = 0;
+	for (uint64_t frameTime : frameTimes)
+		total += frameTime;
+
+	result.AverageMS = total / 1e6 / count;
+	result.P50MS = NearestRankPercentileMS(frameTimes.data(), count, 0.50);
+	result.P95MS = NearestRankPercentileMS(frameTimes.data(), count, 0.95);
+	result.P99MS = NearestRankPercentileMS(frameTimes.data(), count, 0.99);
+	result.MaxMS = frameTimes.back() / 1e6;
+	return result;
+}
+
+// Permutation `index` of the pipeline creation measurement, the shader fields are
+// filled in by the caller from CREATION_VERTEX_SHADERS and CREATION_FRAGMENT_SHADERS
+static constexpr const char* CREATION_VERTEX_SHADERS[] = { "PositionColor.vert", "PositionColorTransform.vert" };
+static constexpr const char* CREATION_FRAGMENT_SHADERS[] = { "Color.frag", "Overdraw.frag" };
+
+static PipelineDesc CreationPermutation(uint32_t index)
+{
+	static constexpr SDL_GPUBlendFactor factors[] = {
+		SDL_GPU_BLENDFACTOR_ZERO, SDL_GPU_BLENDFACTOR_ONE,
+		SDL_GPU_BLENDFACTOR_SRC_COLOR, SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_COLOR,
+		SDL_GPU_BLENDFACTOR_DST_COLOR, SDL_GPU_BLENDFACTOR_ONE_MINUS_DST_COLOR,
+		SDL_GPU_BLENDFACTOR_SRC_ALPHA, SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA
+	};
+
+	PipelineDesc desc{};
+	desc.VertexInput = &VertexInputFor<VertexPositionColor>::State;
+	desc.Blend.enable_blend = true;
+	desc.Blend.src_color_blendfactor = factors[index / 4 % 8];
+	desc.Blend.dst_color_blendfactor = factors[index / 32 % 8];
+	desc.Blend.color_blend_op = SDL_GPU_BLENDOP_ADD;
+	desc.Blend.src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
+	desc.Blend.dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ZERO;
+	desc.Blend.alpha_blend_op = SDL_GPU_BLENDOP_ADD;
+	return desc;
+}
+
+// Must run while the pipeline cache is still empty, before any scene loads shaders.
+// Both runs create every shader and `count` pipelines from scratch and are torn down
+// again afterwards. They use disjoint permutations so a driver-side cache filled by
+// the first run cannot serve the second.
+static PipelineCreationResult MeasurePipelineCreation(Renderer& renderer, uint32_t count)
+{
+	PipelineCreationResult result{};
+	result.Pipelines = count;
+	result.Workers = renderer.Jobs->GetWorkerCount();
+
+	std::vector<SDL_GPUShader*> shaders;
+	std::vector<SDL_GPUGraphicsPipeline*> pipelines;
+	auto release = [&]
+	{
+		for (SDL_GPUGraphicsPipeline* pipeline : pipelines)
+			renderer.ReleasePipeline(pipeline);
+		for (SDL_GPUShader* shader : shaders)
+			renderer.ReleaseShader(shader);
+		pipelines.clear();
+		shaders.clear();
+		renderer.TrimPipelines();
+	};
+
+	// Serial, the way main.cpp used to create its pipelines
+	uint64_t start = SDL_GetTicksNS();
+	{
+		SDL_GPUShader* vertexShaders[2] = { renderer.LoadShader(CREATION_VERTEX_SHADERS[0]), renderer.LoadShader(CREATION_VERTEX_SHADERS[1], 0, 0, 1) };
+		SDL_GPUShader* fragmentShaders[2] = { renderer.LoadShader(CREATION_FRAGMENT_SHADERS[0]), renderer.LoadShader(CREATION_FRAGMENT_SHADERS[1]) };
+		shaders = { vertexShaders[0], vertexShaders[1], fragmentShaders[0], fragmentShaders[1] };
+		if (std::find(shaders.begin(), shaders.end(), nullptr) != shaders.end())
+			SDLException("Failed to load pipeline creation shaders");
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			PipelineDesc desc = CreationPermutation(i);
+			desc.VertexShader = vertexShaders[i % 2];
+			desc.FragmentShader = fragmentShaders[i / 2 % 2];
+
+			SDL_GPUGraphicsPipeline* pipeline = renderer.CreatePipeline(desc);
+			if (!pipeline)
+				SDLException("Failed to create pipeline creation permutation");
+			pipelines.push_back(pipeline);
+		}
+	}
+	result.SerialMS = (SDL_GetTicksNS() - start) / 1e6;
+	release();
+
+	// Async, every job is scheduled up front and waited on at the end
+	start = SDL_GetTicksNS();
+	{
+		Renderer::AsyncShader vertexShaders[2] = { renderer.LoadShaderAsync(CREATION_VERTEX_SHADERS[0]), renderer.LoadShaderAsync(CREATION_VERTEX_SHADERS[1], 0, 0, 1) };
+		Renderer::AsyncShader fragmentShaders[2] = { renderer.LoadShaderAsync(CREATION_FRAGMENT_SHADERS[0]), renderer.LoadShaderAsync(CREATION_FRAGMENT_SHADERS[1]) };
+
+		std::vector<Renderer::AsyncPipeline> requests;
+		requests.reserve(count);
+		for (uint32_t i = 0; i < count; i++)
+			requests.push_back(renderer.CreatePipelineAsync(vertexShaders[i % 2], fragmentShaders[i / 2 % 2], CreationPermutation(count + i)));
+
+		for (const Renderer::AsyncPipeline& request : requests)
+			pipelines.push_back(renderer.Jobs->Wait(request));
+		for (const Renderer::AsyncShader& request : { vertexShaders[0], vertexShaders[1], fragmentShaders[0], fragmentShaders[1] })
+			shaders.push_back(renderer.Jobs->Wait(request));
+	}
+	result.AsyncMS = (SDL_GetTicksNS() - start) / 1e6;
+
+	const bool failed = std::find(pipelines.begin(), pipelines.end(), nullptr) != pipelines.end() || std::find(shaders.begin(), shaders.end(), nullptr) != shaders.end();
+	release();
+	if (failed)
+		SDLException("Failed to create pipeline creation permutations asynchronously");
+
+	return result;
+}
+
+static void WriteResults(FILE* file, Renderer& renderer, const BenchOptions& options, const PipelineCreationResult& creation, const std::vector<BenchResult>& results)
+{
+	fprintf(file, "{\n  \"driver\": \"%s\",\n  \"headless\": %s,\n  \"frames\": %u,\n  \"warmup_frames\": %u,\n",
+		SDL_GetGPUDeviceDriver(renderer.Device), renderer.IsHeadless() ? "true" : "false", options.Frames, options.WarmupFrames);
+
+	if (creation.Pipelines)
+	{
+		fprintf(file, "  \"pipeline_creation\": {\"pipelines\": %u, \"workers\": %u, \"serial_ms\": %.3f, \"async_ms\": %.3f, \"speedup\": %.2f},\n",
+			creation.Pipelines, creation.Workers, creation.SerialMS, creation.AsyncMS, creation.AsyncMS > 0.0 ? creation.SerialMS / creation.AsyncMS : 0.0);
+	}
+
+	fputs("  \"results\": [\n", file);
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const BenchResult& result = results[i];
+		double fps = result.Seconds > 0.0 ? result.Frames / result.Seconds : 0.0;
+
+		fprintf(file, "    {\"scene\": \"%s\", \"record_threads\": %u, \"frames\": %u, \"seconds\": %.4f, \"fps\": %.2f, "
+			"\"%s_per_frame\": %llu, \"%s_per_second\": %.0f, "
+			"\"frame_ms\": {\"avg\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f}, \"render_scale\": %.2f, "
+			"\"last_frame\": {\"draws\": %u, \"pipeline_binds\": %u, \"vertex_buffer_binds\": %u, \"record_chunks\": %u}",
+			result.Scene.c_str(), result.RecordThreads, result.Frames, result.Seconds, fps,
+			result.ItemName, (unsigned long long)result.ItemsPerFrame, result.ItemName, fps * double(result.ItemsPerFrame),
+			result.AverageMS, result.P50MS, result.P95MS, result.P99MS, result.MaxMS, result.RenderScale,
+			result.LastFrame.Draws, result.LastFrame.PipelineBinds, result.LastFrame.VertexBufferBinds, result.LastFrame.RecordChunks);
+
+		if (!result.Metrics.empty())
+		{
+			fputs(", \"metrics\": {", file);
+			for (size_t m = 0; m < result.Metrics.size(); m++)
+				fprintf(file, "%s\"%s\": %.6g", m > 0 ? ", " : "", result.Metrics[m].Name, result.Metrics[m].Value);
+			fputc('}', file);
+		}
+
+		fprintf(file, "}%s\n", i + 1 < results.size() ? "," : "");
+	}
+
+	fputs("  ]\n}\n", file);
+}
+
+
+int main(int argc, char* argv[])
+{
+	BenchOptions options{};
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--frames" && hasValue)
+			options.Frames = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+		else if (argument == "--warmup" && hasValue)
+			options.WarmupFrames = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+		else if (argument == "--scene" && hasValue)
+			options.Scene = argv[++i];
+		else if (argument == "--output" && hasValue)
+			options.OutputPath = argv[++i];
+		else if (argument == "--windowed")
+			options.Windowed = true;
+		else
+		{
+			fprintf(stderr, "Usage: %s [--frames N] [--warmup N] [--scene name] [--windowed] [--output file.json]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (!SDL_Init(SDL_INIT_VIDEO))
+		SDLException("Failed to initialize SDL");
+
+	BasePath = SDL_GetBasePath();
+	if (!BasePath)
+		SDLException("Failed to get base path for assets");
+
+	SDL_Window* window = nullptr;
+	if (options.Windowed)
+	{
+		window = SDL_CreateWindow("sdlGPU bench", 1920, 1080, 0);
+		if (!window)
+			SDLException("Failed to create SDL window");
+	}
+
+	std::vector<BenchResult> results;
+	PipelineCreationResult creation{};
+	{
+		Renderer renderer(window, 1920, 1080);
+
+		// Unthrottled, frame times are the cost of the frame and not the display's
+		FramePacingSettings pacing{};
+		pacing.PresentMode = SDL_GPU_PRESENTMODE_IMMEDIATE;
+		pacing.FramesInFlight = 2;
+		renderer.SetFramePacing(pacing);
+
+		auto wanted = [&](const char* name) { return options.Scene.empty() || options.Scene == name; };
+
+		// Ahead of everything else, the cache has to be empty for a cold start
+		if (wanted("pipeline_creation"))
+			creation = MeasurePipelineCreation(renderer, 64);
+
+		SDL_GPUShader* vertexShader = renderer.LoadShader("PositionColor.vert");
+		SDL_GPUShader* instancedVertexShader = renderer.LoadShader("PositionColorInstancedStorage.vert", 0, 0, 1);
+		SDL_GPUShader* streamedVertexShader = renderer.LoadShader("PositionColorInstanced.vert");
+		SDL_GPUShader* fragmentShader = renderer.LoadShader("Color.frag");
+		SDL_GPUShader* texturedVertexShader = renderer.LoadShader("PositionTexture.vert");
+		SDL_GPUShader* texturedFragmentShader = renderer.LoadShader("Texture.frag", 1);
+		if (!vertexShader || !instancedVertexShader || !streamedVertexShader || !fragmentShader || !texturedVertexShader || !texturedFragmentShader)
+			SDLException("Failed to load benchmark shaders");
+
+		SDL_GPUGraphicsPipeline* pipeline = renderer.CreatePipeline<VertexPositionColor>(vertexShader, fragmentShader);
+		SDL_GPUGraphicsPipeline* instancedPipeline = renderer.CreatePipeline<VertexPositionColor>(instancedVertexShader, fragmentShader);
+		SDL_GPUGraphicsPipeline* streamedPipeline = renderer.CreatePipeline<VertexInput<VertexStream<VertexPositionColor>, InstanceStream<InstanceData>>>(streamedVertexShader, fragmentShader);
+		SDL_GPUGraphicsPipeline* texturedPipeline = renderer.CreatePipeline<VertexPositionTexture>(texturedVertexShader, texturedFragmentShader);
+		if (!pipeline || !instancedPipeline || !streamedPipeline || !texturedPipeline)
+			SDLException("Failed to create benchmark pipelines");
+
+		if (wanted("draws"))
+		{
+			// Recording scaling over the job system, capped at what the machine has
+			DrawsScene scene(renderer, pipeline);
+			const uint32_t maxThreads = renderer.Jobs->GetWorkerCount() + 1;
+			for (uint32_t threads : { 1u, 2u, 4u, 8u })
+			{
+				if (threads > maxThreads)
+					break;
+				results.push_back(RunScene(renderer, scene, options, threads));
+			}
+		}
+
+		if (wanted("draws_indexed"))
+		{
+			DrawsScene scene(renderer, pipeline, true);
+			results.push_back(RunScene(renderer, scene, options, 1));
+		}
+
+		// The same instances read from a vertex storage buffer and from an instance-rate stream
+		for (auto [input, scenePipeline, name] : {
+			std::tuple(InstanceInput::StorageBuffer, instancedPipeline, "instancing"),
+			std::tuple(InstanceInput::VertexStream, streamedPipeline, "instancing_vertex_stream") })
+		{
+			if (wanted(name))
+			{
+				InstancingScene scene(renderer, scenePipeline, input, name);
+				results.push_back(RunScene(renderer, scene, options, 1));
+			}
+		}
+
+		if (wanted("uploads"))
+		{
+			UploadsScene scene(renderer, pipeline);
+			results.push_back(RunScene(renderer, scene, options, 1));
+		}
+
+		for (bool defragment : { false, true })
+		{
+			if (wanted(defragment ? "mesh_pool_defragment" : "mesh_pool"))
+			{
+				MeshPoolScene scene(renderer, pipeline, defragment);
+				results.push_back(RunScene(renderer, scene, options, 1));
+			}
+		}
+
+		if (wanted("texture_streaming"))
+		{
+			TextureStreamingScene scene(renderer, texturedPipeline);
+			results.push_back(RunScene(renderer, scene, options, 1));
+		}
+
+		if (wanted("pipeline_churn"))
+		{
+			PipelineChurnScene scene(renderer, vertexShader, fragmentShader);
+			results.push_back(RunScene(renderer, scene, options, 1));
+		}
+
+		for (auto [mode, name] : {
+			std::pair(OverdrawScene::Mode::BackToFront, "overdraw_back_to_front"),
+			std::pair(OverdrawScene::Mode::FrontToBack, "overdraw_front_to_back"),
+			std::pair(OverdrawScene::Mode::DepthPrepass, "overdraw_prepass") })
+		{
+			if (wanted(name))
+			{
+				OverdrawScene scene(renderer, mode, name);
+				results.push_back(RunScene(renderer, scene, options, 1));
+			}
+		}
+
+		if (wanted("overdraw_dynamic_resolution"))
+		{
+			// The worst overdraw case again, with the render scale chasing a tight GPU budget
+			ResolutionScaleSettings scaling{};
+			scaling.Enabled = true;
+			scaling.TargetGpuMS = 4.0;
+			scaling.MinScale = 0.25f;
+			renderer.SetResolutionScaling(scaling);
+
+			OverdrawScene scene(renderer, OverdrawScene::Mode::BackToFront, "overdraw_dynamic_resolution");
+			results.push_back(RunScene(renderer, scene, options, 1));
+
+			renderer.SetResolutionScaling(ResolutionScaleSettings{});
+		}
+
+		if (wanted("vertex_packing"))
+		{
+			VertexPackingScene scene;
+			results.push_back(RunScene(renderer, scene, options, 1));
+		}
+
+		if (wanted("mesh_optimizer"))
+		{
+			MeshOptimizerScene scene;
+			results.push_back(RunScene(renderer, scene, options, 1));
+		}
+
+		for (auto [nodeCount, name] : { std::pair(10'000u, "transforms_10k"), std::pair(100'000u, "transforms_100k"), std::pair(1'000'000u, "transforms_1m") })
+		{
+			if (wanted(name))
+			{
+				TransformsScene scene(renderer, nodeCount, name);
+				results.push_back(RunScene(renderer, scene, options, 1));
+			}
+		}
+
+		for (auto [capacity, name] : { std::pair(1u << 20, "particles_1m"), std::pair(1u << 22, "particles_4m") })
+		{
+			if (wanted(name))
+			{
+				ParticlesScene scene(renderer, capacity, name);
+				results.push_back(RunScene(renderer, scene, options, 1));
+			}
+		}
+
+		for (CpuCulling::Shape shape : { CpuCulling::Shape::Sphere, CpuCulling::Shape::SphereAndBox })
+		{
+			const bool boxes = shape == CpuCulling::Shape::SphereAndBox;
+			if (wanted(boxes ? "culling_boxes" : "culling"))
+			{
+				CullingScene scene(nullptr, shape);
+				results.push_back(RunScene(renderer, scene, options, 1));
+			}
+
+			if (wanted(boxes ? "culling_boxes_parallel" : "culling_parallel"))
+			{
+				CullingScene scene(renderer.Jobs.get(), shape);
+				results.push_back(RunScene(renderer, scene, options, 1));
+			}
+		}
+
+		if (wanted("gpu_culling"))
+		{
+			GpuCullingScene scene(renderer, pipeline);
+			results.push_back(RunScene(renderer, scene, options, 1));
+		}
+
+		SDL_WaitForGPUIdle(renderer.Device);
+		renderer.ReleasePipeline(pipeline);
+		renderer.ReleasePipeline(instancedPipeline);
+		renderer.ReleasePipeline(streamedPipeline);
+		renderer.ReleasePipeline(texturedPipeline);
+		renderer.ReleaseShader(vertexShader);
+		renderer.ReleaseShader(instancedVertexShader);
+		renderer.ReleaseShader(streamedVertexShader);
+		renderer.ReleaseShader(fragmentShader);
+		renderer.ReleaseShader(texturedVertexShader);
+		renderer.ReleaseShader(texturedFragmentShader);
+
+		if (results.empty() && !creation.Pipelines)
+		{
+			fprintf(stderr, "Unknown scene '%s'\n", options.Scene.c_str());
+			return EXIT_FAILURE;
+		}
+
+		FILE* output = options.OutputPath.empty() ? stdout : fopen(options.OutputPath.c_str(), "wb");
+		if (!output)
+			SDLException("Failed to open benchmark output file");
+
+		WriteResults(output, renderer, options, creation, results);
+		if (output != stdout)
+			fclose(output);
+
+		renderer.Cleanup();
+	}
+
+	if (window)
+		SDL_DestroyWindow(window);
+	SDL_Quit();
+	return EXIT_SUCCESS;
+}
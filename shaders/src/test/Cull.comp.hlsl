@@ -0,0 +1,54 @@
+// Tests every object's bounding sphere against the frustum and appends a draw
+// command for each visible one. Only uses storage buffer atomics, no subgroup ops.
+// Pipeline: one read-only and two read-write storage buffers, one uniform buffer, 64 threads
+
+struct CullObject
+{
+    float4 sphere;   // xyz center, w radius
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+    uint padding0;
+    uint padding1;
+    uint padding2;
+};
+
+// SDL binds compute read-only storage buffers to set 0, read-write ones to set 1 and uniforms to set 2
+[[vk::binding(0, 0)]] StructuredBuffer<CullObject> Objects : register(t0, space0);
+[[vk::binding(0, 1)]] RWByteAddressBuffer DrawCommands : register(u0, space1);
+[[vk::binding(1, 1)]] RWByteAddressBuffer VisibleCount : register(u1, space1);
+
+[[vk::binding(0, 2)]] cbuffer CullParams : register(b0, space2)
+{
+    float4 Planes[6];
+    uint ObjectCount;
+};
+
+// SDL_GPUIndexedIndirectDrawCommand, five 32-bit values
+static const uint COMMAND_SIZE = 20;
+
+[numthreads(64, 1, 1)]
+void main(uint3 threadId : SV_DispatchThreadID)
+{
+    uint index = threadId.x;
+    if (index >= ObjectCount)
+        return;
+
+    CullObject object = Objects[index];
+
+    [unroll]
+    for (uint i = 0; i < 6; i++)
+    {
+        if (dot(Planes[i].xyz, object.sphere.xyz) + Planes[i].w < -object.sphere.w)
+            return;
+    }
+
+    uint slot;
+    VisibleCount.InterlockedAdd(0, 1, slot);
+
+    uint address = slot * COMMAND_SIZE;
+    DrawCommands.Store4(address, uint4(object.indexCount, object.instanceCount, object.firstIndex, asuint(object.vertexOffset)));
+    DrawCommands.Store(address + 16, object.firstInstance);
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+// Clears the indirect draw commands and the visible counter ahead of Cull.comp.
+// SDL has no draw-count buffer, every command slot is submitted and unused ones must draw nothing.
+// Pipeline: two read-write storage buffers, one uniform buffer, 64 threads
+
+// SDL binds compute read-write storage buffers to set 1 and uniforms to set 2
+[[vk::binding(0, 1)]] RWByteAddressBuffer DrawCommands : register(u0, space1);
+[[vk::binding(1, 1)]] RWByteAddressBuffer VisibleCount : register(u1, space1);
+
+[[vk::binding(0, 2)]] cbuffer CullParams : register(b0, space2)
+{
+    float4 Planes[6];
+    uint ObjectCount;
+};
+
+// SDL_GPUIndexedIndirectDrawCommand, five 32-bit values
+static const uint COMMAND_SIZE = 20;
+
+[numthreads(64, 1, 1)]
+void main(uint3 threadId : SV_DispatchThreadID)
+{
+    uint index = threadId.x;
+    if (index == 0)
+        VisibleCount.Store(0, 0);
+
+    if (index >= ObjectCount)
+        return;
+
+    uint address = index * COMMAND_SIZE;
+    DrawCommands.Store4(address, uint4(0, 0, 0, 0));
+    DrawCommands.Store(address + 16, 0);
+}
\ No newline at end of file
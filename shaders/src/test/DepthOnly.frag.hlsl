@@ -0,0 +1,5 @@
+// Depth pre-pass fragment shader. Writes no color, the pipeline masks the color target out.
+
+void main()
+{
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+// Deliberately expensive color shader, so shaded fragments show up in frame times
+// of the overdraw benchmark scenes.
+
+struct PSInput
+{
+    float4 color : TEXCOORD0;
+};
+
+float4 main(PSInput input) : SV_Target0
+{
+    float3 color = input.color.xyz;
+
+    [loop]
+    for (int i = 0; i < 64; i++)
+        color = frac(color * 1.37f + sin(color.zxy * 3.1f));
+
+    return float4(lerp(input.color.xyz, color, 0.25f), 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+// Soft round particle, premultiplied by its alpha for additive blending (ONE, ONE)
+
+struct Input
+{
+    float4 color : TEXCOORD0;
+    float2 corner : TEXCOORD1;
+};
+
+float4 main(Input input) : SV_Target0
+{
+    float alpha = input.color.a * saturate(1.0f - dot(input.corner, input.corner));
+    return float4(input.color.rgb * alpha, alpha);
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+// Camera-facing particle billboards for GpuParticles, drawn with six vertices per
+// instance and no vertex input. Each instance reads the billboard ParticleSimulate.comp
+// wrote for one live particle.
+// Pipeline: no vertex buffers, one storage buffer, draws with Particle.frag
+
+struct ParticleVertex
+{
+    float4 clipPosition;
+    float2 clipSize;
+    uint color;          // RGBA8
+    uint padding;
+};
+
+// SDL binds vertex storage buffers to set 0 after the sampled and storage textures
+[[vk::binding(0, 0)]] StructuredBuffer<ParticleVertex> Vertices : register(t0, space0);
+
+struct Output
+{
+    float4 position : SV_POSITION;
+    float4 color : TEXCOORD0;
+    float2 corner : TEXCOORD1;
+};
+
+// Two triangles covering [-1, 1]
+static const float2 CORNERS[6] =
+{
+    float2(-1.0f, -1.0f), float2(1.0f, -1.0f), float2(1.0f, 1.0f),
+    float2(-1.0f, -1.0f), float2(1.0f, 1.0f), float2(-1.0f, 1.0f)
+};
+
+Output main(uint vertexIndex : SV_VertexID, uint instanceIndex : SV_InstanceID)
+{
+    ParticleVertex particle = Vertices[instanceIndex];
+    float2 corner = CORNERS[vertexIndex];
+
+    Output output;
+    output.position = particle.clipPosition + float4(corner * particle.clipSize, 0.0f, 0.0f);
+    output.color = float4((particle.color >> uint4(0, 8, 16, 24)) & 0xFF) / 255.0f;
+    output.corner = corner;
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+// Turns the particle counters into indirect arguments. Stage 0 runs after the emission
+// and writes the simulation's dispatch, stage 1 runs after the simulation and writes
+// the draw of the survivors.
+// Pipeline: two read-write storage buffers, one uniform buffer, 1 thread
+
+// SDL binds compute read-write storage buffers to set 1 and uniforms to set 2
+[[vk::binding(0, 1)]] RWByteAddressBuffer Counters : register(u0, space1);
+[[vk::binding(1, 1)]] RWByteAddressBuffer Args : register(u1, space1);
+
+[[vk::binding(0, 2)]] cbuffer ParticleParams : register(b0, space2)
+{
+    float4 ViewProjection[4];   // rows
+    float4 EmitterPosition;     // w spawn radius
+    float4 EmitterVelocity;     // w velocity spread
+    float4 Gravity;             // w drag
+    float4 StartColor;
+    float4 EndColor;
+    float2 BillboardScale;
+    float StartSize;
+    float EndSize;
+    float LifetimeMin;
+    float LifetimeMax;
+    float DeltaTime;
+    uint EmitCount;
+    uint Capacity;
+    uint ListIn;
+    uint Seed;
+    uint ArgsStage;
+};
+
+// SDL_GPUIndirectDispatchCommand at 0, SDL_GPUIndirectDrawCommand at 16
+static const uint DRAW_ARGS_OFFSET = 16;
+static const uint THREAD_COUNT = 256;
+static const uint VERTICES_PER_PARTICLE = 6;
+
+[numthreads(1, 1, 1)]
+void main()
+{
+    uint listOut = 1 - ListIn;
+
+    if (ArgsStage == 0)
+    {
+        // Emission threads that found the dead list empty left it negative
+        int deadCount = asint(Counters.Load(0));
+        Counters.Store(0, uint(max(deadCount, 0)));
+
+        uint aliveCount = Counters.Load((1 + ListIn) * 4);
+        Args.Store3(0, uint3((aliveCount + THREAD_COUNT - 1) / THREAD_COUNT, 1, 1));
+        Counters.Store((1 + listOut) * 4, 0);
+    }
+    else
+    {
+        uint aliveCount = Counters.Load((1 + listOut) * 4);
+        Args.Store4(DRAW_ARGS_OFFSET, uint4(VERTICES_PER_PARTICLE, aliveCount, 0, 0));
+    }
+}
\ No newline at end of file
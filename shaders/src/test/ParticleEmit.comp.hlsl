@@ -0,0 +1,90 @@
+// Spawns EmitCount particles, each one pops a slot off the dead list and is appended
+// to the alive list read by this frame's simulation. Threads past the end of the dead
+// list spawn nothing; the dead count goes negative then and ParticleArgs clamps it.
+// Pipeline: three read-write storage buffers, one uniform buffer, 256 threads
+
+struct Particle
+{
+    float3 position;
+    float age;
+    float3 velocity;
+    float lifetime;
+};
+
+// SDL binds compute read-write storage buffers to set 1 and uniforms to set 2
+[[vk::binding(0, 1)]] RWStructuredBuffer<Particle> Particles : register(u0, space1);
+[[vk::binding(1, 1)]] RWByteAddressBuffer Lists : register(u1, space1);
+[[vk::binding(2, 1)]] RWByteAddressBuffer Counters : register(u2, space1);
+
+[[vk::binding(0, 2)]] cbuffer ParticleParams : register(b0, space2)
+{
+    float4 ViewProjection[4];   // rows
+    float4 EmitterPosition;     // w spawn radius
+    float4 EmitterVelocity;     // w velocity spread
+    float4 Gravity;             // w drag
+    float4 StartColor;
+    float4 EndColor;
+    float2 BillboardScale;
+    float StartSize;
+    float EndSize;
+    float LifetimeMin;
+    float LifetimeMax;
+    float DeltaTime;
+    uint EmitCount;
+    uint Capacity;
+    uint ListIn;
+    uint Seed;
+    uint ArgsStage;
+};
+
+// PCG hash, one well-mixed value per call
+uint NextRandom(inout uint state)
+{
+    state = state * 747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+float RandomFloat(inout uint state)
+{
+    return float(NextRandom(state) >> 8) * (1.0f / 16777216.0f);
+}
+
+// Uniform inside the unit sphere
+float3 RandomInSphere(inout uint state)
+{
+    float z = RandomFloat(state) * 2.0f - 1.0f;
+    float angle = RandomFloat(state) * 6.28318531f;
+    float radius = pow(RandomFloat(state), 1.0f / 3.0f);
+    float ring = sqrt(saturate(1.0f - z * z));
+    return float3(cos(angle) * ring, sin(angle) * ring, z) * radius;
+}
+
+[numthreads(256, 1, 1)]
+void main(uint3 threadId : SV_DispatchThreadID)
+{
+    if (threadId.x >= EmitCount)
+        return;
+
+    // Adds -1, the count is read as signed
+    uint deadCount;
+    Counters.InterlockedAdd(0, 0xFFFFFFFFu, deadCount);
+    if (asint(deadCount) <= 0)
+        return;
+
+    uint index = Lists.Load((2 * Capacity + deadCount - 1) * 4);
+
+    uint state = threadId.x ^ (Seed * 0x9E3779B9u);
+    NextRandom(state);
+
+    Particle particle;
+    particle.position = EmitterPosition.xyz + RandomInSphere(state) * EmitterPosition.w;
+    particle.age = 0.0f;
+    particle.velocity = EmitterVelocity.xyz + RandomInSphere(state) * EmitterVelocity.w;
+    particle.lifetime = lerp(LifetimeMin, LifetimeMax, RandomFloat(state));
+    Particles[index] = particle;
+
+    uint slot;
+    Counters.InterlockedAdd((1 + ListIn) * 4, 1, slot);
+    Lists.Store((ListIn * Capacity + slot) * 4, index);
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+// Puts every particle on the dead list and empties both alive lists, ahead of the first frame
+// and whenever GpuParticles::Reset is called.
+// Pipeline: two read-write storage buffers, one uniform buffer, 256 threads
+
+// SDL binds compute read-write storage buffers to set 1 and uniforms to set 2
+[[vk::binding(0, 1)]] RWByteAddressBuffer Lists : register(u0, space1);
+[[vk::binding(1, 1)]] RWByteAddressBuffer Counters : register(u1, space1);
+
+[[vk::binding(0, 2)]] cbuffer ParticleParams : register(b0, space2)
+{
+    float4 ViewProjection[4];   // rows
+    float4 EmitterPosition;     // w spawn radius
+    float4 EmitterVelocity;     // w velocity spread
+    float4 Gravity;             // w drag
+    float4 StartColor;
+    float4 EndColor;
+    float2 BillboardScale;
+    float StartSize;
+    float EndSize;
+    float LifetimeMin;
+    float LifetimeMax;
+    float DeltaTime;
+    uint EmitCount;
+    uint Capacity;
+    uint ListIn;
+    uint Seed;
+    uint ArgsStage;
+};
+
+// Lists holds alive list 0, alive list 1 and the dead list, Capacity indices each.
+// Counters holds the dead count and the count of either alive list.
+[numthreads(256, 1, 1)]
+void main(uint3 threadId : SV_DispatchThreadID)
+{
+    uint index = threadId.x;
+    if (index == 0)
+        Counters.Store3(0, uint3(Capacity, 0, 0));
+
+    if (index >= Capacity)
+        return;
+
+    Lists.Store((2 * Capacity + index) * 4, index);
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+// Ages and integrates the particles on this frame's alive list. Expired ones are pushed
+// back onto the dead list, survivors are compacted into the other alive list and their
+// billboard is written to the vertex buffer at the same slot, so Particle.vert can draw
+// the first alive-count entries. Dispatched indirectly with the arguments from ParticleArgs.
+// Pipeline: four read-write storage buffers, one uniform buffer, 256 threads
+
+struct Particle
+{
+    float3 position;
+    float age;
+    float3 velocity;
+    float lifetime;
+};
+
+struct ParticleVertex
+{
+    float4 clipPosition;
+    float2 clipSize;
+    uint color;          // RGBA8
+    uint padding;
+};
+
+// SDL binds compute read-write storage buffers to set 1 and uniforms to set 2
+[[vk::binding(0, 1)]] RWStructuredBuffer<Particle> Particles : register(u0, space1);
+[[vk::binding(1, 1)]] RWByteAddressBuffer Lists : register(u1, space1);
+[[vk::binding(2, 1)]] RWByteAddressBuffer Counters : register(u2, space1);
+[[vk::binding(3, 1)]] RWStructuredBuffer<ParticleVertex> Vertices : register(u3, space1);
+
+[[vk::binding(0, 2)]] cbuffer ParticleParams : register(b0, space2)
+{
+    float4 ViewProjection[4];   // rows
+    float4 EmitterPosition;     // w spawn radius
+    float4 EmitterVelocity;     // w velocity spread
+    float4 Gravity;             // w drag
+    float4 StartColor;
+    float4 EndColor;
+    float2 BillboardScale;
+    float StartSize;
+    float EndSize;
+    float LifetimeMin;
+    float LifetimeMax;
+    float DeltaTime;
+    uint EmitCount;
+    uint Capacity;
+    uint ListIn;
+    uint Seed;
+    uint ArgsStage;
+};
+
+uint PackColor(float4 color)
+{
+    uint4 bytes = uint4(saturate(color) * 255.0f + 0.5f);
+    return bytes.r | (bytes.g << 8) | (bytes.b << 16) | (bytes.a << 24);
+}
+
+[numthreads(256, 1, 1)]
+void main(uint3 threadId : SV_DispatchThreadID)
+{
+    uint listOut = 1 - ListIn;
+    if (threadId.x >= Counters.Load((1 + ListIn) * 4))
+        return;
+
+    uint index = Lists.Load((ListIn * Capacity + threadId.x) * 4);
+    Particle particle = Particles[index];
+
+    particle.age += DeltaTime;
+    if (particle.age >= particle.lifetime)
+    {
+        uint deadSlot;
+        Counters.InterlockedAdd(0, 1, deadSlot);
+        Lists.Store((2 * Capacity + deadSlot) * 4, index);
+        return;
+    }
+
+    particle.velocity += Gravity.xyz * DeltaTime;
+    particle.velocity *= max(1.0f - Gravity.w * DeltaTime, 0.0f);
+    particle.position += particle.velocity * DeltaTime;
+    Particles[index] = particle;
+
+    uint slot;
+    Counters.InterlockedAdd((1 + listOut) * 4, 1, slot);
+    Lists.Store((listOut * Capacity + slot) * 4, index);
+
+    float t = particle.age / particle.lifetime;
+    float4 position = float4(particle.position, 1.0f);
+
+    // Offsets in clip space before the divide by w, so billboards shrink with distance
+    ParticleVertex output;
+    output.clipPosition = float4(dot(ViewProjection[0], position), dot(ViewProjection[1], position), dot(ViewProjection[2], position), dot(ViewProjection[3], position));
+    output.clipSize = BillboardScale * lerp(StartSize, EndSize, t);
+    output.color = PackColor(lerp(StartColor, EndColor, t));
+    output.padding = 0;
+    Vertices[slot] = output;
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+// Depth pre-pass vertex shader, only reads positions. Must place vertices exactly like
+// PositionColor.vert so the shading pass can test EQUAL against its depth.
+// Pipeline: VertexPosition
+
+struct Input
+{
+    float3 position : TEXCOORD0;
+};
+
+float4 main(Input input) : SV_POSITION
+{
+    return float4(input.position, 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+// Instanced PositionColor, per-instance data comes from an instance-rate
+// vertex buffer on slot 1 (InstanceInput::VertexStream).
+// Pipeline: VertexInput<VertexStream<VertexPositionColor>, InstanceStream<InstanceData>>
+
+struct Input
+{
+    [[vk::location(0)]] float3 position : TEXCOORD0;
+    [[vk::location(1)]] float4 color : TEXCOORD1;
+
+    [[vk::location(2)]] float4 row0 : TEXCOORD2;
+    [[vk::location(3)]] float4 row1 : TEXCOORD3;
+    [[vk::location(4)]] float4 row2 : TEXCOORD4;
+    [[vk::location(5)]] float4 instanceColor : TEXCOORD5;
+    [[vk::location(6)]] uint instanceId : TEXCOORD6;
+};
+
+struct Output
+{
+    float4 position : SV_POSITION;
+    float4 color : TEXCOORD0;
+};
+
+Output main(Input input)
+{
+    float4 position = float4(input.position, 1.0f);
+
+    Output output;
+    output.position = float4(dot(input.row0, position), dot(input.row1, position), dot(input.row2, position), 1.0f);
+    output.color = input.color * input.instanceColor;
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+// Instanced PositionColor, per-instance data is read from a storage buffer
+// indexed by SV_InstanceID (InstanceInput::StorageBuffer).
+// Pipeline: VertexPositionColor, one storage buffer
+
+struct InstanceData
+{
+    float4 row0;
+    float4 row1;
+    float4 row2;
+    float4 color;
+    uint id;
+    uint padding0;
+    uint padding1;
+    uint padding2;
+};
+
+// SDL binds vertex storage buffers to set 0 after the sampled and storage textures
+[[vk::binding(0, 0)]] StructuredBuffer<InstanceData> Instances : register(t0, space0);
+
+struct Input
+{
+    float3 position : TEXCOORD0;
+    float4 color : TEXCOORD1;
+};
+
+struct Output
+{
+    float4 position : SV_POSITION;
+    float4 color : TEXCOORD0;
+};
+
+Output main(Input input, uint instanceIndex : SV_InstanceID)
+{
+    InstanceData instance = Instances[instanceIndex];
+    float4 position = float4(input.position, 1.0f);
+
+    Output output;
+    output.position = float4(dot(instance.row0, position), dot(instance.row1, position), dot(instance.row2, position), 1.0f);
+    output.color = input.color * instance.color;
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+// PositionColor placed by the transform hierarchy. Object i of an instanced draw reads
+// its world transform from Transforms[i], written by TransformHierarchy::Update.
+// Pipeline: VertexPositionColor, one storage buffer
+
+struct ObjectTransform
+{
+    float4 row0;
+    float4 row1;
+    float4 row2;
+};
+
+// SDL binds vertex storage buffers to set 0 after the sampled and storage textures
+[[vk::binding(0, 0)]] StructuredBuffer<ObjectTransform> Transforms : register(t0, space0);
+
+struct Input
+{
+    float3 position : TEXCOORD0;
+    float4 color : TEXCOORD1;
+};
+
+struct Output
+{
+    float4 position : SV_POSITION;
+    float4 color : TEXCOORD0;
+};
+
+Output main(Input input, uint objectIndex : SV_InstanceID)
+{
+    ObjectTransform transform = Transforms[objectIndex];
+    float4 position = float4(input.position, 1.0f);
+
+    Output output;
+    output.position = float4(dot(transform.row0, position), dot(transform.row1, position), dot(transform.row2, position), 1.0f);
+    output.color = input.color;
+    return output;
+}
\ No newline at end of file
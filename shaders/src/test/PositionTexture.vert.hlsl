@@ -0,0 +1,22 @@
+// Textured PositionTexture, the texture is sampled in Texture.frag
+// Pipeline: VertexPositionTexture
+
+struct Input
+{
+    float3 position : TEXCOORD0;
+    float2 texcoord : TEXCOORD1;
+};
+
+struct Output
+{
+    float4 position : SV_POSITION;
+    float2 texcoord : TEXCOORD0;
+};
+
+Output main(Input input)
+{
+    Output output;
+    output.position = float4(input.position, 1.0);
+    output.texcoord = input.texcoord;
+    return output;
+}
@@ -0,0 +1,15 @@
+// Samples the texture bound on fragment sampler slot 0, e.g. by RenderPassDrawTextured.
+// SDL expects combined image samplers in set 2 for fragment shaders,
+// the DX9 style sampler2D compiles to one with glslc.
+
+[[vk::binding(0, 2)]] sampler2D Texture : register(s0, space2);
+
+struct PSInput
+{
+    float2 texcoord : TEXCOORD0;
+};
+
+float4 main(PSInput input) : SV_Target0
+{
+    return tex2D(Texture, input.texcoord);
+}
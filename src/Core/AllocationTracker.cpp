@@ -0,0 +1,70 @@
+#include "AllocationTracker.hpp"
+
+#if SDLGPU_TRACK_ALLOCATIONS
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+static std::atomic<uint64_t> g_HotPathAllocations{0};
+static thread_local uint32_t t_HotPathDepth = 0;
+
+void AllocationTracker::BeginHotPath()
+{
+	t_HotPathDepth++;
+}
+
+void AllocationTracker::EndHotPath()
+{
+	t_HotPathDepth--;
+}
+
+uint64_t AllocationTracker::GetHotPathAllocations()
+{
+	return g_HotPathAllocations.load(std::memory_order_relaxed);
+}
+
+
+
+static void* TrackedAllocate(size_t size, size_t alignment)
+{
+	if (t_HotPathDepth > 0)
+		g_HotPathAllocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (size == 0)
+		size = 1;
+
+#ifdef _MSC_VER
+	void* memory = _aligned_malloc(size, alignment);
+#else
+	// aligned_alloc wants the size rounded to the alignment
+	void* memory = alignment > alignof(std::max_align_t) ? std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1)) : std::malloc(size);
+#endif
+	if (!memory)
+		throw std::bad_alloc();
+	return memory;
+}
+
+static void TrackedFree(void* memory)
+{
+#ifdef _MSC_VER
+	_aligned_free(memory);
+#else
+	std::free(memory);
+#endif
+}
+
+// The array and nothrow forms forward to these by default
+void* operator new(size_t size) { return TrackedAllocate(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t alignment) { return TrackedAllocate(size, size_t(alignment)); }
+void operator delete(void* memory) noexcept { TrackedFree(memory); }
+void operator delete(void* memory, size_t) noexcept { TrackedFree(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { TrackedFree(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { TrackedFree(memory); }
+
+#endif
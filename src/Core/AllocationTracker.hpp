@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+
+// Debug counter for heap allocations on the frame's hot path.
+// Built with the SDLGPU_TRACK_ALLOCATIONS CMake option, the global operator new is
+// replaced and counts every allocation made while the calling thread is inside a
+// hot path section. Without it all of this compiles to nothing.
+namespace AllocationTracker
+{
+#if SDLGPU_TRACK_ALLOCATIONS
+	void BeginHotPath();
+	void EndHotPath();
+
+	// Allocations counted since startup, over all threads
+	uint64_t GetHotPathAllocations();
+#else
+	inline void BeginHotPath() {}
+	inline void EndHotPath() {}
+	inline uint64_t GetHotPathAllocations() { return 0; }
+#endif
+
+	// Marks the calling thread as on the hot path for the lifetime of the scope
+	struct HotPathScope
+	{
+		HotPathScope() { BeginHotPath(); }
+		~HotPathScope() { EndHotPath(); }
+
+		HotPathScope(const HotPathScope&) = delete;
+		HotPathScope& operator=(const HotPathScope&) = delete;
+	};
+}
@@ -0,0 +1,72 @@
+#include "FrameArena.hpp"
+#include <algorithm>
+
+
+FrameArena::FrameArena(size_t blockSize)
+{
+	m_BlockSize = blockSize;
+}
+
+FrameArena::~FrameArena()
+{
+}
+
+void FrameArena::Rewind(const Marker& marker)
+{
+	m_Block = marker.Block;
+	m_Offset = marker.Offset;
+}
+
+size_t FrameArena::GetUsed() const
+{
+	if (m_Block >= m_Blocks.size())
+		return 0;
+	return m_Blocks[m_Block].UsedBefore + m_Offset;
+}
+
+
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+	// Move through the blocks kept from earlier frames before growing
+	while (m_Block < m_Blocks.size())
+	{
+		Block& block = m_Blocks[m_Block];
+		uintptr_t base = reinterpret_cast<uintptr_t>(block.Data.get());
+		size_t aligned = ((base + m_Offset + alignment - 1) & ~uintptr_t(alignment - 1)) - base;
+
+		if (aligned + bytes <= block.Size)
+		{
+			m_Offset = aligned + bytes;
+			m_HighWater = std::max(m_HighWater, block.UsedBefore + m_Offset);
+			return block.Data.get() + aligned;
+		}
+
+		if (m_Block + 1 == m_Blocks.size())
+			break;
+
+		m_Block++;
+		m_Offset = 0;
+	}
+
+	// Oversized requests get a block of their own size
+	Block block{};
+	block.Size = std::max(m_BlockSize, bytes + alignment);
+	block.Data = std::make_unique_for_overwrite<std::byte[]>(block.Size);
+	block.UsedBefore = m_Capacity;
+
+	m_Capacity += block.Size;
+	m_Blocks.push_back(std::move(block));
+	m_Block = m_Blocks.size() - 1;
+	m_Offset = 0;
+
+	return do_allocate(bytes, alignment);
+}
+
+
+
+FrameArena& GetThreadArena()
+{
+	thread_local FrameArena arena;
+	return arena;
+}
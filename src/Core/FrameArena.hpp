@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+
+// Bump allocator for transient data that dies all at once.
+// Allocations are pointer bumps inside large blocks and deallocation does nothing;
+// Reset rewinds to the first block in O(1) and keeps the blocks for reuse.
+// Usable anywhere a std::pmr::memory_resource is, e.g. std::pmr::vector<T> v(&arena).
+// Not thread safe, every thread uses its own arena.
+class FrameArena : public std::pmr::memory_resource
+{
+	public:
+		static constexpr size_t DEFAULT_BLOCK_SIZE = 1u << 20;
+
+		// Position to rewind to, everything allocated after it is released by Rewind
+		struct Marker
+		{
+			size_t Block{0};
+			size_t Offset{0};
+		};
+
+		// Rewinds the arena when it goes out of scope
+		class Scope
+		{
+			public:
+				Scope(FrameArena& arena) : m_Arena(arena), m_Marker(arena.GetMarker()) {}
+				~Scope() { m_Arena.Rewind(m_Marker); }
+
+				Scope(const Scope&) = delete;
+				Scope& operator=(const Scope&) = delete;
+
+			private:
+				FrameArena& m_Arena;
+				Marker m_Marker;
+		};
+
+		FrameArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+		virtual ~FrameArena();
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		void Reset() { Rewind(Marker{}); }
+
+		Marker GetMarker() const { return { m_Block, m_Offset }; }
+		void Rewind(const Marker& marker);
+
+		// Bytes handed out since the last reset, including alignment padding
+		size_t GetUsed() const;
+		size_t GetCapacity() const { return m_Capacity; }
+		size_t GetHighWater() const { return m_HighWater; }
+		size_t GetBlockCount() const { return m_Blocks.size(); }
+
+	private:
+		struct Block
+		{
+			std::unique_ptr<std::byte[]> Data;
+			size_t Size;
+			size_t UsedBefore;   // bytes in the blocks before this one, for GetUsed
+		};
+
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void*, size_t, size_t) override {}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+		size_t m_BlockSize{DEFAULT_BLOCK_SIZE};
+		std::vector<Block> m_Blocks;
+		size_t m_Block{0};
+		size_t m_Offset{0};
+		size_t m_Capacity{0};
+		size_t m_HighWater{0};
+};
+
+
+// The calling thread's arena for scratch memory, one per thread.
+// Jobs get everything they allocate here released when they finish.
+FrameArena& GetThreadArena();
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+
+// View frustum as six inward-facing planes, xyz is the unit normal and w the distance.
+// Points inside satisfy dot(plane.xyz, p) + plane.w >= 0.
+struct Frustum
+{
+	enum Plane { Left, Right, Bottom, Top, Near, Far, Count };
+
+	glm::vec4 Planes[Count];
+
+	// Extracts the planes from a view-projection matrix (Gribb/Hartmann).
+	// Expects SDL GPU clip space, depth in [0, 1].
+	static Frustum FromViewProjection(const glm::mat4& viewProjection)
+	{
+		// glm is column major, row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+		glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+		glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+		glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+		glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+		Frustum frustum;
+		frustum.Planes[Left] = row3 + row0;
+		frustum.Planes[Right] = row3 - row0;
+		frustum.Planes[Bottom] = row3 + row1;
+		frustum.Planes[Top] = row3 - row1;
+		frustum.Planes[Near] = row2;
+		frustum.Planes[Far] = row3 - row2;
+
+		for (glm::vec4& plane : frustum.Planes)
+			plane /= glm::length(glm::vec3(plane));
+
+		return frustum;
+	}
+
+	bool IntersectsSphere(const glm::vec3& center, float radius) const
+	{
+		for (const glm::vec4& plane : Planes)
+		{
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+				return false;
+		}
+		return true;
+	}
+};
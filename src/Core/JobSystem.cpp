@@ -0,0 +1,213 @@
+#include "JobSystem.hpp"
+#include "FrameArena.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+
+
+JobSystem::JobSystem(uint32_t workerCount)
+{
+	if (workerCount == 0)
+		workerCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+	m_Workers.reserve(workerCount);
+	for (uint32_t i = 0; i < workerCount; i++)
+		m_Workers.emplace_back(&JobSystem::WorkerLoop, this);
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard lock(m_QueueMutex);
+		m_Stopping = true;
+	}
+	m_QueueCondition.notify_all();
+
+	for (std::thread& worker : m_Workers)
+		worker.join();
+}
+
+
+
+JobHandle JobSystem::Schedule(std::function<void()> work, std::span<const JobHandle> dependencies)
+{
+	auto job = std::make_shared<Job>();
+	job->Work = std::move(work);
+
+	// Held until every dependency is registered so the job cannot start early
+	job->PendingDependencies.store(1, std::memory_order_relaxed);
+
+	for (const JobHandle& dependency : dependencies)
+	{
+		if (!dependency)
+			continue;
+
+		std::lock_guard lock(dependency->Mutex);
+		if (dependency->Done.load(std::memory_order_acquire))
+		{
+			if (dependency->Error)
+			{
+				std::lock_guard jobLock(job->Mutex);
+				if (!job->Error)
+					job->Error = dependency->Error;
+			}
+			continue;
+		}
+
+		job->PendingDependencies.fetch_add(1, std::memory_order_relaxed);
+		dependency->Continuations.push_back(job);
+	}
+
+	if (job->PendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		Enqueue(job);
+
+	return job;
+}
+
+void JobSystem::Wait(const JobHandle& job)
+{
+	if (!job)
+		return;
+
+	while (!job->Done.load(std::memory_order_acquire))
+	{
+		JobHandle next;
+		{
+			std::unique_lock lock(m_QueueMutex);
+			if (m_Queue.empty())
+			{
+				// Nothing to help with, sleep until some job finishes
+				m_DoneCondition.wait(lock, [&]{ return job->Done.load(std::memory_order_acquire) || !m_Queue.empty(); });
+				continue;
+			}
+
+			next = std::move(m_Queue.front());
+			m_Queue.pop_front();
+		}
+
+		Execute(next);
+	}
+
+	if (job->Error)
+		std::rethrow_exception(job->Error);
+}
+
+
+
+void JobSystem::ParallelFor(uint32_t count, const std::function<void(uint32_t index)>& work)
+{
+	if (count == 0)
+		return;
+
+	std::vector<JobHandle> jobs;
+	jobs.reserve(count - 1);
+	for (uint32_t i = 1; i < count; i++)
+		jobs.push_back(Schedule([&work, i]{ work(i); }));
+
+	// The jobs reference `work`, so every one of them has to finish before returning
+	std::exception_ptr error;
+	try
+	{
+		work(0);
+	}
+	catch (...)
+	{
+		error = std::current_exception();
+	}
+
+	for (const JobHandle& job : jobs)
+	{
+		try
+		{
+			Wait(job);
+		}
+		catch (...)
+		{
+			if (!error)
+				error = std::current_exception();
+		}
+	}
+
+	if (error)
+		std::rethrow_exception(error);
+}
+
+
+
+void JobSystem::Enqueue(JobHandle job)
+{
+	{
+		std::lock_guard lock(m_QueueMutex);
+		m_Queue.push_back(std::move(job));
+	}
+	m_QueueCondition.notify_one();
+	m_DoneCondition.notify_all();
+}
+
+void JobSystem::Execute(const JobHandle& job)
+{
+	// A failed dependency skips the work and hands its error on
+	if (!job->Error)
+	{
+		// Scratch memory the job took from the thread arena is released when it finishes
+		FrameArena::Scope scratch(GetThreadArena());
+		SDLGPU_PROFILE_ZONE("Job");
+
+		try
+		{
+			job->Work();
+		}
+		catch (...)
+		{
+			job->Error = std::current_exception();
+		}
+	}
+	job->Work = nullptr;
+
+	std::vector<JobHandle> continuations;
+	{
+		std::lock_guard lock(job->Mutex);
+		job->Done.store(true, std::memory_order_release);
+		continuations.swap(job->Continuations);
+	}
+
+	for (JobHandle& continuation : continuations)
+	{
+		// Failures propagate so waiting on a dependent job reports the original error
+		if (job->Error)
+		{
+			std::lock_guard lock(continuation->Mutex);
+			if (!continuation->Error)
+				continuation->Error = job->Error;
+		}
+
+		if (continuation->PendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			Enqueue(std::move(continuation));
+	}
+
+	{
+		// Taking the lock orders the notify after a waiter's predicate check
+		std::lock_guard lock(m_QueueMutex);
+	}
+	m_DoneCondition.notify_all();
+}
+
+void JobSystem::WorkerLoop()
+{
+	Profiler::SetThreadName("Worker");
+
+	while (true)
+	{
+		JobHandle job;
+		{
+			std::unique_lock lock(m_QueueMutex);
+			m_QueueCondition.wait(lock, [&]{ return m_Stopping || !m_Queue.empty(); });
+			if (m_Stopping && m_Queue.empty())
+				return;
+
+			job = std::move(m_Queue.front());
+			m_Queue.pop_front();
+		}
+
+		Execute(job);
+	}
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+// A unit of work. Jobs start once all of their dependencies have finished.
+struct Job
+{
+	std::function<void()> Work;
+
+	std::atomic<uint32_t> PendingDependencies{0};
+	std::atomic<bool> Done{false};
+	std::exception_ptr Error;
+
+	// Jobs waiting on this one, guarded by Mutex
+	std::mutex Mutex;
+	std::vector<std::shared_ptr<Job>> Continuations;
+};
+
+using JobHandle = std::shared_ptr<Job>;
+
+// A job together with the value it produces
+template<typename T>
+struct AsyncResult
+{
+	JobHandle Job;
+	std::shared_ptr<T> Value;
+
+	bool IsReady() const { return Job && Job->Done.load(std::memory_order_acquire); }
+};
+
+
+// Fixed pool of worker threads, sized to the core count by default.
+// Threads waiting on a job help run queued work instead of blocking.
+// Jobs can use GetThreadArena() for scratch memory, it is rewound after every job.
+class JobSystem
+{
+	public:
+		// 0 picks one worker per hardware thread, minus the calling thread
+		JobSystem(uint32_t workerCount = 0);
+		virtual ~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		JobHandle Schedule(std::function<void()> work, std::span<const JobHandle> dependencies = {});
+
+		// Schedules a function returning a value, the value is valid once the job is done
+		template<typename TFunction>
+		auto ScheduleResult(TFunction&& function, std::span<const JobHandle> dependencies = {})
+		{
+			using T = std::invoke_result_t<TFunction&>;
+
+			AsyncResult<T> result{};
+			result.Value = std::make_shared<T>();
+			result.Job = Schedule([function = std::forward<TFunction>(function), value = result.Value]() mutable
+			{
+				*value = function();
+			}, dependencies);
+			return result;
+		}
+
+		// Blocks until the job has run, rethrowing anything it threw
+		void Wait(const JobHandle& job);
+
+		template<typename T>
+		T& Wait(const AsyncResult<T>& result)
+		{
+			Wait(result.Job);
+			return *result.Value;
+		}
+
+		// Runs work(0) .. work(count - 1) on the workers and the calling thread and blocks
+		// until all of them are done. The first exception is rethrown after the rest finish.
+		void ParallelFor(uint32_t count, const std::function<void(uint32_t index)>& work);
+
+		uint32_t GetWorkerCount() const { return uint32_t(m_Workers.size()); }
+
+	private:
+		std::vector<std::thread> m_Workers;
+
+		std::mutex m_QueueMutex;
+		std::condition_variable m_QueueCondition;
+		std::condition_variable m_DoneCondition;
+		std::deque<JobHandle> m_Queue;
+		bool m_Stopping{false};
+
+		void Enqueue(JobHandle job);
+		void Execute(const JobHandle& job);
+		void WorkerLoop();
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+// Read-only memory mapping of a whole file.
+// The mapping stays valid until Close() or destruction, so pointers into it
+// can be handed straight to APIs that copy the data (shader and texture creation).
+class MappedFile
+{
+	public:
+		MappedFile() = default;
+		MappedFile(const std::string& path);
+		virtual ~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		// Returns false if the file does not exist or cannot be mapped
+		bool Open(const std::string& path);
+		void Close();
+
+		bool IsOpen() const { return m_Data != nullptr; }
+		const uint8_t* GetData() const { return m_Data; }
+		size_t GetSize() const { return m_Size; }
+
+	private:
+		const uint8_t* m_Data{nullptr};
+		size_t m_Size{0};
+
+#ifdef _WIN32
+		void* m_File{nullptr};
+		void* m_Mapping{nullptr};
+#endif
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+
+// Nearest rank percentile of `count` nanosecond samples sorted ascending, in milliseconds.
+// `p` is in [0, 1] and `count` must not be zero.
+inline double NearestRankPercentileMS(const uint64_t* sorted, uint32_t count, double p)
+{
+	uint32_t rank = uint32_t(std::ceil(p * count));
+	return sorted[std::clamp(rank, 1u, count) - 1] / 1e6;
+}
@@ -0,0 +1,288 @@
+#include "Profiler.hpp"
+#include "Percentile.hpp"
+
+#if SDLGPU_ENABLE_PROFILER
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+namespace
+{
+	enum class EventType : uint8_t
+	{
+		Zone,
+		Counter
+	};
+
+	// Fields are relaxed atomics so the exporter can read a slot while its thread
+	// overwrites it, torn events are detected through the head and dropped
+	struct RingEvent
+	{
+		std::atomic<const char*> Name{nullptr};
+		std::atomic<uint64_t> Start{0};
+		std::atomic<uint64_t> Value{0};   // end time for zones, the value for counters
+		std::atomic<EventType> Type{EventType::Zone};
+	};
+
+	struct Event
+	{
+		const char* Name;
+		uint64_t Start;
+		uint64_t Value;
+		EventType Type;
+	};
+
+	struct ThreadBuffer
+	{
+		uint32_t ThreadId{0};
+		std::atomic<const char*> Name{nullptr};
+		std::atomic<uint64_t> Head{0};   // events written so far, only the owner writes it
+		std::array<RingEvent, Profiler::RING_SIZE> Events;
+
+		void Push(const char* name, uint64_t start, uint64_t value, EventType type)
+		{
+			uint64_t head = Head.load(std::memory_order_relaxed);
+			RingEvent& event = Events[head & (Profiler::RING_SIZE - 1)];
+			event.Name.store(name, std::memory_order_relaxed);
+			event.Start.store(start, std::memory_order_relaxed);
+			event.Value.store(value, std::memory_order_relaxed);
+			event.Type.store(type, std::memory_order_relaxed);
+			Head.store(head + 1, std::memory_order_release);
+		}
+
+		// Copies whatever is still in the ring, oldest first
+		void Read(std::vector<Event>& events) const
+		{
+			uint64_t head = Head.load(std::memory_order_acquire);
+			uint64_t first = head > Profiler::RING_SIZE ? head - Profiler::RING_SIZE : 0;
+
+			size_t start = events.size();
+			for (uint64_t i = first; i < head; i++)
+			{
+				const RingEvent& event = Events[i & (Profiler::RING_SIZE - 1)];
+				events.push_back(Event{
+					event.Name.load(std::memory_order_relaxed),
+					event.Start.load(std::memory_order_relaxed),
+					event.Value.load(std::memory_order_relaxed),
+					event.Type.load(std::memory_order_relaxed) });
+			}
+
+			// Slots the owner wrapped around to while copying may be torn
+			std::atomic_thread_fence(std::memory_order_acquire);
+			uint64_t newHead = Head.load(std::memory_order_relaxed);
+			uint64_t valid = newHead > Profiler::RING_SIZE ? newHead - Profiler::RING_SIZE : 0;
+			if (valid > first)
+				events.erase(events.begin() + start, events.begin() + start + size_t(std::min(valid, head) - first));
+		}
+	};
+
+	constexpr uint32_t GPU_THREAD_ID = 0;
+
+	std::mutex g_BuffersMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> g_Buffers;
+	ThreadBuffer* g_GpuBuffer = nullptr;
+	uint64_t g_LastFrameNS = 0;
+
+	ThreadBuffer* RegisterBuffer(const char* name)
+	{
+		std::lock_guard lock(g_BuffersMutex);
+
+		// Id 0 is the GPU track, threads start at 1
+		if (g_Buffers.empty())
+		{
+			g_Buffers.push_back(std::make_unique<ThreadBuffer>());
+			g_Buffers.back()->ThreadId = GPU_THREAD_ID;
+			g_Buffers.back()->Name.store("GPU", std::memory_order_relaxed);
+			g_GpuBuffer = g_Buffers.back().get();
+		}
+
+		if (!name)
+			return g_GpuBuffer;
+
+		g_Buffers.push_back(std::make_unique<ThreadBuffer>());
+		g_Buffers.back()->ThreadId = uint32_t(g_Buffers.size() - 1);
+		g_Buffers.back()->Name.store(name, std::memory_order_relaxed);
+		return g_Buffers.back().get();
+	}
+
+	// Registered on first use and kept after the thread exits so its events can still be exported
+	ThreadBuffer& GetThreadBuffer()
+	{
+		thread_local ThreadBuffer* buffer = RegisterBuffer("Thread");
+		return *buffer;
+	}
+
+	ThreadBuffer& GetGpuBuffer()
+	{
+		static ThreadBuffer* buffer = RegisterBuffer(nullptr);
+		return *buffer;
+	}
+
+	std::vector<std::pair<uint32_t, std::vector<Event>>> ReadAll()
+	{
+		std::lock_guard lock(g_BuffersMutex);
+
+		std::vector<std::pair<uint32_t, std::vector<Event>>> threads;
+		threads.reserve(g_Buffers.size());
+		for (const auto& buffer : g_Buffers)
+		{
+			threads.emplace_back(buffer->ThreadId, std::vector<Event>{});
+			buffer->Read(threads.back().second);
+		}
+		return threads;
+	}
+
+	void WriteJsonString(FILE* file, const char* text)
+	{
+		fputc('"', file);
+		for (const char* c = text ? text : ""; *c; c++)
+		{
+			if (*c == '"' || *c == '\\')
+				fputc('\\', file);
+			if (uint8_t(*c) >= 0x20)
+				fputc(*c, file);
+		}
+		fputc('"', file);
+	}
+}
+
+
+
+void Profiler::RecordZone(const char* name, uint64_t startNS, uint64_t endNS)
+{
+	GetThreadBuffer().Push(name, startNS, endNS, EventType::Zone);
+}
+
+void Profiler::RecordCounter(const char* name, int64_t value)
+{
+	GetThreadBuffer().Push(name, Now(), uint64_t(value), EventType::Counter);
+}
+
+void Profiler::RecordGpuZone(const char* name, uint64_t startNS, uint64_t endNS)
+{
+	// Only the thread that submits frames records GPU zones
+	GetGpuBuffer().Push(name, startNS, endNS, EventType::Zone);
+}
+
+void Profiler::MarkFrame()
+{
+	uint64_t now = Now();
+	if (g_LastFrameNS)
+		RecordZone("Frame", g_LastFrameNS, now);
+	g_LastFrameNS = now;
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+	GetThreadBuffer().Name.store(name, std::memory_order_relaxed);
+}
+
+
+
+std::vector<ProfileZoneSummary> Profiler::GetSummary()
+{
+	// Zones with the same name from any thread are summarized together
+	std::map<std::string_view, std::vector<uint64_t>> durations;
+	for (const auto& [threadId, events] : ReadAll())
+	{
+		for (const Event& event : events)
+		{
+			if (event.Type == EventType::Zone && event.Name)
+				durations[event.Name].push_back(event.Value > event.Start ? event.Value - event.Start : 0);
+		}
+	}
+
+	std::vector<ProfileZoneSummary> summaries;
+	summaries.reserve(durations.size());
+	for (auto& [name, samples] : durations)
+	{
+		if (samples.empty())
+			continue;
+
+		std::sort(samples.begin(), samples.end());
+		uint32_t count = uint32_t(samples.size());
+
+		uint64_t total = 0;
+		for (uint64_t sample : samples)
+			total += sample;
+
+		ProfileZoneSummary& summary = summaries.emplace_back();
+		summary.Name = std::string(name);
+		summary.Count = count;
+		summary.AverageMS = total / 1e6 / count;
+		summary.P50MS = NearestRankPercentileMS(samples.data(), count, 0.50);
+		summary.P95MS = NearestRankPercentileMS(samples.data(), count, 0.95);
+		summary.P99MS = NearestRankPercentileMS(samples.data(), count, 0.99);
+		summary.MaxMS = samples.back() / 1e6;
+	}
+
+	std::sort(summaries.begin(), summaries.end(), [](const ProfileZoneSummary& a, const ProfileZoneSummary& b) { return a.AverageMS * a.Count > b.AverageMS * b.Count; });
+	return summaries;
+}
+
+void Profiler::PrintSummary()
+{
+	printf("%-28s %8s %9s %9s %9s %9s %9s\n", "zone", "count", "avg ms", "p50 ms", "p95 ms", "p99 ms", "max ms");
+	for (const ProfileZoneSummary& summary : GetSummary())
+		printf("%-28s %8u %9.3f %9.3f %9.3f %9.3f %9.3f\n", summary.Name.c_str(), summary.Count, summary.AverageMS, summary.P50MS, summary.P95MS, summary.P99MS, summary.MaxMS);
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path)
+{
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file)
+		return false;
+
+	auto threads = ReadAll();
+
+	// Timestamps relative to the oldest event, in microseconds
+	uint64_t origin = UINT64_MAX;
+	for (const auto& [threadId, events] : threads)
+	{
+		for (const Event& event : events)
+			origin = std::min(origin, event.Start);
+	}
+
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+	bool first = true;
+
+	{
+		std::lock_guard lock(g_BuffersMutex);
+		for (const auto& buffer : g_Buffers)
+		{
+			fprintf(file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", buffer->ThreadId);
+			WriteJsonString(file, buffer->Name.load(std::memory_order_relaxed));
+			fputs("}}", file);
+			first = false;
+		}
+	}
+
+	for (const auto& [threadId, events] : threads)
+	{
+		for (const Event& event : events)
+		{
+			double timestamp = (event.Start - origin) / 1e3;
+
+			fputs(first ? "{\"name\":" : ",\n{\"name\":", file);
+			WriteJsonString(file, event.Name);
+			if (event.Type == EventType::Zone)
+				fprintf(file, ",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", threadId, timestamp, event.Value > event.Start ? (event.Value - event.Start) / 1e3 : 0.0);
+			else
+				fprintf(file, ",\"ph\":\"C\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%lld}}", threadId, timestamp, (long long)int64_t(event.Value));
+			first = false;
+		}
+	}
+
+	fputs("\n]}\n", file);
+	bool written = !ferror(file);
+	fclose(file);
+	return written;
+}
+
+#endif
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// Per-zone timings over everything still in the ring buffers
+struct ProfileZoneSummary
+{
+	std::string Name;
+	uint32_t Count{0};
+	double AverageMS{0.0};
+	double P50MS{0.0};
+	double P95MS{0.0};
+	double P99MS{0.0};
+	double MaxMS{0.0};
+};
+
+
+// Frame profiler. Zones and counters go into a fixed ring buffer per thread,
+// written only by the owning thread without locks, so older events are dropped
+// once a ring is full. GPU frames are timed from submit to the fence being seen
+// as signaled. Built with the SDLGPU_ENABLE_PROFILER CMake option, otherwise the
+// zone macros compile to nothing and recording does nothing.
+namespace Profiler
+{
+	// Events kept per thread
+	constexpr uint32_t RING_SIZE = 1u << 14;
+
+	inline uint64_t Now()
+	{
+		return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+#if SDLGPU_ENABLE_PROFILER
+	// `name` must outlive the profiler, zone names are string literals
+	void RecordZone(const char* name, uint64_t startNS, uint64_t endNS);
+	void RecordCounter(const char* name, int64_t value);
+
+	// GPU work goes onto its own track, timed by the CPU observing fences
+	void RecordGpuZone(const char* name, uint64_t startNS, uint64_t endNS);
+
+	// Call once per frame, records a "Frame" zone since the previous call
+	void MarkFrame();
+
+	void SetThreadName(const char* name);
+
+	std::vector<ProfileZoneSummary> GetSummary();
+	void PrintSummary();
+
+	// Chrome trace_event JSON, open in chrome://tracing or ui.perfetto.dev
+	bool WriteChromeTrace(const std::string& path);
+#else
+	inline void RecordZone(const char*, uint64_t, uint64_t) {}
+	inline void RecordCounter(const char*, int64_t) {}
+	inline void RecordGpuZone(const char*, uint64_t, uint64_t) {}
+	inline void MarkFrame() {}
+	inline void SetThreadName(const char*) {}
+	inline std::vector<ProfileZoneSummary> GetSummary() { return {}; }
+	inline void PrintSummary() {}
+	inline bool WriteChromeTrace(const std::string&) { return false; }
+#endif
+}
+
+
+// Records the time from construction to destruction as a zone
+class ProfileZone
+{
+	public:
+		ProfileZone(const char* name) : m_Name(name), m_Start(Profiler::Now()) {}
+		~ProfileZone() { Profiler::RecordZone(m_Name, m_Start, Profiler::Now()); }
+
+		ProfileZone(const ProfileZone&) = delete;
+		ProfileZone& operator=(const ProfileZone&) = delete;
+
+	private:
+		const char* m_Name;
+		uint64_t m_Start;
+};
+
+
+#if SDLGPU_ENABLE_PROFILER
+	#define SDLGPU_PROFILE_CONCAT_INNER(a, b) a##b
+	#define SDLGPU_PROFILE_CONCAT(a, b) SDLGPU_PROFILE_CONCAT_INNER(a, b)
+
+	#define SDLGPU_PROFILE_ZONE(name) ProfileZone SDLGPU_PROFILE_CONCAT(profileZone, __LINE__)(name)
+	#define SDLGPU_PROFILE_FUNCTION() SDLGPU_PROFILE_ZONE(__func__)
+	#define SDLGPU_PROFILE_COUNTER(name, value) Profiler::RecordCounter(name, int64_t(value))
+#else
+	#define SDLGPU_PROFILE_ZONE(name) do {} while (0)
+	#define SDLGPU_PROFILE_FUNCTION() do {} while (0)
+	#define SDLGPU_PROFILE_COUNTER(name, value) do {} while (0)
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+
+// Instruction set selection for the SIMD kernels.
+// Exactly one of SDLGPU_SIMD_AVX2, SDLGPU_SIMD_SSE2, SDLGPU_SIMD_NEON or
+// SDLGPU_SIMD_SCALAR is defined, chosen from the compiler's target flags.
+// AVX2 builds are opt-in through the SDLGPU_ENABLE_AVX2 CMake option.
+
+#if defined(__AVX2__) && (defined(__F16C__) || defined(_MSC_VER))
+	#define SDLGPU_SIMD_AVX2 1
+	#define SDLGPU_SIMD_SSE2 0
+	#define SDLGPU_SIMD_NEON 0
+	#define SDLGPU_SIMD_SCALAR 0
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define SDLGPU_SIMD_AVX2 0
+	#define SDLGPU_SIMD_SSE2 1
+	#define SDLGPU_SIMD_NEON 0
+	#define SDLGPU_SIMD_SCALAR 0
+	#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#define SDLGPU_SIMD_AVX2 0
+	#define SDLGPU_SIMD_SSE2 0
+	#define SDLGPU_SIMD_NEON 1
+	#define SDLGPU_SIMD_SCALAR 0
+	#include <arm_neon.h>
+#else
+	#define SDLGPU_SIMD_AVX2 0
+	#define SDLGPU_SIMD_SSE2 0
+	#define SDLGPU_SIMD_NEON 0
+	#define SDLGPU_SIMD_SCALAR 1
+#endif
+
+// SSE2 code paths are also used by AVX2 builds
+#define SDLGPU_SIMD_X86 (SDLGPU_SIMD_AVX2 || SDLGPU_SIMD_SSE2)
+
+constexpr const char* SimdBackendName()
+{
+#if SDLGPU_SIMD_AVX2
+	return "AVX2";
+#elif SDLGPU_SIMD_SSE2
+	return "SSE2";
+#elif SDLGPU_SIMD_NEON
+	return "NEON";
+#else
+	return "Scalar";
+#endif
+}
@@ -0,0 +1,263 @@
+#include "TlsfAllocator.hpp"
+#include <algorithm>
+#include <bit>
+
+
+TlsfAllocator::TlsfAllocator(uint32_t capacity)
+{
+	Reset(capacity);
+}
+
+void TlsfAllocator::Reset(uint32_t capacity)
+{
+	m_Capacity = capacity;
+	m_Used = 0;
+	m_AllocationCount = 0;
+	m_FreeRangeCount = 0;
+
+	m_FlBitmap = 0;
+	for (uint32_t fl = 0; fl < FL_COUNT; fl++)
+	{
+		m_SlBitmaps[fl] = 0;
+		for (uint32_t sl = 0; sl < SL_COUNT; sl++)
+			m_Bins[fl][sl] = INVALID_NODE;
+	}
+
+	m_Nodes.clear();
+	m_UnusedNodes = INVALID_NODE;
+
+	if (capacity == 0)
+		return;
+
+	uint32_t node = CreateNode();
+	m_Nodes[node].Offset = 0;
+	m_Nodes[node].Size = capacity;
+	InsertFree(node);
+}
+
+
+
+TlsfAllocator::Allocation TlsfAllocator::Allocate(uint32_t size)
+{
+	if (size == 0 || size > m_Capacity - m_Used)
+		return {};
+
+	uint32_t node = FindFree(size);
+	if (node == INVALID_NODE)
+		return {};
+
+	RemoveFree(node);
+
+	// Hand the tail back as a new free range
+	uint32_t remainder = m_Nodes[node].Size - size;
+	if (remainder > 0)
+	{
+		uint32_t tail = CreateNode();
+		Node& allocated = m_Nodes[node];
+
+		m_Nodes[tail].Offset = allocated.Offset + size;
+		m_Nodes[tail].Size = remainder;
+		m_Nodes[tail].PrevPhysical = node;
+		m_Nodes[tail].NextPhysical = allocated.NextPhysical;
+
+		if (allocated.NextPhysical != INVALID_NODE)
+			m_Nodes[allocated.NextPhysical].PrevPhysical = tail;
+		allocated.NextPhysical = tail;
+		allocated.Size = size;
+
+		InsertFree(tail);
+	}
+
+	m_Used += size;
+	m_AllocationCount++;
+
+	return { m_Nodes[node].Offset, size, node };
+}
+
+void TlsfAllocator::Free(uint32_t node)
+{
+	// Destroyed nodes have no size
+	if (node >= m_Nodes.size() || m_Nodes[node].Free || m_Nodes[node].Size == 0)
+		return;
+
+	m_Used -= m_Nodes[node].Size;
+	m_AllocationCount--;
+
+	// Merge with free neighbours so adjacent ranges never both sit in the bins
+	uint32_t prev = m_Nodes[node].PrevPhysical;
+	if (prev != INVALID_NODE && m_Nodes[prev].Free)
+	{
+		RemoveFree(prev);
+		m_Nodes[prev].Size += m_Nodes[node].Size;
+		m_Nodes[prev].NextPhysical = m_Nodes[node].NextPhysical;
+		if (m_Nodes[node].NextPhysical != INVALID_NODE)
+			m_Nodes[m_Nodes[node].NextPhysical].PrevPhysical = prev;
+
+		DestroyNode(node);
+		node = prev;
+	}
+
+	uint32_t next = m_Nodes[node].NextPhysical;
+	if (next != INVALID_NODE && m_Nodes[next].Free)
+	{
+		RemoveFree(next);
+		m_Nodes[node].Size += m_Nodes[next].Size;
+		m_Nodes[node].NextPhysical = m_Nodes[next].NextPhysical;
+		if (m_Nodes[next].NextPhysical != INVALID_NODE)
+			m_Nodes[m_Nodes[next].NextPhysical].PrevPhysical = node;
+
+		DestroyNode(next);
+	}
+
+	InsertFree(node);
+}
+
+uint32_t TlsfAllocator::GetLargestFree() const
+{
+	if (m_FlBitmap == 0)
+		return 0;
+
+	// The highest non-empty bin holds the largest range, but its sizes vary within the bin
+	uint32_t fl = 31 - std::countl_zero(m_FlBitmap);
+	uint32_t sl = 31 - std::countl_zero(m_SlBitmaps[fl]);
+
+	uint32_t largest = 0;
+	for (uint32_t node = m_Bins[fl][sl]; node != INVALID_NODE; node = m_Nodes[node].NextFree)
+		largest = std::max(largest, m_Nodes[node].Size);
+	return largest;
+}
+
+
+
+void TlsfAllocator::MapInsert(uint32_t size, uint32_t& fl, uint32_t& sl)
+{
+	if (size < SL_COUNT)
+	{
+		// Small sizes get one bin each in the first row
+		fl = 0;
+		sl = size;
+		return;
+	}
+
+	uint32_t log2 = 31 - std::countl_zero(size);
+	sl = (size >> (log2 - SL_BITS)) ^ SL_COUNT;
+	fl = log2 - SL_BITS + 1;
+}
+
+void TlsfAllocator::MapSearch(uint32_t size, uint32_t& fl, uint32_t& sl)
+{
+	// Round up to the next bin boundary so every range in the found bin fits
+	uint64_t rounded = size;
+	if (size >= SL_COUNT)
+	{
+		uint32_t log2 = 31 - std::countl_zero(size);
+		rounded += (uint64_t(1) << (log2 - SL_BITS)) - 1;
+	}
+
+	if (rounded > UINT32_MAX)
+	{
+		fl = FL_COUNT;
+		sl = 0;
+		return;
+	}
+
+	MapInsert(uint32_t(rounded), fl, sl);
+}
+
+uint32_t TlsfAllocator::FindFree(uint32_t size) const
+{
+	uint32_t fl, sl;
+	MapSearch(size, fl, sl);
+
+	// First a large enough bin in the same row, then the smallest non-empty row above it
+	uint32_t slMap = fl < FL_COUNT ? m_SlBitmaps[fl] & (~0u << sl) : 0;
+	if (slMap == 0)
+	{
+		uint32_t flMap = fl + 1 < FL_COUNT ? m_FlBitmap & (~0u << (fl + 1)) : 0;
+		if (flMap != 0)
+		{
+			fl = std::countr_zero(flMap);
+			slMap = m_SlBitmaps[fl];
+		}
+	}
+
+	if (slMap != 0)
+		return m_Bins[fl][std::countr_zero(slMap)];
+
+	// Nothing is guaranteed to fit, some range in the size's own bin still might.
+	// Only reached when the allocator is nearly full.
+	MapInsert(size, fl, sl);
+	for (uint32_t node = m_Bins[fl][sl]; node != INVALID_NODE; node = m_Nodes[node].NextFree)
+	{
+		if (m_Nodes[node].Size >= size)
+			return node;
+	}
+	return INVALID_NODE;
+}
+
+void TlsfAllocator::InsertFree(uint32_t node)
+{
+	uint32_t fl, sl;
+	MapInsert(m_Nodes[node].Size, fl, sl);
+
+	Node& inserted = m_Nodes[node];
+	inserted.Free = true;
+	inserted.PrevFree = INVALID_NODE;
+	inserted.NextFree = m_Bins[fl][sl];
+	if (inserted.NextFree != INVALID_NODE)
+		m_Nodes[inserted.NextFree].PrevFree = node;
+
+	m_Bins[fl][sl] = node;
+	m_SlBitmaps[fl] |= 1u << sl;
+	m_FlBitmap |= 1u << fl;
+	m_FreeRangeCount++;
+}
+
+void TlsfAllocator::RemoveFree(uint32_t node)
+{
+	uint32_t fl, sl;
+	MapInsert(m_Nodes[node].Size, fl, sl);
+
+	Node& removed = m_Nodes[node];
+	if (removed.PrevFree != INVALID_NODE)
+		m_Nodes[removed.PrevFree].NextFree = removed.NextFree;
+	else
+		m_Bins[fl][sl] = removed.NextFree;
+
+	if (removed.NextFree != INVALID_NODE)
+		m_Nodes[removed.NextFree].PrevFree = removed.PrevFree;
+
+	if (m_Bins[fl][sl] == INVALID_NODE)
+	{
+		m_SlBitmaps[fl] &= ~(1u << sl);
+		if (m_SlBitmaps[fl] == 0)
+			m_FlBitmap &= ~(1u << fl);
+	}
+
+	removed.Free = false;
+	removed.PrevFree = INVALID_NODE;
+	removed.NextFree = INVALID_NODE;
+	m_FreeRangeCount--;
+}
+
+uint32_t TlsfAllocator::CreateNode()
+{
+	// Reuse destroyed nodes so node indices stay small and stable
+	if (m_UnusedNodes != INVALID_NODE)
+	{
+		uint32_t node = m_UnusedNodes;
+		m_UnusedNodes = m_Nodes[node].NextFree;
+		m_Nodes[node] = Node{};
+		return node;
+	}
+
+	m_Nodes.emplace_back();
+	return uint32_t(m_Nodes.size() - 1);
+}
+
+void TlsfAllocator::DestroyNode(uint32_t node)
+{
+	m_Nodes[node] = Node{};
+	m_Nodes[node].NextFree = m_UnusedNodes;
+	m_UnusedNodes = node;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+
+// Two-level segregated fit allocator over an abstract range [0, capacity).
+// Only tracks offsets, the memory itself lives elsewhere (usually a GPU buffer).
+// Allocate and Free are O(1): free ranges are binned by size class, the first
+// level is the power of two and the second splits it into SL_COUNT linear steps,
+// and a bitmap per level finds the smallest non-empty bin with one bit scan.
+class TlsfAllocator
+{
+	public:
+		static constexpr uint32_t INVALID_NODE = UINT32_MAX;
+
+		static constexpr uint32_t SL_BITS = 4;
+		static constexpr uint32_t SL_COUNT = 1u << SL_BITS;
+		static constexpr uint32_t FL_COUNT = 32 - SL_BITS + 1;
+
+		struct Allocation
+		{
+			uint32_t Offset{0};
+			uint32_t Size{0};
+			uint32_t Node{INVALID_NODE};   // pass to Free
+
+			bool IsValid() const { return Node != INVALID_NODE; }
+		};
+
+		TlsfAllocator(uint32_t capacity = 0);
+
+		// Drops every allocation
+		void Reset(uint32_t capacity);
+
+		// Returns an invalid allocation if no free range is large enough
+		Allocation Allocate(uint32_t size);
+		void Free(uint32_t node);
+
+		uint32_t GetCapacity() const { return m_Capacity; }
+		uint32_t GetUsed() const { return m_Used; }
+		uint32_t GetFree() const { return m_Capacity - m_Used; }
+		uint32_t GetAllocationCount() const { return m_AllocationCount; }
+		uint32_t GetFreeRangeCount() const { return m_FreeRangeCount; }
+
+		// Size of the largest free range, scans one bin
+		uint32_t GetLargestFree() const;
+
+	private:
+		struct Node
+		{
+			uint32_t Offset{0};
+			uint32_t Size{0};
+
+			// Neighbours in address order
+			uint32_t PrevPhysical{INVALID_NODE};
+			uint32_t NextPhysical{INVALID_NODE};
+
+			// Neighbours in the node's free bin, or the node free list if unused
+			uint32_t PrevFree{INVALID_NODE};
+			uint32_t NextFree{INVALID_NODE};
+
+			bool Free{false};
+		};
+
+		static void MapInsert(uint32_t size, uint32_t& fl, uint32_t& sl);
+		static void MapSearch(uint32_t size, uint32_t& fl, uint32_t& sl);
+
+		uint32_t CreateNode();
+		void DestroyNode(uint32_t node);
+
+		void InsertFree(uint32_t node);
+		void RemoveFree(uint32_t node);
+		uint32_t FindFree(uint32_t size) const;
+
+		uint32_t m_Capacity{0};
+		uint32_t m_Used{0};
+		uint32_t m_AllocationCount{0};
+		uint32_t m_FreeRangeCount{0};
+
+		uint32_t m_FlBitmap{0};
+		uint32_t m_SlBitmaps[FL_COUNT]{};
+		uint32_t m_Bins[FL_COUNT][SL_COUNT]{};
+
+		std::vector<Node> m_Nodes;
+		uint32_t m_UnusedNodes{INVALID_NODE};
+};
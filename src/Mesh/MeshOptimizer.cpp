@@ -0,0 +1,447 @@
+#include "MeshOptimizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+namespace
+{
+	constexpr uint32_t INVALID_INDEX = ~0u;
+
+	uint32_t HashBytes(const uint8_t* data, size_t size)
+	{
+		// FNV-1a, vertices are small so this is plenty
+		uint32_t hash = 2166136261u;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= data[i];
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	// Forsyth scoring constants, see "Linear-Speed Vertex Cache Optimisation"
+	constexpr int32_t SCORE_CACHE_SIZE = 32;
+	constexpr float CACHE_DECAY_POWER = 1.5f;
+	constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+	constexpr float VALENCE_BOOST_SCALE = 2.0f;
+	constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+	float VertexScore(int32_t cachePosition, uint32_t remainingTriangles)
+	{
+		if (remainingTriangles == 0)
+			return -1.0f;
+
+		float score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			if (cachePosition < 3)
+			{
+				// The last triangle's vertices get a fixed score so we don't
+				// favour drawing it again straight away
+				score = LAST_TRIANGLE_SCORE;
+			}
+			else
+			{
+				const float scaler = 1.0f / float(SCORE_CACHE_SIZE - 3);
+				score = std::pow(1.0f - float(cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+			}
+		}
+
+		// Boost vertices with few triangles left so lone triangles don't get stranded
+		score += VALENCE_BOOST_SCALE * std::pow(float(remainingTriangles), -VALENCE_BOOST_POWER);
+		return score;
+	}
+
+	// Triangle adjacency in compressed form: the triangles of vertex v are
+	// Triangles[Offsets[v] .. Offsets[v] + Counts[v])
+	struct TriangleAdjacency
+	{
+		std::vector<uint32_t> Counts;
+		std::vector<uint32_t> Offsets;
+		std::vector<uint32_t> Triangles;
+
+		void Build(const uint32_t* indices, size_t indexCount, size_t vertexCount)
+		{
+			Counts.assign(vertexCount, 0);
+			Offsets.resize(vertexCount);
+			Triangles.resize(indexCount);
+
+			for (size_t i = 0; i < indexCount; i++)
+				Counts[indices[i]]++;
+
+			uint32_t offset = 0;
+			for (size_t v = 0; v < vertexCount; v++)
+			{
+				Offsets[v] = offset;
+				offset += Counts[v];
+			}
+
+			std::vector<uint32_t> fill(Offsets);
+			for (size_t i = 0; i < indexCount; i++)
+				Triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+	};
+}
+
+
+
+uint32_t MeshOptimizer::GenerateVertexRemap(uint32_t* remap, const uint32_t* indices, size_t indexCount, const void* vertices, size_t vertexCount, size_t stride)
+{
+	const uint8_t* vertexBytes = static_cast<const uint8_t*>(vertices);
+
+	std::fill(remap, remap + vertexCount, INVALID_INDEX);
+
+	// Open addressing table of vertex indices, kept at most half full
+	size_t tableSize = 1;
+	while (tableSize < vertexCount * 2)
+		tableSize <<= 1;
+	std::vector<uint32_t> table(tableSize, INVALID_INDEX);
+
+	uint32_t uniqueCount = 0;
+	const size_t referenceCount = indices ? indexCount : vertexCount;
+
+	for (size_t i = 0; i < referenceCount; i++)
+	{
+		uint32_t vertex = indices ? indices[i] : static_cast<uint32_t>(i);
+		if (remap[vertex] != INVALID_INDEX)
+			continue;
+
+		const uint8_t* data = vertexBytes + vertex * stride;
+		size_t slot = HashBytes(data, stride) & (tableSize - 1);
+
+		while (table[slot] != INVALID_INDEX && memcmp(vertexBytes + table[slot] * stride, data, stride) != 0)
+			slot = (slot + 1) & (tableSize - 1);
+
+		if (table[slot] == INVALID_INDEX)
+		{
+			table[slot] = vertex;
+			remap[vertex] = uniqueCount++;
+		}
+		else
+		{
+			remap[vertex] = remap[table[slot]];
+		}
+	}
+
+	return uniqueCount;
+}
+
+void MeshOptimizer::RemapVertexBuffer(void* destination, const void* vertices, size_t vertexCount, size_t stride, const uint32_t* remap)
+{
+	uint8_t* destinationBytes = static_cast<uint8_t*>(destination);
+	const uint8_t* sourceBytes = static_cast<const uint8_t*>(vertices);
+
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		if (remap[i] != INVALID_INDEX)
+			memcpy(destinationBytes + remap[i] * stride, sourceBytes + i * stride, stride);
+	}
+}
+
+void MeshOptimizer::RemapIndexBuffer(uint32_t* destination, const uint32_t* indices, size_t indexCount, const uint32_t* remap)
+{
+	for (size_t i = 0; i < indexCount; i++)
+		destination[i] = remap[indices[i]];
+}
+
+
+
+void MeshOptimizer::OptimizeVertexCache(uint32_t* destination, const uint32_t* indices, size_t indexCount, size_t vertexCount)
+{
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+		return;
+
+	// Work on a copy so destination may alias indices
+	std::vector<uint32_t> source(indices, indices + indexCount);
+
+	TriangleAdjacency adjacency;
+	adjacency.Build(source.data(), indexCount, vertexCount);
+
+	std::vector<int32_t> cachePositions(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++)
+		vertexScores[v] = VertexScore(-1, adjacency.Counts[v]);
+
+	std::vector<float> triangleScores(triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+	for (size_t t = 0; t < triangleCount; t++)
+		triangleScores[t] = vertexScores[source[t * 3]] + vertexScores[source[t * 3 + 1]] + vertexScores[source[t * 3 + 2]];
+
+	uint32_t bestTriangle = static_cast<uint32_t>(std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin());
+
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> newCache;
+	cache.reserve(SCORE_CACHE_SIZE + 3);
+	newCache.reserve(SCORE_CACHE_SIZE + 3);
+
+	size_t fallbackCursor = 0;
+
+	for (size_t output = 0; output < triangleCount; output++)
+	{
+		if (bestTriangle == INVALID_INDEX)
+		{
+			// Nothing in the cache has triangles left, continue with the next unused one
+			while (emitted[fallbackCursor])
+				fallbackCursor++;
+			bestTriangle = static_cast<uint32_t>(fallbackCursor);
+		}
+
+		const uint32_t* triangle = &source[bestTriangle * 3];
+		memcpy(destination + output * 3, triangle, sizeof(uint32_t) * 3);
+		emitted[bestTriangle] = true;
+
+		// Drop the triangle from its vertices' adjacency lists
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			uint32_t vertex = triangle[k];
+			uint32_t* list = &adjacency.Triangles[adjacency.Offsets[vertex]];
+			uint32_t& count = adjacency.Counts[vertex];
+
+			for (uint32_t i = 0; i < count; i++)
+			{
+				if (list[i] == bestTriangle)
+				{
+					list[i] = list[count - 1];
+					count--;
+					break;
+				}
+			}
+		}
+
+		// Move the triangle's vertices to the front of the LRU cache
+		newCache.assign(triangle, triangle + 3);
+		for (uint32_t vertex : cache)
+		{
+			if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+				newCache.push_back(vertex);
+		}
+
+		// Vertices pushed out of the cache lose their cache score
+		for (size_t i = SCORE_CACHE_SIZE; i < newCache.size(); i++)
+		{
+			uint32_t vertex = newCache[i];
+			cachePositions[vertex] = -1;
+			vertexScores[vertex] = VertexScore(-1, adjacency.Counts[vertex]);
+		}
+		if (newCache.size() > SCORE_CACHE_SIZE)
+			newCache.resize(SCORE_CACHE_SIZE);
+
+		for (size_t i = 0; i < newCache.size(); i++)
+		{
+			uint32_t vertex = newCache[i];
+			cachePositions[vertex] = static_cast<int32_t>(i);
+			vertexScores[vertex] = VertexScore(static_cast<int32_t>(i), adjacency.Counts[vertex]);
+		}
+
+		cache.swap(newCache);
+
+		// Rescore the triangles touching the cache and pick the best one
+		bestTriangle = INVALID_INDEX;
+		float bestScore = -1.0f;
+
+		for (uint32_t vertex : cache)
+		{
+			const uint32_t* list = &adjacency.Triangles[adjacency.Offsets[vertex]];
+			for (uint32_t i = 0; i < adjacency.Counts[vertex]; i++)
+			{
+				uint32_t t = list[i];
+				const uint32_t* candidate = &source[t * 3];
+				float score = vertexScores[candidate[0]] + vertexScores[candidate[1]] + vertexScores[candidate[2]];
+				triangleScores[t] = score;
+
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestTriangle = t;
+				}
+			}
+		}
+	}
+}
+
+
+
+void MeshOptimizer::OptimizeOverdraw(uint32_t* destination, const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t positionStride)
+{
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+		return;
+
+	std::vector<uint32_t> source(indices, indices + indexCount);
+	const uint8_t* positionBytes = reinterpret_cast<const uint8_t*>(positions);
+
+	auto position = [&](uint32_t vertex) {
+		return reinterpret_cast<const float*>(positionBytes + vertex * positionStride);
+	};
+
+	// Cluster boundaries are the triangles that miss the cache on all three vertices.
+	// The cache is effectively cold there, so moving clusters around costs no ACMR.
+	std::vector<uint32_t> clusterStarts;
+	{
+		std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+		uint32_t timestamp = DEFAULT_ANALYSIS_CACHE_SIZE + 1;
+
+		for (size_t t = 0; t < triangleCount; t++)
+		{
+			uint32_t misses = 0;
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				uint32_t vertex = source[t * 3 + k];
+				if (timestamp - cacheTimestamps[vertex] > DEFAULT_ANALYSIS_CACHE_SIZE)
+				{
+					cacheTimestamps[vertex] = timestamp++;
+					misses++;
+				}
+			}
+
+			if (t == 0 || misses == 3)
+				clusterStarts.push_back(static_cast<uint32_t>(t));
+		}
+	}
+
+	// Mesh centroid
+	float meshCenter[3] = {};
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		const float* p = position(source[i]);
+		meshCenter[0] += p[0];
+		meshCenter[1] += p[1];
+		meshCenter[2] += p[2];
+	}
+	for (float& c : meshCenter)
+		c /= float(indexCount);
+
+	// Sort key per cluster: how far the cluster sits out along its own average normal
+	struct ClusterOrder
+	{
+		float Key;
+		uint32_t Cluster;
+	};
+	std::vector<ClusterOrder> order(clusterStarts.size());
+
+	for (size_t c = 0; c < clusterStarts.size(); c++)
+	{
+		size_t begin = clusterStarts[c];
+		size_t end = c + 1 < clusterStarts.size() ? clusterStarts[c + 1] : triangleCount;
+
+		float center[3] = {};
+		float normal[3] = {};
+		float totalArea = 0.0f;
+
+		for (size_t t = begin; t < end; t++)
+		{
+			const float* p0 = position(source[t * 3]);
+			const float* p1 = position(source[t * 3 + 1]);
+			const float* p2 = position(source[t * 3 + 2]);
+
+			float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			float area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				center[k] += (p0[k] + p1[k] + p2[k]) * (area / 3.0f);
+				normal[k] += n[k];
+			}
+			totalArea += area;
+		}
+
+		float normalLength = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		float key = 0.0f;
+		if (totalArea > 0.0f && normalLength > 0.0f)
+		{
+			for (uint32_t k = 0; k < 3; k++)
+				key += (center[k] / totalArea - meshCenter[k]) * (normal[k] / normalLength);
+		}
+
+		order[c] = { key, static_cast<uint32_t>(c) };
+	}
+
+	// Outermost clusters first, they are the most likely to occlude the rest
+	std::stable_sort(order.begin(), order.end(), [](const ClusterOrder& a, const ClusterOrder& b) { return a.Key > b.Key; });
+
+	size_t output = 0;
+	for (const ClusterOrder& entry : order)
+	{
+		size_t begin = clusterStarts[entry.Cluster];
+		size_t end = entry.Cluster + 1 < clusterStarts.size() ? clusterStarts[entry.Cluster + 1] : triangleCount;
+
+		memcpy(destination + output, &source[begin * 3], (end - begin) * 3 * sizeof(uint32_t));
+		output += (end - begin) * 3;
+	}
+}
+
+
+
+uint32_t MeshOptimizer::GenerateVertexFetchRemap(uint32_t* remap, const uint32_t* indices, size_t indexCount, size_t vertexCount)
+{
+	std::fill(remap, remap + vertexCount, INVALID_INDEX);
+
+	uint32_t nextVertex = 0;
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		if (remap[indices[i]] == INVALID_INDEX)
+			remap[indices[i]] = nextVertex++;
+	}
+
+	return nextVertex;
+}
+
+MeshOptimizer::VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+{
+	VertexCacheStats stats{};
+	if (indexCount < 3)
+		return stats;
+
+	// FIFO cache simulated with insertion timestamps
+	std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+	std::vector<bool> referenced(vertexCount, false);
+	uint32_t timestamp = cacheSize + 1;
+	uint32_t uniqueVertices = 0;
+
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		uint32_t vertex = indices[i];
+
+		if (!referenced[vertex])
+		{
+			referenced[vertex] = true;
+			uniqueVertices++;
+		}
+
+		if (timestamp - cacheTimestamps[vertex] > cacheSize)
+		{
+			cacheTimestamps[vertex] = timestamp++;
+			stats.TransformedVertices++;
+		}
+	}
+
+	stats.ACMR = float(stats.TransformedVertices) / float(indexCount / 3);
+	stats.ATVR = float(stats.TransformedVertices) / float(uniqueVertices);
+	return stats;
+}
+
+std::vector<uint16_t> MeshOptimizer::ConvertIndicesTo16(const std::vector<uint32_t>& indices)
+{
+	std::vector<uint16_t> result(indices.size());
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		if (indices[i] > 0xFFFF)
+			throw std::runtime_error("Mesh has too many vertices for 16-bit indices");
+
+		result[i] = static_cast<uint16_t>(indices[i]);
+	}
+	return result;
+}
+
+void MeshOptimizer::PrintReport(const MeshOptimizationReport& report)
+{
+	printf("Mesh: %u triangles, %u -> %u vertices\n", report.Triangles, report.VerticesBefore, report.VerticesAfter);
+	printf("  ACMR %.3f -> %.3f, ATVR %.3f -> %.3f (FIFO %u)\n",
+		report.CacheBefore.ACMR, report.CacheAfter.ACMR,
+		report.CacheBefore.ATVR, report.CacheAfter.ATVR,
+		DEFAULT_ANALYSIS_CACHE_SIZE);
+}
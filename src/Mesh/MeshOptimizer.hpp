@@ -0,0 +1,125 @@
+#pragma once
+
+#include "common.hpp"
+#include <cstddef>
+#include <type_traits>
+
+
+// Offline mesh processing for indexed triangle lists.
+// The low level functions work on raw vertex bytes with a stride so they accept
+// every vertex struct from common.hpp, OptimizeMesh chains them for a typed mesh.
+namespace MeshOptimizer
+{
+	// Post-transform cache statistics of an index buffer.
+	// ACMR = transformed vertices per triangle (0.5 is ideal on large grids, 3 is worst)
+	// ATVR = transformed vertices per unique vertex (1 is ideal)
+	struct VertexCacheStats
+	{
+		uint32_t TransformedVertices{0};
+		float ACMR{0.0f};
+		float ATVR{0.0f};
+	};
+
+	struct MeshOptimizationOptions
+	{
+		bool Weld{true};
+		bool OptimizeVertexCache{true};
+		bool OptimizeOverdraw{false};
+		bool OptimizeVertexFetch{true};
+	};
+
+	struct MeshOptimizationReport
+	{
+		uint32_t VerticesBefore{0};
+		uint32_t VerticesAfter{0};
+		uint32_t Triangles{0};
+		VertexCacheStats CacheBefore{};
+		VertexCacheStats CacheAfter{};
+	};
+
+	// FIFO size used for ACMR/ATVR reporting, typical of current hardware
+	constexpr uint32_t DEFAULT_ANALYSIS_CACHE_SIZE = 16;
+
+
+	// Builds a remap table that maps every vertex to the first bit-identical vertex.
+	// `indices` may be null for an unindexed triangle list. Returns the unique vertex count.
+	uint32_t GenerateVertexRemap(uint32_t* remap, const uint32_t* indices, size_t indexCount, const void* vertices, size_t vertexCount, size_t stride);
+
+	void RemapVertexBuffer(void* destination, const void* vertices, size_t vertexCount, size_t stride, const uint32_t* remap);
+	void RemapIndexBuffer(uint32_t* destination, const uint32_t* indices, size_t indexCount, const uint32_t* remap);
+
+	// Reorders triangles for post-transform vertex cache locality (Forsyth's linear-speed algorithm)
+	void OptimizeVertexCache(uint32_t* destination, const uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+	// Reorders clusters of cache-optimized triangles so outward facing, outer parts of
+	// the mesh are drawn first. Clusters are only split where the cache was cold anyway,
+	// so this keeps the ACMR of the input.
+	void OptimizeOverdraw(uint32_t* destination, const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t positionStride);
+
+	// Builds a remap table that orders vertices by first use in the index buffer.
+	// Unreferenced vertices are dropped. Returns the new vertex count.
+	uint32_t GenerateVertexFetchRemap(uint32_t* remap, const uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+	VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = DEFAULT_ANALYSIS_CACHE_SIZE);
+
+	// Narrows indices to 16 bits, only valid for meshes with at most 65536 vertices
+	std::vector<uint16_t> ConvertIndicesTo16(const std::vector<uint32_t>& indices);
+
+	void PrintReport(const MeshOptimizationReport& report);
+
+
+	// Runs the enabled optimization stages on a mesh in place.
+	// An empty index list is treated as an unindexed triangle list and gets generated.
+	template<typename TVertex>
+	MeshOptimizationReport OptimizeMesh(std::vector<TVertex>& vertices, std::vector<uint32_t>& indices, const MeshOptimizationOptions& options = {})
+	{
+		static_assert(std::is_trivially_copyable_v<TVertex>, "Vertices are compared and moved as raw bytes");
+		static_assert(offsetof(TVertex, x) == 0 && offsetof(TVertex, z) == sizeof(float) * 2, "Vertex must start with a float3 position");
+
+		MeshOptimizationReport report{};
+		report.VerticesBefore = static_cast<uint32_t>(vertices.size());
+
+		if (indices.empty())
+		{
+			indices.resize(vertices.size());
+			for (uint32_t i = 0; i < indices.size(); i++)
+				indices[i] = i;
+		}
+
+		report.Triangles = static_cast<uint32_t>(indices.size() / 3);
+		report.CacheBefore = AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+		std::vector<uint32_t> remap(vertices.size());
+
+		if (options.Weld)
+		{
+			uint32_t uniqueCount = GenerateVertexRemap(remap.data(), indices.data(), indices.size(), vertices.data(), vertices.size(), sizeof(TVertex));
+
+			std::vector<TVertex> welded(uniqueCount);
+			RemapVertexBuffer(welded.data(), vertices.data(), vertices.size(), sizeof(TVertex), remap.data());
+			RemapIndexBuffer(indices.data(), indices.data(), indices.size(), remap.data());
+			vertices.swap(welded);
+		}
+
+		if (options.OptimizeVertexCache)
+			MeshOptimizer::OptimizeVertexCache(indices.data(), indices.data(), indices.size(), vertices.size());
+
+		if (options.OptimizeOverdraw)
+			MeshOptimizer::OptimizeOverdraw(indices.data(), indices.data(), indices.size(), &vertices[0].x, vertices.size(), sizeof(TVertex));
+
+		if (options.OptimizeVertexFetch)
+		{
+			remap.resize(vertices.size());
+			uint32_t usedCount = GenerateVertexFetchRemap(remap.data(), indices.data(), indices.size(), vertices.size());
+
+			std::vector<TVertex> ordered(usedCount);
+			RemapVertexBuffer(ordered.data(), vertices.data(), vertices.size(), sizeof(TVertex), remap.data());
+			RemapIndexBuffer(indices.data(), indices.data(), indices.size(), remap.data());
+			vertices.swap(ordered);
+		}
+
+		report.VerticesAfter = static_cast<uint32_t>(vertices.size());
+		report.CacheAfter = AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+		return report;
+	}
+}
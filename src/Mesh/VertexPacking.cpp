@@ -0,0 +1,588 @@
+#include "VertexPacking.hpp"
+#include "Core/Simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+namespace
+{
+	template<typename T>
+	const T* SourceAt(const void* base, size_t stride, size_t index)
+	{
+		return reinterpret_cast<const T*>(static_cast<const uint8_t*>(base) + index * stride);
+	}
+
+	void* DestinationAt(void* base, size_t stride, size_t index)
+	{
+		return static_cast<uint8_t*>(base) + index * stride;
+	}
+
+	uint8_t FloatToUnorm8(float value)
+	{
+		value = std::clamp(value, 0.0f, 1.0f);
+		return static_cast<uint8_t>(std::lrint(value * 255.0f));
+	}
+
+	int16_t FloatToSnorm16(float value)
+	{
+		value = std::clamp(value, -1.0f, 1.0f);
+		return static_cast<int16_t>(std::lrint(value * 32767.0f));
+	}
+
+
+#if SDLGPU_SIMD_X86
+	// Float to half for 4 lanes, result in the low 64 bits
+	inline __m128i FloatToHalf4(__m128 value)
+	{
+	#if SDLGPU_SIMD_AVX2
+		return _mm_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT);
+	#else
+		// Round to nearest even without F16C, same steps as the scalar FloatToHalf
+		const __m128i signMask = _mm_set1_epi32(int(0x80000000u));
+		const __m128i halfMaxAsFloat = _mm_set1_epi32((127 + 16) << 23);
+		const __m128i minNormalAsFloat = _mm_set1_epi32((127 - 14) << 23);
+		const __m128i subnormalMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+		const __m128i normalBias = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));
+		const __m128i infinity = _mm_set1_epi32(0x7C00);
+		const __m128i nanBit = _mm_set1_epi32(0x200);
+
+		__m128 sign = _mm_and_ps(value, _mm_castsi128_ps(signMask));
+		__m128 absolute = _mm_xor_ps(value, sign);
+		__m128i absoluteBits = _mm_castps_si128(absolute);
+
+		__m128i isNan = _mm_castps_si128(_mm_cmpunord_ps(absolute, absolute));
+		__m128i isFinite = _mm_cmpgt_epi32(halfMaxAsFloat, absoluteBits);
+		__m128i isSubnormal = _mm_cmpgt_epi32(minNormalAsFloat, absoluteBits);
+
+		__m128i special = _mm_or_si128(_mm_and_si128(isNan, nanBit), infinity);
+
+		__m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absolute, _mm_castsi128_ps(subnormalMagic))), subnormalMagic);
+
+		__m128i mantissaOdd = _mm_srai_epi32(_mm_slli_epi32(absoluteBits, 31 - 13), 31);
+		__m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(absoluteBits, normalBias), mantissaOdd), 13);
+
+		__m128i finite = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+		__m128i half = _mm_or_si128(_mm_and_si128(isFinite, finite), _mm_andnot_si128(isFinite, special));
+		half = _mm_or_si128(half, _mm_srli_epi32(_mm_castps_si128(sign), 16));
+
+		// Sign extend so the saturating pack keeps all 16 bits
+		half = _mm_srai_epi32(_mm_slli_epi32(half, 16), 16);
+		return _mm_packs_epi32(half, half);
+	#endif
+	}
+
+	inline void Store32(void* destination, __m128i value)
+	{
+		int32_t bits = _mm_cvtsi128_si32(value);
+		memcpy(destination, &bits, sizeof(bits));
+	}
+
+	inline void Transpose3(__m128 a, __m128 b, __m128 c, __m128 d, __m128& x, __m128& y, __m128& z)
+	{
+		__m128 ab0 = _mm_unpacklo_ps(a, b); // a0 b0 a1 b1
+		__m128 cd0 = _mm_unpacklo_ps(c, d); // c0 d0 c1 d1
+		__m128 ab1 = _mm_unpackhi_ps(a, b); // a2 b2 a3 b3
+		__m128 cd1 = _mm_unpackhi_ps(c, d); // c2 d2 c3 d3
+		x = _mm_movelh_ps(ab0, cd0);
+		y = _mm_movehl_ps(cd0, ab0);
+		z = _mm_movelh_ps(ab1, cd1);
+	}
+#endif
+}
+
+
+
+uint16_t VertexPacking::FloatToHalf(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	uint32_t sign = (bits >> 16) & 0x8000u;
+	uint32_t absolute = bits & 0x7FFFFFFFu;
+
+	// Inf or NaN, NaNs stay quiet NaNs
+	if (absolute >= 0x7F800000u)
+		return static_cast<uint16_t>(sign | (absolute > 0x7F800000u ? 0x7E00u : 0x7C00u));
+
+	// Too large, rounds to infinity
+	if (absolute >= ((127u + 16u) << 23))
+		return static_cast<uint16_t>(sign | 0x7C00u);
+
+	if (absolute < ((127u - 14u) << 23))
+	{
+		// Subnormal result, let the FPU do the rounding by adding a magic number
+		const uint32_t magicBits = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+		float magic, shifted;
+		memcpy(&magic, &magicBits, sizeof(magic));
+		memcpy(&shifted, &absolute, sizeof(shifted));
+		shifted += magic;
+
+		uint32_t shiftedBits;
+		memcpy(&shiftedBits, &shifted, sizeof(shiftedBits));
+		return static_cast<uint16_t>(sign | (shiftedBits - magicBits));
+	}
+
+	// Normal result, rebias the exponent and round the mantissa to nearest even
+	uint32_t mantissaOdd = (absolute >> 13) & 1u;
+	absolute += ((15u - 127u) << 23) + 0xFFFu + mantissaOdd;
+	return static_cast<uint16_t>(sign | (absolute >> 13));
+}
+
+float VertexPacking::HalfToFloat(uint16_t value)
+{
+	uint32_t sign = uint32_t(value & 0x8000u) << 16;
+	uint32_t exponent = (value >> 10) & 0x1Fu;
+	uint32_t mantissa = value & 0x3FFu;
+
+	uint32_t bits;
+	if (exponent == 0x1F)
+	{
+		bits = sign | 0x7F800000u | (mantissa << 13);
+	}
+	else if (exponent != 0)
+	{
+		bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+	}
+	else
+	{
+		// Zero or subnormal, value = mantissa * 2^-24
+		float result = std::ldexp(float(mantissa), -24);
+		return sign ? -result : result;
+	}
+
+	float result;
+	memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+void VertexPacking::EncodeOctahedral(float nx, float ny, float nz, int16_t& ox, int16_t& oy)
+{
+	float l1 = std::fabs(nx) + std::fabs(ny) + std::fabs(nz);
+	float x = l1 > 0.0f ? nx / l1 : 0.0f;
+	float y = l1 > 0.0f ? ny / l1 : 0.0f;
+
+	// Fold the lower hemisphere over the diagonals
+	if (nz < 0.0f)
+	{
+		float foldedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		float foldedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+		x = foldedX;
+		y = foldedY;
+	}
+
+	ox = FloatToSnorm16(x);
+	oy = FloatToSnorm16(y);
+}
+
+void VertexPacking::DecodeOctahedral(int16_t ox, int16_t oy, float& nx, float& ny, float& nz)
+{
+	float x = std::max(float(ox) / 32767.0f, -1.0f);
+	float y = std::max(float(oy) / 32767.0f, -1.0f);
+	float z = 1.0f - std::fabs(x) - std::fabs(y);
+
+	float t = std::max(-z, 0.0f);
+	x += x >= 0.0f ? -t : t;
+	y += y >= 0.0f ? -t : t;
+
+	float length = std::sqrt(x * x + y * y + z * z);
+	nx = x / length;
+	ny = y / length;
+	nz = z / length;
+}
+
+
+
+void VertexPacking::PackPositionsHalf4(void* destination, size_t destinationStride, const void* source, size_t sourceStride, size_t count)
+{
+	size_t i = 0;
+
+#if SDLGPU_SIMD_X86
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	for (; i + 2 <= count; i += 2)
+	{
+		// Load x y z (next field) and replace the last lane with w = 1
+		__m128 p0 = _mm_loadu_ps(SourceAt<float>(source, sourceStride, i));
+		__m128 p1 = _mm_loadu_ps(SourceAt<float>(source, sourceStride, i + 1));
+		p0 = _mm_movelh_ps(p0, _mm_unpackhi_ps(p0, one));
+		p1 = _mm_movelh_ps(p1, _mm_unpackhi_ps(p1, one));
+
+	#if SDLGPU_SIMD_AVX2
+		__m128i halves = _mm256_cvtps_ph(_mm256_set_m128(p1, p0), _MM_FROUND_TO_NEAREST_INT);
+	#else
+		__m128i halves = _mm_unpacklo_epi64(FloatToHalf4(p0), FloatToHalf4(p1));
+	#endif
+
+		_mm_storel_epi64(static_cast<__m128i*>(DestinationAt(destination, destinationStride, i)), halves);
+		_mm_storel_epi64(static_cast<__m128i*>(DestinationAt(destination, destinationStride, i + 1)), _mm_srli_si128(halves, 8));
+	}
+#elif SDLGPU_SIMD_NEON
+	for (; i < count; i++)
+	{
+		float32x4_t p = vsetq_lane_f32(1.0f, vld1q_f32(SourceAt<float>(source, sourceStride, i)), 3);
+		uint16x4_t halves = vreinterpret_u16_f16(vcvt_f16_f32(p));
+		vst1_u16(static_cast<uint16_t*>(DestinationAt(destination, destinationStride, i)), halves);
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		const float* p = SourceAt<float>(source, sourceStride, i);
+		uint16_t halves[4] = { FloatToHalf(p[0]), FloatToHalf(p[1]), FloatToHalf(p[2]), FloatToHalf(1.0f) };
+		memcpy(DestinationAt(destination, destinationStride, i), halves, sizeof(halves));
+	}
+}
+
+void VertexPacking::PackTexcoordsHalf2(void* destination, size_t destinationStride, const void* source, size_t sourceStride, size_t count)
+{
+	size_t i = 0;
+
+#if SDLGPU_SIMD_X86
+	for (; i + 4 <= count; i += 4)
+	{
+		// Two UVs per register, loaded 64 bits at a time so we never read past the field
+		__m128 uv01 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(SourceAt<float>(source, sourceStride, i))),
+			reinterpret_cast<const __m64*>(SourceAt<float>(source, sourceStride, i + 1)));
+		__m128 uv23 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(SourceAt<float>(source, sourceStride, i + 2))),
+			reinterpret_cast<const __m64*>(SourceAt<float>(source, sourceStride, i + 3)));
+
+	#if SDLGPU_SIMD_AVX2
+		__m128i halves = _mm256_cvtps_ph(_mm256_set_m128(uv23, uv01), _MM_FROUND_TO_NEAREST_INT);
+	#else
+		__m128i halves = _mm_unpacklo_epi64(FloatToHalf4(uv01), FloatToHalf4(uv23));
+	#endif
+
+		for (size_t k = 0; k < 4; k++)
+		{
+			Store32(DestinationAt(destination, destinationStride, i + k), halves);
+			halves = _mm_srli_si128(halves, 4);
+		}
+	}
+#elif SDLGPU_SIMD_NEON
+	for (; i + 2 <= count; i += 2)
+	{
+		float32x4_t uv = vcombine_f32(vld1_f32(SourceAt<float>(source, sourceStride, i)), vld1_f32(SourceAt<float>(source, sourceStride, i + 1)));
+		uint32x2_t halves = vreinterpret_u32_f16(vcvt_f16_f32(uv));
+		vst1_lane_u32(static_cast<uint32_t*>(DestinationAt(destination, destinationStride, i)), halves, 0);
+		vst1_lane_u32(static_cast<uint32_t*>(DestinationAt(destination, destinationStride, i + 1)), halves, 1);
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		const float* uv = SourceAt<float>(source, sourceStride, i);
+		uint16_t halves[2] = { FloatToHalf(uv[0]), FloatToHalf(uv[1]) };
+		memcpy(DestinationAt(destination, destinationStride, i), halves, sizeof(halves));
+	}
+}
+
+void VertexPacking::PackNormalsOctahedral(void* destination, size_t destinationStride, const void* source, size_t sourceStride, size_t count)
+{
+	size_t i = 0;
+
+#if SDLGPU_SIMD_X86
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 negativeOne = _mm_set1_ps(-1.0f);
+	const __m128 snormScale = _mm_set1_ps(32767.0f);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x, y, z;
+		Transpose3(_mm_loadu_ps(SourceAt<float>(source, sourceStride, i)),
+			_mm_loadu_ps(SourceAt<float>(source, sourceStride, i + 1)),
+			_mm_loadu_ps(SourceAt<float>(source, sourceStride, i + 2)),
+			_mm_loadu_ps(SourceAt<float>(source, sourceStride, i + 3)),
+			x, y, z);
+
+		__m128 absX = _mm_andnot_ps(signMask, x);
+		__m128 absY = _mm_andnot_ps(signMask, y);
+		__m128 absZ = _mm_andnot_ps(signMask, z);
+		__m128 l1 = _mm_add_ps(_mm_add_ps(absX, absY), absZ);
+
+		// Zero length normals encode as (0, 0) like the scalar path
+		__m128 valid = _mm_cmpgt_ps(l1, zero);
+		__m128 ox = _mm_and_ps(_mm_div_ps(x, l1), valid);
+		__m128 oy = _mm_and_ps(_mm_div_ps(y, l1), valid);
+
+		// Fold the lower hemisphere, +0 and -0 both count as positive like in the scalar path
+		__m128 xPositive = _mm_cmpge_ps(ox, zero);
+		__m128 yPositive = _mm_cmpge_ps(oy, zero);
+		__m128 signX = _mm_or_ps(_mm_and_ps(xPositive, one), _mm_andnot_ps(xPositive, negativeOne));
+		__m128 signY = _mm_or_ps(_mm_and_ps(yPositive, one), _mm_andnot_ps(yPositive, negativeOne));
+
+		__m128 foldedX = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, oy)), signX);
+		__m128 foldedY = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, ox)), signY);
+
+		__m128 lower = _mm_cmplt_ps(z, zero);
+		ox = _mm_or_ps(_mm_and_ps(lower, foldedX), _mm_andnot_ps(lower, ox));
+		oy = _mm_or_ps(_mm_and_ps(lower, foldedY), _mm_andnot_ps(lower, oy));
+
+		ox = _mm_min_ps(_mm_max_ps(ox, negativeOne), one);
+		oy = _mm_min_ps(_mm_max_ps(oy, negativeOne), one);
+
+		__m128i ix = _mm_cvtps_epi32(_mm_mul_ps(ox, snormScale));
+		__m128i iy = _mm_cvtps_epi32(_mm_mul_ps(oy, snormScale));
+
+		// Interleave to x0 y0 x1 y1 ... and narrow to 16 bits
+		__m128i packed = _mm_packs_epi32(_mm_unpacklo_epi32(ix, iy), _mm_unpackhi_epi32(ix, iy));
+
+		for (size_t k = 0; k < 4; k++)
+		{
+			Store32(DestinationAt(destination, destinationStride, i + k), packed);
+			packed = _mm_srli_si128(packed, 4);
+		}
+	}
+#elif SDLGPU_SIMD_NEON
+	const float32x4_t one = vdupq_n_f32(1.0f);
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	const float32x4_t snormScale = vdupq_n_f32(32767.0f);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		float32x4_t a = vld1q_f32(SourceAt<float>(source, sourceStride, i));
+		float32x4_t b = vld1q_f32(SourceAt<float>(source, sourceStride, i + 1));
+		float32x4_t c = vld1q_f32(SourceAt<float>(source, sourceStride, i + 2));
+		float32x4_t d = vld1q_f32(SourceAt<float>(source, sourceStride, i + 3));
+
+		float32x4x2_t ab = vtrnq_f32(a, b);
+		float32x4x2_t cd = vtrnq_f32(c, d);
+		float32x4_t x = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+		float32x4_t y = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+		float32x4_t z = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+
+		float32x4_t l1 = vaddq_f32(vaddq_f32(vabsq_f32(x), vabsq_f32(y)), vabsq_f32(z));
+		uint32x4_t valid = vcgtq_f32(l1, zero);
+		float32x4_t ox = vbslq_f32(valid, vdivq_f32(x, l1), zero);
+		float32x4_t oy = vbslq_f32(valid, vdivq_f32(y, l1), zero);
+
+		float32x4_t signX = vbslq_f32(vcgeq_f32(ox, zero), one, vnegq_f32(one));
+		float32x4_t signY = vbslq_f32(vcgeq_f32(oy, zero), one, vnegq_f32(one));
+		float32x4_t foldedX = vmulq_f32(vsubq_f32(one, vabsq_f32(oy)), signX);
+		float32x4_t foldedY = vmulq_f32(vsubq_f32(one, vabsq_f32(ox)), signY);
+
+		uint32x4_t lower = vcltq_f32(z, zero);
+		ox = vminq_f32(vmaxq_f32(vbslq_f32(lower, foldedX, ox), vnegq_f32(one)), one);
+		oy = vminq_f32(vmaxq_f32(vbslq_f32(lower, foldedY, oy), vnegq_f32(one)), one);
+
+		int16x4_t ix = vqmovn_s32(vcvtnq_s32_f32(vmulq_f32(ox, snormScale)));
+		int16x4_t iy = vqmovn_s32(vcvtnq_s32_f32(vmulq_f32(oy, snormScale)));
+		int16x4x2_t interleaved = vzip_s16(ix, iy);
+
+		uint32x2_t low = vreinterpret_u32_s16(interleaved.val[0]);
+		uint32x2_t high = vreinterpret_u32_s16(interleaved.val[1]);
+		vst1_lane_u32(static_cast<uint32_t*>(DestinationAt(destination, destinationStride, i)), low, 0);
+		vst1_lane_u32(static_cast<uint32_t*>(DestinationAt(destination, destinationStride, i + 1)), low, 1);
+		vst1_lane_u32(static_cast<uint32_t*>(DestinationAt(destination, destinationStride, i + 2)), high, 0);
+		vst1_lane_u32(static_cast<uint32_t*>(DestinationAt(destination, destinationStride, i + 3)), high, 1);
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		const float* n = SourceAt<float>(source, sourceStride, i);
+		int16_t encoded[2];
+		EncodeOctahedral(n[0], n[1], n[2], encoded[0], encoded[1]);
+		memcpy(DestinationAt(destination, destinationStride, i), encoded, sizeof(encoded));
+	}
+}
+
+void VertexPacking::PackColorsUnorm8(void* destination, size_t destinationStride, const void* source, size_t sourceStride, size_t count)
+{
+	size_t i = 0;
+
+#if SDLGPU_SIMD_X86
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 unormScale = _mm_set1_ps(255.0f);
+
+	auto convert = [&](size_t index) {
+		__m128 color = _mm_loadu_ps(SourceAt<float>(source, sourceStride, index));
+		color = _mm_mul_ps(_mm_min_ps(_mm_max_ps(color, zero), one), unormScale);
+		return _mm_cvtps_epi32(color);
+	};
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i c01 = _mm_packs_epi32(convert(i), convert(i + 1));
+		__m128i c23 = _mm_packs_epi32(convert(i + 2), convert(i + 3));
+		__m128i packed = _mm_packus_epi16(c01, c23);
+
+		for (size_t k = 0; k < 4; k++)
+		{
+			Store32(DestinationAt(destination, destinationStride, i + k), packed);
+			packed = _mm_srli_si128(packed, 4);
+		}
+	}
+#elif SDLGPU_SIMD_NEON
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	const float32x4_t one = vdupq_n_f32(1.0f);
+	const float32x4_t unormScale = vdupq_n_f32(255.0f);
+
+	auto convert = [&](size_t index) {
+		float32x4_t color = vld1q_f32(SourceAt<float>(source, sourceStride, index));
+		color = vmulq_f32(vminq_f32(vmaxq_f32(color, zero), one), unormScale);
+		return vmovn_u32(vcvtnq_u32_f32(color));
+	};
+
+	for (; i + 2 <= count; i += 2)
+	{
+		uint8x8_t packed = vmovn_u16(vcombine_u16(convert(i), convert(i + 1)));
+		uint32x2_t words = vreinterpret_u32_u8(packed);
+		vst1_lane_u32(static_cast<uint32_t*>(DestinationAt(destination, destinationStride, i)), words, 0);
+		vst1_lane_u32(static_cast<uint32_t*>(DestinationAt(destination, destinationStride, i + 1)), words, 1);
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		const float* c = SourceAt<float>(source, sourceStride, i);
+		uint8_t packed[4] = { FloatToUnorm8(c[0]), FloatToUnorm8(c[1]), FloatToUnorm8(c[2]), FloatToUnorm8(c[3]) };
+		memcpy(DestinationAt(destination, destinationStride, i), packed, sizeof(packed));
+	}
+}
+
+
+
+void VertexPacking::PackVertices(VertexPackedPositionColor* destination, const VertexPositionColor* source, size_t count)
+{
+	constexpr size_t destinationStride = sizeof(VertexPackedPositionColor);
+	constexpr size_t sourceStride = sizeof(VertexPositionColor);
+
+	PackPositionsHalf4(&destination->x, destinationStride, &source->x, sourceStride, count);
+	PackColorsUnorm8(&destination->r, destinationStride, &source->r, sourceStride, count);
+}
+
+void VertexPacking::PackVertices(VertexPackedPositionNormalTexture* destination, const VertexPositionNormalTexture* source, size_t count)
+{
+	constexpr size_t destinationStride = sizeof(VertexPackedPositionNormalTexture);
+	constexpr size_t sourceStride = sizeof(VertexPositionNormalTexture);
+
+	PackPositionsHalf4(&destination->x, destinationStride, &source->x, sourceStride, count);
+	PackNormalsOctahedral(&destination->nx, destinationStride, &source->nx, sourceStride, count);
+	PackTexcoordsHalf2(&destination->u, destinationStride, &source->u, sourceStride, count);
+}
+
+void VertexPacking::PackVertices(VertexPackedPositionNormalColorTexture* destination, const VertexPositionNormalColorTexture* source, size_t count)
+{
+	constexpr size_t destinationStride = sizeof(VertexPackedPositionNormalColorTexture);
+	constexpr size_t sourceStride = sizeof(VertexPositionNormalColorTexture);
+
+	PackPositionsHalf4(&destination->x, destinationStride, &source->x, sourceStride, count);
+	PackNormalsOctahedral(&destination->nx, destinationStride, &source->nx, sourceStride, count);
+	PackColorsUnorm8(&destination->r, destinationStride, &source->r, sourceStride, count);
+	PackTexcoordsHalf2(&destination->u, destinationStride, &source->u, sourceStride, count);
+}
+
+void VertexPacking::PackVerticesScalar(VertexPackedPositionColor* destination, const VertexPositionColor* source, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const VertexPositionColor& in = source[i];
+		VertexPackedPositionColor& out = destination[i];
+
+		out.x = FloatToHalf(in.x);
+		out.y = FloatToHalf(in.y);
+		out.z = FloatToHalf(in.z);
+		out.w = FloatToHalf(1.0f);
+		out.r = FloatToUnorm8(in.r);
+		out.g = FloatToUnorm8(in.g);
+		out.b = FloatToUnorm8(in.b);
+		out.a = FloatToUnorm8(in.a);
+	}
+}
+
+void VertexPacking::PackVerticesScalar(VertexPackedPositionNormalTexture* destination, const VertexPositionNormalTexture* source, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const VertexPositionNormalTexture& in = source[i];
+		VertexPackedPositionNormalTexture& out = destination[i];
+
+		out.x = FloatToHalf(in.x);
+		out.y = FloatToHalf(in.y);
+		out.z = FloatToHalf(in.z);
+		out.w = FloatToHalf(1.0f);
+		EncodeOctahedral(in.nx, in.ny, in.nz, out.nx, out.ny);
+		out.u = FloatToHalf(in.u);
+		out.v = FloatToHalf(in.v);
+	}
+}
+
+void VertexPacking::PackVerticesScalar(VertexPackedPositionNormalColorTexture* destination, const VertexPositionNormalColorTexture* source, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const VertexPositionNormalColorTexture& in = source[i];
+		VertexPackedPositionNormalColorTexture& out = destination[i];
+
+		out.x = FloatToHalf(in.x);
+		out.y = FloatToHalf(in.y);
+		out.z = FloatToHalf(in.z);
+		out.w = FloatToHalf(1.0f);
+		EncodeOctahedral(in.nx, in.ny, in.nz, out.nx, out.ny);
+		out.r = FloatToUnorm8(in.r);
+		out.g = FloatToUnorm8(in.g);
+		out.b = FloatToUnorm8(in.b);
+		out.a = FloatToUnorm8(in.a);
+		out.u = FloatToHalf(in.u);
+		out.v = FloatToHalf(in.v);
+	}
+}
+
+
+
+void VertexPacking::UnpackVertices(VertexPositionColor* destination, const VertexPackedPositionColor* source, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const VertexPackedPositionColor& in = source[i];
+		destination[i] = {
+			HalfToFloat(in.x), HalfToFloat(in.y), HalfToFloat(in.z),
+			in.r / 255.0f, in.g / 255.0f, in.b / 255.0f, in.a / 255.0f
+		};
+	}
+}
+
+void VertexPacking::UnpackVertices(VertexPositionNormalTexture* destination, const VertexPackedPositionNormalTexture* source, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const VertexPackedPositionNormalTexture& in = source[i];
+		VertexPositionNormalTexture& out = destination[i];
+
+		out.x = HalfToFloat(in.x);
+		out.y = HalfToFloat(in.y);
+		out.z = HalfToFloat(in.z);
+		DecodeOctahedral(in.nx, in.ny, out.nx, out.ny, out.nz);
+		out.u = HalfToFloat(in.u);
+		out.v = HalfToFloat(in.v);
+	}
+}
+
+void VertexPacking::UnpackVertices(VertexPositionNormalColorTexture* destination, const VertexPackedPositionNormalColorTexture* source, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const VertexPackedPositionNormalColorTexture& in = source[i];
+		VertexPositionNormalColorTexture& out = destination[i];
+
+		out.x = HalfToFloat(in.x);
+		out.y = HalfToFloat(in.y);
+		out.z = HalfToFloat(in.z);
+		DecodeOctahedral(in.nx, in.ny, out.nx, out.ny, out.nz);
+		out.r = in.r / 255.0f;
+		out.g = in.g / 255.0f;
+		out.b = in.b / 255.0f;
+		out.a = in.a / 255.0f;
+		out.u = HalfToFloat(in.u);
+		out.v = HalfToFloat(in.v);
+	}
+}
+
+const char* VertexPacking::GetBackendName()
+{
+	return SimdBackendName();
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "common.hpp"
+#include <cstddef>
+
+
+// Bulk conversion of float vertices into the packed formats in common.hpp.
+// The element kernels run 4 (SSE2/NEON) or 8 (AVX2) elements per iteration and
+// fall back to the scalar reference for the tail and on other targets.
+namespace VertexPacking
+{
+	// Scalar reference conversions, round to nearest even
+	uint16_t FloatToHalf(float value);
+	float HalfToFloat(uint16_t value);
+
+	void EncodeOctahedral(float nx, float ny, float nz, int16_t& ox, int16_t& oy);
+	void DecodeOctahedral(int16_t ox, int16_t oy, float& nx, float& ny, float& nz);
+
+
+	// Element kernels over strided arrays, strides are in bytes.
+	// Positions, normals and colors read 16 bytes per source element, so the
+	// field must be followed by at least one more float in the source struct.
+	void PackPositionsHalf4(void* destination, size_t destinationStride, const void* source, size_t sourceStride, size_t count);
+	void PackTexcoordsHalf2(void* destination, size_t destinationStride, const void* source, size_t sourceStride, size_t count);
+	void PackNormalsOctahedral(void* destination, size_t destinationStride, const void* source, size_t sourceStride, size_t count);
+	void PackColorsUnorm8(void* destination, size_t destinationStride, const void* source, size_t sourceStride, size_t count);
+
+
+	void PackVertices(VertexPackedPositionColor* destination, const VertexPositionColor* source, size_t count);
+	void PackVertices(VertexPackedPositionNormalTexture* destination, const VertexPositionNormalTexture* source, size_t count);
+	void PackVertices(VertexPackedPositionNormalColorTexture* destination, const VertexPositionNormalColorTexture* source, size_t count);
+
+	// One vertex at a time through the scalar conversions, the reference the
+	// element kernels are checked against. The output is bit-identical.
+	void PackVerticesScalar(VertexPackedPositionColor* destination, const VertexPositionColor* source, size_t count);
+	void PackVerticesScalar(VertexPackedPositionNormalTexture* destination, const VertexPositionNormalTexture* source, size_t count);
+	void PackVerticesScalar(VertexPackedPositionNormalColorTexture* destination, const VertexPositionNormalColorTexture* source, size_t count);
+
+	// Scalar inverse of PackVertices, for measuring quantization error
+	void UnpackVertices(VertexPositionColor* destination, const VertexPackedPositionColor* source, size_t count);
+	void UnpackVertices(VertexPositionNormalTexture* destination, const VertexPackedPositionNormalTexture* source, size_t count);
+	void UnpackVertices(VertexPositionNormalColorTexture* destination, const VertexPackedPositionNormalColorTexture* source, size_t count);
+
+	const char* GetBackendName();
+}
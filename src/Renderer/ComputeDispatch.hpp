@@ -0,0 +1,54 @@
+#pragma once
+
+#include "common.hpp"
+#include <array>
+#include <SDL3/SDL_gpu.h>
+
+
+// Resource counts and workgroup size of a compute shader.
+// Only used for loose .comp files, shaders.pack carries the reflected values.
+struct ComputePipelineInfo
+{
+	uint32_t SamplerCount{0};
+	uint32_t ReadOnlyStorageTextureCount{0};
+	uint32_t ReadOnlyStorageBufferCount{0};
+	uint32_t ReadWriteStorageTextureCount{0};
+	uint32_t ReadWriteStorageBufferCount{0};
+	uint32_t UniformBufferCount{0};
+
+	uint32_t ThreadCountX{64};
+	uint32_t ThreadCountY{1};
+	uint32_t ThreadCountZ{1};
+};
+
+
+// One queued compute dispatch. Every dispatch gets its own compute pass, so SDL
+// synchronizes writes of one dispatch with reads of the next.
+struct ComputeDispatch
+{
+	static constexpr uint32_t MAX_STORAGE_BUFFERS = 4;
+
+	SDL_GPUComputePipeline* Pipeline{nullptr};
+
+	// Read-only storage buffers, bound to slot 0 upwards
+	std::array<SDL_GPUBuffer*, MAX_STORAGE_BUFFERS> ReadOnlyBuffers{};
+	uint32_t ReadOnlyBufferCount{0};
+
+	// Read-write storage buffers, set `cycle` on the first write of a frame
+	// so the GPU does not wait for the previous frame still reading them
+	std::array<SDL_GPUStorageBufferReadWriteBinding, MAX_STORAGE_BUFFERS> ReadWriteBuffers{};
+	uint32_t ReadWriteBufferCount{0};
+
+	// Pushed to uniform slot 0, copied when the dispatch is queued
+	const void* UniformData{nullptr};
+	uint32_t UniformSize{0};
+
+	uint32_t GroupCountX{1};
+	uint32_t GroupCountY{1};
+	uint32_t GroupCountZ{1};
+
+	// Reads the group counts as an SDL_GPUIndirectDispatchCommand at IndirectOffset instead,
+	// e.g. written by an earlier dispatch. The buffer must not be bound to this one.
+	SDL_GPUBuffer* IndirectBuffer{nullptr};
+	uint32_t IndirectOffset{0};
+};
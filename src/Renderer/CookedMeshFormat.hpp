@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// On-disk layout of cooked meshes (.mesh), shared by the MeshCooker tool and MeshPool.
+// Only depends on the standard library.
+//
+//   CookedMeshHeader       vertex layout, counts, blob offsets, bounds
+//   CookedSubmesh[SubmeshCount]
+//   vertex blob            VertexCount * VertexStride bytes, aligned to COOKED_MESH_ALIGNMENT
+//   index blob             IndexCount * IndexSize bytes, aligned to COOKED_MESH_ALIGNMENT
+//
+// The blobs are exactly what goes into the vertex and index buffers, so loading is a copy.
+
+constexpr uint32_t COOKED_MESH_MAGIC = 0x534D5853; // "SXMS"
+constexpr uint32_t COOKED_MESH_VERSION = 1;
+constexpr uint32_t COOKED_MESH_ALIGNMENT = 16;
+constexpr uint32_t COOKED_MESH_MAX_ELEMENTS = 8;
+
+// Mirrors VertexElement, Format is an SDL_GPUVertexElementFormat
+struct CookedMeshElement
+{
+	uint32_t Format;
+	uint32_t Offset;
+	uint32_t Location;
+};
+
+struct CookedMeshHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t VertexType;      // one of the VERTEX_TYPE_* ids
+	uint32_t VertexStride;
+	uint32_t ElementCount;
+	uint32_t IndexSize;       // 2 or 4 bytes, 0 for unindexed meshes
+	uint32_t VertexCount;
+	uint32_t IndexCount;
+	uint32_t SubmeshCount;
+	uint32_t SubmeshOffset;
+	uint32_t VertexOffset;
+	uint32_t IndexOffset;
+	CookedMeshElement Elements[COOKED_MESH_MAX_ELEMENTS];
+	float BoundsMin[3];
+	float BoundsMax[3];
+	uint64_t FileSize;
+};
+
+// A range of the index blob drawn with one material
+struct CookedSubmesh
+{
+	uint32_t FirstIndex;
+	uint32_t IndexCount;
+	uint32_t MaterialHash;    // CookedMeshHash of the material name, 0 without one
+	uint32_t Padding;
+	float BoundsMin[3];
+	float BoundsMax[3];
+};
+
+static_assert(sizeof(CookedMeshElement) == 12);
+static_assert(sizeof(CookedMeshHeader) == 176);
+static_assert(sizeof(CookedSubmesh) == 40);
+
+// 32-bit FNV-1a
+constexpr uint32_t CookedMeshHash(std::string_view text)
+{
+	uint32_t hash = 2166136261u;
+	for (char c : text)
+	{
+		hash ^= uint8_t(c);
+		hash *= 16777619u;
+	}
+	return hash;
+}
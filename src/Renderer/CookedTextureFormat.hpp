@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk layout of cooked textures (.ctex), shared by the TextureCooker tool and TextureManager.
+// Only depends on the standard library so the cooker's encoders can build without SDL.
+//
+//   CookedTextureHeader
+//   CookedTextureMip[MipCount]   largest first
+//   mip payloads                 each aligned to COOKED_TEXTURE_ALIGNMENT
+//
+// Payloads are tightly packed rows of 4x4 blocks (or of pixels for RGBA8), top row first,
+// which is the layout SDL_UploadToGPUTexture expects with pixels_per_row = 0.
+
+constexpr uint32_t COOKED_TEXTURE_MAGIC = 0x43545853; // "SXTC"
+constexpr uint32_t COOKED_TEXTURE_VERSION = 1;
+constexpr uint32_t COOKED_TEXTURE_ALIGNMENT = 16;
+constexpr uint32_t COOKED_TEXTURE_MAX_MIPS = 16;
+
+enum class CookedTextureFormat : uint32_t
+{
+	RGBA8 = 0,   // uncompressed fallback
+	BC1 = 1,     // RGB, 1-bit alpha, 8 bytes per block
+	BC3 = 2,     // RGBA, 16 bytes per block
+	BC7 = 3,     // RGBA, 16 bytes per block
+};
+
+// Payload is sRGB encoded, sample it through an _SRGB format
+constexpr uint32_t COOKED_TEXTURE_FLAG_SRGB = 1u << 0;
+
+struct CookedTextureHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	CookedTextureFormat Format;
+	uint32_t Flags;
+	uint32_t Width;
+	uint32_t Height;
+	uint32_t MipCount;
+	uint32_t Padding;
+	uint64_t FileSize;
+};
+
+struct CookedTextureMip
+{
+	uint32_t Offset;   // from the start of the file
+	uint32_t Size;
+	uint32_t Width;
+	uint32_t Height;
+};
+
+static_assert(sizeof(CookedTextureHeader) == 40);
+static_assert(sizeof(CookedTextureMip) == 16);
+
+constexpr bool IsBlockCompressed(CookedTextureFormat format)
+{
+	return format != CookedTextureFormat::RGBA8;
+}
+
+// Bytes per 4x4 block, or per pixel for RGBA8
+constexpr uint32_t CookedTextureElementBytes(CookedTextureFormat format)
+{
+	switch (format)
+	{
+	case CookedTextureFormat::BC1: return 8;
+	case CookedTextureFormat::BC3: return 16;
+	case CookedTextureFormat::BC7: return 16;
+	default: return 4;
+	}
+}
+
+// Pixel rows covered by one payload row
+constexpr uint32_t CookedTextureRowHeight(CookedTextureFormat format)
+{
+	return IsBlockCompressed(format) ? 4 : 1;
+}
+
+constexpr uint32_t CookedTextureRowBytes(CookedTextureFormat format, uint32_t width)
+{
+	return (IsBlockCompressed(format) ? (width + 3) / 4 : width) * CookedTextureElementBytes(format);
+}
+
+constexpr uint32_t CookedTextureRowCount(CookedTextureFormat format, uint32_t height)
+{
+	return IsBlockCompressed(format) ? (height + 3) / 4 : height;
+}
+
+constexpr uint32_t CookedTextureMipSize(CookedTextureFormat format, uint32_t width, uint32_t height)
+{
+	return CookedTextureRowBytes(format, width) * CookedTextureRowCount(format, height);
+}
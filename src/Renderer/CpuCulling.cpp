@@ -0,0 +1,315 @@
+#include "CpuCulling.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/Simd.hpp"
+#include <algorithm>
+#include <bit>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+
+namespace
+{
+	// A padding radius no plane distance can make up for
+	constexpr float CULLED_RADIUS = -FLT_MAX;
+
+	constexpr uint32_t MAX_PARALLEL_CHUNKS = 64;
+
+	struct BoundsArrays
+	{
+		const float* CenterX;
+		const float* CenterY;
+		const float* CenterZ;
+		const float* Radius;
+		const float* ExtentX;
+		const float* ExtentY;
+		const float* ExtentZ;
+	};
+
+
+	// The few operations the kernel needs, over as many lanes as the target has.
+	// Plain floats on targets without SIMD.
+#if SDLGPU_SIMD_AVX2
+	constexpr uint32_t LANE_COUNT = 8;
+	using Lanes = __m256;
+	using LaneMask = __m256;
+
+	inline Lanes Load(const float* source) { return _mm256_loadu_ps(source); }
+	inline Lanes Splat(float value) { return _mm256_set1_ps(value); }
+	inline Lanes Add(Lanes a, Lanes b) { return _mm256_add_ps(a, b); }
+	inline Lanes Mul(Lanes a, Lanes b) { return _mm256_mul_ps(a, b); }
+	inline Lanes Max(Lanes a, Lanes b) { return _mm256_max_ps(a, b); }
+	inline Lanes Negate(Lanes a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+	inline LaneMask AllLanes() { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+	inline LaneMask AndGreaterEqual(LaneMask mask, Lanes a, Lanes b) { return _mm256_and_ps(mask, _mm256_cmp_ps(a, b, _CMP_GE_OQ)); }
+	inline uint32_t MoveMask(LaneMask mask) { return uint32_t(_mm256_movemask_ps(mask)); }
+#elif SDLGPU_SIMD_SSE2
+	constexpr uint32_t LANE_COUNT = 4;
+	using Lanes = __m128;
+	using LaneMask = __m128;
+
+	inline Lanes Load(const float* source) { return _mm_loadu_ps(source); }
+	inline Lanes Splat(float value) { return _mm_set1_ps(value); }
+	inline Lanes Add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+	inline Lanes Mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+	inline Lanes Max(Lanes a, Lanes b) { return _mm_max_ps(a, b); }
+	inline Lanes Negate(Lanes a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+	inline LaneMask AllLanes() { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+	inline LaneMask AndGreaterEqual(LaneMask mask, Lanes a, Lanes b) { return _mm_and_ps(mask, _mm_cmpge_ps(a, b)); }
+	inline uint32_t MoveMask(LaneMask mask) { return uint32_t(_mm_movemask_ps(mask)); }
+#elif SDLGPU_SIMD_NEON
+	constexpr uint32_t LANE_COUNT = 4;
+	using Lanes = float32x4_t;
+	using LaneMask = uint32x4_t;
+
+	inline Lanes Load(const float* source) { return vld1q_f32(source); }
+	inline Lanes Splat(float value) { return vdupq_n_f32(value); }
+	inline Lanes Add(Lanes a, Lanes b) { return vaddq_f32(a, b); }
+	inline Lanes Mul(Lanes a, Lanes b) { return vmulq_f32(a, b); }
+	inline Lanes Max(Lanes a, Lanes b) { return vmaxq_f32(a, b); }
+	inline Lanes Negate(Lanes a) { return vnegq_f32(a); }
+	inline LaneMask AllLanes() { return vdupq_n_u32(0xFFFFFFFFu); }
+	inline LaneMask AndGreaterEqual(LaneMask mask, Lanes a, Lanes b) { return vandq_u32(mask, vcgeq_f32(a, b)); }
+
+	inline uint32_t MoveMask(LaneMask mask)
+	{
+		const uint32_t bits[4] = { 1, 2, 4, 8 };
+		return vaddvq_u32(vandq_u32(mask, vld1q_u32(bits)));
+	}
+#else
+	constexpr uint32_t LANE_COUNT = 1;
+	using Lanes = float;
+	using LaneMask = bool;
+
+	inline Lanes Load(const float* source) { return *source; }
+	inline Lanes Splat(float value) { return value; }
+	inline Lanes Add(Lanes a, Lanes b) { return a + b; }
+	inline Lanes Mul(Lanes a, Lanes b) { return a * b; }
+	inline Lanes Max(Lanes a, Lanes b) { return std::max(a, b); }
+	inline Lanes Negate(Lanes a) { return -a; }
+	inline LaneMask AllLanes() { return true; }
+	inline LaneMask AndGreaterEqual(LaneMask mask, Lanes a, Lanes b) { return mask && a >= b; }
+	inline uint32_t MoveMask(LaneMask mask) { return mask ? 1u : 0u; }
+#endif
+
+	static_assert(CpuCulling::BATCH % LANE_COUNT == 0);
+
+
+	// Frustum planes splatted once per call.
+	// The negated absolute normals project the box extents onto the plane as -radius.
+	struct PlaneLanes
+	{
+		Lanes X[Frustum::Count];
+		Lanes Y[Frustum::Count];
+		Lanes Z[Frustum::Count];
+		Lanes W[Frustum::Count];
+		Lanes NegAbsX[Frustum::Count];
+		Lanes NegAbsY[Frustum::Count];
+		Lanes NegAbsZ[Frustum::Count];
+	};
+
+	// Bit i is set when object first + i is visible.
+	// Being in front of both -radius and -box radius is being in front of the larger one.
+	template<bool TestBoxes>
+	inline uint32_t TestLanes(const PlaneLanes& planes, const BoundsArrays& bounds, uint32_t first)
+	{
+		const Lanes centerX = Load(bounds.CenterX + first);
+		const Lanes centerY = Load(bounds.CenterY + first);
+		const Lanes centerZ = Load(bounds.CenterZ + first);
+		const Lanes negRadius = Negate(Load(bounds.Radius + first));
+
+		Lanes extentX{}, extentY{}, extentZ{};
+		if constexpr (TestBoxes)
+		{
+			extentX = Load(bounds.ExtentX + first);
+			extentY = Load(bounds.ExtentY + first);
+			extentZ = Load(bounds.ExtentZ + first);
+		}
+
+		LaneMask inside = AllLanes();
+		for (int plane = 0; plane < Frustum::Count; plane++)
+		{
+			Lanes distance = Add(Add(Add(Mul(planes.X[plane], centerX), Mul(planes.Y[plane], centerY)), Mul(planes.Z[plane], centerZ)), planes.W[plane]);
+
+			Lanes threshold = negRadius;
+			if constexpr (TestBoxes)
+				threshold = Max(negRadius, Add(Add(Mul(planes.NegAbsX[plane], extentX), Mul(planes.NegAbsY[plane], extentY)), Mul(planes.NegAbsZ[plane], extentZ)));
+
+			inside = AndGreaterEqual(inside, distance, threshold);
+		}
+
+		return MoveMask(inside);
+	}
+
+	template<bool TestBoxes>
+	uint32_t CullKernel(const Frustum& frustum, const BoundsArrays& bounds, uint32_t first, uint32_t end, uint32_t* visible)
+	{
+		PlaneLanes planes;
+		for (int plane = 0; plane < Frustum::Count; plane++)
+		{
+			const glm::vec4& p = frustum.Planes[plane];
+			planes.X[plane] = Splat(p.x);
+			planes.Y[plane] = Splat(p.y);
+			planes.Z[plane] = Splat(p.z);
+			planes.W[plane] = Splat(p.w);
+			planes.NegAbsX[plane] = Splat(-std::abs(p.x));
+			planes.NegAbsY[plane] = Splat(-std::abs(p.y));
+			planes.NegAbsZ[plane] = Splat(-std::abs(p.z));
+		}
+
+		uint32_t count = 0;
+		for (uint32_t batch = first; batch < end; batch += CpuCulling::BATCH)
+		{
+			uint32_t mask = 0;
+			for (uint32_t lane = 0; lane < CpuCulling::BATCH; lane += LANE_COUNT)
+				mask |= TestLanes<TestBoxes>(planes, bounds, batch + lane) << lane;
+
+			// Compact, one store per visible object
+			while (mask)
+			{
+				visible[count++] = batch + uint32_t(std::countr_zero(mask));
+				mask &= mask - 1;
+			}
+		}
+		return count;
+	}
+}
+
+
+
+uint32_t CpuCulling::Add(const glm::vec3& center, float radius, const glm::vec3& extents)
+{
+	// Grow by a whole batch of culled padding objects
+	if (m_Count == GetPaddedCount())
+	{
+		const uint32_t padded = m_Count + BATCH;
+		m_CenterX.resize(padded, 0.0f);
+		m_CenterY.resize(padded, 0.0f);
+		m_CenterZ.resize(padded, 0.0f);
+		m_Radius.resize(padded, CULLED_RADIUS);
+		m_ExtentX.resize(padded, 0.0f);
+		m_ExtentY.resize(padded, 0.0f);
+		m_ExtentZ.resize(padded, 0.0f);
+	}
+
+	const uint32_t index = m_Count++;
+	Set(index, center, radius, extents);
+	return index;
+}
+
+uint32_t CpuCulling::AddBox(const glm::vec3& minimum, const glm::vec3& maximum)
+{
+	const glm::vec3 extents = (maximum - minimum) * 0.5f;
+	return Add(minimum + extents, glm::length(extents), extents);
+}
+
+void CpuCulling::Set(uint32_t index, const glm::vec3& center, float radius, const glm::vec3& extents)
+{
+	m_CenterX[index] = center.x;
+	m_CenterY[index] = center.y;
+	m_CenterZ[index] = center.z;
+	m_Radius[index] = radius;
+	m_ExtentX[index] = extents.x;
+	m_ExtentY[index] = extents.y;
+	m_ExtentZ[index] = extents.z;
+}
+
+uint32_t CpuCulling::Remove(uint32_t index)
+{
+	const uint32_t last = --m_Count;
+	if (index != last)
+	{
+		Set(index,
+			glm::vec3(m_CenterX[last], m_CenterY[last], m_CenterZ[last]),
+			m_Radius[last],
+			glm::vec3(m_ExtentX[last], m_ExtentY[last], m_ExtentZ[last]));
+	}
+
+	// The slot becomes padding again
+	Set(last, glm::vec3(0.0f), CULLED_RADIUS, glm::vec3(0.0f));
+	return last;
+}
+
+void CpuCulling::Clear()
+{
+	m_Count = 0;
+	for (std::vector<float>* array : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_Radius, &m_ExtentX, &m_ExtentY, &m_ExtentZ })
+		array->clear();
+}
+
+void CpuCulling::Reserve(uint32_t count)
+{
+	const uint32_t padded = (count + BATCH - 1) / BATCH * BATCH;
+	for (std::vector<float>* array : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_Radius, &m_ExtentX, &m_ExtentY, &m_ExtentZ })
+		array->reserve(padded);
+}
+
+
+
+uint32_t CpuCulling::Cull(const Frustum& frustum, uint32_t* visible, Shape shape) const
+{
+	return CullRange(frustum, 0, GetPaddedCount(), visible, shape);
+}
+
+uint32_t CpuCulling::CullParallel(JobSystem& jobs, const Frustum& frustum, uint32_t* visible, Shape shape) const
+{
+	const uint32_t padded = GetPaddedCount();
+	const uint32_t chunkCount = std::min({ jobs.GetWorkerCount() + 1, padded / PARALLEL_CHUNK, MAX_PARALLEL_CHUNKS });
+	if (chunkCount <= 1)
+		return Cull(frustum, visible, shape);
+
+	// Each chunk compacts into its own part of `visible`, starting at its first object,
+	// and the parts are moved together afterwards
+	const uint32_t chunkSize = (padded / chunkCount + BATCH - 1) / BATCH * BATCH;
+	uint32_t counts[MAX_PARALLEL_CHUNKS];
+
+	jobs.ParallelFor(chunkCount, [&](uint32_t chunk)
+	{
+		const uint32_t first = std::min(padded, chunk * chunkSize);
+		const uint32_t end = chunk + 1 == chunkCount ? padded : std::min(padded, first + chunkSize);
+		counts[chunk] = CullRange(frustum, first, end, visible + first, shape);
+	});
+
+	uint32_t count = counts[0];
+	for (uint32_t chunk = 1; chunk < chunkCount; chunk++)
+	{
+		memmove(visible + count, visible + chunk * chunkSize, counts[chunk] * sizeof(uint32_t));
+		count += counts[chunk];
+	}
+	return count;
+}
+
+uint32_t CpuCulling::CullScalar(const Frustum& frustum, uint32_t* visible, Shape shape) const
+{
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < m_Count; i++)
+	{
+		bool inside = true;
+		for (const glm::vec4& plane : frustum.Planes)
+		{
+			float distance = plane.x * m_CenterX[i] + plane.y * m_CenterY[i] + plane.z * m_CenterZ[i] + plane.w;
+			if (distance < -m_Radius[i])
+				inside = false;
+
+			float boxRadius = std::abs(plane.x) * m_ExtentX[i] + std::abs(plane.y) * m_ExtentY[i] + std::abs(plane.z) * m_ExtentZ[i];
+			if (shape == Shape::SphereAndBox && distance < -boxRadius)
+				inside = false;
+		}
+
+		if (inside)
+			visible[count++] = i;
+	}
+	return count;
+}
+
+uint32_t CpuCulling::CullRange(const Frustum& frustum, uint32_t first, uint32_t end, uint32_t* visible, Shape shape) const
+{
+	const BoundsArrays bounds{
+		m_CenterX.data(), m_CenterY.data(), m_CenterZ.data(), m_Radius.data(),
+		m_ExtentX.data(), m_ExtentY.data(), m_ExtentZ.data()
+	};
+
+	if (shape == Shape::SphereAndBox)
+		return CullKernel<true>(frustum, bounds, first, end, visible);
+	return CullKernel<false>(frustum, bounds, first, end, visible);
+}
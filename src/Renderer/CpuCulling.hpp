@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Core/Frustum.hpp"
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+
+
+// Frustum culling on the CPU, for draw lists that are built on the CPU anyway.
+// Every object has a bounding sphere and an axis-aligned box around the same center.
+// They are stored as structure of arrays, one array per component, so the kernels load
+// 4 (SSE2/NEON) or 8 (AVX2) objects of one component at once and test them against the
+// six planes without shuffling. The result is a compact list of visible indices.
+//
+// The arrays are padded to a multiple of BATCH with objects that are always culled,
+// so the kernels have no tail loop.
+class CpuCulling
+{
+	public:
+		static constexpr uint32_t BATCH = 16;                    // objects per kernel iteration
+		static constexpr uint32_t PARALLEL_CHUNK = 64u * 1024u;  // fewest objects worth a job
+
+		enum class Shape
+		{
+			Sphere,          // one radius per plane, reads 16 bytes per object
+			SphereAndBox,    // culled when either the sphere or the box is outside, 28 bytes per object
+		};
+
+		// Returns the object's index, stable until a Remove moves it
+		uint32_t Add(const glm::vec3& center, float radius, const glm::vec3& extents);
+
+		// Box from its corners, with the sphere around it
+		uint32_t AddBox(const glm::vec3& minimum, const glm::vec3& maximum);
+
+		void Set(uint32_t index, const glm::vec3& center, float radius, const glm::vec3& extents);
+
+		// Moves the last object into the freed slot and returns its old index
+		uint32_t Remove(uint32_t index);
+
+		void Clear();
+		void Reserve(uint32_t count);
+
+		uint32_t GetCount() const { return m_Count; }
+
+		// Writes the indices of the objects intersecting the frustum in ascending order and
+		// returns how many there are. `visible` needs room for GetCount() indices.
+		uint32_t Cull(const Frustum& frustum, uint32_t* visible, Shape shape = Shape::Sphere) const;
+
+		// Cull split over the job system, with the same result
+		uint32_t CullParallel(JobSystem& jobs, const Frustum& frustum, uint32_t* visible, Shape shape = Shape::Sphere) const;
+
+		// One object at a time in plain C++, the reference the SIMD kernels are checked against
+		uint32_t CullScalar(const Frustum& frustum, uint32_t* visible, Shape shape = Shape::Sphere) const;
+
+	private:
+		uint32_t m_Count{0};
+
+		std::vector<float> m_CenterX;
+		std::vector<float> m_CenterY;
+		std::vector<float> m_CenterZ;
+		std::vector<float> m_Radius;
+		std::vector<float> m_ExtentX;
+		std::vector<float> m_ExtentY;
+		std::vector<float> m_ExtentZ;
+
+		// Culls the objects in [first, end), both multiples of BATCH
+		uint32_t CullRange(const Frustum& frustum, uint32_t first, uint32_t end, uint32_t* visible, Shape shape) const;
+
+		uint32_t GetPaddedCount() const { return uint32_t(m_Radius.size()); }
+};
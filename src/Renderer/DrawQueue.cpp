@@ -0,0 +1,190 @@
+#include "DrawQueue.hpp"
+#include <array>
+#include <span>
+
+
+void DrawQueue::Sort(std::pmr::memory_resource* scratch)
+{
+	const uint32_t count = static_cast<uint32_t>(m_Items.size());
+	if (count < 2)
+		return;
+
+	std::pmr::vector<KeyIndex> keys(count, scratch);
+	std::pmr::vector<KeyIndex> keysScratch(count, scratch);
+
+	for (uint32_t i = 0; i < count; i++)
+		keys[i] = { m_Items[i].SortKey, i };
+
+	// LSD radix sort on (key, index) pairs, one byte per pass.
+	// All eight histograms are built in a single sweep over the keys.
+	std::array<std::array<uint32_t, 256>, 8> histograms{};
+	for (const KeyIndex& entry : keys)
+	{
+		for (uint32_t byte = 0; byte < 8; byte++)
+			histograms[byte][(entry.Key >> (byte * 8)) & 0xFF]++;
+	}
+
+	KeyIndex* source = keys.data();
+	KeyIndex* destination = keysScratch.data();
+
+	for (uint32_t byte = 0; byte < 8; byte++)
+	{
+		std::array<uint32_t, 256>& histogram = histograms[byte];
+
+		// Every key has the same value in this byte, nothing to reorder
+		if (histogram[(source[0].Key >> (byte * 8)) & 0xFF] == count)
+			continue;
+
+		uint32_t sum = 0;
+		for (uint32_t& bucket : histogram)
+		{
+			uint32_t bucketCount = bucket;
+			bucket = sum;
+			sum += bucketCount;
+		}
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const KeyIndex& entry = source[i];
+			destination[histogram[(entry.Key >> (byte * 8)) & 0xFF]++] = entry;
+		}
+
+		std::swap(source, destination);
+	}
+
+	// Gather the items in sorted order
+	m_ItemsScratch.resize(count);
+	for (uint32_t i = 0; i < count; i++)
+		m_ItemsScratch[i] = m_Items[source[i].Index];
+
+	m_Items.swap(m_ItemsScratch);
+}
+
+void DrawQueue::Record(SDL_GPURenderPass* renderPass, DrawStats& stats, size_t first, size_t count) const
+{
+	SDL_GPUGraphicsPipeline* boundPipeline = nullptr;
+	SDL_GPUBufferBinding boundVertexBuffer{};
+	SDL_GPUBufferBinding boundInstanceBuffer{};
+	SDL_GPUBuffer* boundStorageBuffer = nullptr;
+	SDL_GPUTextureSamplerBinding boundTexture{};
+	SDL_GPUBufferBinding boundIndexBuffer{};
+	SDL_GPUIndexElementSize boundIndexElementSize{SDL_GPU_INDEXELEMENTSIZE_32BIT};
+
+	for (const DrawItem& item : std::span(m_Items).subspan(first, count))
+	{
+		if (item.Pipeline != boundPipeline)
+		{
+			SDL_BindGPUGraphicsPipeline(renderPass, item.Pipeline);
+			boundPipeline = item.Pipeline;
+			stats.PipelineBinds++;
+		}
+		else
+		{
+			stats.PipelineBindsSkipped++;
+		}
+
+		if (item.VertexBuffer)
+		{
+			if (item.VertexBuffer != boundVertexBuffer.buffer || item.VertexBufferOffset != boundVertexBuffer.offset)
+			{
+				boundVertexBuffer.buffer = item.VertexBuffer;
+				boundVertexBuffer.offset = item.VertexBufferOffset;
+
+				SDL_BindGPUVertexBuffers(renderPass, 0, &boundVertexBuffer, 1);
+				stats.VertexBufferBinds++;
+			}
+			else
+			{
+				stats.VertexBufferBindsSkipped++;
+			}
+		}
+
+		if (item.InstanceBuffer)
+		{
+			if (item.InstanceBuffer != boundInstanceBuffer.buffer || item.InstanceBufferOffset != boundInstanceBuffer.offset)
+			{
+				boundInstanceBuffer.buffer = item.InstanceBuffer;
+				boundInstanceBuffer.offset = item.InstanceBufferOffset;
+
+				SDL_BindGPUVertexBuffers(renderPass, 1, &boundInstanceBuffer, 1);
+				stats.VertexBufferBinds++;
+			}
+			else
+			{
+				stats.VertexBufferBindsSkipped++;
+			}
+		}
+
+		if (item.VertexStorageBuffer)
+		{
+			if (item.VertexStorageBuffer != boundStorageBuffer)
+			{
+				boundStorageBuffer = item.VertexStorageBuffer;
+
+				SDL_BindGPUVertexStorageBuffers(renderPass, 0, &boundStorageBuffer, 1);
+				stats.StorageBufferBinds++;
+			}
+			else
+			{
+				stats.StorageBufferBindsSkipped++;
+			}
+		}
+
+		if (item.Texture)
+		{
+			if (item.Texture != boundTexture.texture || item.Sampler != boundTexture.sampler)
+			{
+				boundTexture.texture = item.Texture;
+				boundTexture.sampler = item.Sampler;
+
+				SDL_BindGPUFragmentSamplers(renderPass, 0, &boundTexture, 1);
+				stats.TextureBinds++;
+			}
+			else
+			{
+				stats.TextureBindsSkipped++;
+			}
+		}
+
+		if (item.IndexBuffer)
+		{
+			if (item.IndexBuffer != boundIndexBuffer.buffer || item.IndexBufferOffset != boundIndexBuffer.offset ||
+				item.IndexElementSize != boundIndexElementSize)
+			{
+				boundIndexBuffer.buffer = item.IndexBuffer;
+				boundIndexBuffer.offset = item.IndexBufferOffset;
+				boundIndexElementSize = item.IndexElementSize;
+
+				SDL_BindGPUIndexBuffer(renderPass, &boundIndexBuffer, boundIndexElementSize);
+				stats.IndexBufferBinds++;
+			}
+			else
+			{
+				stats.IndexBufferBindsSkipped++;
+			}
+
+			if (item.IndirectBuffer)
+				SDL_DrawGPUIndexedPrimitivesIndirect(renderPass, item.IndirectBuffer, item.IndirectOffset, item.IndirectDrawCount);
+			else
+				SDL_DrawGPUIndexedPrimitives(renderPass, item.IndexCount, item.InstanceCount, item.FirstIndex, item.VertexOffset, item.FirstInstance);
+		}
+		else
+		{
+			if (item.IndirectBuffer)
+				SDL_DrawGPUPrimitivesIndirect(renderPass, item.IndirectBuffer, item.IndirectOffset, item.IndirectDrawCount);
+			else
+				SDL_DrawGPUPrimitives(renderPass, item.VertexCount, item.InstanceCount, item.FirstVertex, item.FirstInstance);
+		}
+
+		// Indirect counts live on the GPU, only the submitted commands are known here
+		if (item.IndirectBuffer)
+		{
+			stats.IndirectDraws += item.IndirectDrawCount;
+		}
+		else
+		{
+			stats.Draws++;
+			stats.Instances += item.InstanceCount;
+		}
+	}
+}
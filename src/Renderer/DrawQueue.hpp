@@ -0,0 +1,136 @@
+#pragma once
+
+#include "common.hpp"
+#include <memory_resource>
+#include <SDL3/SDL_gpu.h>
+
+
+// One queued draw. The sort key decides the order draws are recorded in,
+// so draws sharing state end up next to each other.
+struct DrawItem
+{
+	uint64_t SortKey{0};
+
+	SDL_GPUGraphicsPipeline* Pipeline{nullptr};
+	SDL_GPUBuffer* VertexBuffer{nullptr};
+	uint32_t VertexBufferOffset{0};
+
+	// Indexed draws set an index buffer, VertexCount/FirstVertex are ignored then
+	SDL_GPUBuffer* IndexBuffer{nullptr};
+	uint32_t IndexBufferOffset{0};
+	SDL_GPUIndexElementSize IndexElementSize{SDL_GPU_INDEXELEMENTSIZE_32BIT};
+
+	// Per-instance data, either an instance-rate vertex buffer on slot 1
+	// or a vertex storage buffer on slot 0 indexed by SV_InstanceID
+	SDL_GPUBuffer* InstanceBuffer{nullptr};
+	uint32_t InstanceBufferOffset{0};
+	SDL_GPUBuffer* VertexStorageBuffer{nullptr};
+
+	// Fragment texture and sampler on sampler slot 0
+	SDL_GPUTexture* Texture{nullptr};
+	SDL_GPUSampler* Sampler{nullptr};
+
+	uint32_t VertexCount{0};
+	uint32_t InstanceCount{1};
+	uint32_t FirstVertex{0};
+	uint32_t FirstInstance{0};
+
+	uint32_t IndexCount{0};
+	uint32_t FirstIndex{0};
+	int32_t VertexOffset{0};
+
+	// Indirect draws read IndirectDrawCount commands from this buffer instead of the
+	// counts above. Indexed ones expect SDL_GPUIndexedIndirectDrawCommand entries.
+	SDL_GPUBuffer* IndirectBuffer{nullptr};
+	uint32_t IndirectOffset{0};
+	uint32_t IndirectDrawCount{0};
+};
+
+
+// Per-frame draw counters
+struct DrawStats
+{
+	uint32_t Draws{0};
+	uint32_t PipelineBinds{0};
+	uint32_t PipelineBindsSkipped{0};
+	uint32_t VertexBufferBinds{0};
+	uint32_t VertexBufferBindsSkipped{0};
+	uint32_t IndexBufferBinds{0};
+	uint32_t IndexBufferBindsSkipped{0};
+	uint32_t StorageBufferBinds{0};
+	uint32_t StorageBufferBindsSkipped{0};
+	uint32_t TextureBinds{0};
+	uint32_t TextureBindsSkipped{0};
+	uint32_t Instances{0};
+	uint32_t IndirectDraws{0};     // commands submitted through indirect buffers
+	uint32_t Dispatches{0};
+	uint32_t RecordChunks{0};      // command buffers the draws were recorded into in parallel
+	uint32_t HotPathAllocations{0}; // heap allocations while recording, needs SDLGPU_TRACK_ALLOCATIONS
+};
+
+
+class DrawQueue
+{
+	public:
+		// Values of the key's pass field, passes are recorded in this order
+		static constexpr uint8_t PASS_DEPTH_PREPASS = 0;   // position-only draws filling the depth buffer
+		static constexpr uint8_t PASS_MAIN = 1;
+		static constexpr uint8_t PASS_TRANSPARENT = 2;     // blended draws over everything opaque
+
+		// Sort key layout, most significant first:
+		// pass (4) | pipeline (12) | vertex/index buffer (12) | material (12) | depth (24)
+		// Pipeline and buffer ids are handed out by SortKey.hpp
+		static constexpr uint64_t MakeKey(uint8_t pass, uint16_t pipeline, uint16_t buffer, uint16_t material, uint32_t depth)
+		{
+			return (uint64_t(pass & 0xF) << 60) |
+				(uint64_t(pipeline & 0xFFF) << 48) |
+				(uint64_t(buffer & 0xFFF) << 36) |
+				(uint64_t(material & 0xFFF) << 24) |
+				uint64_t(depth & 0xFFFFFF);
+		}
+
+		// Quantizes a view depth in [0, 1] to the 24 key bits, `invert` sorts far to near
+		static constexpr uint32_t QuantizeDepth(float depth, bool invert = false)
+		{
+			depth = depth < 0.0f ? 0.0f : (depth > 1.0f ? 1.0f : depth);
+			uint32_t quantized = uint32_t(depth * float(0xFFFFFF));
+			return invert ? 0xFFFFFF - quantized : quantized;
+		}
+
+		// Replaces the pass and depth fields of `key`, keeping its state fields
+		static constexpr uint64_t WithPassAndDepth(uint64_t key, uint8_t pass, uint32_t depth)
+		{
+			return (key & 0x0FFFFFFFFF000000ull) | MakeKey(pass, 0, 0, 0, depth);
+		}
+
+		void Clear() { m_Items.clear(); }
+		void Submit(const DrawItem& item) { m_Items.push_back(item); }
+
+		bool Empty() const { return m_Items.empty(); }
+		size_t Size() const { return m_Items.size(); }
+
+		// Radix sorts the queued items by key, stable for equal keys.
+		// The key arrays are temporary and come from `scratch`, usually the frame arena.
+		void Sort(std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+		// Records the sorted items into `renderPass`, skipping redundant binds
+		void Record(SDL_GPURenderPass* renderPass, DrawStats& stats) const { Record(renderPass, stats, 0, m_Items.size()); }
+
+		// Records `count` items starting at `first`. Only reads the queue, so disjoint
+		// ranges can be recorded on several threads at once.
+		void Record(SDL_GPURenderPass* renderPass, DrawStats& stats, size_t first, size_t count) const;
+
+		const std::vector<DrawItem>& GetItems() const { return m_Items; }
+
+	private:
+		struct KeyIndex
+		{
+			uint64_t Key;
+			uint32_t Index;
+		};
+
+		std::vector<DrawItem> m_Items;
+
+		// Swapped with m_Items after sorting, kept around so steady-state frames don't allocate
+		std::vector<DrawItem> m_ItemsScratch;
+};
@@ -0,0 +1,69 @@
+#include "FramePacer.hpp"
+#include "Core/Percentile.hpp"
+#include <algorithm>
+#include <array>
+
+
+void FramePacer::SetTargetFrameRate(double framesPerSecond)
+{
+	m_TargetFrameRate = framesPerSecond > 0.0 ? framesPerSecond : 0.0;
+	m_IntervalNS = m_TargetFrameRate > 0.0 ? uint64_t(1e9 / m_TargetFrameRate) : 0;
+	m_NextFrameNS = 0;
+}
+
+void FramePacer::WaitForNextFrame()
+{
+	uint64_t now = SDL_GetTicksNS();
+
+	if (m_IntervalNS && m_NextFrameNS > now)
+	{
+		const uint64_t remaining = m_NextFrameNS - now;
+		if (remaining > m_SpinThresholdNS)
+			SDL_DelayNS(remaining - m_SpinThresholdNS);
+
+		while ((now = SDL_GetTicksNS()) < m_NextFrameNS)
+		{
+		}
+	}
+
+	if (m_IntervalNS)
+	{
+		// Keep the cadence when slightly late, restart it after a long stall
+		// instead of rushing frames out to catch up
+		m_NextFrameNS += m_IntervalNS;
+		if (m_NextFrameNS <= now)
+			m_NextFrameNS = now + m_IntervalNS;
+	}
+
+	if (m_LastFrameNS)
+	{
+		m_History[m_HistoryNext] = now - m_LastFrameNS;
+		m_HistoryNext = (m_HistoryNext + 1) % HISTORY_SIZE;
+		m_HistoryCount = std::min(m_HistoryCount + 1, HISTORY_SIZE);
+	}
+	m_LastFrameNS = now;
+}
+
+FrameTimeStats FramePacer::GetStats() const
+{
+	FrameTimeStats stats{};
+	stats.Frames = m_HistoryCount;
+	stats.SkippedFrames = m_SkippedFrames;
+	if (!m_HistoryCount)
+		return stats;
+
+	std::array<uint64_t, HISTORY_SIZE> sorted;
+	std::copy_n(m_History, m_HistoryCount, sorted.begin());
+	std::sort(sorted.begin(), sorted.begin() + m_HistoryCount);
+
+	uint64_t total = 0;
+	for (uint32_t i = 0; i < m_HistoryCount; i++)
+		total += sorted[i];
+
+	stats.AverageMS = total / 1e6 / m_HistoryCount;
+	stats.P50MS = NearestRankPercentileMS(sorted.data(), m_HistoryCount, 0.50);
+	stats.P95MS = NearestRankPercentileMS(sorted.data(), m_HistoryCount, 0.95);
+	stats.P99MS = NearestRankPercentileMS(sorted.data(), m_HistoryCount, 0.99);
+	stats.MaxMS = sorted[m_HistoryCount - 1] / 1e6;
+	return stats;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "common.hpp"
+#include <SDL3/SDL_gpu.h>
+
+
+struct FramePacingSettings
+{
+	SDL_GPUPresentMode PresentMode{SDL_GPU_PRESENTMODE_VSYNC};
+
+	// Frames the CPU may queue ahead of the GPU, 1 to MAX_FRAMES_IN_FLIGHT
+	uint32_t FramesInFlight{2};
+
+	// CPU side frame rate cap, 0 leaves pacing to the present mode
+	double TargetFrameRate{0.0};
+
+	// Wait for the previous frame to finish on the GPU before input is sampled.
+	// Trades throughput for the shortest input to photon path.
+	bool LowLatency{false};
+};
+
+struct FrameTimeStats
+{
+	uint32_t Frames{0};        // frames in the history window
+	uint32_t SkippedFrames{0}; // frames without a swapchain texture, since start
+	double AverageMS{0.0};
+	double P50MS{0.0};
+	double P95MS{0.0};
+	double P99MS{0.0};
+	double MaxMS{0.0};
+};
+
+
+// CPU frame limiter and frame time history.
+// Waits sleep for most of the remaining interval and spin for the rest,
+// since OS sleeps routinely overshoot by a millisecond or more.
+class FramePacer
+{
+	public:
+		static constexpr uint32_t HISTORY_SIZE = 512;
+		static constexpr uint64_t DEFAULT_SPIN_THRESHOLD_NS = 2'000'000;
+
+		FramePacer() = default;
+		virtual ~FramePacer() = default;
+
+		void SetTargetFrameRate(double framesPerSecond);
+		double GetTargetFrameRate() const { return m_TargetFrameRate; }
+
+		// How long before the deadline sleeping stops and spinning starts
+		void SetSpinThreshold(uint64_t nanoseconds) { m_SpinThresholdNS = nanoseconds; }
+
+		// Blocks until the next frame is due and records the previous frame's duration
+		void WaitForNextFrame();
+
+		void MarkSkipped() { m_SkippedFrames++; }
+
+		// Percentiles over the last HISTORY_SIZE frames
+		FrameTimeStats GetStats() const;
+
+	private:
+		double m_TargetFrameRate{0.0};
+		uint64_t m_IntervalNS{0};
+		uint64_t m_SpinThresholdNS{DEFAULT_SPIN_THRESHOLD_NS};
+
+		uint64_t m_NextFrameNS{0};
+		uint64_t m_LastFrameNS{0};
+
+		uint64_t m_History[HISTORY_SIZE]{};
+		uint32_t m_HistoryCount{0};
+		uint32_t m_HistoryNext{0};
+		uint32_t m_SkippedFrames{0};
+};
@@ -0,0 +1,337 @@
+#include "GpuBufferPool.hpp"
+#include "SortKey.hpp"
+#include "Core/FrameArena.hpp"
+#include "Core/Profiler.hpp"
+#include <algorithm>
+
+GpuBufferPool::GpuBufferPool(SDL_GPUDevice* device, UploadManager* uploader, SDL_GPUBufferUsageFlags usage, uint32_t elementSize, uint32_t blockElementCount)
+{
+	m_Device = device;
+	m_Uploader = uploader;
+	m_Usage = usage;
+	m_ElementSize = elementSize;
+	m_BlockElementCount = blockElementCount;
+
+	if (elementSize == 0 || blockElementCount == 0 || uint64_t(elementSize) * blockElementCount > UINT32_MAX)
+	{
+		SDLException("Invalid GPU buffer pool block size");
+		return;
+	}
+
+	CreateBlock(blockElementCount);
+}
+
+GpuBufferPool::~GpuBufferPool()
+{
+}
+
+void GpuBufferPool::Cleanup()
+{
+	for (Block& block : m_Blocks)
+	{
+		if (block.Buffer)
+		{
+			SDL_ReleaseGPUBuffer(m_Device, block.Buffer);
+			block.Buffer = nullptr;
+		}
+	}
+
+	m_Blocks.clear();
+	m_Allocations.clear();
+	m_FreeAllocationIds.clear();
+	m_PendingFrees.clear();
+}
+
+
+
+uint32_t GpuBufferPool::Allocate(uint32_t count)
+{
+	if (count == 0 || uint64_t(count) * m_ElementSize > UINT32_MAX)
+	{
+		SDLException("GPU buffer pool allocation does not fit into a GPU buffer");
+		return INVALID_ALLOCATION;
+	}
+
+	RetireFrees();
+
+	// First fit over the blocks, a new block only when none has room
+	uint32_t blockIndex = 0;
+	TlsfAllocator::Allocation range{};
+	for (; blockIndex < m_Blocks.size(); blockIndex++)
+	{
+		if (!m_Blocks[blockIndex].Buffer)
+			continue;
+
+		range = m_Blocks[blockIndex].Allocator.Allocate(count);
+		if (range.IsValid())
+			break;
+	}
+
+	// Allocations larger than a block get a dedicated one, released like any other once empty
+	if (!range.IsValid())
+	{
+		blockIndex = CreateBlock(std::max(count, m_BlockElementCount));
+		if (blockIndex == UINT32_MAX)
+			return INVALID_ALLOCATION;
+
+		range = m_Blocks[blockIndex].Allocator.Allocate(count);
+	}
+
+	uint32_t id;
+	if (!m_FreeAllocationIds.empty())
+	{
+		id = m_FreeAllocationIds.back();
+		m_FreeAllocationIds.pop_back();
+	}
+	else
+	{
+		id = uint32_t(m_Allocations.size());
+		m_Allocations.emplace_back();
+	}
+
+	m_Allocations[id] = Allocation{ blockIndex, range.Node, range.Offset, count };
+	return id;
+}
+
+void GpuBufferPool::Free(uint32_t allocation)
+{
+	if (allocation >= m_Allocations.size() || m_Allocations[allocation].Node == TlsfAllocator::INVALID_NODE)
+		return;
+
+	// Draws recorded this frame may still read the range
+	Allocation& freed = m_Allocations[allocation];
+	m_PendingFrees.push_back(PendingFree{ freed.Block, freed.Node, m_Uploader->GetFrameSerial() });
+
+	freed = Allocation{};
+	m_FreeAllocationIds.push_back(allocation);
+}
+
+void GpuBufferPool::Upload(uint32_t allocation, const void* data, uint32_t count, uint32_t first)
+{
+	SDLGPU_PROFILE_ZONE("GpuBufferPool::Upload");
+
+	if (allocation >= m_Allocations.size() || m_Allocations[allocation].Node == TlsfAllocator::INVALID_NODE)
+	{
+		SDLException("Invalid GPU buffer pool allocation");
+		return;
+	}
+
+	const Allocation& target = m_Allocations[allocation];
+	// Written so it cannot wrap around in 32 bits
+	if (count > target.Count || first > target.Count - count)
+	{
+		SDLException("GPU buffer pool upload out of range");
+		return;
+	}
+
+	// Never cycled, the buffer holds other allocations as well
+	m_Uploader->UploadToBuffer(m_Blocks[target.Block].Buffer, (target.Offset + first) * m_ElementSize, data, count * m_ElementSize, false);
+}
+
+GpuBufferRange GpuBufferPool::GetRange(uint32_t allocation) const
+{
+	if (allocation >= m_Allocations.size() || m_Allocations[allocation].Node == TlsfAllocator::INVALID_NODE)
+		return {};
+
+	const Allocation& found = m_Allocations[allocation];
+	const Block& block = m_Blocks[found.Block];
+	return { block.Buffer, found.Offset, found.Count, block.Id };
+}
+
+
+
+uint32_t GpuBufferPool::Defragment(uint64_t maxBytes)
+{
+	SDLGPU_PROFILE_ZONE("GpuBufferPool::Defragment");
+
+	RetireFrees();
+
+	// Back to front, so the allocations furthest out move first
+	FrameArena::Scope scratch(GetThreadArena());
+	std::pmr::vector<uint32_t> order(&GetThreadArena());
+	order.reserve(m_Allocations.size());
+	for (uint32_t id = 0; id < m_Allocations.size(); id++)
+	{
+		if (m_Allocations[id].Node != TlsfAllocator::INVALID_NODE)
+			order.push_back(id);
+	}
+
+	std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+	{
+		const Allocation& first = m_Allocations[a];
+		const Allocation& second = m_Allocations[b];
+		return first.Block != second.Block ? first.Block > second.Block : first.Offset > second.Offset;
+	});
+
+	SDL_GPUCommandBuffer* commandBuffer = nullptr;
+	SDL_GPUCopyPass* copyPass = nullptr;
+
+	uint32_t moves = 0;
+	uint64_t movedBytes = 0;
+
+	for (uint32_t id : order)
+	{
+		Allocation& moved = m_Allocations[id];
+		uint64_t bytes = uint64_t(moved.Count) * m_ElementSize;
+		if (movedBytes + bytes > maxBytes)
+			break;
+
+		// Look for a free range in an earlier block, or earlier in the same one. Old ranges
+		// stay reserved until the copies have run, so sources and destinations never overlap.
+		uint32_t blockIndex = 0;
+		TlsfAllocator::Allocation range{};
+		for (; blockIndex <= moved.Block; blockIndex++)
+		{
+			Block& block = m_Blocks[blockIndex];
+			if (!block.Buffer)
+				continue;
+
+			range = block.Allocator.Allocate(moved.Count);
+			if (!range.IsValid())
+				continue;
+
+			if (blockIndex < moved.Block || range.Offset < moved.Offset)
+				break;
+
+			block.Allocator.Free(range.Node);
+			range = {};
+		}
+
+		if (!range.IsValid())
+			continue;
+
+		if (!copyPass)
+		{
+			// Uploads queued for the old locations have to land before they are copied
+			m_Uploader->FlushNow(false);
+
+			commandBuffer = SDL_AcquireGPUCommandBuffer(m_Device);
+			if (!commandBuffer)
+			{
+				m_Blocks[blockIndex].Allocator.Free(range.Node);
+				SDLException("Failed to acquire GPU command buffer for defragmentation");
+				return moves;
+			}
+			copyPass = SDL_BeginGPUCopyPass(commandBuffer);
+		}
+
+		SDL_GPUBufferLocation source{};
+		source.buffer = m_Blocks[moved.Block].Buffer;
+		source.offset = moved.Offset * m_ElementSize;
+
+		SDL_GPUBufferLocation destination{};
+		destination.buffer = m_Blocks[blockIndex].Buffer;
+		destination.offset = range.Offset * m_ElementSize;
+
+		SDL_CopyGPUBufferToBuffer(copyPass, &source, &destination, uint32_t(bytes), false);
+
+		// Submitted after the current frame's draws were recorded, so the next frame's fence covers the copy
+		m_PendingFrees.push_back(PendingFree{ moved.Block, moved.Node, m_Uploader->GetFrameSerial() + 1 });
+
+		moved.Block = blockIndex;
+		moved.Node = range.Node;
+		moved.Offset = range.Offset;
+
+		moves++;
+		movedBytes += bytes;
+	}
+
+	if (copyPass)
+	{
+		SDL_EndGPUCopyPass(copyPass);
+		if (!SDL_SubmitGPUCommandBuffer(commandBuffer))
+			SDLException("Failed to submit defragmentation command buffer");
+	}
+
+	m_MovedAllocations += moves;
+	m_MovedBytes += movedBytes;
+	return moves;
+}
+
+GpuBufferPoolStats GpuBufferPool::GetStats() const
+{
+	GpuBufferPoolStats stats{};
+	stats.PendingFrees = uint32_t(m_PendingFrees.size());
+	stats.MovedAllocations = m_MovedAllocations;
+	stats.MovedBytes = m_MovedBytes;
+
+	for (const Block& block : m_Blocks)
+	{
+		if (!block.Buffer)
+			continue;
+
+		stats.Blocks++;
+		stats.ReservedBytes += uint64_t(block.Allocator.GetCapacity()) * m_ElementSize;
+		stats.UsedBytes += uint64_t(block.Allocator.GetUsed()) * m_ElementSize;
+		stats.FreeBytes += uint64_t(block.Allocator.GetFree()) * m_ElementSize;
+		stats.LargestFreeBytes = std::max(stats.LargestFreeBytes, uint64_t(block.Allocator.GetLargestFree()) * m_ElementSize);
+		stats.FreeRanges += block.Allocator.GetFreeRangeCount();
+	}
+
+	// Pending frees are still counted as used by their blocks
+	stats.Allocations = uint32_t(m_Allocations.size() - m_FreeAllocationIds.size());
+
+	if (stats.FreeBytes > 0)
+		stats.Fragmentation = 1.0f - float(double(stats.LargestFreeBytes) / double(stats.FreeBytes));
+
+	return stats;
+}
+
+
+
+uint32_t GpuBufferPool::CreateBlock(uint32_t elementCount)
+{
+	SDL_GPUBufferCreateInfo bufferCreateInfo{};
+	bufferCreateInfo.size = elementCount * m_ElementSize;
+	bufferCreateInfo.usage = m_Usage;
+
+	SDL_GPUBuffer* buffer = SDL_CreateGPUBuffer(m_Device, &bufferCreateInfo);
+	if (!buffer)
+	{
+		SDLException("Failed to create GPU buffer pool block");
+		return UINT32_MAX;
+	}
+
+	// Reuse the slot of a released block so block indices stay small
+	auto released = std::find_if(m_Blocks.begin(), m_Blocks.end(), [](const Block& block) { return !block.Buffer; });
+	if (released == m_Blocks.end())
+		released = m_Blocks.emplace(m_Blocks.end());
+
+	released->Buffer = buffer;
+	released->Allocator.Reset(elementCount);
+	released->Id = SortKey::NextBufferId();
+
+	return uint32_t(released - m_Blocks.begin());
+}
+
+void GpuBufferPool::RetireFrees()
+{
+	if (m_PendingFrees.empty())
+		return;
+
+	uint64_t completed = m_Uploader->GetCompletedSerial();
+	std::erase_if(m_PendingFrees, [&](const PendingFree& pending)
+	{
+		if (pending.FrameSerial > completed)
+			return false;
+
+		m_Blocks[pending.Block].Allocator.Free(pending.Node);
+		return true;
+	});
+
+	// Keep one block around, release the others once nothing lives in them
+	uint32_t liveBlocks = uint32_t(std::count_if(m_Blocks.begin(), m_Blocks.end(), [](const Block& block) { return block.Buffer != nullptr; }));
+	for (Block& block : m_Blocks)
+	{
+		if (liveBlocks <= 1)
+			break;
+
+		if (block.Buffer && block.Allocator.GetAllocationCount() == 0)
+		{
+			// SDL holds on to the buffer until frames in flight are done with it
+			SDL_ReleaseGPUBuffer(m_Device, block.Buffer);
+			block.Buffer = nullptr;
+			liveBlocks--;
+		}
+	}
+}
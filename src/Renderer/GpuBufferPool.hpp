@@ -0,0 +1,114 @@
+#pragma once
+#include "common.hpp"
+#include "Core/TlsfAllocator.hpp"
+#include "Renderer/UploadManager.hpp"
+#include <SDL3/SDL_gpu.h>
+
+// Where an allocation currently lives. Offsets and counts are in elements,
+// so a vertex range can be drawn with firstVertex/vertex_offset directly.
+struct GpuBufferRange
+{
+    SDL_GPUBuffer* Buffer{nullptr};
+    uint32_t Offset{0};
+    uint32_t Count{0};
+    uint16_t BufferId{0};   // small id used in draw sort keys
+};
+
+struct GpuBufferPoolStats
+{
+    uint32_t Blocks{0};
+    uint32_t Allocations{0};
+    uint32_t PendingFrees{0};       // freed, waiting for frames in flight
+    uint64_t ReservedBytes{0};
+    uint64_t UsedBytes{0};
+    uint64_t FreeBytes{0};
+    uint64_t LargestFreeBytes{0};   // largest single free range over all blocks
+    uint32_t FreeRanges{0};
+
+    // 0 when all free space is one range, approaching 1 as it splinters
+    float Fragmentation{0.0f};
+
+    uint64_t MovedAllocations{0};   // by Defragment, since creation
+    uint64_t MovedBytes{0};
+};
+
+// Packs many small allocations into a few large GPU buffers.
+// Each block is one SDL_GPUBuffer of `blockElementCount` elements managed by a
+// TLSF allocator, new blocks are reserved when the existing ones are full.
+// An allocation larger than that gets a block of its own sized to fit it.
+// Allocations are referred to by id since Defragment can move them; resolve the
+// id with GetRange when recording a draw.
+class GpuBufferPool
+{
+    public:
+        static constexpr uint32_t INVALID_ALLOCATION = UINT32_MAX;
+
+        GpuBufferPool(SDL_GPUDevice* device, UploadManager* uploader, SDL_GPUBufferUsageFlags usage, uint32_t elementSize, uint32_t blockElementCount);
+        virtual ~GpuBufferPool();
+
+        void Cleanup();
+
+        // Reserves `count` elements. Throws if they do not fit into a 32-bit buffer size.
+        uint32_t Allocate(uint32_t count);
+
+        // The range is reused once every frame recorded so far has finished on the GPU
+        void Free(uint32_t allocation);
+
+        // Stages `count` elements into the allocation starting at element `first`
+        void Upload(uint32_t allocation, const void* data, uint32_t count, uint32_t first = 0);
+
+        GpuBufferRange GetRange(uint32_t allocation) const;
+
+        // Moves allocations towards the front of the pool with GPU-to-GPU copies, at most
+        // `maxBytes` per call so it can run a little every frame. Blocks left empty are
+        // released once the copies have completed. Submits its own command buffer, call outside of Renderer::SubmitCommandBuffer.
+        // Returns the number of allocations moved.
+        uint32_t Defragment(uint64_t maxBytes = UINT64_MAX);
+
+        GpuBufferPoolStats GetStats() const;
+
+        uint32_t GetElementSize() const { return m_ElementSize; }
+        uint32_t GetBlockElementCount() const { return m_BlockElementCount; }
+        uint64_t GetMovedBytes() const { return m_MovedBytes; }
+
+    private:
+        struct Block
+        {
+            SDL_GPUBuffer* Buffer{nullptr};   // null once released
+            TlsfAllocator Allocator;
+            uint16_t Id{0};
+        };
+
+        struct Allocation
+        {
+            uint32_t Block{0};
+            uint32_t Node{TlsfAllocator::INVALID_NODE};   // INVALID_NODE if the id is unused
+            uint32_t Offset{0};
+            uint32_t Count{0};
+        };
+
+        struct PendingFree
+        {
+            uint32_t Block;
+            uint32_t Node;
+            uint64_t FrameSerial;   // safe to reuse once this frame has completed
+        };
+
+        // At least `elementCount` elements, never fewer than m_BlockElementCount
+        uint32_t CreateBlock(uint32_t elementCount);
+        void RetireFrees();
+
+        SDL_GPUDevice* m_Device{nullptr};
+        UploadManager* m_Uploader{nullptr};
+        SDL_GPUBufferUsageFlags m_Usage{0};
+        uint32_t m_ElementSize{0};
+        uint32_t m_BlockElementCount{0};
+
+        std::vector<Block> m_Blocks;
+        std::vector<Allocation> m_Allocations;
+        std::vector<uint32_t> m_FreeAllocationIds;
+        std::vector<PendingFree> m_PendingFrees;
+
+        uint64_t m_MovedAllocations{0};
+        uint64_t m_MovedBytes{0};
+};
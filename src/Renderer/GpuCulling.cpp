@@ -0,0 +1,170 @@
+#include "GpuCulling.hpp"
+#include "Renderer.hpp"
+#include <cstring>
+
+GpuCulling::GpuCulling(Renderer* renderer, uint32_t objectCapacity)
+{
+	m_Renderer = renderer;
+	m_Capacity = objectCapacity;
+
+	// Counts for loose shader files, shaders.pack carries the reflected ones
+	ComputePipelineInfo clearInfo{};
+	clearInfo.ReadWriteStorageBufferCount = 2;
+	clearInfo.UniformBufferCount = 1;
+	clearInfo.ThreadCountX = THREAD_COUNT;
+
+	ComputePipelineInfo cullInfo{};
+	cullInfo.ReadOnlyStorageBufferCount = 1;
+	cullInfo.ReadWriteStorageBufferCount = 2;
+	cullInfo.UniformBufferCount = 1;
+	cullInfo.ThreadCountX = THREAD_COUNT;
+
+	m_ClearPipeline = m_Renderer->CreateComputePipeline("CullClear.comp", clearInfo);
+	m_CullPipeline = m_Renderer->CreateComputePipeline("Cull.comp", cullInfo);
+
+	SDL_GPUBufferCreateInfo bufferCreateInfo{};
+	bufferCreateInfo.size = objectCapacity * sizeof(CullObject);
+	bufferCreateInfo.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ;
+	m_ObjectBuffer = SDL_CreateGPUBuffer(m_Renderer->Device, &bufferCreateInfo);
+
+	bufferCreateInfo.size = objectCapacity * sizeof(SDL_GPUIndexedIndirectDrawCommand);
+	bufferCreateInfo.usage = SDL_GPU_BUFFERUSAGE_INDIRECT | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE;
+	m_DrawBuffer = SDL_CreateGPUBuffer(m_Renderer->Device, &bufferCreateInfo);
+
+	bufferCreateInfo.size = sizeof(uint32_t);
+	bufferCreateInfo.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE;
+	m_CounterBuffer = SDL_CreateGPUBuffer(m_Renderer->Device, &bufferCreateInfo);
+
+	if (!m_ObjectBuffer || !m_DrawBuffer || !m_CounterBuffer)
+	{
+		SDLException("Failed to create GPU culling buffers");
+	}
+}
+
+GpuCulling::~GpuCulling()
+{
+}
+
+void GpuCulling::Cleanup()
+{
+	m_Renderer->ReleaseComputePipeline(m_ClearPipeline);
+	m_Renderer->ReleaseComputePipeline(m_CullPipeline);
+	m_ClearPipeline = nullptr;
+	m_CullPipeline = nullptr;
+
+	for (SDL_GPUBuffer** buffer : {&m_ObjectBuffer, &m_DrawBuffer, &m_CounterBuffer})
+	{
+		if (*buffer)
+		{
+			SDL_ReleaseGPUBuffer(m_Renderer->Device, *buffer);
+			*buffer = nullptr;
+		}
+	}
+
+	if (m_ReadbackBuffer)
+	{
+		SDL_ReleaseGPUTransferBuffer(m_Renderer->Device, m_ReadbackBuffer);
+		m_ReadbackBuffer = nullptr;
+	}
+}
+
+void GpuCulling::SetObjects(std::span<const CullObject> objects)
+{
+	if (objects.size() > m_Capacity)
+	{
+		SDLException("Too many objects for GPU culling");
+		return;
+	}
+
+	m_ObjectCount = uint32_t(objects.size());
+	if (m_ObjectCount > 0)
+		m_Renderer->Uploader->UploadToBuffer(m_ObjectBuffer, 0, objects.data(), uint32_t(objects.size_bytes()), true);
+}
+
+void GpuCulling::Dispatch(const Frustum& frustum)
+{
+	if (m_ObjectCount == 0 || !m_ClearPipeline || !m_CullPipeline)
+		return;
+
+	CullParams params{};
+	std::memcpy(params.Planes, frustum.Planes, sizeof(params.Planes));
+	params.ObjectCount = m_ObjectCount;
+
+	uint32_t groupCount = (m_ObjectCount + THREAD_COUNT - 1) / THREAD_COUNT;
+
+	// Empties every command slot and resets the counter. Cycling here leaves the
+	// commands of frames still in flight alone.
+	ComputeDispatch clear{};
+	clear.Pipeline = m_ClearPipeline;
+	clear.ReadWriteBuffers[0].buffer = m_DrawBuffer;
+	clear.ReadWriteBuffers[0].cycle = true;
+	clear.ReadWriteBuffers[1].buffer = m_CounterBuffer;
+	clear.ReadWriteBuffers[1].cycle = true;
+	clear.ReadWriteBufferCount = 2;
+	clear.UniformData = &params;
+	clear.UniformSize = sizeof(params);
+	clear.GroupCountX = groupCount;
+	m_Renderer->Dispatch(clear);
+
+	// Appends the visible objects' draws, runs in its own pass after the clear
+	ComputeDispatch cull{};
+	cull.Pipeline = m_CullPipeline;
+	cull.ReadOnlyBuffers[0] = m_ObjectBuffer;
+	cull.ReadOnlyBufferCount = 1;
+	cull.ReadWriteBuffers[0].buffer = m_DrawBuffer;
+	cull.ReadWriteBuffers[0].cycle = false;
+	cull.ReadWriteBuffers[1].buffer = m_CounterBuffer;
+	cull.ReadWriteBuffers[1].cycle = false;
+	cull.ReadWriteBufferCount = 2;
+	cull.UniformData = &params;
+	cull.UniformSize = sizeof(params);
+	cull.GroupCountX = groupCount;
+	m_Renderer->Dispatch(cull);
+}
+
+void GpuCulling::Draw(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer)
+{
+	if (m_ObjectCount == 0)
+		return;
+
+	m_Renderer->RenderPassDrawIndexedIndirect(pipeline, vertexBuffer, indexBuffer, m_DrawBuffer, 0, m_ObjectCount);
+}
+
+uint32_t GpuCulling::ReadVisibleCount()
+{
+	SDL_GPUDevice* device = m_Renderer->Device;
+	if (!m_ReadbackBuffer)
+	{
+		SDL_GPUTransferBufferCreateInfo transferBufferCreateInfo{};
+		transferBufferCreateInfo.usage = SDL_GPU_TRANSFERBUFFERUSAGE_DOWNLOAD;
+		transferBufferCreateInfo.size = sizeof(uint32_t);
+		m_ReadbackBuffer = SDL_CreateGPUTransferBuffer(device, &transferBufferCreateInfo);
+		if (!m_ReadbackBuffer)
+			SDLException("Failed to create GPU culling readback buffer");
+	}
+
+	// Runs after every command buffer submitted so far, so it sees the latest counter
+	SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(device);
+	if (!commandBuffer)
+		SDLException("Failed to acquire GPU command buffer");
+
+	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(commandBuffer);
+	SDL_GPUBufferRegion source{ m_CounterBuffer, 0, sizeof(uint32_t) };
+	SDL_GPUTransferBufferLocation destination{ m_ReadbackBuffer, 0 };
+	SDL_DownloadFromGPUBuffer(copyPass, &source, &destination);
+	SDL_EndGPUCopyPass(copyPass);
+
+	SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(commandBuffer);
+	if (!fence)
+		SDLException("Failed to submit GPU command buffer");
+	SDL_WaitForGPUFences(device, true, &fence, 1);
+	SDL_ReleaseGPUFence(device, fence);
+
+	uint32_t count = 0;
+	const void* mapped = SDL_MapGPUTransferBuffer(device, m_ReadbackBuffer, false);
+	if (!mapped)
+		SDLException("Failed to map GPU culling readback buffer");
+	std::memcpy(&count, mapped, sizeof(count));
+	SDL_UnmapGPUTransferBuffer(device, m_ReadbackBuffer);
+	return count;
+}
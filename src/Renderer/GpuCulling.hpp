@@ -0,0 +1,91 @@
+#pragma once
+
+#include "common.hpp"
+#include "Core/Frustum.hpp"
+#include <span>
+#include <SDL3/SDL_gpu.h>
+
+class Renderer;
+class VertexBuffer;
+class IndexBuffer;
+
+
+// One cullable object: a bounding sphere and the indexed draw it turns into.
+// Layout matches CullObject in Cull.comp.hlsl.
+struct CullObject
+{
+	float Center[3];
+	float Radius;
+
+	uint32_t IndexCount;
+	uint32_t InstanceCount;
+	uint32_t FirstIndex;
+	int32_t VertexOffset;
+	uint32_t FirstInstance;
+	uint32_t Padding[3];
+};
+
+static_assert(sizeof(CullObject) == 48);
+static_assert(sizeof(SDL_GPUIndexedIndirectDrawCommand) == 20);
+
+
+// Frustum culling on the GPU.
+// Objects live in a storage buffer that is only uploaded when they change. Every frame
+// a compute pass tests them against the frustum and compacts the visible ones into an
+// indirect buffer, which is drawn with a single indirect call, so the CPU cost does not
+// grow with the object count.
+//
+// SDL has no draw-count buffer, so the indirect draw submits one command per object
+// and the slots past the visible ones are cleared to empty draws beforehand.
+class GpuCulling
+{
+	public:
+		static constexpr uint32_t THREAD_COUNT = 64;   // numthreads of the culling shaders
+
+		GpuCulling(Renderer* renderer, uint32_t objectCapacity);
+		virtual ~GpuCulling();
+
+		void Cleanup();
+
+		// Replaces the object list, queued through the renderer's uploader
+		void SetObjects(std::span<const CullObject> objects);
+
+		// Queues the clear and culling dispatches for this frame
+		void Dispatch(const Frustum& frustum);
+
+		// Queues the indirect draw of the visible objects. Call after Dispatch.
+		void Draw(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer);
+
+		// Visible count of the last submitted Dispatch, for validation and debugging.
+		// Submits a download of its own and blocks until the GPU is done with it.
+		uint32_t ReadVisibleCount();
+
+		SDL_GPUBuffer* GetObjectBuffer() const { return m_ObjectBuffer; }
+		SDL_GPUBuffer* GetDrawBuffer() const { return m_DrawBuffer; }
+		uint32_t GetObjectCount() const { return m_ObjectCount; }
+		uint32_t GetCapacity() const { return m_Capacity; }
+
+	private:
+		// Uniform block of both shaders
+		struct CullParams
+		{
+			float Planes[Frustum::Count][4];
+			uint32_t ObjectCount;
+			uint32_t Padding[3];
+		};
+
+		static_assert(sizeof(CullParams) == 112);
+
+		Renderer* m_Renderer{nullptr};
+
+		SDL_GPUComputePipeline* m_ClearPipeline{nullptr};
+		SDL_GPUComputePipeline* m_CullPipeline{nullptr};
+
+		SDL_GPUBuffer* m_ObjectBuffer{nullptr};
+		SDL_GPUBuffer* m_DrawBuffer{nullptr};
+		SDL_GPUBuffer* m_CounterBuffer{nullptr};
+		SDL_GPUTransferBuffer* m_ReadbackBuffer{nullptr};   // created by the first ReadVisibleCount
+
+		uint32_t m_Capacity{0};
+		uint32_t m_ObjectCount{0};
+};
@@ -0,0 +1,92 @@
+#include "GpuFrameTimer.hpp"
+#include "Core/Profiler.hpp"
+#include <algorithm>
+
+
+GpuFrameTimer::GpuFrameTimer(SDL_GPUDevice* device)
+{
+	m_Device = device;
+
+	// Never more than the frames in flight, reserved so Watch does not allocate on the frame path
+	m_Pending.reserve(MAX_FRAMES_IN_FLIGHT * 2);
+
+	m_Thread = std::thread([this]{ Run(); });
+}
+
+GpuFrameTimer::~GpuFrameTimer()
+{
+	{
+		std::lock_guard lock(m_Mutex);
+		m_Stop = true;
+	}
+	m_Condition.notify_all();
+
+	// A fence being waited on still signals once the GPU gets to it
+	m_Thread.join();
+}
+
+void GpuFrameTimer::Watch(SDL_GPUFence* fence, uint64_t submitNS)
+{
+	if (!fence)
+		return;
+
+	{
+		std::lock_guard lock(m_Mutex);
+		m_Pending.push_back(PendingFrame{fence, submitNS});
+	}
+	m_Condition.notify_all();
+}
+
+void GpuFrameTimer::Forget(SDL_GPUFence* fence)
+{
+	std::unique_lock lock(m_Mutex);
+
+	// Fences are forgotten once signaled, so this wait is short
+	m_Condition.wait(lock, [&]{ return m_Waiting != fence; });
+
+	auto it = std::find_if(m_Pending.begin(), m_Pending.end(), [&](const PendingFrame& frame) { return frame.Fence == fence; });
+	if (it != m_Pending.end())
+		m_Pending.erase(it);
+}
+
+bool GpuFrameTimer::TakeFrameTime(uint64_t& nanoseconds)
+{
+	std::lock_guard lock(m_Mutex);
+	if (!m_HasFrameTime)
+		return false;
+
+	nanoseconds = m_FrameTimeNS;
+	m_HasFrameTime = false;
+	return true;
+}
+
+void GpuFrameTimer::Run()
+{
+	Profiler::SetThreadName("GPU frame timer");
+
+	std::unique_lock lock(m_Mutex);
+	for (;;)
+	{
+		m_Condition.wait(lock, [&]{ return m_Stop || !m_Pending.empty(); });
+		if (m_Stop)
+			return;
+
+		PendingFrame frame = m_Pending.front();
+		m_Waiting = frame.Fence;
+
+		lock.unlock();
+		SDL_WaitForGPUFences(m_Device, true, &frame.Fence, 1);
+		const uint64_t completedNS = Profiler::Now();
+		lock.lock();
+
+		// Forget() leaves the fence alone while it is being waited on, it is still the front
+		m_Pending.erase(m_Pending.begin());
+		m_Waiting = nullptr;
+
+		m_FrameTimeNS = completedNS - std::max(frame.SubmitNS, m_LastCompletedNS);
+		m_LastCompletedNS = completedNS;
+		m_HasFrameTime = true;
+
+		m_Condition.notify_all();
+	}
+}
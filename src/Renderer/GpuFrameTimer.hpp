@@ -0,0 +1,54 @@
+#pragma once
+
+#include "common.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <SDL3/SDL_gpu.h>
+
+
+// Times frames on the GPU by blocking on their fences on a thread of its own, so a
+// fence is seen the moment it signals instead of whenever the render thread polls it.
+// A frame's time runs from its submit, or from the previous frame completing if it was
+// queued behind it, to its fence signaling. That is the GPU time for GPU-bound frames
+// and includes the submission latency otherwise. Under VSYNC the fence also waits for
+// the display, so no frame is timed shorter than the refresh interval.
+class GpuFrameTimer
+{
+	public:
+		GpuFrameTimer(SDL_GPUDevice* device);
+		virtual ~GpuFrameTimer();
+
+		// `submitNS` is Profiler::Now() right before the submit. The fence must stay
+		// alive until Forget() for it has returned.
+		void Watch(SDL_GPUFence* fence, uint64_t submitNS);
+
+		// Call before releasing a watched fence
+		void Forget(SDL_GPUFence* fence);
+
+		// Time of the newest frame completed since the last call, false if there is none
+		bool TakeFrameTime(uint64_t& nanoseconds);
+
+	private:
+		struct PendingFrame
+		{
+			SDL_GPUFence* Fence;
+			uint64_t SubmitNS;
+		};
+
+		SDL_GPUDevice* m_Device{nullptr};
+		std::thread m_Thread;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_Condition;
+		std::vector<PendingFrame> m_Pending;     // in submission order
+		SDL_GPUFence* m_Waiting{nullptr};        // front of m_Pending while the thread waits on it
+		bool m_Stop{false};
+
+		uint64_t m_LastCompletedNS{0};
+		uint64_t m_FrameTimeNS{0};
+		bool m_HasFrameTime{false};
+
+		void Run();
+};
@@ -0,0 +1,198 @@
+#include "GpuParticles.hpp"
+#include "Renderer.hpp"
+#include <algorithm>
+#include <cmath>
+
+GpuParticles::GpuParticles(Renderer* renderer, uint32_t capacity)
+{
+	m_Renderer = renderer;
+	m_Capacity = capacity;
+
+	// Counts for loose shader files, shaders.pack carries the reflected ones
+	ComputePipelineInfo initInfo{};
+	initInfo.ReadWriteStorageBufferCount = 2;
+	initInfo.UniformBufferCount = 1;
+	initInfo.ThreadCountX = THREAD_COUNT;
+
+	ComputePipelineInfo emitInfo{};
+	emitInfo.ReadWriteStorageBufferCount = 3;
+	emitInfo.UniformBufferCount = 1;
+	emitInfo.ThreadCountX = THREAD_COUNT;
+
+	ComputePipelineInfo argsInfo{};
+	argsInfo.ReadWriteStorageBufferCount = 2;
+	argsInfo.UniformBufferCount = 1;
+	argsInfo.ThreadCountX = 1;
+
+	ComputePipelineInfo simulateInfo{};
+	simulateInfo.ReadWriteStorageBufferCount = 4;
+	simulateInfo.UniformBufferCount = 1;
+	simulateInfo.ThreadCountX = THREAD_COUNT;
+
+	m_InitPipeline = m_Renderer->CreateComputePipeline("ParticleInit.comp", initInfo);
+	m_EmitPipeline = m_Renderer->CreateComputePipeline("ParticleEmit.comp", emitInfo);
+	m_ArgsPipeline = m_Renderer->CreateComputePipeline("ParticleArgs.comp", argsInfo);
+	m_SimulatePipeline = m_Renderer->CreateComputePipeline("ParticleSimulate.comp", simulateInfo);
+
+	// Particle state carries over between frames, so none of these are cycled
+	SDL_GPUBufferCreateInfo bufferCreateInfo{};
+	bufferCreateInfo.size = capacity * sizeof(GpuParticle);
+	bufferCreateInfo.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE;
+	m_ParticleBuffer = SDL_CreateGPUBuffer(m_Renderer->Device, &bufferCreateInfo);
+
+	bufferCreateInfo.size = 3 * capacity * sizeof(uint32_t);
+	m_ListBuffer = SDL_CreateGPUBuffer(m_Renderer->Device, &bufferCreateInfo);
+
+	bufferCreateInfo.size = 3 * sizeof(uint32_t);
+	m_CounterBuffer = SDL_CreateGPUBuffer(m_Renderer->Device, &bufferCreateInfo);
+
+	bufferCreateInfo.size = capacity * sizeof(ParticleVertex);
+	bufferCreateInfo.usage = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE;
+	m_VertexBuffer = SDL_CreateGPUBuffer(m_Renderer->Device, &bufferCreateInfo);
+
+	bufferCreateInfo.size = ARGS_SIZE;
+	bufferCreateInfo.usage = SDL_GPU_BUFFERUSAGE_INDIRECT | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE;
+	m_ArgsBuffer = SDL_CreateGPUBuffer(m_Renderer->Device, &bufferCreateInfo);
+
+	if (!m_ParticleBuffer || !m_ListBuffer || !m_CounterBuffer || !m_VertexBuffer || !m_ArgsBuffer)
+	{
+		SDLException("Failed to create GPU particle buffers");
+	}
+}
+
+GpuParticles::~GpuParticles()
+{
+}
+
+void GpuParticles::Cleanup()
+{
+	for (SDL_GPUComputePipeline** pipeline : {&m_InitPipeline, &m_EmitPipeline, &m_ArgsPipeline, &m_SimulatePipeline})
+	{
+		m_Renderer->ReleaseComputePipeline(*pipeline);
+		*pipeline = nullptr;
+	}
+
+	for (SDL_GPUBuffer** buffer : {&m_ParticleBuffer, &m_ListBuffer, &m_CounterBuffer, &m_VertexBuffer, &m_ArgsBuffer})
+	{
+		if (*buffer)
+		{
+			SDL_ReleaseGPUBuffer(m_Renderer->Device, *buffer);
+			*buffer = nullptr;
+		}
+	}
+}
+
+void GpuParticles::Reset()
+{
+	m_ResetPending = true;
+	m_Burst = 0;
+	m_EmitRemainder = 0.0;
+}
+
+void GpuParticles::Burst(uint32_t count)
+{
+	m_Burst = std::min(m_Burst + std::min(count, m_Capacity), m_Capacity);
+}
+
+void GpuParticles::Update(const ParticleEmitter& emitter, float deltaTime, const glm::mat4& view, const glm::mat4& projection)
+{
+	if (!m_InitPipeline || !m_EmitPipeline || !m_ArgsPipeline || !m_SimulatePipeline)
+		return;
+
+	// Whole particles owed by the rate, the fraction carries over to the next frame
+	m_EmitRemainder += double(std::max(emitter.Rate, 0.0f)) * double(std::max(deltaTime, 0.0f));
+	const double whole = std::floor(m_EmitRemainder);
+	m_EmitRemainder -= whole;
+
+	m_EmittedCount = uint32_t(std::min(whole + double(m_Burst), double(m_Capacity)));
+	m_Burst = 0;
+
+	const glm::mat4 viewProjection = projection * view;
+
+	ParticleParams params{};
+	for (int row = 0; row < 4; row++)
+		params.ViewProjection[row] = glm::vec4(viewProjection[0][row], viewProjection[1][row], viewProjection[2][row], viewProjection[3][row]);
+	params.EmitterPosition = glm::vec4(emitter.Position, emitter.SpawnRadius);
+	params.EmitterVelocity = glm::vec4(emitter.Velocity, emitter.VelocitySpread);
+	params.Gravity = glm::vec4(emitter.Gravity, emitter.Drag);
+	params.StartColor = emitter.StartColor;
+	params.EndColor = emitter.EndColor;
+	params.BillboardScale = glm::vec2(projection[0][0], projection[1][1]);
+	params.StartSize = emitter.StartSize;
+	params.EndSize = emitter.EndSize;
+	params.LifetimeMin = emitter.LifetimeMin;
+	params.LifetimeMax = std::max(emitter.LifetimeMax, emitter.LifetimeMin);
+	params.DeltaTime = deltaTime;
+	params.EmitCount = m_EmittedCount;
+	params.Capacity = m_Capacity;
+	params.ListIn = m_ListIn;
+	params.Seed = ++m_FrameCount;
+
+	const uint32_t capacityGroups = (m_Capacity + THREAD_COUNT - 1) / THREAD_COUNT;
+
+	if (m_ResetPending)
+	{
+		QueueDispatch(m_InitPipeline, params, capacityGroups, false, {m_ListBuffer, m_CounterBuffer});
+		m_ResetPending = false;
+	}
+
+	if (m_EmittedCount > 0)
+		QueueDispatch(m_EmitPipeline, params, (m_EmittedCount + THREAD_COUNT - 1) / THREAD_COUNT, false, {m_ParticleBuffer, m_ListBuffer, m_CounterBuffer});
+
+	// The simulation only covers the live particles, its group count comes from the counters
+	params.ArgsStage = 0;
+	QueueDispatch(m_ArgsPipeline, params, 1, false, {m_CounterBuffer, m_ArgsBuffer});
+
+	QueueDispatch(m_SimulatePipeline, params, 0, true, {m_ParticleBuffer, m_ListBuffer, m_CounterBuffer, m_VertexBuffer});
+
+	params.ArgsStage = 1;
+	QueueDispatch(m_ArgsPipeline, params, 1, false, {m_CounterBuffer, m_ArgsBuffer});
+
+	// The survivors are next frame's input
+	m_ListIn ^= 1;
+}
+
+void GpuParticles::Draw(SDL_GPUGraphicsPipeline* pipeline)
+{
+	if (m_FrameCount == 0)
+		return;
+
+	// Six vertices per live particle, the instance count is written by ParticleArgs
+	DrawItem item{};
+	item.Pipeline = pipeline;
+	item.VertexStorageBuffer = m_VertexBuffer;
+	item.IndirectBuffer = m_ArgsBuffer;
+	item.IndirectOffset = DRAW_ARGS_OFFSET;
+	item.IndirectDrawCount = 1;
+	item.SortKey = DrawQueue::MakeKey(DrawQueue::PASS_TRANSPARENT, m_Renderer->GetPipelineId(pipeline), 0, 0, 0);
+
+	m_Renderer->Draw(item);
+}
+
+void GpuParticles::QueueDispatch(SDL_GPUComputePipeline* pipeline, const ParticleParams& params, uint32_t groupCount, bool indirect, std::initializer_list<SDL_GPUBuffer*> buffers)
+{
+	ComputeDispatch dispatch{};
+	dispatch.Pipeline = pipeline;
+
+	for (SDL_GPUBuffer* buffer : buffers)
+	{
+		dispatch.ReadWriteBuffers[dispatch.ReadWriteBufferCount].buffer = buffer;
+		dispatch.ReadWriteBuffers[dispatch.ReadWriteBufferCount].cycle = false;
+		dispatch.ReadWriteBufferCount++;
+	}
+
+	dispatch.UniformData = &params;
+	dispatch.UniformSize = sizeof(params);
+
+	if (indirect)
+	{
+		dispatch.IndirectBuffer = m_ArgsBuffer;
+		dispatch.IndirectOffset = DISPATCH_ARGS_OFFSET;
+	}
+	else
+	{
+		dispatch.GroupCountX = groupCount;
+	}
+
+	m_Renderer->Dispatch(dispatch);
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "common.hpp"
+#include <initializer_list>
+#include <glm/glm.hpp>
+#include <SDL3/SDL_gpu.h>
+
+class Renderer;
+
+
+// Spawn and motion parameters, the only particle data the CPU sends each frame
+struct ParticleEmitter
+{
+	glm::vec3 Position{0.0f};
+	float SpawnRadius{0.0f};
+
+	glm::vec3 Velocity{0.0f, 1.0f, 0.0f};
+	float VelocitySpread{0.5f};          // random velocity added in every direction
+
+	glm::vec3 Gravity{0.0f, -9.81f, 0.0f};
+	float Drag{0.0f};                    // fraction of the velocity lost per second
+
+	glm::vec4 StartColor{1.0f};
+	glm::vec4 EndColor{1.0f, 1.0f, 1.0f, 0.0f};
+	float StartSize{0.05f};
+	float EndSize{0.0f};
+
+	float LifetimeMin{1.0f};             // seconds
+	float LifetimeMax{2.0f};
+	float Rate{1000.0f};                 // particles per second
+};
+
+// Simulation state of one particle. Layout matches Particle in the particle shaders.
+struct GpuParticle
+{
+	float Position[3];
+	float Age;
+	float Velocity[3];
+	float Lifetime;
+};
+
+// What the vertex shader reads per live particle, written by the simulation.
+// Layout matches ParticleVertex in Particle.vert.hlsl.
+struct ParticleVertex
+{
+	float ClipPosition[4];
+	float ClipSize[2];
+	uint32_t Color;                      // RGBA8
+	uint32_t Padding;
+};
+
+static_assert(sizeof(GpuParticle) == 32);
+static_assert(sizeof(ParticleVertex) == 32);
+static_assert(sizeof(SDL_GPUIndirectDrawCommand) == 16);
+
+
+// Particles simulated and drawn entirely on the GPU.
+// Every frame compute shaders pop dead particles off a dead list to spawn new ones,
+// integrate the live ones and compact the survivors into the other of two alive lists,
+// pushing expired ones back onto the dead list. The survivors' billboards are written
+// to a vertex storage buffer together with their count as an indirect draw, so the
+// draw is one indirect instanced call and particle data never touches the CPU.
+//
+// The simulation runs over the live count through an indirect dispatch, built by a
+// one-thread pass from the counters, so an idle system costs almost nothing.
+class GpuParticles
+{
+	public:
+		static constexpr uint32_t THREAD_COUNT = 256;   // numthreads of the emit, init and simulate shaders
+
+		GpuParticles(Renderer* renderer, uint32_t capacity);
+		virtual ~GpuParticles();
+
+		void Cleanup();
+
+		// Kills every particle, runs with the next Update's dispatches
+		void Reset();
+
+		// Spawns `count` particles on top of the emitter's rate in the next Update
+		void Burst(uint32_t count);
+
+		// Queues this frame's emit and simulate dispatches. `view` and `projection`
+		// place the billboards, which face the camera and shrink with distance.
+		void Update(const ParticleEmitter& emitter, float deltaTime, const glm::mat4& view, const glm::mat4& projection);
+
+		// Queues the indirect draw of the live particles in the transparent pass.
+		// `pipeline` takes no vertex input and one vertex storage buffer, see Particle.vert;
+		// Particle.frag expects additive blending.
+		void Draw(SDL_GPUGraphicsPipeline* pipeline);
+
+		uint32_t GetCapacity() const { return m_Capacity; }
+
+		// Particles requested by the last Update, fewer spawn when the dead list runs out
+		uint32_t GetEmittedCount() const { return m_EmittedCount; }
+
+		SDL_GPUBuffer* GetParticleBuffer() const { return m_ParticleBuffer; }
+		SDL_GPUBuffer* GetVertexBuffer() const { return m_VertexBuffer; }
+		SDL_GPUBuffer* GetArgsBuffer() const { return m_ArgsBuffer; }
+
+	private:
+		// Uniform block of every particle compute shader
+		struct ParticleParams
+		{
+			glm::vec4 ViewProjection[4];     // rows
+			glm::vec4 EmitterPosition;       // w spawn radius
+			glm::vec4 EmitterVelocity;       // w velocity spread
+			glm::vec4 Gravity;               // w drag
+			glm::vec4 StartColor;
+			glm::vec4 EndColor;
+			glm::vec2 BillboardScale;        // projection scale of x and y
+			float StartSize;
+			float EndSize;
+			float LifetimeMin;
+			float LifetimeMax;
+			float DeltaTime;
+			uint32_t EmitCount;
+			uint32_t Capacity;
+			uint32_t ListIn;                 // alive list read this frame, the other one is written
+			uint32_t Seed;
+			uint32_t ArgsStage;              // 0 builds the simulate dispatch, 1 the draw
+		};
+
+		static_assert(sizeof(ParticleParams) == 192);
+
+		// Args buffer layout
+		static constexpr uint32_t DISPATCH_ARGS_OFFSET = 0;
+		static constexpr uint32_t DRAW_ARGS_OFFSET = 16;
+		static constexpr uint32_t ARGS_SIZE = DRAW_ARGS_OFFSET + sizeof(SDL_GPUIndirectDrawCommand);
+
+		Renderer* m_Renderer{nullptr};
+
+		SDL_GPUComputePipeline* m_InitPipeline{nullptr};
+		SDL_GPUComputePipeline* m_EmitPipeline{nullptr};
+		SDL_GPUComputePipeline* m_ArgsPipeline{nullptr};
+		SDL_GPUComputePipeline* m_SimulatePipeline{nullptr};
+
+		SDL_GPUBuffer* m_ParticleBuffer{nullptr};   // GpuParticle per slot
+		SDL_GPUBuffer* m_ListBuffer{nullptr};       // two alive lists and the dead list, capacity indices each
+		SDL_GPUBuffer* m_CounterBuffer{nullptr};    // dead count, alive count of either list
+		SDL_GPUBuffer* m_VertexBuffer{nullptr};     // ParticleVertex per live particle
+		SDL_GPUBuffer* m_ArgsBuffer{nullptr};       // simulate dispatch and draw commands
+
+		uint32_t m_Capacity{0};
+		uint32_t m_ListIn{0};
+		uint32_t m_Burst{0};
+		uint32_t m_EmittedCount{0};
+		uint32_t m_FrameCount{0};
+		double m_EmitRemainder{0.0};
+		bool m_ResetPending{true};   // the lists are filled by the first Update
+
+		void QueueDispatch(SDL_GPUComputePipeline* pipeline, const ParticleParams& params, uint32_t groupCount, bool indirect, std::initializer_list<SDL_GPUBuffer*> buffers);
+};
@@ -0,0 +1,48 @@
+#include "IndexBuffer.hpp"
+#include "SortKey.hpp"
+#include "Core/Profiler.hpp"
+
+IndexBuffer::IndexBuffer(SDL_GPUDevice* device, UploadManager* uploader, uint32_t indexCount, SDL_GPUIndexElementSize elementSize)
+{
+	m_Device = device;
+	m_Uploader = uploader;
+	m_IndexCount = indexCount;
+	m_ElementSize = elementSize;
+
+	m_Id = SortKey::NextBufferId();
+
+	SDL_GPUBufferCreateInfo indexBufferCreateInfo{};
+	indexBufferCreateInfo.size = indexCount * GetElementBytes(elementSize);
+	indexBufferCreateInfo.usage = SDL_GPU_BUFFERUSAGE_INDEX;
+
+	m_IndexBuffer = SDL_CreateGPUBuffer(m_Device, &indexBufferCreateInfo);
+	if (!m_IndexBuffer)
+	{
+		SDLException("Failed to create GPU index buffer");
+	}
+}
+
+IndexBuffer::~IndexBuffer()
+{
+}
+
+void IndexBuffer::UploadData(const void* indices, const uint32_t indexCount, const uint32_t firstIndex)
+{
+	SDLGPU_PROFILE_ZONE("IndexBuffer::UploadData");
+
+	if (!m_Uploader || !m_IndexBuffer)
+	{
+		SDLException("Index buffer or uploader not initialized");
+		return;
+	}
+
+	// Written so it cannot wrap around in 32 bits
+	if (indexCount > m_IndexCount || firstIndex > m_IndexCount - indexCount)
+	{
+		SDLException("Index buffer upload out of range");
+		return;
+	}
+
+	const uint32_t elementBytes = GetElementBytes(m_ElementSize);
+	m_Uploader->UploadToBuffer(m_IndexBuffer, firstIndex * elementBytes, indices, indexCount * elementBytes);
+}
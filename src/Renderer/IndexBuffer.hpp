@@ -0,0 +1,43 @@
+#pragma once
+#include "common.hpp"
+#include "Renderer/UploadManager.hpp"
+#include <SDL3/SDL_gpu.h>
+
+class IndexBuffer
+{
+    public:
+        IndexBuffer(SDL_GPUDevice* device, UploadManager* uploader, uint32_t indexCount, SDL_GPUIndexElementSize elementSize = SDL_GPU_INDEXELEMENTSIZE_32BIT);
+        virtual ~IndexBuffer();
+
+        void Cleanup()
+        {
+            if (m_IndexBuffer)
+            {
+                SDL_ReleaseGPUBuffer(m_Device, m_IndexBuffer);
+                m_IndexBuffer = nullptr;
+            }
+        }
+
+        // Stages the indices through the device uploader, offsets and counts are in indices
+        void UploadData(const void* indices, const uint32_t indexCount, const uint32_t firstIndex = 0);
+
+        SDL_GPUBuffer* GetIndexBuffer() const { return m_IndexBuffer; }
+        SDL_GPUIndexElementSize GetElementSize() const { return m_ElementSize; }
+        uint32_t GetIndexCount() const { return m_IndexCount; }
+
+        static constexpr uint32_t GetElementBytes(SDL_GPUIndexElementSize elementSize)
+        {
+            return elementSize == SDL_GPU_INDEXELEMENTSIZE_16BIT ? 2u : 4u;
+        }
+
+        // Small id used in draw sort keys
+        uint16_t GetId() const { return m_Id; }
+
+    private:
+        SDL_GPUDevice* m_Device{nullptr};
+        SDL_GPUBuffer* m_IndexBuffer{nullptr};
+        UploadManager* m_Uploader{nullptr};
+        SDL_GPUIndexElementSize m_ElementSize{SDL_GPU_INDEXELEMENTSIZE_32BIT};
+        uint32_t m_IndexCount{0};
+        uint16_t m_Id{0};
+};
@@ -0,0 +1,41 @@
+#include "InstanceBuffer.hpp"
+
+InstanceBuffer::InstanceBuffer(SDL_GPUDevice* device, UploadManager* uploader, uint32_t instanceCapacity, uint32_t instanceStride)
+{
+	m_Device = device;
+	m_Uploader = uploader;
+	m_Capacity = instanceCapacity;
+	m_Stride = instanceStride;
+
+	SDL_GPUBufferCreateInfo bufferCreateInfo{};
+	bufferCreateInfo.size = instanceCapacity * instanceStride;
+	bufferCreateInfo.usage = SDL_GPU_BUFFERUSAGE_VERTEX | SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ;
+
+	m_Buffer = SDL_CreateGPUBuffer(m_Device, &bufferCreateInfo);
+	if (!m_Buffer)
+	{
+		SDLException("Failed to create GPU instance buffer");
+	}
+}
+
+InstanceBuffer::~InstanceBuffer()
+{
+}
+
+void* InstanceBuffer::BeginFrame(uint32_t instanceCount)
+{
+	if (!m_Uploader || !m_Buffer)
+	{
+		SDLException("Instance buffer or uploader not initialized");
+		return nullptr;
+	}
+
+	if (instanceCount == 0 || instanceCount > m_Capacity)
+	{
+		SDLException("Instance count out of range");
+		return nullptr;
+	}
+
+	m_InstanceCount = instanceCount;
+	return m_Uploader->MapBufferUpload(m_Buffer, 0, instanceCount * m_Stride, true);
+}
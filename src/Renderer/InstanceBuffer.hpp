@@ -0,0 +1,56 @@
+#pragma once
+#include "common.hpp"
+#include "Renderer/UploadManager.hpp"
+#include <SDL3/SDL_gpu.h>
+
+// How an instanced draw reads its instance buffer, has to match the pipeline's vertex shader
+enum class InstanceInput
+{
+    VertexStream,   // instance-rate vertex buffer on slot 1
+    StorageBuffer,  // vertex storage buffer on slot 0, indexed by SV_InstanceID
+};
+
+// Per-instance data rewritten every frame.
+// The buffer can be bound as an instance-rate vertex buffer or as a vertex
+// storage buffer read with SV_InstanceID, the shader decides which.
+class InstanceBuffer
+{
+    public:
+        InstanceBuffer(SDL_GPUDevice* device, UploadManager* uploader, uint32_t instanceCapacity, uint32_t instanceStride = sizeof(InstanceData));
+        virtual ~InstanceBuffer();
+
+        void Cleanup()
+        {
+            if (m_Buffer)
+            {
+                SDL_ReleaseGPUBuffer(m_Device, m_Buffer);
+                m_Buffer = nullptr;
+            }
+        }
+
+        // Returns staging memory for this frame's `instanceCount` instances, written
+        // straight into the upload ring without an intermediate copy. The GPU buffer is
+        // cycled, so instances of frames still in flight are left alone.
+        // Call once per frame and fill the memory before the next upload.
+        void* BeginFrame(uint32_t instanceCount);
+
+        template<typename TInstance>
+        TInstance* BeginFrame(uint32_t instanceCount)
+        {
+            if (sizeof(TInstance) != m_Stride)
+                SDLException("Instance type does not match the instance buffer stride");
+            return static_cast<TInstance*>(BeginFrame(instanceCount));
+        }
+
+        SDL_GPUBuffer* GetBuffer() const { return m_Buffer; }
+        uint32_t GetInstanceCount() const { return m_InstanceCount; }
+        uint32_t GetCapacity() const { return m_Capacity; }
+
+    private:
+        SDL_GPUDevice* m_Device{nullptr};
+        SDL_GPUBuffer* m_Buffer{nullptr};
+        UploadManager* m_Uploader{nullptr};
+        uint32_t m_Capacity{0};
+        uint32_t m_Stride{0};
+        uint32_t m_InstanceCount{0};
+};
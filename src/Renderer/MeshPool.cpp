@@ -0,0 +1,117 @@
+#include "MeshPool.hpp"
+#include "Core/MappedFile.hpp"
+#include "Core/Profiler.hpp"
+#include <algorithm>
+
+MeshPool::MeshPool(SDL_GPUDevice* device, UploadManager* uploader, uint32_t vertexStride, SDL_GPUIndexElementSize indexElementSize, uint32_t blockVertexCount, uint32_t blockIndexCount)
+	: m_Vertices(device, uploader, SDL_GPU_BUFFERUSAGE_VERTEX, vertexStride, blockVertexCount),
+	m_Indices(device, uploader, SDL_GPU_BUFFERUSAGE_INDEX, IndexBuffer::GetElementBytes(indexElementSize), blockIndexCount),
+	m_IndexElementSize(indexElementSize)
+{
+}
+
+MeshPool::~MeshPool()
+{
+}
+
+MeshHandle MeshPool::CreateMesh(const void* vertices, uint32_t vertexCount, const void* indices, uint32_t indexCount)
+{
+	MeshHandle mesh{};
+	mesh.Vertices = m_Vertices.Allocate(vertexCount);
+	if (mesh.Vertices == GpuBufferPool::INVALID_ALLOCATION)
+		return {};
+
+	m_Vertices.Upload(mesh.Vertices, vertices, vertexCount);
+
+	if (indices && indexCount > 0)
+	{
+		mesh.Indices = m_Indices.Allocate(indexCount);
+		if (mesh.Indices == GpuBufferPool::INVALID_ALLOCATION)
+		{
+			m_Vertices.Free(mesh.Vertices);
+			return {};
+		}
+
+		m_Indices.Upload(mesh.Indices, indices, indexCount);
+	}
+
+	return mesh;
+}
+
+MeshHandle MeshPool::LoadMesh(const std::string& path, uint8_t vertexType, std::span<const VertexElement> elements, CookedMeshInfo* info)
+{
+	SDLGPU_PROFILE_ZONE("MeshPool::LoadMesh");
+
+	// Unmapped on return, the uploader has copied the blobs into staging by then
+	MappedFile file;
+	if (!file.Open(path))
+		return {};
+
+	const uint8_t* data = file.GetData();
+	const size_t size = file.GetSize();
+
+	if (size < sizeof(CookedMeshHeader))
+		SDLException("Cooked mesh is truncated: " + path);
+
+	const auto* header = reinterpret_cast<const CookedMeshHeader*>(data);
+	if (header->Magic != COOKED_MESH_MAGIC || header->Version != COOKED_MESH_VERSION)
+		SDLException("Cooked mesh has an unknown format: " + path);
+
+	if (header->FileSize != size || header->ElementCount > COOKED_MESH_MAX_ELEMENTS ||
+		header->SubmeshOffset % alignof(CookedSubmesh) != 0 ||
+		header->SubmeshOffset + uint64_t(header->SubmeshCount) * sizeof(CookedSubmesh) > size ||
+		header->VertexOffset + uint64_t(header->VertexCount) * header->VertexStride > size ||
+		header->IndexOffset + uint64_t(header->IndexCount) * header->IndexSize > size)
+		SDLException("Cooked mesh is corrupt: " + path);
+
+	// The blobs go into the buffers as they are. Comparing the elements as well catches
+	// files cooked before a vertex struct changed.
+	bool matches = header->VertexType == vertexType && header->VertexStride == m_Vertices.GetElementSize() && header->ElementCount == elements.size();
+	for (size_t i = 0; matches && i < elements.size(); i++)
+	{
+		const CookedMeshElement& element = header->Elements[i];
+		matches = element.Format == uint32_t(elements[i].Format) && element.Offset == elements[i].Offset && element.Location == elements[i].Location;
+	}
+
+	if (header->IndexCount > 0)
+		matches &= header->IndexSize == IndexBuffer::GetElementBytes(m_IndexElementSize);
+
+	if (!matches)
+		SDLException("Cooked mesh does not match the mesh pool layout: " + path);
+
+	std::span<const CookedSubmesh> submeshes{ reinterpret_cast<const CookedSubmesh*>(data + header->SubmeshOffset), header->SubmeshCount };
+	for (const CookedSubmesh& submesh : submeshes)
+	{
+		if (uint64_t(submesh.FirstIndex) + submesh.IndexCount > header->IndexCount)
+			SDLException("Cooked mesh is corrupt: " + path);
+	}
+
+	MeshHandle mesh = CreateMesh(data + header->VertexOffset, header->VertexCount,
+		header->IndexCount > 0 ? data + header->IndexOffset : nullptr, header->IndexCount);
+
+	if (info)
+	{
+		info->VertexCount = header->VertexCount;
+		info->IndexCount = header->IndexCount;
+		std::copy(header->BoundsMin, header->BoundsMin + 3, info->BoundsMin);
+		std::copy(header->BoundsMax, header->BoundsMax + 3, info->BoundsMax);
+		info->Submeshes.assign(submeshes.begin(), submeshes.end());
+	}
+
+	return mesh;
+}
+
+void MeshPool::DestroyMesh(MeshHandle mesh)
+{
+	m_Vertices.Free(mesh.Vertices);
+	m_Indices.Free(mesh.Indices);
+}
+
+uint32_t MeshPool::Defragment(uint64_t maxBytes)
+{
+	uint64_t movedBefore = m_Vertices.GetMovedBytes();
+	uint32_t moves = m_Vertices.Defragment(maxBytes);
+
+	uint64_t spent = m_Vertices.GetMovedBytes() - movedBefore;
+	return moves + m_Indices.Defragment(maxBytes - spent);
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "common.hpp"
+#include "Renderer/GpuBufferPool.hpp"
+#include "Renderer/CookedMeshFormat.hpp"
+#include "Renderer/IndexBuffer.hpp"
+#include "Renderer/VertexLayout.hpp"
+#include <span>
+#include <string>
+#include <vector>
+#include <SDL3/SDL_gpu.h>
+
+// A mesh in a MeshPool, two allocation ids. Cheap to copy and stays valid across defragmentation.
+struct MeshHandle
+{
+    uint32_t Vertices{GpuBufferPool::INVALID_ALLOCATION};
+    uint32_t Indices{GpuBufferPool::INVALID_ALLOCATION};   // invalid for non-indexed meshes
+
+    bool IsValid() const { return Vertices != GpuBufferPool::INVALID_ALLOCATION; }
+    bool IsIndexed() const { return Indices != GpuBufferPool::INVALID_ALLOCATION; }
+};
+
+// Everything in a cooked mesh file besides the buffer contents
+struct CookedMeshInfo
+{
+    uint32_t VertexCount{0};
+    uint32_t IndexCount{0};
+    float BoundsMin[3]{};
+    float BoundsMax[3]{};
+    std::vector<CookedSubmesh> Submeshes;   // index ranges relative to the mesh
+};
+
+// Vertex and index data of many meshes packed into shared buffers. Meshes of the
+// same block draw from one binding, selected with vertex_offset/firstIndex.
+// Meshes larger than a block get blocks of their own.
+// All meshes in a pool share one vertex layout and index size.
+class MeshPool
+{
+    public:
+        static constexpr uint32_t DEFAULT_BLOCK_VERTICES = 1u << 20;
+        static constexpr uint32_t DEFAULT_BLOCK_INDICES = 3u << 20;
+
+        MeshPool(SDL_GPUDevice* device, UploadManager* uploader, uint32_t vertexStride,
+            SDL_GPUIndexElementSize indexElementSize = SDL_GPU_INDEXELEMENTSIZE_32BIT,
+            uint32_t blockVertexCount = DEFAULT_BLOCK_VERTICES, uint32_t blockIndexCount = DEFAULT_BLOCK_INDICES);
+        virtual ~MeshPool();
+
+        void Cleanup()
+        {
+            m_Vertices.Cleanup();
+            m_Indices.Cleanup();
+        }
+
+        // Allocates the mesh and queues its data through the uploader. `indices` may be null.
+        MeshHandle CreateMesh(const void* vertices, uint32_t vertexCount, const void* indices = nullptr, uint32_t indexCount = 0);
+
+        template<typename TVertex>
+        MeshHandle CreateMesh(std::span<const TVertex> vertices, std::span<const uint32_t> indices = {})
+        {
+            if (sizeof(TVertex) != m_Vertices.GetElementSize() || m_IndexElementSize != SDL_GPU_INDEXELEMENTSIZE_32BIT)
+                SDLException("Mesh data does not match the mesh pool layout");
+            return CreateMesh(vertices.data(), uint32_t(vertices.size()), indices.empty() ? nullptr : indices.data(), uint32_t(indices.size()));
+        }
+
+        // Maps a .mesh file from tools/MeshCooker and queues its vertex and index blobs straight
+        // from the mapping into staging, nothing is parsed. Returns an invalid handle if the file
+        // is missing, throws if it is corrupt or was cooked for another layout or index size.
+        template<typename TVertex>
+        MeshHandle LoadMesh(const std::string& path, CookedMeshInfo* info = nullptr)
+        {
+            return LoadMesh(path, VertexLayout<TVertex>::Type, VertexLayout<TVertex>::Elements, info);
+        }
+
+        MeshHandle LoadMesh(const std::string& path, uint8_t vertexType, std::span<const VertexElement> elements, CookedMeshInfo* info = nullptr);
+
+        void DestroyMesh(MeshHandle mesh);
+
+        GpuBufferRange GetVertices(MeshHandle mesh) const { return m_Vertices.GetRange(mesh.Vertices); }
+        GpuBufferRange GetIndices(MeshHandle mesh) const { return m_Indices.GetRange(mesh.Indices); }
+        SDL_GPUIndexElementSize GetIndexElementSize() const { return m_IndexElementSize; }
+
+        // Budget is shared between the vertex and index pools
+        uint32_t Defragment(uint64_t maxBytes = UINT64_MAX);
+
+        GpuBufferPool& GetVertexPool() { return m_Vertices; }
+        GpuBufferPool& GetIndexPool() { return m_Indices; }
+        const GpuBufferPool& GetVertexPool() const { return m_Vertices; }
+        const GpuBufferPool& GetIndexPool() const { return m_Indices; }
+
+    private:
+        GpuBufferPool m_Vertices;
+        GpuBufferPool m_Indices;
+        SDL_GPUIndexElementSize m_IndexElementSize{SDL_GPU_INDEXELEMENTSIZE_32BIT};
+};
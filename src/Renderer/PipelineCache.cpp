@@ -0,0 +1,473 @@
+#include "PipelineCache.hpp"
+#include "SortKey.hpp"
+#include <type_traits>
+
+
+namespace
+{
+	// FNV-1a over individual fields, hashing whole SDL structs would pick up padding
+	constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+	constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+	template<typename T>
+	void HashValue(uint64_t& hash, const T& value)
+	{
+		static_assert(std::is_scalar_v<T>);
+		const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+		for (size_t i = 0; i < sizeof(T); i++)
+		{
+			hash ^= bytes[i];
+			hash *= FNV_PRIME;
+		}
+	}
+
+	void HashStencil(uint64_t& hash, const SDL_GPUStencilOpState& state)
+	{
+		HashValue(hash, state.fail_op);
+		HashValue(hash, state.pass_op);
+		HashValue(hash, state.depth_fail_op);
+		HashValue(hash, state.compare_op);
+	}
+
+	bool EqualStencil(const SDL_GPUStencilOpState& a, const SDL_GPUStencilOpState& b)
+	{
+		return a.fail_op == b.fail_op && a.pass_op == b.pass_op &&
+			a.depth_fail_op == b.depth_fail_op && a.compare_op == b.compare_op;
+	}
+
+	bool EqualVertexInput(const SDL_GPUVertexInputState* a, const SDL_GPUVertexInputState* b)
+	{
+		uint32_t bufferCount = a ? a->num_vertex_buffers : 0;
+		uint32_t attributeCount = a ? a->num_vertex_attributes : 0;
+		if (bufferCount != (b ? b->num_vertex_buffers : 0) || attributeCount != (b ? b->num_vertex_attributes : 0))
+			return false;
+
+		for (uint32_t i = 0; i < bufferCount; i++)
+		{
+			const SDL_GPUVertexBufferDescription& x = a->vertex_buffer_descriptions[i];
+			const SDL_GPUVertexBufferDescription& y = b->vertex_buffer_descriptions[i];
+			if (x.slot != y.slot || x.pitch != y.pitch || x.input_rate != y.input_rate || x.instance_step_rate != y.instance_step_rate)
+				return false;
+		}
+
+		for (uint32_t i = 0; i < attributeCount; i++)
+		{
+			const SDL_GPUVertexAttribute& x = a->vertex_attributes[i];
+			const SDL_GPUVertexAttribute& y = b->vertex_attributes[i];
+			if (x.location != y.location || x.buffer_slot != y.buffer_slot || x.format != y.format || x.offset != y.offset)
+				return false;
+		}
+
+		return true;
+	}
+
+	// Marks an id slot whose pipeline was destroyed, never a valid pipeline address
+	SDL_GPUGraphicsPipeline* const ID_TOMBSTONE = reinterpret_cast<SDL_GPUGraphicsPipeline*>(uintptr_t(1));
+
+	uint32_t IdSlotIndex(SDL_GPUGraphicsPipeline* pipeline, uint32_t slotCount)
+	{
+		// Fibonacci hashing, the low bits of a heap address carry little entropy
+		return uint32_t((uint64_t(uintptr_t(pipeline)) * 11400714819323198485ull) >> 32) & (slotCount - 1);
+	}
+}
+
+
+PipelineCache::PipelineCache(SDL_GPUDevice* device)
+{
+	m_Device = device;
+	m_IdSlots = std::make_unique<IdSlot[]>(ID_SLOT_COUNT);
+}
+
+PipelineCache::~PipelineCache()
+{
+	Cleanup();
+}
+
+void PipelineCache::Cleanup()
+{
+	std::lock_guard lock(m_Mutex);
+	if (!m_Device)
+		return;
+
+	for (auto& [hash, entry] : m_Pipelines)
+		DestroyPipeline(entry);
+	m_Pipelines.clear();
+	m_PipelineLookup.clear();
+
+	for (uint32_t i = 0; i < ID_SLOT_COUNT; i++)
+		m_IdSlots[i].Pipeline.store(nullptr, std::memory_order_relaxed);
+
+	for (auto& [shader, entry] : m_Shaders)
+		SDL_ReleaseGPUShader(m_Device, shader);
+	m_Shaders.clear();
+	m_ShadersByName.clear();
+
+	m_Stats.Pipelines = 0;
+	m_Stats.Shaders = 0;
+	m_Device = nullptr;
+}
+
+
+
+SDL_GPUShader* PipelineCache::AddShader(const std::string& name, SDL_GPUShader* shader)
+{
+	std::unique_lock lock(m_Mutex);
+
+	// Lost a race against another thread loading the same shader
+	auto existing = m_ShadersByName.find(name);
+	if (existing != m_ShadersByName.end())
+	{
+		SDL_GPUShader* winner = existing->second;
+		RetainShaderLocked(winner);
+		lock.unlock();
+
+		SDL_ReleaseGPUShader(m_Device, shader);
+		return winner;
+	}
+
+	m_Shaders[shader] = ShaderEntry{name, 1};
+	m_ShadersByName[name] = shader;
+	m_Stats.Shaders = m_Shaders.size();
+	return shader;
+}
+
+SDL_GPUShader* PipelineCache::FindShader(const std::string& name)
+{
+	std::lock_guard lock(m_Mutex);
+
+	auto it = m_ShadersByName.find(name);
+	if (it == m_ShadersByName.end())
+		return nullptr;
+
+	RetainShaderLocked(it->second);
+	return it->second;
+}
+
+void PipelineCache::RetainShader(SDL_GPUShader* shader)
+{
+	std::lock_guard lock(m_Mutex);
+	RetainShaderLocked(shader);
+}
+
+void PipelineCache::ReleaseShader(SDL_GPUShader* shader)
+{
+	std::lock_guard lock(m_Mutex);
+	ReleaseShaderLocked(shader);
+}
+
+void PipelineCache::RetainShaderLocked(SDL_GPUShader* shader)
+{
+	auto it = m_Shaders.find(shader);
+	if (it == m_Shaders.end())
+		SDLException("Retaining a shader that was not loaded through the pipeline cache");
+
+	it->second.References++;
+}
+
+void PipelineCache::ReleaseShaderLocked(SDL_GPUShader* shader)
+{
+	auto it = m_Shaders.find(shader);
+	if (it == m_Shaders.end() || --it->second.References > 0)
+		return;
+
+	m_ShadersByName.erase(it->second.Name);
+	m_Shaders.erase(it);
+	m_Stats.Shaders = m_Shaders.size();
+
+	SDL_ReleaseGPUShader(m_Device, shader);
+}
+
+
+
+uint64_t PipelineCache::Hash(const PipelineDesc& desc)
+{
+	uint64_t hash = FNV_OFFSET;
+
+	HashValue(hash, desc.VertexShader);
+	HashValue(hash, desc.FragmentShader);
+
+	if (const SDL_GPUVertexInputState* input = desc.VertexInput)
+	{
+		HashValue(hash, input->num_vertex_buffers);
+		for (uint32_t i = 0; i < input->num_vertex_buffers; i++)
+		{
+			const SDL_GPUVertexBufferDescription& buffer = input->vertex_buffer_descriptions[i];
+			HashValue(hash, buffer.slot);
+			HashValue(hash, buffer.pitch);
+			HashValue(hash, buffer.input_rate);
+			HashValue(hash, buffer.instance_step_rate);
+		}
+
+		HashValue(hash, input->num_vertex_attributes);
+		for (uint32_t i = 0; i < input->num_vertex_attributes; i++)
+		{
+			const SDL_GPUVertexAttribute& attribute = input->vertex_attributes[i];
+			HashValue(hash, attribute.location);
+			HashValue(hash, attribute.buffer_slot);
+			HashValue(hash, attribute.format);
+			HashValue(hash, attribute.offset);
+		}
+	}
+
+	HashValue(hash, desc.PrimitiveType);
+
+	const SDL_GPURasterizerState& raster = desc.Rasterizer;
+	HashValue(hash, raster.fill_mode);
+	HashValue(hash, raster.cull_mode);
+	HashValue(hash, raster.front_face);
+	HashValue(hash, raster.depth_bias_constant_factor);
+	HashValue(hash, raster.depth_bias_clamp);
+	HashValue(hash, raster.depth_bias_slope_factor);
+	HashValue(hash, raster.enable_depth_bias);
+	HashValue(hash, raster.enable_depth_clip);
+
+	const SDL_GPUColorTargetBlendState& blend = desc.Blend;
+	HashValue(hash, blend.src_color_blendfactor);
+	HashValue(hash, blend.dst_color_blendfactor);
+	HashValue(hash, blend.color_blend_op);
+	HashValue(hash, blend.src_alpha_blendfactor);
+	HashValue(hash, blend.dst_alpha_blendfactor);
+	HashValue(hash, blend.alpha_blend_op);
+	HashValue(hash, blend.color_write_mask);
+	HashValue(hash, blend.enable_blend);
+	HashValue(hash, blend.enable_color_write_mask);
+
+	const SDL_GPUDepthStencilState& depth = desc.DepthStencil;
+	HashValue(hash, depth.compare_op);
+	HashStencil(hash, depth.back_stencil_state);
+	HashStencil(hash, depth.front_stencil_state);
+	HashValue(hash, depth.compare_mask);
+	HashValue(hash, depth.write_mask);
+	HashValue(hash, depth.enable_depth_test);
+	HashValue(hash, depth.enable_depth_write);
+	HashValue(hash, depth.enable_stencil_test);
+
+	HashValue(hash, desc.ColorFormat);
+	HashValue(hash, desc.DepthFormat);
+
+	return hash;
+}
+
+bool PipelineCache::Equal(const PipelineDesc& a, const PipelineDesc& b)
+{
+	const SDL_GPURasterizerState& ra = a.Rasterizer;
+	const SDL_GPURasterizerState& rb = b.Rasterizer;
+	const SDL_GPUColorTargetBlendState& ba = a.Blend;
+	const SDL_GPUColorTargetBlendState& bb = b.Blend;
+	const SDL_GPUDepthStencilState& da = a.DepthStencil;
+	const SDL_GPUDepthStencilState& db = b.DepthStencil;
+
+	return a.VertexShader == b.VertexShader && a.FragmentShader == b.FragmentShader &&
+		EqualVertexInput(a.VertexInput, b.VertexInput) &&
+		a.PrimitiveType == b.PrimitiveType &&
+		ra.fill_mode == rb.fill_mode && ra.cull_mode == rb.cull_mode && ra.front_face == rb.front_face &&
+		ra.depth_bias_constant_factor == rb.depth_bias_constant_factor && ra.depth_bias_clamp == rb.depth_bias_clamp &&
+		ra.depth_bias_slope_factor == rb.depth_bias_slope_factor &&
+		ra.enable_depth_bias == rb.enable_depth_bias && ra.enable_depth_clip == rb.enable_depth_clip &&
+		ba.src_color_blendfactor == bb.src_color_blendfactor && ba.dst_color_blendfactor == bb.dst_color_blendfactor &&
+		ba.color_blend_op == bb.color_blend_op && ba.src_alpha_blendfactor == bb.src_alpha_blendfactor &&
+		ba.dst_alpha_blendfactor == bb.dst_alpha_blendfactor && ba.alpha_blend_op == bb.alpha_blend_op &&
+		ba.color_write_mask == bb.color_write_mask && ba.enable_blend == bb.enable_blend &&
+		ba.enable_color_write_mask == bb.enable_color_write_mask &&
+		da.compare_op == db.compare_op &&
+		EqualStencil(da.back_stencil_state, db.back_stencil_state) &&
+		EqualStencil(da.front_stencil_state, db.front_stencil_state) &&
+		da.compare_mask == db.compare_mask && da.write_mask == db.write_mask &&
+		da.enable_depth_test == db.enable_depth_test && da.enable_depth_write == db.enable_depth_write &&
+		da.enable_stencil_test == db.enable_stencil_test &&
+		a.ColorFormat == b.ColorFormat && a.DepthFormat == b.DepthFormat;
+}
+
+
+
+SDL_GPUGraphicsPipeline* PipelineCache::GetPipeline(const PipelineDesc& desc)
+{
+	const uint64_t hash = Hash(desc);
+
+	{
+		std::lock_guard lock(m_Mutex);
+		if (PipelineEntry* entry = FindPipeline(hash, desc))
+		{
+			m_Stats.Hits++;
+			entry->References++;
+			return entry->Pipeline;
+		}
+	}
+
+	SDL_GPUColorTargetDescription colorTargetDescription{};
+	colorTargetDescription.format = desc.ColorFormat;
+	colorTargetDescription.blend_state = desc.Blend;
+
+	SDL_GPUGraphicsPipelineCreateInfo pipelineCreateInfo{};
+	pipelineCreateInfo.vertex_shader = desc.VertexShader;
+	pipelineCreateInfo.fragment_shader = desc.FragmentShader;
+	pipelineCreateInfo.primitive_type = desc.PrimitiveType;
+	pipelineCreateInfo.rasterizer_state = desc.Rasterizer;
+	pipelineCreateInfo.depth_stencil_state = desc.DepthStencil;
+	pipelineCreateInfo.target_info.color_target_descriptions = &colorTargetDescription;
+	pipelineCreateInfo.target_info.num_color_targets = 1;
+	pipelineCreateInfo.target_info.depth_stencil_format = desc.DepthFormat;
+	pipelineCreateInfo.target_info.has_depth_stencil_target = desc.DepthFormat != SDL_GPU_TEXTUREFORMAT_INVALID;
+
+	if (desc.VertexInput)
+		pipelineCreateInfo.vertex_input_state = *desc.VertexInput;
+
+	// Driver compilation is the slow part, other threads keep using the cache meanwhile
+	const uint64_t start = SDL_GetTicksNS();
+	SDL_GPUGraphicsPipeline* pipeline = SDL_CreateGPUGraphicsPipeline(m_Device, &pipelineCreateInfo);
+	const uint64_t creationTime = SDL_GetTicksNS() - start;
+
+	std::unique_lock lock(m_Mutex);
+	m_Stats.Misses++;
+	m_Stats.CreationTimeNS += creationTime;
+
+	if (!pipeline)
+		return nullptr;
+
+	// Another thread created the same pipeline while we were compiling
+	if (PipelineEntry* existing = FindPipeline(hash, desc))
+	{
+		existing->References++;
+		SDL_GPUGraphicsPipeline* winner = existing->Pipeline;
+		lock.unlock();
+
+		SDL_ReleaseGPUGraphicsPipeline(m_Device, pipeline);
+		return winner;
+	}
+
+	PipelineEntry& entry = m_Pipelines.emplace(hash, PipelineEntry{})->second;
+	entry.Desc = desc;
+	entry.Pipeline = pipeline;
+	entry.References = 1;
+
+	// Own a copy of the vertex input so the key outlives the caller's state
+	if (desc.VertexInput)
+	{
+		const SDL_GPUVertexInputState& input = *desc.VertexInput;
+		entry.VertexBuffers.assign(input.vertex_buffer_descriptions, input.vertex_buffer_descriptions + input.num_vertex_buffers);
+		entry.VertexAttributes.assign(input.vertex_attributes, input.vertex_attributes + input.num_vertex_attributes);
+		entry.VertexInput.vertex_buffer_descriptions = entry.VertexBuffers.data();
+		entry.VertexInput.num_vertex_buffers = input.num_vertex_buffers;
+		entry.VertexInput.vertex_attributes = entry.VertexAttributes.data();
+		entry.VertexInput.num_vertex_attributes = input.num_vertex_attributes;
+		entry.Desc.VertexInput = &entry.VertexInput;
+	}
+
+	// The pipeline keeps its shaders alive for as long as it is cached
+	RetainShaderLocked(desc.VertexShader);
+	RetainShaderLocked(desc.FragmentShader);
+
+	m_PipelineLookup[pipeline] = &entry;
+	m_Stats.Pipelines = m_PipelineLookup.size();
+	InsertPipelineId(pipeline, SortKey::WrapKeyId(m_NextPipelineId++));
+	return pipeline;
+}
+
+void PipelineCache::ReleasePipeline(SDL_GPUGraphicsPipeline* pipeline)
+{
+	std::lock_guard lock(m_Mutex);
+	auto it = m_PipelineLookup.find(pipeline);
+	if (it != m_PipelineLookup.end() && it->second->References > 0)
+		it->second->References--;
+}
+
+void PipelineCache::Trim()
+{
+	std::lock_guard lock(m_Mutex);
+	for (auto it = m_Pipelines.begin(); it != m_Pipelines.end();)
+	{
+		if (it->second.References > 0)
+		{
+			++it;
+			continue;
+		}
+
+		m_PipelineLookup.erase(it->second.Pipeline);
+		RemovePipelineId(it->second.Pipeline);
+		DestroyPipeline(it->second);
+		it = m_Pipelines.erase(it);
+	}
+
+	m_Stats.Pipelines = m_PipelineLookup.size();
+}
+
+uint16_t PipelineCache::GetPipelineId(SDL_GPUGraphicsPipeline* pipeline) const
+{
+	if (!pipeline)
+		return 0;
+
+	uint32_t slot = IdSlotIndex(pipeline, ID_SLOT_COUNT);
+	for (uint32_t probe = 0; probe < ID_SLOT_COUNT; probe++)
+	{
+		SDL_GPUGraphicsPipeline* key = m_IdSlots[slot].Pipeline.load(std::memory_order_acquire);
+		if (key == pipeline)
+			return m_IdSlots[slot].Id.load(std::memory_order_relaxed);
+		if (!key)
+			break;
+		slot = (slot + 1) & (ID_SLOT_COUNT - 1);
+	}
+	return 0;
+}
+
+PipelineCacheStats PipelineCache::GetStats() const
+{
+	std::lock_guard lock(m_Mutex);
+	return m_Stats;
+}
+
+PipelineCache::PipelineEntry* PipelineCache::FindPipeline(uint64_t hash, const PipelineDesc& desc)
+{
+	auto [first, last] = m_Pipelines.equal_range(hash);
+	for (auto it = first; it != last; ++it)
+	{
+		if (Equal(it->second.Desc, desc))
+			return &it->second;
+	}
+	return nullptr;
+}
+
+void PipelineCache::DestroyPipeline(PipelineEntry& entry)
+{
+	SDL_ReleaseGPUGraphicsPipeline(m_Device, entry.Pipeline);
+	entry.Pipeline = nullptr;
+
+	ReleaseShaderLocked(entry.Desc.VertexShader);
+	ReleaseShaderLocked(entry.Desc.FragmentShader);
+}
+
+void PipelineCache::InsertPipelineId(SDL_GPUGraphicsPipeline* pipeline, uint16_t id)
+{
+	// The pipeline is new, so the first free or dead slot on its probe sequence is its own.
+	// A full table only costs the sort key its pipeline grouping.
+	uint32_t slot = IdSlotIndex(pipeline, ID_SLOT_COUNT);
+	for (uint32_t probe = 0; probe < ID_SLOT_COUNT; probe++)
+	{
+		IdSlot& entry = m_IdSlots[slot];
+		SDL_GPUGraphicsPipeline* key = entry.Pipeline.load(std::memory_order_relaxed);
+		if (!key || key == ID_TOMBSTONE)
+		{
+			entry.Id.store(id, std::memory_order_relaxed);
+			entry.Pipeline.store(pipeline, std::memory_order_release);
+			return;
+		}
+		slot = (slot + 1) & (ID_SLOT_COUNT - 1);
+	}
+}
+
+void PipelineCache::RemovePipelineId(SDL_GPUGraphicsPipeline* pipeline)
+{
+	uint32_t slot = IdSlotIndex(pipeline, ID_SLOT_COUNT);
+	for (uint32_t probe = 0; probe < ID_SLOT_COUNT; probe++)
+	{
+		IdSlot& entry = m_IdSlots[slot];
+		SDL_GPUGraphicsPipeline* key = entry.Pipeline.load(std::memory_order_relaxed);
+		if (key == pipeline)
+		{
+			entry.Pipeline.store(ID_TOMBSTONE, std::memory_order_release);
+			return;
+		}
+		if (!key)
+			return;
+		slot = (slot + 1) & (ID_SLOT_COUNT - 1);
+	}
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "common.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <SDL3/SDL_gpu.h>
+
+
+// Everything that goes into a graphics pipeline.
+// Two descriptors with equal contents map to the same cached pipeline.
+struct PipelineDesc
+{
+	SDL_GPUShader* VertexShader{nullptr};
+	SDL_GPUShader* FragmentShader{nullptr};
+
+	// Usually &VertexInputFor<T>::State, null for pipelines without vertex buffers
+	const SDL_GPUVertexInputState* VertexInput{nullptr};
+
+	SDL_GPUPrimitiveType PrimitiveType{SDL_GPU_PRIMITIVETYPE_TRIANGLELIST};
+	SDL_GPURasterizerState Rasterizer{}; // zero is solid fill, no culling, counter-clockwise front faces
+	SDL_GPUColorTargetBlendState Blend{};
+	SDL_GPUDepthStencilState DepthStencil{}; // zero is no depth test or write, see DepthState()
+
+	// INVALID means the renderer's frame targets, the swapchain format and the depth buffer format
+	SDL_GPUTextureFormat ColorFormat{SDL_GPU_TEXTUREFORMAT_INVALID};
+	SDL_GPUTextureFormat DepthFormat{SDL_GPU_TEXTUREFORMAT_INVALID};
+};
+
+// Depth test without stencil for PipelineDesc::DepthStencil. The depth buffer clears to 1,
+// so LESS with writes is the usual opaque state and EQUAL without writes shades only the
+// fragments a depth pre-pass left visible.
+constexpr SDL_GPUDepthStencilState DepthState(SDL_GPUCompareOp compare = SDL_GPU_COMPAREOP_LESS, bool write = true)
+{
+	SDL_GPUDepthStencilState state{};
+	state.compare_op = compare;
+	state.enable_depth_test = true;
+	state.enable_depth_write = write;
+	return state;
+}
+
+struct PipelineCacheStats
+{
+	uint32_t Hits{0};
+	uint32_t Misses{0};
+	uint32_t Pipelines{0};
+	uint32_t Shaders{0};
+	uint64_t CreationTimeNS{0}; // total time spent in SDL_CreateGPUGraphicsPipeline
+};
+
+
+// Caches graphics pipelines by their full create state and keeps shaders
+// alive through reference counts, so shaders can be shared between pipelines
+// and pipelines requested again are returned without touching the driver.
+// All methods are thread safe, driver calls run outside the lock.
+class PipelineCache
+{
+	public:
+		PipelineCache(SDL_GPUDevice* device);
+		virtual ~PipelineCache();
+
+		void Cleanup();
+
+		// Shaders ------------------------------------------------------------
+		// Registers a newly created shader under `name` with a reference count of one.
+		// If another thread registered the name first, `shader` is released and the
+		// existing one is returned with an extra reference instead.
+		SDL_GPUShader* AddShader(const std::string& name, SDL_GPUShader* shader);
+
+		// Returns the shader registered under `name` with an extra reference, or null
+		SDL_GPUShader* FindShader(const std::string& name);
+
+		void RetainShader(SDL_GPUShader* shader);
+		void ReleaseShader(SDL_GPUShader* shader);
+
+		// Pipelines ----------------------------------------------------------
+		// Returns the cached pipeline for `desc` or creates it. Every call adds a reference.
+		// `desc.ColorFormat` and `desc.DepthFormat` must already be resolved to real formats.
+		SDL_GPUGraphicsPipeline* GetPipeline(const PipelineDesc& desc);
+
+		// Drops a reference, unreferenced pipelines stay cached until Trim()
+		void ReleasePipeline(SDL_GPUGraphicsPipeline* pipeline);
+
+		// Destroys all pipelines nobody holds a reference to
+		void Trim();
+
+		// Small per-pipeline id for building draw sort keys, 0 if unknown.
+		// Called for every draw, so it reads a table of its own without taking the lock.
+		uint16_t GetPipelineId(SDL_GPUGraphicsPipeline* pipeline) const;
+
+		PipelineCacheStats GetStats() const;
+
+		static uint64_t Hash(const PipelineDesc& desc);
+		static bool Equal(const PipelineDesc& a, const PipelineDesc& b);
+
+	private:
+		struct ShaderEntry
+		{
+			std::string Name;
+			uint32_t References{0};
+		};
+
+		struct PipelineEntry
+		{
+			// Desc.VertexInput points at the copy below, callers' states may be temporaries
+			PipelineDesc Desc{};
+			SDL_GPUVertexInputState VertexInput{};
+			std::vector<SDL_GPUVertexBufferDescription> VertexBuffers;
+			std::vector<SDL_GPUVertexAttribute> VertexAttributes;
+
+			SDL_GPUGraphicsPipeline* Pipeline{nullptr};
+			uint32_t References{0};
+		};
+
+		// Slot of the pipeline id table, Pipeline is published after Id
+		struct IdSlot
+		{
+			std::atomic<SDL_GPUGraphicsPipeline*> Pipeline{nullptr};
+			std::atomic<uint16_t> Id{0};
+		};
+
+		static constexpr uint32_t ID_SLOT_COUNT = 8192;   // power of two
+
+		SDL_GPUDevice* m_Device{nullptr};
+		mutable std::mutex m_Mutex;
+
+		std::unordered_map<SDL_GPUShader*, ShaderEntry> m_Shaders;
+		std::unordered_map<std::string, SDL_GPUShader*> m_ShadersByName;
+
+		// Hash -> entries, a multimap so colliding hashes are still told apart by Equal()
+		std::unordered_multimap<uint64_t, PipelineEntry> m_Pipelines;
+		std::unordered_map<SDL_GPUGraphicsPipeline*, PipelineEntry*> m_PipelineLookup;
+		uint32_t m_NextPipelineId{0};   // sequence, wrapped into the sort key's 12 bits
+
+		// Pipeline -> id with linear probing, written under m_Mutex and read without it.
+		// Destroyed pipelines leave a tombstone that probes pass over and inserts reuse.
+		std::unique_ptr<IdSlot[]> m_IdSlots;
+
+		PipelineCacheStats m_Stats{};
+
+		// Callers hold m_Mutex
+		PipelineEntry* FindPipeline(uint64_t hash, const PipelineDesc& desc);
+		void RetainShaderLocked(SDL_GPUShader* shader);
+		void ReleaseShaderLocked(SDL_GPUShader* shader);
+		void DestroyPipeline(PipelineEntry& entry);
+		void InsertPipelineId(SDL_GPUGraphicsPipeline* pipeline, uint16_t id);
+		void RemovePipelineId(SDL_GPUGraphicsPipeline* pipeline);
+};
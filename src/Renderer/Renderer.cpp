@@ -0,0 +1,1189 @@
+#include "Renderer.hpp"
+#include "VertexBuffer.hpp"
+#include "Core/AllocationTracker.hpp"
+#include "Core/Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+
+
+static constexpr SDL_FColor CLEAR_COLOR{0.1f, 0.1f, 0.2f, 1.0f};
+
+
+Renderer::Renderer(SDL_Window* window, uint32_t headlessWidth, uint32_t headlessHeight)
+{
+	m_Window = window;
+
+	// Create a GPU device with SPIR-V, DirectX IL, and Metal shader formats enabled
+	// and claim the window for the GPU device
+	Device = SDL_CreateGPUDevice(SDL_GPU_SHADERFORMAT_SPIRV |
+							SDL_GPU_SHADERFORMAT_DXIL |
+							SDL_GPU_SHADERFORMAT_MSL,
+							true,nullptr);
+	if (!Device)
+		SDLException("Failed to create GPU device");
+
+	if (window && !SDL_ClaimWindowForGPUDevice(Device, window))
+	{
+		SDLException("Failed to claim window for GPU device");
+	}
+
+	if (!window)
+	{
+		SDL_GPUTextureCreateInfo textureCreateInfo{};
+		textureCreateInfo.type = SDL_GPU_TEXTURETYPE_2D;
+		textureCreateInfo.format = HEADLESS_FORMAT;
+		textureCreateInfo.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
+		textureCreateInfo.width = headlessWidth;
+		textureCreateInfo.height = headlessHeight;
+		textureCreateInfo.layer_count_or_depth = 1;
+		textureCreateInfo.num_levels = 1;
+
+		m_HeadlessTarget = SDL_CreateGPUTexture(Device, &textureCreateInfo);
+		if (!m_HeadlessTarget)
+			SDLException("Failed to create headless render target");
+
+		m_HeadlessWidth = headlessWidth;
+		m_HeadlessHeight = headlessHeight;
+	}
+
+	// D16 is supported everywhere, the others are preferred for their precision
+	for (SDL_GPUTextureFormat format : { SDL_GPU_TEXTUREFORMAT_D32_FLOAT, SDL_GPU_TEXTUREFORMAT_D24_UNORM, SDL_GPU_TEXTUREFORMAT_D16_UNORM })
+	{
+		if (SDL_GPUTextureSupportsFormat(Device, format, SDL_GPU_TEXTURETYPE_2D, SDL_GPU_TEXTUREUSAGE_DEPTH_STENCIL_TARGET))
+		{
+			m_DepthFormat = format;
+			break;
+		}
+	}
+
+	fprintf(stderr, "Using GPU Driver: %s\n", SDL_GetGPUDeviceDriver(Device));
+
+	Profiler::SetThreadName("Main");
+
+	SetFramePacing(m_PacingSettings);
+
+	Uploader = std::make_unique<UploadManager>(Device);
+	m_PipelineCache = std::make_unique<PipelineCache>(Device);
+	Jobs = std::make_unique<JobSystem>();
+	Textures = std::make_unique<TextureManager>(Device, Uploader.get(), Jobs.get());
+
+	// Optional, LoadShader falls back to loose files when the archive was not built
+	if (BasePath)
+		m_ShaderArchive.Open(std::string(BasePath) + "shaders.pack");
+}
+
+Renderer::~Renderer()
+{
+	Cleanup();
+}
+
+
+
+bool Renderer::LoadShaderCode(const std::string& shaderSource, ShaderCode& shaderCode)
+{
+	ShaderArchiveBackend backend;
+	std::string extension;
+
+	SDL_GPUShaderFormat backendFormats = SDL_GetGPUShaderFormats(Device);
+
+	if (backendFormats & SDL_GPU_SHADERFORMAT_SPIRV)
+	{
+		extension = ".spv";
+		shaderCode.Format = SDL_GPU_SHADERFORMAT_SPIRV;
+		backend = ShaderArchiveBackend::SPIRV;
+		shaderCode.EntryPoint = "main";
+	}
+	else if (backendFormats & SDL_GPU_SHADERFORMAT_DXIL)
+	{
+		extension = ".dxil";
+		shaderCode.Format = SDL_GPU_SHADERFORMAT_DXIL;
+		backend = ShaderArchiveBackend::DXIL;
+		shaderCode.EntryPoint = "main";
+	}
+	else if (backendFormats & SDL_GPU_SHADERFORMAT_MSL)
+	{
+		extension = ".msl";
+		shaderCode.Format = SDL_GPU_SHADERFORMAT_MSL;
+		backend = ShaderArchiveBackend::MSL;
+		shaderCode.EntryPoint = "main";
+	}
+	else
+	{
+		SDLException("No supported shader formats available");
+		return false;
+	}
+
+	// Packed shaders come straight out of the mapped archive with reflected resource counts
+	shaderCode.Entry = m_ShaderArchive.IsOpen() ? m_ShaderArchive.Find(shaderSource) : nullptr;
+	if (shaderCode.Entry)
+	{
+		shaderCode.Code = m_ShaderArchive.GetCode(*shaderCode.Entry, backend);
+		if (!shaderCode.Code.empty())
+			return true;
+		shaderCode.Entry = nullptr;
+	}
+
+	// Loose files, used when no archive was built
+	std::string fullPath = std::string(BasePath) + "shaders/" + shaderSource + extension;
+
+	size_t codeSize;
+	shaderCode.OwnedCode = static_cast<uint8_t*>(SDL_LoadFile(fullPath.c_str(), &codeSize));
+	if (!shaderCode.OwnedCode)
+	{
+		SDLException("Failed to load shader file: " + fullPath);
+		return false;
+	}
+
+	shaderCode.Code = { shaderCode.OwnedCode, codeSize };
+	return true;
+}
+
+SDL_GPUShader* Renderer::LoadShader(const std::string& shaderSource, const uint32_t samplerCount, const uint32_t uniformBufferCount, const uint32_t storageBufferCount, const uint32_t storageTextureCount)
+{
+	if (SDL_GPUShader* cached = m_PipelineCache->FindShader(shaderSource))
+		return cached;
+
+	ShaderCode shaderCode{};
+	if (!LoadShaderCode(shaderSource, shaderCode))
+		return nullptr;
+
+	SDL_GPUShaderCreateInfo shaderInfo{};
+	shaderInfo.code = shaderCode.Code.data();
+	shaderInfo.code_size = shaderCode.Code.size();
+	shaderInfo.entrypoint = shaderCode.EntryPoint;
+	shaderInfo.format = shaderCode.Format;
+
+	if (const ShaderArchiveEntry* entry = shaderCode.Entry)
+	{
+		switch (entry->Stage)
+		{
+			case ShaderArchiveStage::Vertex: shaderInfo.stage = SDL_GPU_SHADERSTAGE_VERTEX; break;
+			case ShaderArchiveStage::Fragment: shaderInfo.stage = SDL_GPU_SHADERSTAGE_FRAGMENT; break;
+			default:
+				SDLException("Shader archive entry is not a graphics shader: " + shaderSource);
+				return nullptr;
+		}
+
+		shaderInfo.num_samplers = entry->SamplerCount;
+		shaderInfo.num_uniform_buffers = entry->UniformBufferCount;
+		shaderInfo.num_storage_buffers = entry->StorageBufferCount;
+		shaderInfo.num_storage_textures = entry->StorageTextureCount;
+	}
+	else
+	{
+		if (shaderSource.contains(".vert"))
+		{
+			shaderInfo.stage = SDL_GPU_SHADERSTAGE_VERTEX;
+		}
+		else if (shaderSource.contains(".frag"))
+		{
+			shaderInfo.stage = SDL_GPU_SHADERSTAGE_FRAGMENT;
+		}
+		else
+		{
+			SDL_free(shaderCode.OwnedCode);
+			SDLException("Unrecognized shader type. Shader Filenames must contain either '.vert' or '.frag'");
+			return nullptr;
+		}
+
+		shaderInfo.num_samplers = samplerCount;
+		shaderInfo.num_uniform_buffers = uniformBufferCount;
+		shaderInfo.num_storage_buffers = storageBufferCount;
+		shaderInfo.num_storage_textures = storageTextureCount;
+	}
+
+	SDL_GPUShader* shader = SDL_CreateGPUShader(Device, &shaderInfo);
+	SDL_free(shaderCode.OwnedCode);
+
+	if (!shader)
+	{
+		SDLException("Failed to create GPU shader");
+		return nullptr;
+	}
+
+	// Returns the other thread's shader if it was loaded concurrently
+	return m_PipelineCache->AddShader(shaderSource, shader);
+
+}
+
+SDL_GPUComputePipeline* Renderer::CreateComputePipeline(const std::string& shaderSource, const ComputePipelineInfo& info)
+{
+	ShaderCode shaderCode{};
+	if (!LoadShaderCode(shaderSource, shaderCode))
+		return nullptr;
+
+	SDL_GPUComputePipelineCreateInfo pipelineCreateInfo{};
+	pipelineCreateInfo.code = shaderCode.Code.data();
+	pipelineCreateInfo.code_size = shaderCode.Code.size();
+	pipelineCreateInfo.entrypoint = shaderCode.EntryPoint;
+	pipelineCreateInfo.format = shaderCode.Format;
+
+	if (const ShaderArchiveEntry* entry = shaderCode.Entry)
+	{
+		if (entry->Stage != ShaderArchiveStage::Compute)
+		{
+			SDLException("Shader archive entry is not a compute shader: " + shaderSource);
+			return nullptr;
+		}
+
+		pipelineCreateInfo.num_samplers = entry->SamplerCount;
+		pipelineCreateInfo.num_readonly_storage_textures = entry->StorageTextureCount;
+		pipelineCreateInfo.num_readonly_storage_buffers = entry->StorageBufferCount;
+		pipelineCreateInfo.num_readwrite_storage_textures = entry->ReadWriteStorageTextureCount;
+		pipelineCreateInfo.num_readwrite_storage_buffers = entry->ReadWriteStorageBufferCount;
+		pipelineCreateInfo.num_uniform_buffers = entry->UniformBufferCount;
+		pipelineCreateInfo.threadcount_x = entry->ThreadCount[0];
+		pipelineCreateInfo.threadcount_y = entry->ThreadCount[1];
+		pipelineCreateInfo.threadcount_z = entry->ThreadCount[2];
+	}
+	else
+	{
+		pipelineCreateInfo.num_samplers = info.SamplerCount;
+		pipelineCreateInfo.num_readonly_storage_textures = info.ReadOnlyStorageTextureCount;
+		pipelineCreateInfo.num_readonly_storage_buffers = info.ReadOnlyStorageBufferCount;
+		pipelineCreateInfo.num_readwrite_storage_textures = info.ReadWriteStorageTextureCount;
+		pipelineCreateInfo.num_readwrite_storage_buffers = info.ReadWriteStorageBufferCount;
+		pipelineCreateInfo.num_uniform_buffers = info.UniformBufferCount;
+		pipelineCreateInfo.threadcount_x = info.ThreadCountX;
+		pipelineCreateInfo.threadcount_y = info.ThreadCountY;
+		pipelineCreateInfo.threadcount_z = info.ThreadCountZ;
+	}
+
+	SDL_GPUComputePipeline* pipeline = SDL_CreateGPUComputePipeline(Device, &pipelineCreateInfo);
+	SDL_free(shaderCode.OwnedCode);
+
+	if (!pipeline)
+		SDLException("Failed to create compute pipeline: " + shaderSource);
+
+	return pipeline;
+}
+
+void Renderer::ReleaseComputePipeline(SDL_GPUComputePipeline* pipeline)
+{
+	if (pipeline)
+		SDL_ReleaseGPUComputePipeline(Device, pipeline);
+}
+
+void Renderer::ReleaseShader(SDL_GPUShader* shader)
+{
+	if (shader)
+		m_PipelineCache->ReleaseShader(shader);
+}
+
+SDL_GPUGraphicsPipeline* Renderer::CreatePipeline(const PipelineDesc& desc)
+{
+	PipelineDesc resolved = desc;
+	if (resolved.ColorFormat == SDL_GPU_TEXTUREFORMAT_INVALID)
+		resolved.ColorFormat = GetColorFormat();
+	if (resolved.DepthFormat == SDL_GPU_TEXTUREFORMAT_INVALID)
+		resolved.DepthFormat = m_DepthFormat;
+
+	return m_PipelineCache->GetPipeline(resolved);
+}
+
+SDL_GPUGraphicsPipeline* Renderer::CreatePipeline(SDL_GPUShader* vertexShader, SDL_GPUShader* fragmentShader, const SDL_GPUVertexInputState* vertexInputState)
+{
+	PipelineDesc desc{};
+	desc.VertexShader = vertexShader;
+	desc.FragmentShader = fragmentShader;
+	desc.VertexInput = vertexInputState;
+	return CreatePipeline(desc);
+}
+
+void Renderer::ReleasePipeline(SDL_GPUGraphicsPipeline * pipeline)
+{
+	if(pipeline)
+		m_PipelineCache->ReleasePipeline(pipeline);
+}
+
+void Renderer::PrewarmPipelines(std::span<const PipelineDesc> descs)
+{
+	for (const PipelineDesc& desc : descs)
+	{
+		if (!CreatePipeline(desc))
+			SDLException("Failed to prewarm graphics pipeline");
+	}
+}
+
+Renderer::AsyncShader Renderer::LoadShaderAsync(const std::string& shaderSource, const uint32_t samplerCount, const uint32_t uniformBufferCount, const uint32_t storageBufferCount, const uint32_t storageTextureCount)
+{
+	return Jobs->ScheduleResult([=, this]
+	{
+		return LoadShader(shaderSource, samplerCount, uniformBufferCount, storageBufferCount, storageTextureCount);
+	});
+}
+
+Renderer::AsyncPipeline Renderer::CreatePipelineAsync(const AsyncShader& vertexShader, const AsyncShader& fragmentShader, PipelineDesc desc)
+{
+	// Resolved here, the swapchain belongs to the calling thread
+	if (desc.ColorFormat == SDL_GPU_TEXTUREFORMAT_INVALID)
+		desc.ColorFormat = GetColorFormat();
+	if (desc.DepthFormat == SDL_GPU_TEXTUREFORMAT_INVALID)
+		desc.DepthFormat = m_DepthFormat;
+
+	const JobHandle dependencies[] = { vertexShader.Job, fragmentShader.Job };
+	return Jobs->ScheduleResult([=, this, vertex = vertexShader.Value, fragment = fragmentShader.Value]() mutable
+	{
+		desc.VertexShader = *vertex;
+		desc.FragmentShader = *fragment;
+		return m_PipelineCache->GetPipeline(desc);
+	}, dependencies);
+}
+
+uint16_t Renderer::GetPipelineId(SDL_GPUGraphicsPipeline* pipeline) const
+{
+	return m_PipelineCache->GetPipelineId(pipeline);
+}
+
+SDL_GPUTextureFormat Renderer::GetColorFormat() const
+{
+	return m_Window ? SDL_GetGPUSwapchainTextureFormat(Device, m_Window) : HEADLESS_FORMAT;
+}
+
+
+
+void Renderer::RetireFrames()
+{
+	// Frames complete in submission order, so the newest signaled fence
+	// tells us everything before it has finished as well
+	for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		if (m_FrameFences[i] && SDL_QueryGPUFence(Device, m_FrameFences[i]))
+			CompleteFrame(i);
+	}
+}
+
+void Renderer::WaitForFrame(uint32_t frameIndex)
+{
+	SDL_GPUFence*& fence = m_FrameFences[frameIndex];
+	if (!fence)
+		return;
+
+	SDL_WaitForGPUFences(Device, true, &fence, 1);
+	CompleteFrame(frameIndex);
+}
+
+void Renderer::CompleteFrame(uint32_t frameIndex)
+{
+	SDL_GPUFence*& fence = m_FrameFences[frameIndex];
+
+	// Only as precise as how often fences are polled, an upper bound on the GPU time
+	Profiler::RecordGpuZone("GPU frame", m_FrameSubmitTimes[frameIndex], Profiler::Now());
+
+	if (m_GpuTimer)
+		m_GpuTimer->Forget(fence);
+
+	m_CompletedFrameSerial = std::max(m_CompletedFrameSerial, m_FrameFenceSerials[frameIndex]);
+	SDL_ReleaseGPUFence(Device, fence);
+	fence = nullptr;
+}
+
+void Renderer::WaitForAllFrames()
+{
+	for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+		WaitForFrame(i);
+}
+
+void Renderer::SetFramePacing(const FramePacingSettings& settings)
+{
+	m_PacingSettings = settings;
+
+	if (m_Window && !SDL_WindowSupportsGPUPresentMode(Device, m_Window, m_PacingSettings.PresentMode))
+	{
+		// VSYNC is the only mode every backend has to support
+		fprintf(stderr, "Present mode %d is not supported, falling back to VSYNC\n", int(m_PacingSettings.PresentMode));
+		m_PacingSettings.PresentMode = SDL_GPU_PRESENTMODE_VSYNC;
+	}
+
+	if (m_Window && !SDL_SetGPUSwapchainParameters(Device, m_Window, SDL_GPU_SWAPCHAINCOMPOSITION_SDR, m_PacingSettings.PresentMode))
+		SDLException("Failed to set swapchain parameters");
+
+	// Frame slots are only resized while nothing is in flight
+	m_PacingSettings.FramesInFlight = std::clamp(m_PacingSettings.FramesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
+	if (m_PacingSettings.FramesInFlight != m_FramesInFlight)
+	{
+		WaitForAllFrames();
+		m_FramesInFlight = m_PacingSettings.FramesInFlight;
+		m_FrameIndex = 0;
+	}
+
+	if (!SDL_SetGPUAllowedFramesInFlight(Device, m_FramesInFlight))
+		SDLException("Failed to set allowed frames in flight");
+
+	m_Pacer.SetTargetFrameRate(m_PacingSettings.TargetFrameRate);
+}
+
+void Renderer::SetResolutionScaling(const ResolutionScaleSettings& settings)
+{
+	m_Scaler.SetSettings(settings);
+
+	// Frames already in flight are not watched, forgetting them is harmless
+	if (settings.Enabled && !m_GpuTimer)
+		m_GpuTimer = std::make_unique<GpuFrameTimer>(Device);
+	else if (!settings.Enabled)
+		m_GpuTimer.reset();
+}
+
+void Renderer::BeginFrame()
+{
+	Profiler::MarkFrame();
+	SDLGPU_PROFILE_ZONE("BeginFrame");
+
+	m_Pacer.WaitForNextFrame();
+
+	// No texture last frame, block here rather than spinning on empty frames
+	if (m_SkippedLastFrame)
+		SDL_WaitForGPUSwapchain(Device, m_Window);
+
+	// The last submitted frame sits in the current slot until InitCommandBuffer advances it
+	if (m_PacingSettings.LowLatency)
+		WaitForFrame(m_FrameIndex);
+}
+
+bool Renderer::InitCommandBuffer()
+{
+	SDLGPU_PROFILE_ZONE("InitCommandBuffer");
+
+	m_FrameIndex = (m_FrameIndex + 1) % m_FramesInFlight;
+	m_FrameSerial++;
+
+	RetireFrames();
+
+	// The slot we are about to reuse must have finished on the GPU
+	WaitForFrame(m_FrameIndex);
+	m_FrameArenas[m_FrameIndex].Reset();
+
+	Uploader->BeginFrame(m_FrameSerial, m_CompletedFrameSerial);
+	Textures->Update();
+
+	// The uploader's stats now hold the frame that was just submitted
+	SDLGPU_PROFILE_COUNTER("Uploads", Uploader->GetFrameStats().Uploads);
+	SDLGPU_PROFILE_COUNTER("Upload bytes", Uploader->GetFrameStats().Bytes);
+
+	m_CommandBuffer = SDL_AcquireGPUCommandBuffer(Device);
+	if (!m_CommandBuffer)
+		SDLException("Failed to acquire GPU command buffer");
+
+	if (m_Window)
+	{
+		if (!SDL_AcquireGPUSwapchainTexture(m_CommandBuffer, m_Window, &m_SwapchainTexture, &m_SwapchainWidth, &m_SwapchainHeight))
+			SDLException("Failed to acquire swapchain texture");
+	}
+	else
+	{
+		// Headless frames are never dropped, the slot's fence already guards the target
+		m_SwapchainTexture = m_HeadlessTarget;
+		m_SwapchainWidth = m_HeadlessWidth;
+		m_SwapchainHeight = m_HeadlessHeight;
+	}
+
+	m_SkippedLastFrame = !m_SwapchainTexture;
+	if (m_SkippedLastFrame)
+		m_Pacer.MarkSkipped();
+	else
+		UpdateRenderSize();
+
+	// Everything up to the end of SubmitCommandBuffer should run without touching the heap
+	AllocationTracker::BeginHotPath();
+	m_FrameStartAllocations = AllocationTracker::GetHotPathAllocations();
+
+	return m_SwapchainTexture != nullptr;
+}
+
+void Renderer::RenderPassDraw(SDL_GPUGraphicsPipeline *pipeline, VertexBuffer* vertexBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+{
+	SDLGPU_PROFILE_FUNCTION();
+
+	DrawItem item{};
+	item.Pipeline = pipeline;
+	item.VertexBuffer = vertexBuffer ? vertexBuffer->GetVertexBuffer() : nullptr;
+	item.VertexCount = vertexCount;
+	item.InstanceCount = instanceCount;
+	item.FirstVertex = firstVertex;
+	item.FirstInstance = firstInstance;
+	item.SortKey = DrawQueue::MakeKey(DrawQueue::PASS_MAIN, GetPipelineId(pipeline), vertexBuffer ? vertexBuffer->GetId() : 0, 0, 0);
+
+	Draw(item);
+}
+
+void Renderer::RenderPassDrawIndexed(SDL_GPUGraphicsPipeline *pipeline, VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
+{
+	SDLGPU_PROFILE_FUNCTION();
+
+	DrawItem item{};
+	item.Pipeline = pipeline;
+	item.VertexBuffer = vertexBuffer ? vertexBuffer->GetVertexBuffer() : nullptr;
+	item.IndexBuffer = indexBuffer->GetIndexBuffer();
+	item.IndexElementSize = indexBuffer->GetElementSize();
+	item.IndexCount = indexCount;
+	item.InstanceCount = instanceCount;
+	item.FirstIndex = firstIndex;
+	item.VertexOffset = vertexOffset;
+	item.FirstInstance = firstInstance;
+	item.SortKey = DrawQueue::MakeKey(DrawQueue::PASS_MAIN, GetPipelineId(pipeline), vertexBuffer ? vertexBuffer->GetId() : indexBuffer->GetId(), 0, 0);
+
+	Draw(item);
+}
+
+void Renderer::RenderPassDrawInstanced(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer, InstanceBuffer* instances, InstanceInput input, uint32_t vertexCount, uint32_t firstVertex)
+{
+	SDLGPU_PROFILE_FUNCTION();
+
+	DrawItem item{};
+	item.Pipeline = pipeline;
+	item.VertexBuffer = vertexBuffer ? vertexBuffer->GetVertexBuffer() : nullptr;
+	item.VertexCount = vertexCount;
+	item.FirstVertex = firstVertex;
+	item.InstanceCount = instances->GetInstanceCount();
+
+	if (input == InstanceInput::VertexStream)
+		item.InstanceBuffer = instances->GetBuffer();
+	else
+		item.VertexStorageBuffer = instances->GetBuffer();
+
+	item.SortKey = DrawQueue::MakeKey(DrawQueue::PASS_MAIN, GetPipelineId(pipeline), vertexBuffer ? vertexBuffer->GetId() : 0, 0, 0);
+
+	Draw(item);
+}
+
+void Renderer::RenderPassDrawIndexedInstanced(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, InstanceBuffer* instances, InstanceInput input, uint32_t indexCount, uint32_t firstIndex, int32_t vertexOffset)
+{
+	SDLGPU_PROFILE_FUNCTION();
+
+	DrawItem item{};
+	item.Pipeline = pipeline;
+	item.VertexBuffer = vertexBuffer ? vertexBuffer->GetVertexBuffer() : nullptr;
+	item.IndexBuffer = indexBuffer->GetIndexBuffer();
+	item.IndexElementSize = indexBuffer->GetElementSize();
+	item.IndexCount = indexCount;
+	item.FirstIndex = firstIndex;
+	item.VertexOffset = vertexOffset;
+	item.InstanceCount = instances->GetInstanceCount();
+
+	if (input == InstanceInput::VertexStream)
+		item.InstanceBuffer = instances->GetBuffer();
+	else
+		item.VertexStorageBuffer = instances->GetBuffer();
+
+	item.SortKey = DrawQueue::MakeKey(DrawQueue::PASS_MAIN, GetPipelineId(pipeline), vertexBuffer ? vertexBuffer->GetId() : indexBuffer->GetId(), 0, 0);
+
+	Draw(item);
+}
+
+void Renderer::RenderPassDrawMesh(SDL_GPUGraphicsPipeline* pipeline, const MeshPool& meshes, MeshHandle mesh, uint32_t instanceCount, uint32_t firstInstance)
+{
+	SDLGPU_PROFILE_FUNCTION();
+
+	GpuBufferRange vertices = meshes.GetVertices(mesh);
+	if (!vertices.Buffer)
+		return;
+
+	DrawItem item{};
+	item.Pipeline = pipeline;
+	item.VertexBuffer = vertices.Buffer;
+	item.InstanceCount = instanceCount;
+	item.FirstInstance = firstInstance;
+
+	if (mesh.IsIndexed())
+	{
+		GpuBufferRange indices = meshes.GetIndices(mesh);
+		item.IndexBuffer = indices.Buffer;
+		item.IndexElementSize = meshes.GetIndexElementSize();
+		item.IndexCount = indices.Count;
+		item.FirstIndex = indices.Offset;
+		item.VertexOffset = int32_t(vertices.Offset);
+	}
+	else
+	{
+		item.VertexCount = vertices.Count;
+		item.FirstVertex = vertices.Offset;
+	}
+
+	item.SortKey = DrawQueue::MakeKey(DrawQueue::PASS_MAIN, GetPipelineId(pipeline), vertices.BufferId, 0, 0);
+
+	Draw(item);
+}
+
+void Renderer::RenderPassDrawTextured(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer, TextureHandle texture, uint32_t vertexCount, uint32_t firstVertex)
+{
+	SDLGPU_PROFILE_FUNCTION();
+
+	DrawItem item{};
+	item.Pipeline = pipeline;
+	item.VertexBuffer = vertexBuffer ? vertexBuffer->GetVertexBuffer() : nullptr;
+	item.VertexCount = vertexCount;
+	item.FirstVertex = firstVertex;
+	item.Texture = Textures->GetTexture(texture);
+	item.Sampler = Textures->GetLinearSampler();
+	item.SortKey = DrawQueue::MakeKey(DrawQueue::PASS_MAIN, GetPipelineId(pipeline), vertexBuffer ? vertexBuffer->GetId() : 0, uint16_t(texture), 0);
+
+	Draw(item);
+}
+
+void Renderer::RenderPassDrawIndexedTextured(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, TextureHandle texture, uint32_t indexCount, uint32_t firstIndex, int32_t vertexOffset)
+{
+	SDLGPU_PROFILE_FUNCTION();
+
+	DrawItem item{};
+	item.Pipeline = pipeline;
+	item.VertexBuffer = vertexBuffer ? vertexBuffer->GetVertexBuffer() : nullptr;
+	item.IndexBuffer = indexBuffer->GetIndexBuffer();
+	item.IndexElementSize = indexBuffer->GetElementSize();
+	item.IndexCount = indexCount;
+	item.FirstIndex = firstIndex;
+	item.VertexOffset = vertexOffset;
+	item.Texture = Textures->GetTexture(texture);
+	item.Sampler = Textures->GetLinearSampler();
+	item.SortKey = DrawQueue::MakeKey(DrawQueue::PASS_MAIN, GetPipelineId(pipeline), vertexBuffer ? vertexBuffer->GetId() : indexBuffer->GetId(), uint16_t(texture), 0);
+
+	Draw(item);
+}
+
+void Renderer::RenderPassDrawIndirect(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer, SDL_GPUBuffer* indirectBuffer, uint32_t offset, uint32_t drawCount)
+{
+	SDLGPU_PROFILE_FUNCTION();
+
+	DrawItem item{};
+	item.Pipeline = pipeline;
+	item.VertexBuffer = vertexBuffer ? vertexBuffer->GetVertexBuffer() : nullptr;
+	item.IndirectBuffer = indirectBuffer;
+	item.IndirectOffset = offset;
+	item.IndirectDrawCount = drawCount;
+	item.SortKey = DrawQueue::MakeKey(DrawQueue::PASS_MAIN, GetPipelineId(pipeline), vertexBuffer ? vertexBuffer->GetId() : 0, 0, 0);
+
+	Draw(item);
+}
+
+void Renderer::RenderPassDrawIndexedIndirect(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, SDL_GPUBuffer* indirectBuffer, uint32_t offset, uint32_t drawCount)
+{
+	SDLGPU_PROFILE_FUNCTION();
+
+	DrawItem item{};
+	item.Pipeline = pipeline;
+	item.VertexBuffer = vertexBuffer ? vertexBuffer->GetVertexBuffer() : nullptr;
+	item.IndexBuffer = indexBuffer->GetIndexBuffer();
+	item.IndexElementSize = indexBuffer->GetElementSize();
+	item.IndirectBuffer = indirectBuffer;
+	item.IndirectOffset = offset;
+	item.IndirectDrawCount = drawCount;
+	item.SortKey = DrawQueue::MakeKey(DrawQueue::PASS_MAIN, GetPipelineId(pipeline), vertexBuffer ? vertexBuffer->GetId() : indexBuffer->GetId(), 0, 0);
+
+	Draw(item);
+}
+
+void Renderer::Draw(const DrawItem& item)
+{
+	m_DrawQueue.Submit(item);
+}
+
+void Renderer::DrawOpaque(DrawItem item, float viewDepth, const DrawItem* depthOnly)
+{
+	const uint32_t depth = DrawQueue::QuantizeDepth(viewDepth);
+
+	if (depthOnly)
+	{
+		DrawItem prepass = *depthOnly;
+		prepass.SortKey = DrawQueue::WithPassAndDepth(prepass.SortKey, DrawQueue::PASS_DEPTH_PREPASS, depth);
+		m_DrawQueue.Submit(prepass);
+	}
+
+	item.SortKey = DrawQueue::WithPassAndDepth(item.SortKey, DrawQueue::PASS_MAIN, depth);
+	m_DrawQueue.Submit(item);
+}
+
+void Renderer::RenderPassDrawOpaque(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer, uint32_t vertexCount, uint32_t firstVertex, float viewDepth, SDL_GPUGraphicsPipeline* depthPipeline, VertexBuffer* positionBuffer)
+{
+	SDLGPU_PROFILE_FUNCTION();
+
+	DrawItem item{};
+	item.Pipeline = pipeline;
+	item.VertexBuffer = vertexBuffer ? vertexBuffer->GetVertexBuffer() : nullptr;
+	item.VertexCount = vertexCount;
+	item.FirstVertex = firstVertex;
+	item.SortKey = DrawQueue::MakeKey(DrawQueue::PASS_MAIN, GetPipelineId(pipeline), vertexBuffer ? vertexBuffer->GetId() : 0, 0, 0);
+
+	if (!depthPipeline)
+	{
+		DrawOpaque(item, viewDepth);
+		return;
+	}
+
+	DrawItem depthOnly = item;
+	depthOnly.Pipeline = depthPipeline;
+	depthOnly.VertexBuffer = positionBuffer ? positionBuffer->GetVertexBuffer() : nullptr;
+	depthOnly.SortKey = DrawQueue::MakeKey(DrawQueue::PASS_DEPTH_PREPASS, GetPipelineId(depthPipeline), positionBuffer ? positionBuffer->GetId() : 0, 0, 0);
+	DrawOpaque(item, viewDepth, &depthOnly);
+}
+
+void Renderer::Dispatch(const ComputeDispatch& dispatch)
+{
+	if (!dispatch.Pipeline)
+	{
+		SDLException("Compute dispatch without a pipeline");
+		return;
+	}
+
+	if (dispatch.ReadOnlyBufferCount > ComputeDispatch::MAX_STORAGE_BUFFERS || dispatch.ReadWriteBufferCount > ComputeDispatch::MAX_STORAGE_BUFFERS)
+	{
+		SDLException("Too many storage buffers in compute dispatch");
+		return;
+	}
+
+	QueuedDispatch& queued = m_Dispatches.emplace_back(QueuedDispatch{dispatch, uint32_t(m_DispatchUniforms.size())});
+
+	// The caller's uniform data only has to live until this returns
+	if (dispatch.UniformData && dispatch.UniformSize > 0)
+	{
+		const uint8_t* uniformData = static_cast<const uint8_t*>(dispatch.UniformData);
+		m_DispatchUniforms.insert(m_DispatchUniforms.end(), uniformData, uniformData + dispatch.UniformSize);
+	}
+	else
+	{
+		queued.Dispatch.UniformSize = 0;
+	}
+	queued.Dispatch.UniformData = nullptr;
+}
+
+void Renderer::RecordDispatches(SDL_GPUCommandBuffer* commandBuffer)
+{
+	for (const QueuedDispatch& queued : m_Dispatches)
+	{
+		const ComputeDispatch& dispatch = queued.Dispatch;
+
+		// One pass per dispatch, SDL orders a pass's storage writes before the next pass
+		SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(commandBuffer, nullptr, 0, dispatch.ReadWriteBuffers.data(), dispatch.ReadWriteBufferCount);
+		SDL_BindGPUComputePipeline(computePass, dispatch.Pipeline);
+
+		if (dispatch.ReadOnlyBufferCount > 0)
+			SDL_BindGPUComputeStorageBuffers(computePass, 0, dispatch.ReadOnlyBuffers.data(), dispatch.ReadOnlyBufferCount);
+
+		if (dispatch.UniformSize > 0)
+			SDL_PushGPUComputeUniformData(commandBuffer, 0, m_DispatchUniforms.data() + queued.UniformOffset, dispatch.UniformSize);
+
+		if (dispatch.IndirectBuffer)
+			SDL_DispatchGPUComputeIndirect(computePass, dispatch.IndirectBuffer, dispatch.IndirectOffset);
+		else
+			SDL_DispatchGPUCompute(computePass, dispatch.GroupCountX, dispatch.GroupCountY, dispatch.GroupCountZ);
+		SDL_EndGPUComputePass(computePass);
+
+		m_DrawStats.Dispatches++;
+	}
+
+	m_Dispatches.clear();
+	m_DispatchUniforms.clear();
+}
+
+void Renderer::SetRecordThreadCount(uint32_t threadCount)
+{
+	// The calling thread helps while waiting, so it counts as one of them
+	m_RecordThreadCount = std::clamp(threadCount, 1u, Jobs->GetWorkerCount() + 1);
+}
+
+void Renderer::DrawQueuedItems()
+{
+	SDLGPU_PROFILE_FUNCTION();
+
+	m_LastDrawStats = m_DrawStats;
+	m_DrawStats = DrawStats{};
+
+	uint32_t chunkCount = uint32_t(std::min<size_t>(m_RecordThreadCount, m_DrawQueue.Size() / MIN_DRAWS_PER_CHUNK));
+	if (m_SwapchainTexture && chunkCount > 1)
+	{
+		DrawQueuedItemsParallel(chunkCount);
+		m_DrawQueue.Clear();
+		return;
+	}
+
+	// Everything uploaded so far this frame lands in one copy pass ahead of the draws
+	Uploader->RecordUploads(m_CommandBuffer);
+	Textures->RecordMipmaps(m_CommandBuffer);
+
+	// Compute runs even when the frame is dropped, later frames may build on its results
+	RecordDispatches(m_CommandBuffer);
+
+	if(!m_SwapchainTexture)
+	{
+		m_DrawQueue.Clear();
+		return;
+	}
+
+	// Scaled frames are drawn offscreen and blitted over
+	const bool scaled = m_Scaler.GetSettings().Enabled;
+	uint32_t targetWidth, targetHeight;
+	GetTargetSize(targetWidth, targetHeight);
+	if (scaled)
+		ResizeSceneTexture(targetWidth, targetHeight);
+	ResizeDepthTexture(targetWidth, targetHeight);
+
+	SDL_GPUColorTargetInfo colorTarget{};
+	colorTarget.texture = scaled ? m_SceneTexture : m_SwapchainTexture;
+	colorTarget.store_op = SDL_GPU_STOREOP_STORE;
+	colorTarget.load_op = SDL_GPU_LOADOP_CLEAR;
+	colorTarget.clear_color = CLEAR_COLOR;
+
+	// Depth only lives for the pass
+	SDL_GPUDepthStencilTargetInfo depthTarget{};
+	depthTarget.texture = m_DepthTexture;
+	depthTarget.clear_depth = 1.0f;
+	depthTarget.load_op = SDL_GPU_LOADOP_CLEAR;
+	depthTarget.store_op = SDL_GPU_STOREOP_DONT_CARE;
+	depthTarget.stencil_load_op = SDL_GPU_LOADOP_DONT_CARE;
+	depthTarget.stencil_store_op = SDL_GPU_STOREOP_DONT_CARE;
+
+	m_DrawQueue.Sort(&GetFrameArena());
+
+	SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(m_CommandBuffer, &colorTarget, 1, &depthTarget);
+	SetRenderViewport(renderPass);
+	m_DrawQueue.Record(renderPass, m_DrawStats);
+	SDL_EndGPURenderPass(renderPass);
+
+	if (scaled)
+		BlitSceneTexture(m_CommandBuffer);
+
+	m_DrawQueue.Clear();
+}
+
+void Renderer::DrawQueuedItemsParallel(uint32_t chunkCount)
+{
+	// The frame's command buffer is submitted last because it presents, so uploads
+	// and compute go ahead of the chunks on a command buffer of their own
+	SDL_GPUCommandBuffer* prologue = SDL_AcquireGPUCommandBuffer(Device);
+	if (!prologue)
+		SDLException("Failed to acquire GPU command buffer");
+
+	Uploader->RecordUploads(prologue);
+	Textures->RecordMipmaps(prologue);
+	RecordDispatches(prologue);
+
+	if (!SDL_SubmitGPUCommandBuffer(prologue))
+		SDLException("Failed to submit GPU command buffer");
+
+	uint32_t targetWidth, targetHeight;
+	GetTargetSize(targetWidth, targetHeight);
+	ResizeSceneTexture(targetWidth, targetHeight);
+	ResizeDepthTexture(targetWidth, targetHeight);
+
+	FrameArena& arena = GetFrameArena();
+	m_DrawQueue.Sort(&arena);
+
+	// Even split of the sorted list, chunk i covers [size * i / n, size * (i + 1) / n)
+	const size_t itemCount = m_DrawQueue.Size();
+	std::pmr::vector<RecordChunk> chunks(chunkCount, &arena);
+	for (uint32_t i = 0; i < chunkCount; i++)
+	{
+		chunks[i].Index = i;
+		chunks[i].First = itemCount * i / chunkCount;
+		chunks[i].Count = itemCount * (i + 1) / chunkCount - chunks[i].First;
+	}
+
+	m_NextChunkToSubmit = 0;
+	m_FirstChunkFailed = false;
+
+	// The queue is FIFO, so the lowest chunk not yet submitted has always been picked up
+	// by some thread and the submit turn cannot deadlock. The handles live in the frame
+	// arena, every job is joined below before the arena scope rewinds.
+	std::pmr::vector<JobHandle> jobs(&arena);
+	jobs.reserve(chunkCount);
+	for (RecordChunk& chunk : chunks)
+		jobs.push_back(Jobs->Schedule([this, chunk = &chunk]{ RecordDrawChunk(*chunk); }));
+
+	// Every job has to finish before the queue is cleared, even if one of them failed
+	std::exception_ptr error;
+	for (const JobHandle& job : jobs)
+	{
+		try
+		{
+			Jobs->Wait(job);
+		}
+		catch (...)
+		{
+			if (!error)
+				error = std::current_exception();
+		}
+	}
+	jobs.clear();
+
+	// The frame is abandoned. SDL does not allow cancelling once a swapchain texture
+	// was acquired, so a windowed frame is submitted without draws to release it.
+	if (error)
+	{
+		if (m_Window)
+			SDL_SubmitGPUCommandBuffer(m_CommandBuffer);
+		else
+			SDL_CancelGPUCommandBuffer(m_CommandBuffer);
+		m_CommandBuffer = nullptr;
+
+		m_DrawQueue.Clear();
+		AllocationTracker::EndHotPath();
+		std::rethrow_exception(error);
+	}
+
+	for (const RecordChunk& chunk : chunks)
+	{
+		m_DrawStats.Draws += chunk.Stats.Draws;
+		m_DrawStats.PipelineBinds += chunk.Stats.PipelineBinds;
+		m_DrawStats.PipelineBindsSkipped += chunk.Stats.PipelineBindsSkipped;
+		m_DrawStats.VertexBufferBinds += chunk.Stats.VertexBufferBinds;
+		m_DrawStats.VertexBufferBindsSkipped += chunk.Stats.VertexBufferBindsSkipped;
+		m_DrawStats.IndexBufferBinds += chunk.Stats.IndexBufferBinds;
+		m_DrawStats.IndexBufferBindsSkipped += chunk.Stats.IndexBufferBindsSkipped;
+		m_DrawStats.StorageBufferBinds += chunk.Stats.StorageBufferBinds;
+		m_DrawStats.StorageBufferBindsSkipped += chunk.Stats.StorageBufferBindsSkipped;
+		m_DrawStats.TextureBinds += chunk.Stats.TextureBinds;
+		m_DrawStats.TextureBindsSkipped += chunk.Stats.TextureBindsSkipped;
+		m_DrawStats.Instances += chunk.Stats.Instances;
+		m_DrawStats.IndirectDraws += chunk.Stats.IndirectDraws;
+	}
+	m_DrawStats.RecordChunks = chunkCount;
+
+	BlitSceneTexture(m_CommandBuffer);
+}
+
+void Renderer::RecordDrawChunk(RecordChunk& chunk)
+{
+	SDLGPU_PROFILE_FUNCTION();
+	AllocationTracker::HotPathScope hotPath;
+	const uint32_t chunkIndex = chunk.Index;
+
+	// Command buffers may only be used on the thread that acquired them,
+	// so each chunk is acquired, recorded and submitted on its worker
+	SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(Device);
+	bool recorded = false;
+	if (commandBuffer)
+	{
+		// The first chunk clears, the others draw on top of it
+		SDL_GPUColorTargetInfo colorTarget{};
+		colorTarget.texture = m_SceneTexture;
+		colorTarget.store_op = SDL_GPU_STOREOP_STORE;
+		colorTarget.load_op = chunkIndex == 0 ? SDL_GPU_LOADOP_CLEAR : SDL_GPU_LOADOP_LOAD;
+		colorTarget.clear_color = CLEAR_COLOR;
+
+		// Depth is stored for the chunks after this one
+		SDL_GPUDepthStencilTargetInfo depthTarget{};
+		depthTarget.texture = m_DepthTexture;
+		depthTarget.clear_depth = 1.0f;
+		depthTarget.load_op = chunkIndex == 0 ? SDL_GPU_LOADOP_CLEAR : SDL_GPU_LOADOP_LOAD;
+		depthTarget.store_op = SDL_GPU_STOREOP_STORE;
+		depthTarget.stencil_load_op = SDL_GPU_LOADOP_DONT_CARE;
+		depthTarget.stencil_store_op = SDL_GPU_STOREOP_DONT_CARE;
+
+		SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(commandBuffer, &colorTarget, 1, &depthTarget);
+		if (renderPass)
+		{
+			SetRenderViewport(renderPass);
+			m_DrawQueue.Record(renderPass, chunk.Stats, chunk.First, chunk.Count);
+			SDL_EndGPURenderPass(renderPass);
+			recorded = true;
+		}
+	}
+
+	// Submission follows draw order, the turn is passed on even if this chunk failed
+	bool submitted = false;
+	{
+		std::unique_lock lock(m_SubmitMutex);
+		m_SubmitCondition.wait(lock, [&]{ return m_NextChunkToSubmit == chunkIndex; });
+
+		// Without the first chunk's clear the others would draw over an uncleared
+		// target, so they are dropped and the frame's draws are skipped
+		if (recorded && (chunkIndex == 0 || !m_FirstChunkFailed))
+			submitted = SDL_SubmitGPUCommandBuffer(commandBuffer);
+		else if (commandBuffer)
+			SDL_CancelGPUCommandBuffer(commandBuffer);
+
+		if (chunkIndex == 0)
+			m_FirstChunkFailed = !submitted;
+		m_NextChunkToSubmit++;
+	}
+	m_SubmitCondition.notify_all();
+
+	if (!submitted)
+		SDLException("Failed to record draw chunk");
+}
+
+void Renderer::ResizeSceneTexture(uint32_t width, uint32_t height)
+{
+	if (m_SceneTexture && m_SceneWidth == width && m_SceneHeight == height)
+		return;
+
+	// SDL defers the release until frames in flight are done with it
+	if (m_SceneTexture)
+		SDL_ReleaseGPUTexture(Device, m_SceneTexture);
+
+	SDL_GPUTextureCreateInfo textureCreateInfo{};
+	textureCreateInfo.type = SDL_GPU_TEXTURETYPE_2D;
+	textureCreateInfo.format = GetColorFormat();
+	textureCreateInfo.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
+	textureCreateInfo.width = width;
+	textureCreateInfo.height = height;
+	textureCreateInfo.layer_count_or_depth = 1;
+	textureCreateInfo.num_levels = 1;
+
+	m_SceneTexture = SDL_CreateGPUTexture(Device, &textureCreateInfo);
+	m_SceneWidth = width;
+	m_SceneHeight = height;
+
+	if (!m_SceneTexture)
+		SDLException("Failed to create scene texture");
+}
+
+void Renderer::BlitSceneTexture(SDL_GPUCommandBuffer* commandBuffer)
+{
+	// Only the scaled region holds the frame, bilinear unless it maps 1:1
+	const bool unscaled = m_RenderWidth == m_SwapchainWidth && m_RenderHeight == m_SwapchainHeight;
+
+	SDL_GPUBlitInfo blitInfo{};
+	blitInfo.source.texture = m_SceneTexture;
+	blitInfo.source.w = m_RenderWidth;
+	blitInfo.source.h = m_RenderHeight;
+	blitInfo.destination.texture = m_SwapchainTexture;
+	blitInfo.destination.w = m_SwapchainWidth;
+	blitInfo.destination.h = m_SwapchainHeight;
+	blitInfo.load_op = SDL_GPU_LOADOP_DONT_CARE;
+	blitInfo.filter = unscaled ? SDL_GPU_FILTER_NEAREST : SDL_GPU_FILTER_LINEAR;
+
+	SDL_BlitGPUTexture(commandBuffer, &blitInfo);
+}
+
+void Renderer::GetTargetSize(uint32_t& width, uint32_t& height) const
+{
+	const float maxScale = m_Scaler.GetSettings().Enabled ? m_Scaler.GetSettings().MaxScale : 1.0f;
+	width = std::max(1u, uint32_t(std::ceil(m_SwapchainWidth * maxScale)));
+	height = std::max(1u, uint32_t(std::ceil(m_SwapchainHeight * maxScale)));
+}
+
+void Renderer::UpdateRenderSize()
+{
+	float scale = 1.0f;
+	if (m_GpuTimer)
+	{
+		// The newest completed frame is enough, the scaler averages over frames anyway
+		uint64_t frameTimeNS = 0;
+		if (m_GpuTimer->TakeFrameTime(frameTimeNS))
+			m_Scaler.AddFrameTime(frameTimeNS / 1e6);
+
+		scale = m_Scaler.GetScale();
+		SDLGPU_PROFILE_COUNTER("Resolution scale %", int64_t(scale * 100.0f));
+	}
+
+	uint32_t targetWidth, targetHeight;
+	GetTargetSize(targetWidth, targetHeight);
+	m_RenderWidth = std::clamp(uint32_t(std::lround(m_SwapchainWidth * scale)), 1u, targetWidth);
+	m_RenderHeight = std::clamp(uint32_t(std::lround(m_SwapchainHeight * scale)), 1u, targetHeight);
+}
+
+void Renderer::SetRenderViewport(SDL_GPURenderPass* renderPass) const
+{
+	// Scaled frames only cover the top left of the targets
+	const SDL_GPUViewport viewport{ 0.0f, 0.0f, float(m_RenderWidth), float(m_RenderHeight), 0.0f, 1.0f };
+	SDL_SetGPUViewport(renderPass, &viewport);
+
+	const SDL_Rect scissor{ 0, 0, int(m_RenderWidth), int(m_RenderHeight) };
+	SDL_SetGPUScissor(renderPass, &scissor);
+}
+
+void Renderer::ResizeDepthTexture(uint32_t width, uint32_t height)
+{
+	if (m_DepthTexture && m_DepthWidth == width && m_DepthHeight == height)
+		return;
+
+	// Like the scene texture, released once the frames using it are done
+	if (m_DepthTexture)
+		SDL_ReleaseGPUTexture(Device, m_DepthTexture);
+
+	SDL_GPUTextureCreateInfo textureCreateInfo{};
+	textureCreateInfo.type = SDL_GPU_TEXTURETYPE_2D;
+	textureCreateInfo.format = m_DepthFormat;
+	textureCreateInfo.usage = SDL_GPU_TEXTUREUSAGE_DEPTH_STENCIL_TARGET;
+	textureCreateInfo.width = width;
+	textureCreateInfo.height = height;
+	textureCreateInfo.layer_count_or_depth = 1;
+	textureCreateInfo.num_levels = 1;
+
+	m_DepthTexture = SDL_CreateGPUTexture(Device, &textureCreateInfo);
+	m_DepthWidth = width;
+	m_DepthHeight = height;
+
+	if (!m_DepthTexture)
+		SDLException("Failed to create depth texture");
+}
+
+void Renderer::SubmitCommandBuffer()
+{
+	SDLGPU_PROFILE_ZONE("SubmitCommandBuffer");
+
+	DrawQueuedItems();
+
+	m_FrameFences[m_FrameIndex] = SDL_SubmitGPUCommandBufferAndAcquireFence(m_CommandBuffer);
+	m_FrameFenceSerials[m_FrameIndex] = m_FrameSerial;
+	m_FrameSubmitTimes[m_FrameIndex] = Profiler::Now();
+	m_CommandBuffer = nullptr;
+
+	if (m_GpuTimer)
+		m_GpuTimer->Watch(m_FrameFences[m_FrameIndex], m_FrameSubmitTimes[m_FrameIndex]);
+
+	SDLGPU_PROFILE_COUNTER("Draws", m_DrawStats.Draws);
+	SDLGPU_PROFILE_COUNTER("Pipeline binds", m_DrawStats.PipelineBinds);
+	SDLGPU_PROFILE_COUNTER("Buffer binds", m_DrawStats.VertexBufferBinds + m_DrawStats.IndexBufferBinds + m_DrawStats.StorageBufferBinds);
+	SDLGPU_PROFILE_COUNTER("Texture binds", m_DrawStats.TextureBinds);
+	SDLGPU_PROFILE_COUNTER("Dispatches", m_DrawStats.Dispatches);
+
+	m_DrawStats.HotPathAllocations = uint32_t(AllocationTracker::GetHotPathAllocations() - m_FrameStartAllocations);
+	AllocationTracker::EndHotPath();
+
+	if(!m_FrameFences[m_FrameIndex])
+		SDLException("Failed to submit GPU command buffer");
+}
+
+void Renderer::Cleanup()
+{
+	// Finish outstanding jobs before the objects they create are torn down
+	Jobs.reset();
+
+	if (Device)
+		WaitForAllFrames();
+	m_GpuTimer.reset();
+
+	if (Uploader)
+	{
+		Uploader->Cleanup();
+		Uploader.reset();
+	}
+
+	if (Textures)
+	{
+		Textures->Cleanup();
+		Textures.reset();
+	}
+
+	if (m_PipelineCache)
+	{
+		m_PipelineCache->Cleanup();
+		m_PipelineCache.reset();
+	}
+
+	m_ShaderArchive.Close();
+
+	if (m_SceneTexture)
+	{
+		SDL_ReleaseGPUTexture(Device, m_SceneTexture);
+		m_SceneTexture = nullptr;
+	}
+
+	if (m_DepthTexture)
+	{
+		SDL_ReleaseGPUTexture(Device, m_DepthTexture);
+		m_DepthTexture = nullptr;
+	}
+
+	if (m_HeadlessTarget)
+	{
+		SDL_ReleaseGPUTexture(Device, m_HeadlessTarget);
+		m_HeadlessTarget = nullptr;
+	}
+
+	if (Device)
+	{
+		SDL_DestroyGPUDevice(Device);
+		Device = nullptr;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,344 @@
+#pragma once
+
+#include "common.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/FrameArena.hpp"
+#include "Renderer/VertexBuffer.hpp"
+#include "Renderer/VertexLayout.hpp"
+#include "Renderer/IndexBuffer.hpp"
+#include "Renderer/InstanceBuffer.hpp"
+#include "Renderer/MeshPool.hpp"
+#include "Renderer/TextureManager.hpp"
+#include "Renderer/UploadManager.hpp"
+#include "Renderer/DrawQueue.hpp"
+#include "Renderer/ComputeDispatch.hpp"
+#include "Renderer/PipelineCache.hpp"
+#include "Renderer/ShaderArchive.hpp"
+#include "Renderer/FramePacer.hpp"
+#include "Renderer/GpuFrameTimer.hpp"
+#include "Renderer/ResolutionScaler.hpp"
+#include <array>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+#include <SDL3/SDL_gpu.h>
+#include <SDL3/SDL_video.h>
+
+
+class Renderer
+{
+	public:
+		// Without a window the renderer runs headless: frames are drawn into an offscreen
+		// texture of headlessWidth x headlessHeight and nothing is presented. Works with
+		// SDL's dummy/offscreen video drivers and software Vulkan implementations.
+		Renderer(SDL_Window* window, uint32_t headlessWidth = 1920, uint32_t headlessHeight = 1080);
+		virtual ~Renderer();
+		
+		void Init();
+		void Cleanup();
+		
+		SDL_GPUDevice* Device{nullptr};
+
+		// Staging ring that all buffer and texture uploads go through
+		std::unique_ptr<UploadManager> Uploader;
+
+		// Worker pool for asset and pipeline creation
+		std::unique_ptr<JobSystem> Jobs;
+
+		// Asynchronously decoded and streamed textures, updated every frame
+		std::unique_ptr<TextureManager> Textures;
+
+		// Shaders are cached by name and reference counted, every LoadShader
+		// must be paired with a ReleaseShader. Pipelines hold their own reference.
+		// Shaders found in shaders.pack use the reflected resource counts and
+		// ignore the arguments, which only apply to loose shader files.
+		SDL_GPUShader* LoadShader(
+			const std::string& shaderSource,
+			const uint32_t samplerCount = 0,
+			const uint32_t uniformBufferCount = 0,
+			const uint32_t storageBufferCount = 0,
+			const uint32_t storageTextureCount = 0
+		);
+
+		void ReleaseShader(SDL_GPUShader* shader);
+		
+		// Returns the cached pipeline for this state or creates it
+		SDL_GPUGraphicsPipeline* CreatePipeline(const PipelineDesc& desc);
+
+		SDL_GPUGraphicsPipeline* CreatePipeline(
+			SDL_GPUShader* vertexShader,
+			SDL_GPUShader* fragmentShader,
+			const SDL_GPUVertexInputState* vertexInputState = nullptr
+		);
+
+		// TVertex is either a vertex struct with a VertexLayout or a VertexInput<...>
+		template<typename TVertex>
+		SDL_GPUGraphicsPipeline* CreatePipeline(SDL_GPUShader* vertexShader, SDL_GPUShader* fragmentShader)
+		{
+			return CreatePipeline(vertexShader, fragmentShader, &VertexInputFor<TVertex>::State);
+		}
+
+		void ReleasePipeline(SDL_GPUGraphicsPipeline* pipeline);
+
+		// Destroys the cached pipelines nobody holds a reference to
+		void TrimPipelines() { m_PipelineCache->Trim(); }
+
+		// Creates the pipelines up front so the first frame using them does not hitch.
+		// The cache keeps a reference to each one until Cleanup.
+		void PrewarmPipelines(std::span<const PipelineDesc> descs);
+
+		// Small per-pipeline id for building draw sort keys, lock free
+		uint16_t GetPipelineId(SDL_GPUGraphicsPipeline* pipeline) const;
+
+		PipelineCacheStats GetPipelineCacheStats() const { return m_PipelineCache->GetStats(); }
+
+
+		// Compute pipelines are not cached, the caller owns the returned pipeline.
+		// Shaders found in shaders.pack use the reflected counts and workgroup size.
+		SDL_GPUComputePipeline* CreateComputePipeline(const std::string& shaderSource, const ComputePipelineInfo& info = {});
+		void ReleaseComputePipeline(SDL_GPUComputePipeline* pipeline);
+
+
+		// Async creation on the worker pool. Results are ready once their job is done,
+		// poll IsReady() or block with Jobs->Wait(result) right before first use.
+		using AsyncShader = AsyncResult<SDL_GPUShader*>;
+		using AsyncPipeline = AsyncResult<SDL_GPUGraphicsPipeline*>;
+
+		AsyncShader LoadShaderAsync(
+			const std::string& shaderSource,
+			const uint32_t samplerCount = 0,
+			const uint32_t uniformBufferCount = 0,
+			const uint32_t storageBufferCount = 0,
+			const uint32_t storageTextureCount = 0
+		);
+
+		// Starts once both shaders have loaded, the shader fields of `desc` are filled in
+		// from the results. `desc.VertexInput` must stay valid until the job has run.
+		AsyncPipeline CreatePipelineAsync(const AsyncShader& vertexShader, const AsyncShader& fragmentShader, PipelineDesc desc = {});
+
+		template<typename TVertex>
+		AsyncPipeline CreatePipelineAsync(const AsyncShader& vertexShader, const AsyncShader& fragmentShader)
+		{
+			PipelineDesc desc{};
+			desc.VertexInput = &VertexInputFor<TVertex>::State;
+			return CreatePipelineAsync(vertexShader, fragmentShader, desc);
+		}
+		
+
+		// Present mode, frames in flight, frame rate cap and low-latency mode
+		void SetFramePacing(const FramePacingSettings& settings);
+		const FramePacingSettings& GetFramePacing() const { return m_PacingSettings; }
+
+		// Call at the top of the frame, before input is processed.
+		// Applies the frame rate cap and, in low-latency mode, waits for the previous frame.
+		void BeginFrame();
+
+		// Acquires the swapchain texture without blocking. Returns false if none was
+		// available, the frame is still submitted for its uploads but draws are dropped.
+		bool InitCommandBuffer();
+
+		FrameTimeStats GetFrameTimeStats() const { return m_Pacer.GetStats(); }
+
+		// Dynamic resolution. While enabled, frames are drawn into an offscreen target at a
+		// scale picked from fence-timed GPU frame times and blitted to the swapchain with
+		// bilinear filtering. The targets are allocated at MaxScale and only the viewport
+		// changes with the scale, so nothing is reallocated until the window is resized.
+		void SetResolutionScaling(const ResolutionScaleSettings& settings);
+		const ResolutionScaleSettings& GetResolutionScaling() const { return m_Scaler.GetSettings(); }
+
+		// Scale of the frame being recorded, 1 while dynamic resolution is off
+		float GetResolutionScale() const { return m_Scaler.GetSettings().Enabled ? m_Scaler.GetScale() : 1.0f; }
+
+		// Size the frame being recorded is drawn at, the top left of the frame's targets
+		uint32_t GetRenderWidth() const { return m_RenderWidth; }
+		uint32_t GetRenderHeight() const { return m_RenderHeight; }
+
+		bool IsHeadless() const { return m_Window == nullptr; }
+
+		// Format of the frame's color target, the swapchain's or the headless target's
+		SDL_GPUTextureFormat GetColorFormat() const;
+
+		// Format of the depth buffer every frame's render pass has attached. It is cleared
+		// to 1 and follows the frame's size, pipelines only test against it when their
+		// DepthStencil state enables it.
+		SDL_GPUTextureFormat GetDepthFormat() const { return m_DepthFormat; }
+
+		// Offscreen color target the frames are drawn into, null unless headless
+		SDL_GPUTexture* GetHeadlessTarget() const { return m_HeadlessTarget; }
+
+		// Scratch memory for the frame being recorded, valid until the same frame slot
+		// comes around again and its fence has signaled. Only use it on the render thread,
+		// jobs have their own GetThreadArena().
+		FrameArena& GetFrameArena() { return m_FrameArenas[m_FrameIndex]; }
+
+		// Queues a draw for this frame. All queued draws are sorted and recorded
+		// into a single render pass when the command buffer is submitted.
+		void RenderPassDraw(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer = nullptr, uint32_t vertexCount = 0, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0);
+		void RenderPassDrawIndexed(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0, int32_t vertexOffset = 0, uint32_t firstInstance = 0);
+
+		// One draw over every instance written to `instances` this frame
+		void RenderPassDrawInstanced(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer, InstanceBuffer* instances, InstanceInput input, uint32_t vertexCount, uint32_t firstVertex = 0);
+		void RenderPassDrawIndexedInstanced(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, InstanceBuffer* instances, InstanceInput input, uint32_t indexCount, uint32_t firstIndex = 0, int32_t vertexOffset = 0);
+
+		// Draws a pooled mesh. Meshes sharing a pool block share their bindings,
+		// only vertex_offset/firstIndex change between them.
+		void RenderPassDrawMesh(SDL_GPUGraphicsPipeline* pipeline, const MeshPool& meshes, MeshHandle mesh, uint32_t instanceCount = 1, uint32_t firstInstance = 0);
+
+		// Draws with `texture` and the trilinear sampler on fragment sampler slot 0,
+		// the placeholder texture is bound while it is still loading
+		void RenderPassDrawTextured(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer, TextureHandle texture, uint32_t vertexCount, uint32_t firstVertex = 0);
+		void RenderPassDrawIndexedTextured(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, TextureHandle texture, uint32_t indexCount, uint32_t firstIndex = 0, int32_t vertexOffset = 0);
+
+		// Draws `drawCount` commands read from `indirectBuffer` at `offset`, as written by a compute pass
+		void RenderPassDrawIndirect(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer, SDL_GPUBuffer* indirectBuffer, uint32_t offset, uint32_t drawCount);
+		void RenderPassDrawIndexedIndirect(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, SDL_GPUBuffer* indirectBuffer, uint32_t offset, uint32_t drawCount);
+
+		void Draw(const DrawItem& item);
+
+		// Depth-tested opaque draws, sorted front to back by `viewDepth` in [0, 1] among
+		// draws with the same pipeline and buffer. With a `depthOnly` draw of the same
+		// geometry, usually a position-only pipeline and vertex stream, depth is laid down
+		// by it in a pre-pass ahead of all other draws; `item`'s pipeline should then test
+		// with DepthState(SDL_GPU_COMPAREOP_EQUAL, false) so every pixel is shaded once.
+		void DrawOpaque(DrawItem item, float viewDepth, const DrawItem* depthOnly = nullptr);
+
+		// DrawOpaque for plain vertex buffers, `depthPipeline` reads `positionBuffer`
+		void RenderPassDrawOpaque(SDL_GPUGraphicsPipeline* pipeline, VertexBuffer* vertexBuffer, uint32_t vertexCount, uint32_t firstVertex, float viewDepth, SDL_GPUGraphicsPipeline* depthPipeline = nullptr, VertexBuffer* positionBuffer = nullptr);
+
+		// Queues a compute dispatch for this frame. Dispatches are recorded in order after
+		// the frame's uploads and before the render pass, so draws see their results.
+		void Dispatch(const ComputeDispatch& dispatch);
+
+		// Counters of the previous frame
+		const DrawStats& GetDrawStats() const { return m_LastDrawStats; }
+
+		// Threads recording the frame's draws, 1 records everything on the calling thread.
+		// With more, the sorted draw list is split into chunks that are recorded into their
+		// own command buffers on the job system and submitted in draw order. Frames with
+		// fewer than MIN_DRAWS_PER_CHUNK draws per thread use fewer threads.
+		static constexpr uint32_t MIN_DRAWS_PER_CHUNK = 256;
+
+		void SetRecordThreadCount(uint32_t threadCount);
+		uint32_t GetRecordThreadCount() const { return m_RecordThreadCount; }
+
+		void SubmitCommandBuffer();
+
+
+	private:
+		SDL_Window* m_Window{nullptr};
+
+		SDL_GPUCommandBuffer* m_CommandBuffer{nullptr};
+
+		// The frame's color target, the acquired swapchain texture or the headless target
+		SDL_GPUTexture* m_SwapchainTexture{nullptr};
+		uint32_t m_SwapchainWidth{0};
+		uint32_t m_SwapchainHeight{0};
+
+		SDL_GPUTexture* m_HeadlessTarget{nullptr};
+		uint32_t m_HeadlessWidth{0};
+		uint32_t m_HeadlessHeight{0};
+		static constexpr SDL_GPUTextureFormat HEADLESS_FORMAT = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+
+		// Offscreen color target for multithreaded recording and dynamic resolution. The
+		// swapchain texture belongs to the frame's command buffer, so chunks draw here and
+		// the result is blitted over.
+		SDL_GPUTexture* m_SceneTexture{nullptr};
+		uint32_t m_SceneWidth{0};
+		uint32_t m_SceneHeight{0};
+		void ResizeSceneTexture(uint32_t width, uint32_t height);
+		void BlitSceneTexture(SDL_GPUCommandBuffer* commandBuffer);
+
+		// Depth buffer of the frame's render pass, recreated when the frame size changes
+		SDL_GPUTexture* m_DepthTexture{nullptr};
+		SDL_GPUTextureFormat m_DepthFormat{SDL_GPU_TEXTUREFORMAT_INVALID};
+		uint32_t m_DepthWidth{0};
+		uint32_t m_DepthHeight{0};
+		void ResizeDepthTexture(uint32_t width, uint32_t height);
+
+		// Size of the frame's depth and offscreen color targets, the frame size at the largest scale
+		void GetTargetSize(uint32_t& width, uint32_t& height) const;
+
+		ResolutionScaler m_Scaler;
+		std::unique_ptr<GpuFrameTimer> m_GpuTimer;   // only while dynamic resolution is on
+		uint32_t m_RenderWidth{0};
+		uint32_t m_RenderHeight{0};
+		void UpdateRenderSize();
+		void SetRenderViewport(SDL_GPURenderPass* renderPass) const;
+
+		// Frame fences, a slot is only reused once its previous frame has completed
+		std::array<SDL_GPUFence*, MAX_FRAMES_IN_FLIGHT> m_FrameFences{};
+		std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> m_FrameFenceSerials{};
+		std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> m_FrameSubmitTimes{};   // Profiler::Now() at submit, for GPU frame zones
+		uint32_t m_FrameIndex{0};
+		uint32_t m_FramesInFlight{MAX_FRAMES_IN_FLIGHT};
+		uint64_t m_FrameSerial{0};
+		uint64_t m_CompletedFrameSerial{0};
+
+		std::array<FrameArena, MAX_FRAMES_IN_FLIGHT> m_FrameArenas;
+
+		// AllocationTracker count when the frame started recording
+		uint64_t m_FrameStartAllocations{0};
+
+		void RetireFrames();
+		void WaitForFrame(uint32_t frameIndex);
+		void CompleteFrame(uint32_t frameIndex);   // the slot's fence has signaled
+		void WaitForAllFrames();
+
+		FramePacer m_Pacer;
+		FramePacingSettings m_PacingSettings{};
+		bool m_SkippedLastFrame{false};
+
+		DrawQueue m_DrawQueue;
+		DrawStats m_DrawStats{};
+		DrawStats m_LastDrawStats{};
+		void DrawQueuedItems();
+
+		// One contiguous range of the sorted draw list. Each chunk writes only its own
+		// entry, so recording threads share nothing but the submit turn.
+		struct RecordChunk
+		{
+			uint32_t Index{0};
+			size_t First{0};
+			size_t Count{0};
+			DrawStats Stats{};
+		};
+
+		uint32_t m_RecordThreadCount{1};
+
+		// Chunks submit in order, each waits until the previous one has been submitted
+		std::mutex m_SubmitMutex;
+		std::condition_variable m_SubmitCondition;
+		uint32_t m_NextChunkToSubmit{0};
+		bool m_FirstChunkFailed{false};     // the later chunks would load an uncleared target
+
+		void DrawQueuedItemsParallel(uint32_t chunkCount);
+		void RecordDrawChunk(RecordChunk& chunk);
+
+		struct QueuedDispatch
+		{
+			ComputeDispatch Dispatch;
+			uint32_t UniformOffset;   // into m_DispatchUniforms
+		};
+
+		std::vector<QueuedDispatch> m_Dispatches;
+		std::vector<uint8_t> m_DispatchUniforms;
+		void RecordDispatches(SDL_GPUCommandBuffer* commandBuffer);
+
+		// Shader bytecode for the device's backend, either a view into the archive or a loaded loose file
+		struct ShaderCode
+		{
+			std::span<const uint8_t> Code;
+			uint8_t* OwnedCode{nullptr};                // SDL_LoadFile result, freed by the caller
+			const ShaderArchiveEntry* Entry{nullptr};   // set when the code came from shaders.pack
+			SDL_GPUShaderFormat Format{SDL_GPU_SHADERFORMAT_INVALID};
+			const char* EntryPoint{nullptr};
+		};
+
+		bool LoadShaderCode(const std::string& shaderSource, ShaderCode& shaderCode);
+
+		std::unique_ptr<PipelineCache> m_PipelineCache;
+		ShaderArchive m_ShaderArchive;
+
+};
\ No newline at end of file
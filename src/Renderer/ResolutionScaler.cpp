@@ -0,0 +1,53 @@
+#include "ResolutionScaler.hpp"
+#include <algorithm>
+#include <cmath>
+
+
+void ResolutionScaler::SetSettings(const ResolutionScaleSettings& settings)
+{
+	m_Settings = settings;
+	m_Settings.MinScale = std::max(m_Settings.MinScale, 0.1f);
+	m_Settings.MaxScale = std::max(m_Settings.MaxScale, m_Settings.MinScale);
+	m_Settings.UpThreshold = std::min(m_Settings.UpThreshold, m_Settings.DownThreshold);
+
+	m_Scale = std::clamp(m_Scale, m_Settings.MinScale, m_Settings.MaxScale);
+	m_Samples = 0;
+	m_SettleFrames = 0;
+}
+
+bool ResolutionScaler::AddFrameTime(double milliseconds)
+{
+	if (m_SettleFrames > 0)
+	{
+		m_SettleFrames--;
+		return false;
+	}
+
+	m_AverageMS = m_Samples == 0 ? milliseconds : m_AverageMS + SMOOTHING * (milliseconds - m_AverageMS);
+	m_Samples++;
+	if (m_Samples < MIN_SAMPLES)
+		return false;
+
+	const double target = m_Settings.TargetGpuMS;
+	const bool overBudget = m_AverageMS > target * m_Settings.DownThreshold;
+	const bool underBudget = m_AverageMS < target * m_Settings.UpThreshold;
+	if (!overBudget && !underBudget)
+		return false;
+
+	// Aim for the middle of the band so the next frames land inside it
+	const double goal = target * 0.5 * (m_Settings.DownThreshold + m_Settings.UpThreshold);
+	float scale = m_Scale * float(std::sqrt(goal / std::max(m_AverageMS, 0.01)));
+	if (underBudget)
+		scale = std::min(scale, m_Scale + MAX_STEP_UP);
+	scale = std::clamp(scale, m_Settings.MinScale, m_Settings.MaxScale);
+
+	if (std::abs(scale - m_Scale) < MIN_STEP && scale != m_Settings.MinScale && scale != m_Settings.MaxScale)
+		return false;
+	if (scale == m_Scale)
+		return false;
+
+	m_Scale = scale;
+	m_Samples = 0;
+	m_SettleFrames = m_Settings.SettleFrames;
+	return true;
+}
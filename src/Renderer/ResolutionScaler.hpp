@@ -0,0 +1,61 @@
+#pragma once
+
+#include "common.hpp"
+
+
+struct ResolutionScaleSettings
+{
+	bool Enabled{false};
+
+	// GPU time budget per frame, keep it a little under the display interval.
+	// Frames are timed fence to fence, including the gaps between the GPU's work.
+	// Under VSYNC the fence also waits for the display, so the measured time never
+	// drops below the refresh interval and the scale only falls. Use another present mode.
+	double TargetGpuMS{15.0};
+
+	// Fraction of the window size the scene is rendered at. Render targets are
+	// allocated once at MaxScale, above 1 supersamples.
+	float MinScale{0.5f};
+	float MaxScale{1.0f};
+
+	// Hysteresis band as fractions of the budget, the scale drops above DownThreshold
+	// and only rises again below UpThreshold
+	float DownThreshold{1.0f};
+	float UpThreshold{0.8f};
+
+	// GPU frames ignored after a change, the frames already in flight still use the old scale
+	uint32_t SettleFrames{8};
+};
+
+
+// Picks the render scale from measured GPU frame times.
+// GPU time mostly follows the pixel count, the square of the scale, so an over-budget
+// frame time is corrected in one proportional step towards the middle of the band.
+// Rising is limited to MAX_STEP_UP per change, dropping resolution is cheap to notice
+// but a frame missed from rising too far is not.
+class ResolutionScaler
+{
+	public:
+		static constexpr float MAX_STEP_UP = 0.05f;
+		static constexpr float MIN_STEP = 0.01f;     // smaller changes are not worth a different frame size
+		static constexpr double SMOOTHING = 0.2;     // weight of a new frame time in the running average
+		static constexpr uint32_t MIN_SAMPLES = 4;   // frames averaged before acting, a single hitch changes nothing
+
+		void SetSettings(const ResolutionScaleSettings& settings);
+		const ResolutionScaleSettings& GetSettings() const { return m_Settings; }
+
+		// Feeds the GPU time of one completed frame, returns true if the scale changed
+		bool AddFrameTime(double milliseconds);
+
+		float GetScale() const { return m_Scale; }
+
+		// Running average of the frame times since the last change
+		double GetAverageMS() const { return m_AverageMS; }
+
+	private:
+		ResolutionScaleSettings m_Settings{};
+		float m_Scale{1.0f};
+		double m_AverageMS{0.0};
+		uint32_t m_Samples{0};
+		uint32_t m_SettleFrames{0};
+};
@@ -0,0 +1,77 @@
+#include "ShaderArchive.hpp"
+#include "common.hpp"
+#include <algorithm>
+
+
+bool ShaderArchive::Open(const std::string& path)
+{
+	Close();
+
+	if (!m_File.Open(path))
+		return false;
+
+	const uint8_t* data = m_File.GetData();
+	const size_t size = m_File.GetSize();
+
+	if (size < sizeof(ShaderArchiveHeader))
+		SDLException("Shader archive is truncated: " + path);
+
+	const auto* header = reinterpret_cast<const ShaderArchiveHeader*>(data);
+	if (header->Magic != SHADER_ARCHIVE_MAGIC || header->Version != SHADER_ARCHIVE_VERSION)
+		SDLException("Shader archive has an unknown format: " + path);
+
+	if (header->FileSize != size || header->EntryOffset % alignof(ShaderArchiveEntry) != 0 ||
+		header->EntryOffset + uint64_t(header->EntryCount) * sizeof(ShaderArchiveEntry) > size)
+		SDLException("Shader archive is corrupt: " + path);
+
+	m_Entries = { reinterpret_cast<const ShaderArchiveEntry*>(data + header->EntryOffset), header->EntryCount };
+
+	// Validate every range once so lookups can trust the table
+	for (const ShaderArchiveEntry& entry : m_Entries)
+	{
+		bool valid = uint64_t(entry.NameOffset) + entry.NameLength <= size;
+		for (const ShaderArchiveBlob& blob : entry.Blobs)
+			valid &= uint64_t(blob.Offset) + blob.Size <= size;
+
+		if (!valid)
+			SDLException("Shader archive is corrupt: " + path);
+	}
+
+	return true;
+}
+
+void ShaderArchive::Close()
+{
+	m_Entries = {};
+	m_File.Close();
+}
+
+const ShaderArchiveEntry* ShaderArchive::Find(std::string_view name) const
+{
+	const uint64_t hash = ShaderArchiveHash(name);
+
+	auto it = std::lower_bound(m_Entries.begin(), m_Entries.end(), hash,
+		[](const ShaderArchiveEntry& entry, uint64_t value) { return entry.NameHash < value; });
+
+	for (; it != m_Entries.end() && it->NameHash == hash; ++it)
+	{
+		if (GetName(*it) == name)
+			return &*it;
+	}
+
+	return nullptr;
+}
+
+std::span<const uint8_t> ShaderArchive::GetCode(const ShaderArchiveEntry& entry, ShaderArchiveBackend backend) const
+{
+	const ShaderArchiveBlob& blob = entry.Blobs[size_t(backend)];
+	if (blob.Size == 0)
+		return {};
+
+	return { m_File.GetData() + blob.Offset, blob.Size };
+}
+
+std::string_view ShaderArchive::GetName(const ShaderArchiveEntry& entry) const
+{
+	return { reinterpret_cast<const char*>(m_File.GetData() + entry.NameOffset), entry.NameLength };
+}
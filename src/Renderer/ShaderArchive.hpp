@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Core/MappedFile.hpp"
+#include "Renderer/ShaderArchiveFormat.hpp"
+#include <span>
+#include <string_view>
+
+
+// Runtime view of a shaders.pack built by the ShaderPacker tool.
+// The archive is mapped once and shader code is read straight from the mapping.
+class ShaderArchive
+{
+	public:
+		ShaderArchive() = default;
+		virtual ~ShaderArchive() = default;
+
+		// Returns false if the file does not exist, throws if it exists but is malformed
+		bool Open(const std::string& path);
+		void Close();
+
+		bool IsOpen() const { return m_File.IsOpen(); }
+
+		// Looks a shader up by the name it was packed under, e.g. "PositionColor.vert"
+		const ShaderArchiveEntry* Find(std::string_view name) const;
+
+		// Empty span if the shader was not packed for this backend
+		std::span<const uint8_t> GetCode(const ShaderArchiveEntry& entry, ShaderArchiveBackend backend) const;
+
+		std::span<const ShaderArchiveEntry> GetEntries() const { return m_Entries; }
+
+	private:
+		MappedFile m_File;
+		std::span<const ShaderArchiveEntry> m_Entries;
+
+		std::string_view GetName(const ShaderArchiveEntry& entry) const;
+};
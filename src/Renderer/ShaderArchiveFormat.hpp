@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// On-disk layout of shaders.pack, shared by the ShaderPacker tool and the runtime loader.
+// Only depends on the standard library so the packer can build without SDL.
+//
+//   ShaderArchiveHeader
+//   ShaderArchiveEntry[EntryCount]   sorted by NameHash
+//   name strings                     not null terminated
+//   code blobs                       each aligned to SHADER_ARCHIVE_ALIGNMENT
+
+constexpr uint32_t SHADER_ARCHIVE_MAGIC = 0x41535853; // "SXSA"
+constexpr uint32_t SHADER_ARCHIVE_VERSION = 2;
+constexpr uint32_t SHADER_ARCHIVE_ALIGNMENT = 16;
+
+enum class ShaderArchiveStage : uint8_t
+{
+	Vertex = 0,
+	Fragment = 1,
+	Compute = 2,
+};
+
+// Index into ShaderArchiveEntry::Blobs
+enum class ShaderArchiveBackend : uint8_t
+{
+	SPIRV = 0,
+	DXIL = 1,
+	MSL = 2,
+	Count
+};
+
+struct ShaderArchiveHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t EntryCount;
+	uint32_t EntryOffset;
+	uint64_t FileSize;
+};
+
+struct ShaderArchiveBlob
+{
+	uint32_t Offset; // from the start of the file, 0 if the backend is missing
+	uint32_t Size;
+};
+
+struct ShaderArchiveEntry
+{
+	uint64_t NameHash;
+	uint32_t NameOffset;
+	uint16_t NameLength;
+	ShaderArchiveStage Stage;
+	uint8_t Padding;
+
+	// Resource counts reflected from the SPIR-V blob.
+	// Storage buffers and textures are the read-only ones, graphics shaders have no others.
+	uint32_t SamplerCount;
+	uint32_t UniformBufferCount;
+	uint32_t StorageBufferCount;
+	uint32_t StorageTextureCount;
+	uint32_t ReadWriteStorageBufferCount;
+	uint32_t ReadWriteStorageTextureCount;
+
+	// Compute workgroup size
+	uint16_t ThreadCount[3];
+	uint16_t Padding2;
+
+	ShaderArchiveBlob Blobs[size_t(ShaderArchiveBackend::Count)];
+};
+
+static_assert(sizeof(ShaderArchiveHeader) == 24);
+static_assert(sizeof(ShaderArchiveEntry) == 72);
+
+// FNV-1a, the table of contents is keyed by this hash of the shader name
+constexpr uint64_t ShaderArchiveHash(std::string_view name)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (char c : name)
+	{
+		hash ^= uint8_t(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
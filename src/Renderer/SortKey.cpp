@@ -0,0 +1,9 @@
+#include "SortKey.hpp"
+#include <atomic>
+
+
+uint16_t SortKey::NextBufferId()
+{
+	static std::atomic<uint32_t> sequence{0};
+	return WrapKeyId(sequence.fetch_add(1, std::memory_order_relaxed));
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+
+// Ids of the pipeline and buffer fields in DrawQueue::MakeKey, 12 bits each.
+// They are handed out round-robin over [1, KEY_ID_COUNT), 0 meaning none, so past
+// 4095 objects ids repeat. Draws sharing an id only group less tightly in the sort,
+// DrawQueue::Record compares the actual handles before binding.
+namespace SortKey
+{
+	constexpr uint32_t KEY_ID_COUNT = 0x1000;
+
+	constexpr uint16_t WrapKeyId(uint32_t sequence)
+	{
+		return uint16_t(1 + sequence % (KEY_ID_COUNT - 1));
+	}
+
+	// Ids for VertexBuffer, IndexBuffer and GpuBufferPool blocks, one sequence so they
+	// don't collide with each other. Thread-safe, buffers are created on job threads.
+	uint16_t NextBufferId();
+}
@@ -0,0 +1,468 @@
+#include "TextureManager.hpp"
+#include "Core/Profiler.hpp"
+#include "Renderer/CookedTextureFormat.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <SDL3_image/SDL_image.h>
+
+TextureManager::TextureManager(SDL_GPUDevice* device, UploadManager* uploader, JobSystem* jobs, uint64_t uploadBudget)
+{
+	m_Device = device;
+	m_Uploader = uploader;
+	m_Jobs = jobs;
+	m_UploadBudget = uploadBudget;
+
+	// Slot 0 stays unused so INVALID_TEXTURE never names a texture
+	m_Entries.emplace_back();
+
+	SDL_GPUSamplerCreateInfo samplerCreateInfo{};
+	samplerCreateInfo.min_filter = SDL_GPU_FILTER_LINEAR;
+	samplerCreateInfo.mag_filter = SDL_GPU_FILTER_LINEAR;
+	samplerCreateInfo.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_LINEAR;
+	samplerCreateInfo.address_mode_u = SDL_GPU_SAMPLERADDRESSMODE_REPEAT;
+	samplerCreateInfo.address_mode_v = SDL_GPU_SAMPLERADDRESSMODE_REPEAT;
+	samplerCreateInfo.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_REPEAT;
+	samplerCreateInfo.max_lod = 1000.0f;
+	m_LinearSampler = SDL_CreateGPUSampler(m_Device, &samplerCreateInfo);
+
+	samplerCreateInfo.min_filter = SDL_GPU_FILTER_NEAREST;
+	samplerCreateInfo.mag_filter = SDL_GPU_FILTER_NEAREST;
+	samplerCreateInfo.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_NEAREST;
+	m_NearestSampler = SDL_CreateGPUSampler(m_Device, &samplerCreateInfo);
+
+	if (!m_LinearSampler || !m_NearestSampler)
+		SDLException("Failed to create texture samplers");
+
+	// Grey checkerboard, goes out with the first frame's uploads
+	SDL_GPUTextureCreateInfo textureCreateInfo{};
+	textureCreateInfo.type = SDL_GPU_TEXTURETYPE_2D;
+	textureCreateInfo.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+	textureCreateInfo.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER;
+	textureCreateInfo.width = 2;
+	textureCreateInfo.height = 2;
+	textureCreateInfo.layer_count_or_depth = 1;
+	textureCreateInfo.num_levels = 1;
+
+	m_Placeholder = SDL_CreateGPUTexture(m_Device, &textureCreateInfo);
+	if (!m_Placeholder)
+	{
+		SDLException("Failed to create placeholder texture");
+		return;
+	}
+
+	static constexpr uint8_t checker[] = {
+		160, 160, 160, 255,   96,  96,  96, 255,
+		 96,  96,  96, 255,  160, 160, 160, 255
+	};
+
+	SDL_GPUTextureRegion region{};
+	region.texture = m_Placeholder;
+	region.w = 2;
+	region.h = 2;
+	region.d = 1;
+	m_Uploader->UploadToTexture(region, checker, sizeof(checker));
+}
+
+TextureManager::~TextureManager()
+{
+}
+
+void TextureManager::Cleanup()
+{
+	for (Entry& entry : m_Entries)
+	{
+		if (entry.Texture)
+			SDL_ReleaseGPUTexture(m_Device, entry.Texture);
+	}
+
+	for (SDL_GPUTexture* texture : m_PendingReleases)
+		SDL_ReleaseGPUTexture(m_Device, texture);
+
+	m_Entries.clear();
+	m_FreeEntries.clear();
+	m_Paths.clear();
+	m_StreamQueue.clear();
+	m_PendingMipmaps.clear();
+	m_PendingReleases.clear();
+
+	if (m_Placeholder)
+	{
+		SDL_ReleaseGPUTexture(m_Device, m_Placeholder);
+		m_Placeholder = nullptr;
+	}
+
+	if (m_LinearSampler)
+	{
+		SDL_ReleaseGPUSampler(m_Device, m_LinearSampler);
+		m_LinearSampler = nullptr;
+	}
+
+	if (m_NearestSampler)
+	{
+		SDL_ReleaseGPUSampler(m_Device, m_NearestSampler);
+		m_NearestSampler = nullptr;
+	}
+}
+
+
+
+TextureHandle TextureManager::Load(const std::string& path, bool generateMipmaps, bool srgb)
+{
+	auto found = m_Paths.find(path);
+	if (found != m_Paths.end())
+	{
+		m_Entries[found->second].References++;
+		return found->second;
+	}
+
+	TextureHandle handle;
+	if (!m_FreeEntries.empty())
+	{
+		handle = m_FreeEntries.back();
+		m_FreeEntries.pop_back();
+	}
+	else
+	{
+		handle = TextureHandle(m_Entries.size());
+		m_Entries.emplace_back();
+	}
+
+	Entry& entry = m_Entries[handle];
+	entry = Entry{};
+	entry.Path = path;
+	entry.State = TextureState::Decoding;
+	entry.References = 1;
+
+	// Cooked files carry their own mip chain and color space
+	const bool cooked = path.ends_with(".ctex");
+	entry.GenerateMipmaps = generateMipmaps && !cooked;
+
+	// The job only touches its own result, so the entry can be released while it runs
+	if (cooked)
+		entry.Decode = m_Jobs->ScheduleResult([path] { return MapCookedImage(path); });
+	else
+		entry.Decode = m_Jobs->ScheduleResult([path, srgb] { return DecodeImage(path, srgb); });
+
+	m_Paths.emplace(path, handle);
+	m_StreamQueue.push_back(handle);
+	return handle;
+}
+
+void TextureManager::Release(TextureHandle texture)
+{
+	if (!IsValid(texture))
+		return;
+
+	Entry& entry = m_Entries[texture];
+	if (--entry.References > 0)
+		return;
+
+	if (entry.Texture)
+		m_PendingReleases.push_back(entry.Texture);
+
+	std::erase(m_StreamQueue, texture);
+	m_Paths.erase(entry.Path);
+
+	// Drops our share of a decode still in flight, the job keeps its own
+	entry = Entry{};
+	m_FreeEntries.push_back(texture);
+}
+
+SDL_GPUTexture* TextureManager::GetTexture(TextureHandle texture) const
+{
+	return IsResident(texture) ? m_Entries[texture].Texture : m_Placeholder;
+}
+
+bool TextureManager::IsResident(TextureHandle texture) const
+{
+	return IsValid(texture) && m_Entries[texture].State == TextureState::Resident;
+}
+
+bool TextureManager::HasFailed(TextureHandle texture) const
+{
+	return IsValid(texture) && m_Entries[texture].State == TextureState::Failed;
+}
+
+
+
+void TextureManager::Update()
+{
+	SDLGPU_PROFILE_FUNCTION();
+
+	// The frame that could have queued copies to these has been recorded by now
+	for (SDL_GPUTexture* texture : m_PendingReleases)
+		SDL_ReleaseGPUTexture(m_Device, texture);
+	m_PendingReleases.clear();
+
+	// Request order, so textures asked for first also become resident first
+	uint64_t staged = 0;
+	std::erase_if(m_StreamQueue, [&](TextureHandle handle)
+	{
+		Entry& entry = m_Entries[handle];
+
+		if (entry.State == TextureState::Decoding)
+		{
+			if (!entry.Decode.IsReady())
+				return false;
+
+			if (!CreateTexture(entry))
+			{
+				entry.State = TextureState::Failed;
+				entry.Decode = {};
+				return true;
+			}
+			entry.State = TextureState::Streaming;
+		}
+
+		if (staged >= m_UploadBudget && staged > 0)
+			return false;
+
+		if (!StreamRows(entry, m_UploadBudget - std::min(staged, m_UploadBudget), staged))
+			return false;
+
+		// Staged copies are recorded ahead of the mipmaps and the render pass,
+		// so draws queued from now on can already use the texture
+		if (entry.GenerateMipmaps)
+			m_PendingMipmaps.push_back(entry.Texture);
+
+		entry.State = TextureState::Resident;
+		entry.Decode = {};
+		return true;
+	});
+
+	m_LastUploadedBytes = staged;
+}
+
+void TextureManager::RecordMipmaps(SDL_GPUCommandBuffer* commandBuffer)
+{
+	for (SDL_GPUTexture* texture : m_PendingMipmaps)
+		SDL_GenerateMipmapsForGPUTexture(commandBuffer, texture);
+	m_PendingMipmaps.clear();
+}
+
+TextureStats TextureManager::GetStats() const
+{
+	TextureStats stats{};
+	stats.UploadedBytes = m_LastUploadedBytes;
+
+	for (const Entry& entry : m_Entries)
+	{
+		switch (entry.State)
+		{
+		case TextureState::Decoding:
+			stats.Decoding++;
+			break;
+		case TextureState::Streaming:
+			stats.Streaming++;
+			for (size_t level = entry.UploadedLevel; level < entry.Decode.Value->Levels.size(); level++)
+			{
+				const ImageLevel& levelRows = entry.Decode.Value->Levels[level];
+				stats.PendingBytes += uint64_t(levelRows.RowCount - (level == entry.UploadedLevel ? entry.UploadedRows : 0)) * levelRows.RowBytes;
+			}
+			break;
+		case TextureState::Resident:
+			stats.Resident++;
+			break;
+		case TextureState::Failed:
+			stats.Failed++;
+			break;
+		default:
+			continue;
+		}
+		stats.Textures++;
+	}
+
+	return stats;
+}
+
+
+
+TextureManager::DecodedImage TextureManager::DecodeImage(const std::string& path, bool srgb)
+{
+	SDLGPU_PROFILE_ZONE("DecodeTexture");
+
+	DecodedImage image{};
+	SDL_Surface* surface = IMG_Load(path.c_str());
+	if (!surface)
+	{
+		fprintf(stderr, "Failed to load texture %s: %s\n", path.c_str(), SDL_GetError());
+		return image;
+	}
+
+	SDL_Surface* converted = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+	SDL_DestroySurface(surface);
+	if (!converted)
+	{
+		fprintf(stderr, "Failed to convert texture %s: %s\n", path.c_str(), SDL_GetError());
+		return image;
+	}
+
+	// Repacked without row padding, the uploader expects tight rows
+	ImageLevel level{};
+	level.Width = uint32_t(converted->w);
+	level.Height = uint32_t(converted->h);
+	level.RowBytes = level.Width * BYTES_PER_PIXEL;
+	level.RowCount = level.Height;
+	image.Pixels.resize(size_t(level.RowBytes) * level.Height);
+	for (uint32_t y = 0; y < level.Height; y++)
+		memcpy(image.Pixels.data() + size_t(y) * level.RowBytes, static_cast<const uint8_t*>(converted->pixels) + size_t(y) * converted->pitch, level.RowBytes);
+
+	SDL_DestroySurface(converted);
+
+	image.Format = srgb ? SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB : SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+	image.Levels.push_back(level);
+	return image;
+}
+
+TextureManager::DecodedImage TextureManager::MapCookedImage(const std::string& path)
+{
+	SDLGPU_PROFILE_ZONE("MapCookedTexture");
+
+	DecodedImage image{};
+	if (!image.Cooked.Open(path))
+	{
+		fprintf(stderr, "Failed to open texture %s\n", path.c_str());
+		return image;
+	}
+
+	const uint8_t* data = image.Cooked.GetData();
+	const size_t size = image.Cooked.GetSize();
+
+	CookedTextureHeader header{};
+	if (size >= sizeof(header))
+		memcpy(&header, data, sizeof(header));
+
+	if (header.Magic != COOKED_TEXTURE_MAGIC || header.Version != COOKED_TEXTURE_VERSION || header.FileSize != size ||
+		header.MipCount == 0 || header.MipCount > COOKED_TEXTURE_MAX_MIPS || sizeof(header) + header.MipCount * sizeof(CookedTextureMip) > size)
+	{
+		fprintf(stderr, "Invalid cooked texture %s\n", path.c_str());
+		return DecodedImage{};
+	}
+
+	const bool srgb = header.Flags & COOKED_TEXTURE_FLAG_SRGB;
+	switch (header.Format)
+	{
+	case CookedTextureFormat::RGBA8:
+		image.Format = srgb ? SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB : SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+		break;
+	case CookedTextureFormat::BC1:
+		image.Format = srgb ? SDL_GPU_TEXTUREFORMAT_BC1_RGBA_UNORM_SRGB : SDL_GPU_TEXTUREFORMAT_BC1_RGBA_UNORM;
+		break;
+	case CookedTextureFormat::BC3:
+		image.Format = srgb ? SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM_SRGB : SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM;
+		break;
+	case CookedTextureFormat::BC7:
+		image.Format = srgb ? SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM_SRGB : SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM;
+		break;
+	default:
+		fprintf(stderr, "Unknown format in cooked texture %s\n", path.c_str());
+		return DecodedImage{};
+	}
+
+	// Payloads are already in upload layout, only their bounds need checking
+	for (uint32_t i = 0; i < header.MipCount; i++)
+	{
+		CookedTextureMip mip;
+		memcpy(&mip, data + sizeof(header) + i * sizeof(CookedTextureMip), sizeof(mip));
+
+		if (mip.Width != std::max(1u, header.Width >> i) || mip.Height != std::max(1u, header.Height >> i) ||
+			mip.Size != CookedTextureMipSize(header.Format, mip.Width, mip.Height) || uint64_t(mip.Offset) + mip.Size > size)
+		{
+			fprintf(stderr, "Invalid mip %u in cooked texture %s\n", i, path.c_str());
+			return DecodedImage{};
+		}
+
+		ImageLevel& level = image.Levels.emplace_back();
+		level.Offset = mip.Offset;
+		level.Width = mip.Width;
+		level.Height = mip.Height;
+		level.RowBytes = CookedTextureRowBytes(header.Format, mip.Width);
+		level.RowCount = CookedTextureRowCount(header.Format, mip.Height);
+		level.RowHeight = CookedTextureRowHeight(header.Format);
+	}
+
+	// Fault the pages in here, so the copies into staging on the render thread don't wait on the disk
+	const volatile uint8_t* pages = data;
+	for (size_t offset = 0; offset < size; offset += 4096)
+		(void)pages[offset];
+
+	return image;
+}
+
+bool TextureManager::CreateTexture(Entry& entry)
+{
+	const DecodedImage& image = *entry.Decode.Value;
+	if (image.Levels.empty())
+		return false;
+
+	// Block compression is missing on most mobile GPUs, those need textures cooked as RGBA8
+	if (!SDL_GPUTextureSupportsFormat(m_Device, image.Format, SDL_GPU_TEXTURETYPE_2D, SDL_GPU_TEXTUREUSAGE_SAMPLER))
+	{
+		fprintf(stderr, "Texture format of %s is not supported by this device\n", entry.Path.c_str());
+		return false;
+	}
+
+	// SDL_GenerateMipmapsForGPUTexture blits between levels, which needs the color target usage
+	const ImageLevel& base = image.Levels[0];
+	SDL_GPUTextureCreateInfo textureCreateInfo{};
+	textureCreateInfo.type = SDL_GPU_TEXTURETYPE_2D;
+	textureCreateInfo.format = image.Format;
+	textureCreateInfo.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | (entry.GenerateMipmaps ? SDL_GPU_TEXTUREUSAGE_COLOR_TARGET : 0);
+	textureCreateInfo.width = base.Width;
+	textureCreateInfo.height = base.Height;
+	textureCreateInfo.layer_count_or_depth = 1;
+	textureCreateInfo.num_levels = entry.GenerateMipmaps ? uint32_t(std::bit_width(std::max(base.Width, base.Height))) : uint32_t(image.Levels.size());
+
+	entry.Texture = SDL_CreateGPUTexture(m_Device, &textureCreateInfo);
+	if (!entry.Texture)
+	{
+		fprintf(stderr, "Failed to create texture %s: %s\n", entry.Path.c_str(), SDL_GetError());
+		return false;
+	}
+
+	entry.UploadedLevel = 0;
+	entry.UploadedRows = 0;
+	return true;
+}
+
+bool TextureManager::StreamRows(Entry& entry, uint64_t budget, uint64_t& staged)
+{
+	const DecodedImage& image = *entry.Decode.Value;
+
+	// Levels go out largest first, in as few uploads as the budget allows
+	while (entry.UploadedLevel < image.Levels.size())
+	{
+		const ImageLevel& level = image.Levels[entry.UploadedLevel];
+
+		// A single row always goes out when nothing else did this frame
+		uint32_t rows = uint32_t(std::min<uint64_t>(budget / level.RowBytes, level.RowCount - entry.UploadedRows));
+		if (rows == 0 && staged == 0)
+			rows = 1;
+		if (rows == 0)
+			return false;
+
+		SDL_GPUTextureRegion region{};
+		region.texture = entry.Texture;
+		region.mip_level = entry.UploadedLevel;
+		region.y = entry.UploadedRows * level.RowHeight;
+		region.w = level.Width;
+		region.h = std::min(rows * level.RowHeight, level.Height - region.y);
+		region.d = 1;
+
+		const uint32_t size = rows * level.RowBytes;
+		m_Uploader->UploadToTexture(region, image.GetData() + level.Offset + size_t(entry.UploadedRows) * level.RowBytes, size, level.RowHeight);
+
+		entry.UploadedRows += rows;
+		staged += size;
+		budget -= std::min<uint64_t>(size, budget);
+
+		if (entry.UploadedRows == level.RowCount)
+		{
+			entry.UploadedLevel++;
+			entry.UploadedRows = 0;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "common.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/MappedFile.hpp"
+#include "Renderer/UploadManager.hpp"
+#include <unordered_map>
+#include <vector>
+#include <SDL3/SDL_gpu.h>
+
+
+// Refers to a texture slot, 0 is never a valid texture
+using TextureHandle = uint32_t;
+constexpr TextureHandle INVALID_TEXTURE = 0;
+
+struct TextureStats
+{
+	uint32_t Textures{0};
+	uint32_t Decoding{0};        // waiting for or running on a worker
+	uint32_t Streaming{0};       // decoded or mapped, rows still to upload
+	uint32_t Resident{0};
+	uint32_t Failed{0};
+	uint64_t UploadedBytes{0};   // staged by the last Update
+	uint64_t PendingBytes{0};    // decoded or mapped but not staged yet
+};
+
+
+// Loads textures without stalling the frame.
+// Images are decoded with SDL_image on the job system, then staged through the
+// uploader a few rows at a time so at most the upload budget goes out per frame.
+// Mip chains are generated on the GPU once the base level is in. Cooked .ctex files
+// (see tools/TextureCooker) skip decoding: they are mapped on a worker and their
+// block-compressed mips are copied straight from the mapping into staging memory.
+// Until a texture is resident, GetTexture returns a placeholder so draws can be queued right away.
+// Not thread safe, use it from the render thread.
+class TextureManager
+{
+	public:
+		static constexpr uint64_t DEFAULT_UPLOAD_BUDGET = 8ull * 1024ull * 1024ull;
+
+		TextureManager(SDL_GPUDevice* device, UploadManager* uploader, JobSystem* jobs, uint64_t uploadBudget = DEFAULT_UPLOAD_BUDGET);
+		virtual ~TextureManager();
+
+		void Cleanup();
+
+		// Starts decoding the PNG/JPEG at `path` and returns immediately. Loading a path that
+		// is already loaded returns the same handle with another reference.
+		// Color textures should stay sRGB, data like normal maps should not.
+		// Paths ending in .ctex are cooked textures, which bring their own mips and color space.
+		TextureHandle Load(const std::string& path, bool generateMipmaps = true, bool srgb = true);
+
+		// Drops a reference, the texture is destroyed with the last one
+		void Release(TextureHandle texture);
+
+		// The texture once it is resident, otherwise the placeholder
+		SDL_GPUTexture* GetTexture(TextureHandle texture) const;
+
+		bool IsResident(TextureHandle texture) const;
+		bool HasFailed(TextureHandle texture) const;
+
+		// Trilinear and point samplers, both repeating
+		SDL_GPUSampler* GetLinearSampler() const { return m_LinearSampler; }
+		SDL_GPUSampler* GetNearestSampler() const { return m_NearestSampler; }
+
+		// Bytes staged per frame. Textures above the budget stream in over several
+		// frames, at least one row goes out per frame so large rows still make progress.
+		void SetUploadBudget(uint64_t bytes) { m_UploadBudget = bytes; }
+		uint64_t GetUploadBudget() const { return m_UploadBudget; }
+
+		// Called by the renderer after the uploader's BeginFrame. Creates textures for
+		// finished decodes and stages pending rows until the budget is used up.
+		void Update();
+
+		// Called by the renderer right after the frame's uploads were recorded,
+		// outside of any pass
+		void RecordMipmaps(SDL_GPUCommandBuffer* commandBuffer);
+
+		TextureStats GetStats() const;
+
+	private:
+		enum class TextureState : uint8_t
+		{
+			Free,
+			Decoding,
+			Streaming,
+			Resident,
+			Failed
+		};
+
+		// Payload rows of one mip level, `Offset` is relative to the image's data
+		struct ImageLevel
+		{
+			size_t Offset{0};
+			uint32_t Width{0};
+			uint32_t Height{0};
+			uint32_t RowBytes{0};
+			uint32_t RowCount{0};
+			uint32_t RowHeight{1};   // pixel rows per payload row, 4 for compressed blocks
+		};
+
+		// Decoded RGBA8 pixels or a mapped cooked file, no levels if loading failed
+		struct DecodedImage
+		{
+			std::vector<uint8_t> Pixels;
+			MappedFile Cooked;
+			SDL_GPUTextureFormat Format{SDL_GPU_TEXTUREFORMAT_INVALID};
+			std::vector<ImageLevel> Levels;
+
+			const uint8_t* GetData() const { return Cooked.IsOpen() ? Cooked.GetData() : Pixels.data(); }
+		};
+
+		struct Entry
+		{
+			std::string Path;
+			TextureState State{TextureState::Free};
+			uint32_t References{0};
+			bool GenerateMipmaps{true};
+
+			AsyncResult<DecodedImage> Decode;
+			SDL_GPUTexture* Texture{nullptr};
+			uint32_t UploadedLevel{0};
+			uint32_t UploadedRows{0};   // of UploadedLevel
+		};
+
+		static constexpr uint32_t BYTES_PER_PIXEL = 4;
+
+		// Run on workers, they only touch their arguments
+		static DecodedImage DecodeImage(const std::string& path, bool srgb);
+		static DecodedImage MapCookedImage(const std::string& path);
+
+		bool IsValid(TextureHandle texture) const { return texture != INVALID_TEXTURE && texture < m_Entries.size() && m_Entries[texture].State != TextureState::Free; }
+
+		// Creates the GPU texture for a finished decode, false if it failed
+		bool CreateTexture(Entry& entry);
+
+		// Stages up to `budget` bytes of rows, true once the last row is staged
+		bool StreamRows(Entry& entry, uint64_t budget, uint64_t& staged);
+
+		SDL_GPUDevice* m_Device{nullptr};
+		UploadManager* m_Uploader{nullptr};
+		JobSystem* m_Jobs{nullptr};
+		uint64_t m_UploadBudget{DEFAULT_UPLOAD_BUDGET};
+		uint64_t m_LastUploadedBytes{0};
+
+		SDL_GPUTexture* m_Placeholder{nullptr};
+		SDL_GPUSampler* m_LinearSampler{nullptr};
+		SDL_GPUSampler* m_NearestSampler{nullptr};
+
+		std::vector<Entry> m_Entries;                 // indexed by handle, slot 0 unused
+		std::vector<TextureHandle> m_FreeEntries;
+		std::unordered_map<std::string, TextureHandle> m_Paths;
+
+		std::vector<TextureHandle> m_StreamQueue;     // decoding or streaming, in load order
+		std::vector<SDL_GPUTexture*> m_PendingMipmaps;
+
+		// Released textures may still have copies queued for this frame,
+		// they are handed to SDL at the next Update
+		std::vector<SDL_GPUTexture*> m_PendingReleases;
+};
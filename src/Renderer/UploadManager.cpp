@@ -0,0 +1,332 @@
+#include "UploadManager.hpp"
+#include "Core/Profiler.hpp"
+#include <algorithm>
+
+
+UploadManager::UploadManager(SDL_GPUDevice* device, uint32_t segmentSize)
+{
+	m_Device = device;
+	m_SegmentSize = segmentSize;
+
+	SDL_GPUTransferBufferCreateInfo transferBufferCreateInfo{};
+	transferBufferCreateInfo.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+	transferBufferCreateInfo.size = m_SegmentSize;
+
+	for (Segment& segment : m_Segments)
+	{
+		segment.TransferBuffer = SDL_CreateGPUTransferBuffer(m_Device, &transferBufferCreateInfo);
+		if (!segment.TransferBuffer)
+			SDLException("Failed to create upload staging buffer");
+	}
+}
+
+UploadManager::~UploadManager()
+{
+	Cleanup();
+}
+
+void UploadManager::Cleanup()
+{
+	if (!m_Device)
+		return;
+
+	for (Segment& segment : m_Segments)
+	{
+		if (segment.Mapped)
+			SDL_UnmapGPUTransferBuffer(m_Device, segment.TransferBuffer);
+
+		// Release is deferred by SDL until the GPU no longer references the buffer
+		if (segment.TransferBuffer)
+			SDL_ReleaseGPUTransferBuffer(m_Device, segment.TransferBuffer);
+
+		segment = Segment{};
+	}
+
+	m_PendingBufferCopies.clear();
+	m_PendingTextureCopies.clear();
+	m_Device = nullptr;
+}
+
+
+
+void UploadManager::BeginFrame(uint64_t frameSerial, uint64_t completedSerial)
+{
+	m_FrameSerial = frameSerial;
+	m_CompletedSerial = completedSerial;
+
+	m_LastFrameStats = m_FrameStats;
+	m_FrameStats = UploadStats{};
+}
+
+void UploadManager::UploadToBuffer(SDL_GPUBuffer* buffer, uint32_t offset, const void* data, uint32_t size, bool cycle)
+{
+	if (!buffer || !data)
+	{
+		SDLException("Invalid buffer upload");
+		return;
+	}
+
+	m_FrameStats.Uploads++;
+	m_FrameStats.Bytes += size;
+
+	const uint8_t* source = static_cast<const uint8_t*>(data);
+	uint32_t uploaded = 0;
+
+	while (uploaded < size)
+	{
+		uint32_t chunkSize = std::min(size - uploaded, m_SegmentSize);
+
+		SDL_GPUTransferBufferLocation sourceLocation;
+		uint8_t* staging = Allocate(chunkSize, BUFFER_ALIGNMENT, sourceLocation);
+		memcpy(staging, source + uploaded, chunkSize);
+
+		// Only the first chunk may cycle, otherwise later chunks would discard earlier ones
+		QueueBufferCopy(sourceLocation, buffer, offset + uploaded, chunkSize, cycle && uploaded == 0);
+		uploaded += chunkSize;
+	}
+}
+
+void* UploadManager::MapBufferUpload(SDL_GPUBuffer* buffer, uint32_t offset, uint32_t size, bool cycle)
+{
+	if (!buffer || size == 0 || size > m_SegmentSize)
+	{
+		SDLException("Invalid mapped buffer upload");
+		return nullptr;
+	}
+
+	m_FrameStats.Uploads++;
+	m_FrameStats.Bytes += size;
+
+	SDL_GPUTransferBufferLocation sourceLocation;
+	uint8_t* staging = Allocate(size, BUFFER_ALIGNMENT, sourceLocation);
+	QueueBufferCopy(sourceLocation, buffer, offset, size, cycle);
+	return staging;
+}
+
+void UploadManager::QueueBufferCopy(const SDL_GPUTransferBufferLocation& source, SDL_GPUBuffer* buffer, uint32_t offset, uint32_t size, bool cycle)
+{
+	// Fold into the previous copy if both the staging and the destination ranges continue it
+	if (!cycle && !m_PendingBufferCopies.empty())
+	{
+		PendingBufferCopy& previous = m_PendingBufferCopies.back();
+		if (previous.Source.transfer_buffer == source.transfer_buffer &&
+			previous.Source.offset + previous.Destination.size == source.offset &&
+			previous.Destination.buffer == buffer &&
+			previous.Destination.offset + previous.Destination.size == offset)
+		{
+			previous.Destination.size += size;
+			m_FrameStats.MergedRanges++;
+			return;
+		}
+	}
+
+	PendingBufferCopy copy{};
+	copy.Source = source;
+	copy.Destination.buffer = buffer;
+	copy.Destination.offset = offset;
+	copy.Destination.size = size;
+	copy.Cycle = cycle;
+	m_PendingBufferCopies.push_back(copy);
+}
+
+void UploadManager::UploadToTexture(const SDL_GPUTextureRegion& region, const void* data, uint32_t size, uint32_t blockHeight, bool cycle)
+{
+	if (!region.texture || !data || region.h == 0)
+	{
+		SDLException("Invalid texture upload");
+		return;
+	}
+
+	m_FrameStats.Uploads++;
+	m_FrameStats.Bytes += size;
+
+	const uint8_t* source = static_cast<const uint8_t*>(data);
+
+	if (size <= m_SegmentSize)
+	{
+		SDL_GPUTransferBufferLocation sourceLocation;
+		uint8_t* staging = Allocate(size, TEXTURE_ALIGNMENT, sourceLocation);
+		memcpy(staging, source, size);
+
+		m_PendingTextureCopies.push_back({ sourceLocation, region, cycle });
+		return;
+	}
+
+	// Too large for a single segment, split into bands of whole block rows
+	uint32_t blockRows = (region.h + blockHeight - 1) / blockHeight;
+	if (region.d > 1 || size % blockRows != 0)
+	{
+		SDLException("Texture upload does not fit into the staging ring");
+		return;
+	}
+
+	uint32_t bytesPerBlockRow = size / blockRows;
+	uint32_t blockRowsPerBand = m_SegmentSize / bytesPerBlockRow;
+	if (blockRowsPerBand == 0)
+	{
+		SDLException("Texture row does not fit into the staging ring");
+		return;
+	}
+
+	for (uint32_t blockRow = 0; blockRow < blockRows; blockRow += blockRowsPerBand)
+	{
+		uint32_t bandBlockRows = std::min(blockRowsPerBand, blockRows - blockRow);
+		uint32_t bandSize = bandBlockRows * bytesPerBlockRow;
+
+		SDL_GPUTransferBufferLocation sourceLocation;
+		uint8_t* staging = Allocate(bandSize, TEXTURE_ALIGNMENT, sourceLocation);
+		memcpy(staging, source + blockRow * bytesPerBlockRow, bandSize);
+
+		SDL_GPUTextureRegion band = region;
+		band.y = region.y + blockRow * blockHeight;
+		band.h = std::min(bandBlockRows * blockHeight, region.h - blockRow * blockHeight);
+
+		m_PendingTextureCopies.push_back({ sourceLocation, band, cycle && blockRow == 0 });
+	}
+}
+
+
+
+void UploadManager::RecordUploads(SDL_GPUCommandBuffer* commandBuffer)
+{
+	SDLGPU_PROFILE_ZONE("UploadManager::RecordUploads");
+
+	if (!HasPendingUploads())
+		return;
+
+	RecordCopies(commandBuffer);
+
+	for (Segment& segment : m_Segments)
+	{
+		if (segment.FrameSerial == UINT64_MAX)
+			segment.FrameSerial = m_FrameSerial;
+	}
+}
+
+void UploadManager::FlushNow(bool waitForCompletion)
+{
+	SDLGPU_PROFILE_ZONE("UploadManager::FlushNow");
+
+	if (!HasPendingUploads())
+		return;
+
+	SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(m_Device);
+	if (!commandBuffer)
+	{
+		SDLException("Failed to acquire GPU command buffer for uploads");
+		return;
+	}
+
+	RecordCopies(commandBuffer);
+	m_FrameStats.Submits++;
+
+	// Queue submissions complete in order, so the next frame's fence covers this one
+	for (Segment& segment : m_Segments)
+	{
+		if (segment.FrameSerial == UINT64_MAX)
+			segment.FrameSerial = m_FrameSerial + 1;
+	}
+
+	if (!waitForCompletion)
+	{
+		if (!SDL_SubmitGPUCommandBuffer(commandBuffer))
+			SDLException("Failed to submit upload command buffer");
+		return;
+	}
+
+	SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(commandBuffer);
+	if (!fence)
+	{
+		SDLException("Failed to submit upload command buffer");
+		return;
+	}
+
+	SDL_WaitForGPUFences(m_Device, true, &fence, 1);
+	SDL_ReleaseGPUFence(m_Device, fence);
+}
+
+void UploadManager::RecordCopies(SDL_GPUCommandBuffer* commandBuffer)
+{
+	// Staging memory has to be unmapped before the GPU may read it.
+	// Recorded segments are tagged with UINT64_MAX until the caller knows their serial.
+	for (Segment& segment : m_Segments)
+	{
+		if (!segment.Pending)
+			continue;
+
+		SDL_UnmapGPUTransferBuffer(m_Device, segment.TransferBuffer);
+		segment.Mapped = nullptr;
+		segment.Pending = false;
+		segment.FrameSerial = UINT64_MAX;
+	}
+
+	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(commandBuffer);
+
+	for (const PendingBufferCopy& copy : m_PendingBufferCopies)
+		SDL_UploadToGPUBuffer(copyPass, &copy.Source, &copy.Destination, copy.Cycle);
+
+	for (const PendingTextureCopy& copy : m_PendingTextureCopies)
+	{
+		SDL_GPUTextureTransferInfo source{};
+		source.transfer_buffer = copy.Source.transfer_buffer;
+		source.offset = copy.Source.offset;
+
+		SDL_UploadToGPUTexture(copyPass, &source, &copy.Destination, copy.Cycle);
+	}
+
+	SDL_EndGPUCopyPass(copyPass);
+
+	m_FrameStats.Copies += static_cast<uint32_t>(m_PendingBufferCopies.size() + m_PendingTextureCopies.size());
+	m_FrameStats.CopyPasses++;
+
+	m_PendingBufferCopies.clear();
+	m_PendingTextureCopies.clear();
+
+	// The recorded segment stays untouched until its frame has completed
+	m_CurrentSegment = (m_CurrentSegment + 1) % MAX_FRAMES_IN_FLIGHT;
+}
+
+
+
+uint8_t* UploadManager::Allocate(uint32_t size, uint32_t alignment, SDL_GPUTransferBufferLocation& source)
+{
+	Segment* segment = &m_Segments[m_CurrentSegment];
+
+	uint32_t offset = segment->Pending ? (segment->Offset + alignment - 1) & ~(alignment - 1) : 0;
+	if (uint64_t(offset) + size > m_SegmentSize)
+	{
+		// Current segment is full, continue in the next one.
+		// If that still holds unrecorded copies the ring has wrapped within a frame,
+		// so everything queued so far is submitted on its own first.
+		uint32_t next = (m_CurrentSegment + 1) % MAX_FRAMES_IN_FLIGHT;
+		if (m_Segments[next].Pending)
+			FlushNow(false);
+
+		m_CurrentSegment = next;
+		segment = &m_Segments[m_CurrentSegment];
+		offset = 0;
+	}
+
+	if (!segment->Pending)
+	{
+		MapSegment(*segment);
+		segment->Pending = true;
+	}
+
+	segment->Offset = offset + size;
+
+	source.transfer_buffer = segment->TransferBuffer;
+	source.offset = offset;
+	return segment->Mapped + offset;
+}
+
+void UploadManager::MapSegment(Segment& segment)
+{
+	// Reuse the segment's memory if the GPU is done with it, otherwise let SDL
+	// cycle to a fresh backing so we never wait on an in-flight upload
+	bool cycle = segment.FrameSerial > m_CompletedSerial;
+
+	segment.Mapped = static_cast<uint8_t*>(SDL_MapGPUTransferBuffer(m_Device, segment.TransferBuffer, cycle));
+	if (!segment.Mapped)
+		SDLException("Failed to map upload staging buffer");
+}
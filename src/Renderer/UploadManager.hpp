@@ -0,0 +1,123 @@
+#pragma once
+
+#include "common.hpp"
+#include <array>
+#include <SDL3/SDL_gpu.h>
+
+
+// Per-frame upload counters
+struct UploadStats
+{
+	uint32_t Uploads{0};        // UploadToBuffer/UploadToTexture calls
+	uint64_t Bytes{0};          // bytes staged
+	uint32_t MergedRanges{0};   // buffer uploads folded into the previous copy
+	uint32_t Copies{0};         // copy commands actually recorded
+	uint32_t CopyPasses{0};
+	uint32_t Submits{0};        // command buffers submitted by the uploader itself
+};
+
+
+// Device-wide staging uploader.
+// Owns one persistent transfer buffer per frame in flight (a "segment") and
+// sub-allocates aligned regions out of the current one. Uploads are queued and
+// recorded in one copy pass on the frame's command buffer. A segment is only
+// written again once the frame that used it has completed on the GPU; if it is
+// still in flight, the map cycles to a fresh backing instead of stalling.
+class UploadManager
+{
+	public:
+		static constexpr uint32_t DEFAULT_SEGMENT_SIZE = 32u * 1024u * 1024u;
+		static constexpr uint32_t BUFFER_ALIGNMENT = 4u;
+		static constexpr uint32_t TEXTURE_ALIGNMENT = 512u;
+
+		UploadManager(SDL_GPUDevice* device, uint32_t segmentSize = DEFAULT_SEGMENT_SIZE);
+		virtual ~UploadManager();
+
+		void Cleanup();
+
+		// Called by the renderer at the start of every frame.
+		// `frameSerial` tags segments used this frame, everything up to and
+		// including `completedSerial` is known to be finished on the GPU.
+		void BeginFrame(uint64_t frameSerial, uint64_t completedSerial);
+
+		// Stages `size` bytes and queues a copy into `buffer` at `offset`.
+		// Uploads larger than a segment are split across several segments.
+		void UploadToBuffer(SDL_GPUBuffer* buffer, uint32_t offset, const void* data, uint32_t size, bool cycle = false);
+
+		// Queues a copy into `buffer` at `offset` and returns the staging memory for it, so the
+		// caller can write the data in place instead of staging a copy. The pointer is only valid
+		// until the next call into the uploader. `size` must fit into one segment.
+		void* MapBufferUpload(SDL_GPUBuffer* buffer, uint32_t offset, uint32_t size, bool cycle = false);
+
+		// Stages pixel data for `region`. Uploads that don't fit into a segment are
+		// split into row bands; `blockHeight` keeps bands aligned to compressed blocks.
+		void UploadToTexture(const SDL_GPUTextureRegion& region, const void* data, uint32_t size, uint32_t blockHeight = 1, bool cycle = false);
+
+		// Records every queued copy into a single copy pass on `commandBuffer`.
+		// The caller must not be inside a render or compute pass.
+		void RecordUploads(SDL_GPUCommandBuffer* commandBuffer);
+
+		// Submits every queued copy right away on the uploader's own command buffer.
+		// Meant for bulk uploads outside the frame loop, e.g. behind a loading screen.
+		void FlushNow(bool waitForCompletion = true);
+
+		bool HasPendingUploads() const { return !m_PendingBufferCopies.empty() || !m_PendingTextureCopies.empty(); }
+
+		// Counters of the previous frame
+		const UploadStats& GetFrameStats() const { return m_LastFrameStats; }
+
+		uint32_t GetSegmentSize() const { return m_SegmentSize; }
+
+		// Serial of the frame being recorded and of the newest frame finished on the GPU
+		uint64_t GetFrameSerial() const { return m_FrameSerial; }
+		uint64_t GetCompletedSerial() const { return m_CompletedSerial; }
+
+	private:
+		struct Segment
+		{
+			SDL_GPUTransferBuffer* TransferBuffer{nullptr};
+			uint64_t FrameSerial{0};        // reused once this frame has completed
+			uint8_t* Mapped{nullptr};
+			uint32_t Offset{0};
+			bool Pending{false};            // holds copies that have not been recorded yet
+		};
+
+		struct PendingBufferCopy
+		{
+			SDL_GPUTransferBufferLocation Source;
+			SDL_GPUBufferRegion Destination;
+			bool Cycle;
+		};
+
+		struct PendingTextureCopy
+		{
+			SDL_GPUTransferBufferLocation Source;
+			SDL_GPUTextureRegion Destination;
+			bool Cycle;
+		};
+
+		// Returns a mapped pointer to `size` bytes in the current segment, moving on to
+		// the next segment first if the current one is full
+		uint8_t* Allocate(uint32_t size, uint32_t alignment, SDL_GPUTransferBufferLocation& source);
+
+		// Adds a buffer copy, folded into the previous one when both ranges continue it
+		void QueueBufferCopy(const SDL_GPUTransferBufferLocation& source, SDL_GPUBuffer* buffer, uint32_t offset, uint32_t size, bool cycle);
+
+		void MapSegment(Segment& segment);
+		void RecordCopies(SDL_GPUCommandBuffer* commandBuffer);
+
+		SDL_GPUDevice* m_Device{nullptr};
+		uint32_t m_SegmentSize{0};
+
+		std::array<Segment, MAX_FRAMES_IN_FLIGHT> m_Segments{};
+		uint32_t m_CurrentSegment{0};
+
+		uint64_t m_FrameSerial{0};
+		uint64_t m_CompletedSerial{0};
+
+		std::vector<PendingBufferCopy> m_PendingBufferCopies;
+		std::vector<PendingTextureCopy> m_PendingTextureCopies;
+
+		UploadStats m_FrameStats{};
+		UploadStats m_LastFrameStats{};
+};
@@ -1,11 +1,12 @@
 #pragma once
 #include "common.hpp"
+#include "Renderer/UploadManager.hpp"
 #include <SDL3/SDL_gpu.h>
 
 class VertexBuffer
 {
     public:
-        VertexBuffer(SDL_GPUDevice* device, uint32_t bufferSize);
+        VertexBuffer(SDL_GPUDevice* device, UploadManager* uploader, uint32_t bufferSize);
         virtual ~VertexBuffer();
 
         void Cleanup()
@@ -15,24 +16,20 @@ class VertexBuffer
                 SDL_ReleaseGPUBuffer(m_Device, m_VertexBuffer);
                 m_VertexBuffer = nullptr;
             }
-            // if (m_TransferBuffer)
-            // {
-            //     SDL_ReleaseGPUTransferBuffer(m_Device, m_TransferBuffer);
-            //     m_TransferBuffer = nullptr;
-            // }
         }
 
-        static void GetVertexInfo(uint8_t vertexType,
-            std::vector<SDL_GPUVertexAttribute>& attributes,
-            std::vector<SDL_GPUVertexBufferDescription>& buffers,
-            SDL_GPUVertexInputState& vertexInputState);
-
-        void UploadData(const void* data, const uint32_t size);
+        // Stages the data through the device uploader, can be called any number of times
+        void UploadData(const void* data, const uint32_t size, const uint32_t offset = 0);
 
         SDL_GPUBuffer* GetVertexBuffer() const { return m_VertexBuffer; }
 
+        // Small id used in draw sort keys
+        uint16_t GetId() const { return m_Id; }
+
     private:
         SDL_GPUDevice* m_Device{nullptr};
         SDL_GPUBuffer* m_VertexBuffer{nullptr};
-        SDL_GPUTransferBuffer* m_TransferBuffer{nullptr};
+        UploadManager* m_Uploader{nullptr};
+        uint32_t m_Size{0};
+        uint16_t m_Id{0};
 };
\ No newline at end of file
@@ -0,0 +1,329 @@
+#pragma once
+
+#include "common.hpp"
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+#include <SDL3/SDL_gpu.h>
+
+
+// Compile-time vertex layouts.
+// Every vertex struct gets a VertexLayout specialization listing its attributes once.
+// VertexInput<> turns one or more layouts into static constexpr SDL arrays, so
+// building a pipeline's vertex input state costs nothing at runtime.
+
+struct VertexElement
+{
+	SDL_GPUVertexElementFormat Format;
+	uint32_t Offset;
+	uint32_t Location;
+};
+
+constexpr uint32_t VertexElementSize(SDL_GPUVertexElementFormat format)
+{
+	switch (format)
+	{
+	case SDL_GPU_VERTEXELEMENTFORMAT_BYTE2:
+	case SDL_GPU_VERTEXELEMENTFORMAT_UBYTE2:
+	case SDL_GPU_VERTEXELEMENTFORMAT_BYTE2_NORM:
+	case SDL_GPU_VERTEXELEMENTFORMAT_UBYTE2_NORM:
+		return 2;
+
+	case SDL_GPU_VERTEXELEMENTFORMAT_INT:
+	case SDL_GPU_VERTEXELEMENTFORMAT_UINT:
+	case SDL_GPU_VERTEXELEMENTFORMAT_FLOAT:
+	case SDL_GPU_VERTEXELEMENTFORMAT_BYTE4:
+	case SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4:
+	case SDL_GPU_VERTEXELEMENTFORMAT_BYTE4_NORM:
+	case SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM:
+	case SDL_GPU_VERTEXELEMENTFORMAT_SHORT2:
+	case SDL_GPU_VERTEXELEMENTFORMAT_USHORT2:
+	case SDL_GPU_VERTEXELEMENTFORMAT_SHORT2_NORM:
+	case SDL_GPU_VERTEXELEMENTFORMAT_USHORT2_NORM:
+	case SDL_GPU_VERTEXELEMENTFORMAT_HALF2:
+		return 4;
+
+	case SDL_GPU_VERTEXELEMENTFORMAT_INT2:
+	case SDL_GPU_VERTEXELEMENTFORMAT_UINT2:
+	case SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2:
+	case SDL_GPU_VERTEXELEMENTFORMAT_SHORT4:
+	case SDL_GPU_VERTEXELEMENTFORMAT_USHORT4:
+	case SDL_GPU_VERTEXELEMENTFORMAT_SHORT4_NORM:
+	case SDL_GPU_VERTEXELEMENTFORMAT_USHORT4_NORM:
+	case SDL_GPU_VERTEXELEMENTFORMAT_HALF4:
+		return 8;
+
+	case SDL_GPU_VERTEXELEMENTFORMAT_INT3:
+	case SDL_GPU_VERTEXELEMENTFORMAT_UINT3:
+	case SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3:
+		return 12;
+
+	case SDL_GPU_VERTEXELEMENTFORMAT_INT4:
+	case SDL_GPU_VERTEXELEMENTFORMAT_UINT4:
+	case SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4:
+		return 16;
+
+	default:
+		return 0;
+	}
+}
+
+
+// Specialized once per vertex struct with
+//   static constexpr uint8_t Type;             one of the VERTEX_TYPE_* ids
+//   static constexpr std::array Elements;      attribute list
+//   static constexpr uint32_t PaddingBytes;    optional, trailing bytes no attribute reads
+template<typename TVertex>
+struct VertexLayout;
+
+template<typename TVertex>
+concept HasVertexLayout = requires {
+	{ VertexLayout<TVertex>::Type } -> std::convertible_to<uint8_t>;
+	VertexLayout<TVertex>::Elements;
+};
+
+// A layout is valid when its elements have known formats, unique locations,
+// don't overlap and exactly cover the struct without gaps
+template<typename TVertex>
+consteval bool IsValidVertexLayout()
+{
+	constexpr auto& elements = VertexLayout<TVertex>::Elements;
+
+	uint32_t coveredBytes = 0;
+	if constexpr (requires { VertexLayout<TVertex>::PaddingBytes; })
+		coveredBytes = VertexLayout<TVertex>::PaddingBytes;
+
+	for (size_t i = 0; i < elements.size(); i++)
+	{
+		uint32_t size = VertexElementSize(elements[i].Format);
+		if (size == 0 || elements[i].Offset + size > sizeof(TVertex))
+			return false;
+
+		for (size_t j = 0; j < i; j++)
+		{
+			uint32_t otherSize = VertexElementSize(elements[j].Format);
+			bool overlaps = elements[i].Offset < elements[j].Offset + otherSize && elements[j].Offset < elements[i].Offset + size;
+			if (overlaps || elements[i].Location == elements[j].Location)
+				return false;
+		}
+
+		coveredBytes += size;
+	}
+
+	return coveredBytes == sizeof(TVertex);
+}
+
+
+// One vertex buffer slot of a pipeline's vertex input
+template<typename TVertex, SDL_GPUVertexInputRate InputRate = SDL_GPU_VERTEXINPUTRATE_VERTEX>
+struct VertexStream
+{
+	static_assert(HasVertexLayout<TVertex>, "Vertex type has no VertexLayout specialization");
+	static_assert(IsValidVertexLayout<TVertex>(), "Vertex layout offsets or sizes don't match the struct");
+
+	using Vertex = TVertex;
+	static constexpr SDL_GPUVertexInputRate Rate = InputRate;
+};
+
+template<typename TVertex>
+using InstanceStream = VertexStream<TVertex, SDL_GPU_VERTEXINPUTRATE_INSTANCE>;
+
+
+// Vertex input over one or more streams. Stream i is bound to slot i and its
+// attribute locations follow the ones of the previous streams.
+template<typename... TStreams>
+struct VertexInput
+{
+	static constexpr uint32_t BufferCount = sizeof...(TStreams);
+	static constexpr uint32_t AttributeCount = (uint32_t(VertexLayout<typename TStreams::Vertex>::Elements.size()) + ...);
+
+	static constexpr std::array<SDL_GPUVertexBufferDescription, BufferCount> BufferDescriptions = [] {
+		std::array<SDL_GPUVertexBufferDescription, BufferCount> descriptions{};
+		uint32_t slot = 0;
+		((descriptions[slot] = SDL_GPUVertexBufferDescription{ slot, uint32_t(sizeof(typename TStreams::Vertex)), TStreams::Rate, 0 }, slot++), ...);
+		return descriptions;
+	}();
+
+	static constexpr std::array<SDL_GPUVertexAttribute, AttributeCount> Attributes = [] {
+		std::array<SDL_GPUVertexAttribute, AttributeCount> attributes{};
+		uint32_t slot = 0;
+		uint32_t count = 0;
+		uint32_t locationBase = 0;
+
+		auto append = [&]<typename TVertex>() {
+			for (const VertexElement& element : VertexLayout<TVertex>::Elements)
+				attributes[count++] = SDL_GPUVertexAttribute{ locationBase + element.Location, slot, element.Format, element.Offset };
+
+			locationBase += uint32_t(VertexLayout<TVertex>::Elements.size());
+			slot++;
+		};
+		(append.template operator()<typename TStreams::Vertex>(), ...);
+
+		return attributes;
+	}();
+
+	static constexpr SDL_GPUVertexInputState State{
+		BufferDescriptions.data(), BufferCount,
+		Attributes.data(), AttributeCount
+	};
+};
+
+template<typename T>
+struct IsVertexInput : std::false_type {};
+
+template<typename... TStreams>
+struct IsVertexInput<VertexInput<TStreams...>> : std::true_type {};
+
+// A plain vertex struct stands for a single per-vertex stream
+template<typename T>
+using VertexInputFor = std::conditional_t<IsVertexInput<T>::value, T, VertexInput<VertexStream<T>>>;
+
+
+
+// Layouts of the vertex structs in common.hpp ---------------------------------------------
+
+template<>
+struct VertexLayout<VertexPosition>
+{
+	static constexpr uint8_t Type = VERTEX_TYPE_POSITION;
+	static constexpr std::array Elements{
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, offsetof(VertexPosition, x), 0 },
+	};
+};
+
+template<>
+struct VertexLayout<VertexPositionColor>
+{
+	static constexpr uint8_t Type = VERTEX_TYPE_POSITION_COLOR;
+	static constexpr std::array Elements{
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, offsetof(VertexPositionColor, x), 0 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4, offsetof(VertexPositionColor, r), 1 },
+	};
+};
+
+template<>
+struct VertexLayout<VertexPositionTexture>
+{
+	static constexpr uint8_t Type = VERTEX_TYPE_POSITION_TEXTURE;
+	static constexpr std::array Elements{
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, offsetof(VertexPositionTexture, x), 0 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2, offsetof(VertexPositionTexture, u), 1 },
+	};
+};
+
+template<>
+struct VertexLayout<VertexPositionColorTexture>
+{
+	static constexpr uint8_t Type = VERTEX_TYPE_POSITION_COLOR_TEXTURE;
+	static constexpr std::array Elements{
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, offsetof(VertexPositionColorTexture, x), 0 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4, offsetof(VertexPositionColorTexture, r), 1 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2, offsetof(VertexPositionColorTexture, u), 2 },
+	};
+};
+
+template<>
+struct VertexLayout<VertexPositionNormal>
+{
+	static constexpr uint8_t Type = VERTEX_TYPE_POSITION_NORMAL;
+	static constexpr std::array Elements{
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, offsetof(VertexPositionNormal, x), 0 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, offsetof(VertexPositionNormal, nx), 1 },
+	};
+};
+
+template<>
+struct VertexLayout<VertexPositionNormalTexture>
+{
+	static constexpr uint8_t Type = VERTEX_TYPE_POSITION_NORMAL_TEXTURE;
+	static constexpr std::array Elements{
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, offsetof(VertexPositionNormalTexture, x), 0 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, offsetof(VertexPositionNormalTexture, nx), 1 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2, offsetof(VertexPositionNormalTexture, u), 2 },
+	};
+};
+
+template<>
+struct VertexLayout<VertexPositionNormalColor>
+{
+	static constexpr uint8_t Type = VERTEX_TYPE_POSITION_NORMAL_COLOR;
+	static constexpr std::array Elements{
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, offsetof(VertexPositionNormalColor, x), 0 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, offsetof(VertexPositionNormalColor, nx), 1 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4, offsetof(VertexPositionNormalColor, r), 2 },
+	};
+};
+
+template<>
+struct VertexLayout<VertexPositionNormalColorTexture>
+{
+	static constexpr uint8_t Type = VERTEX_TYPE_POSITION_NORMAL_COLOR_TEXTURE;
+	static constexpr std::array Elements{
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, offsetof(VertexPositionNormalColorTexture, x), 0 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, offsetof(VertexPositionNormalColorTexture, nx), 1 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4, offsetof(VertexPositionNormalColorTexture, r), 2 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2, offsetof(VertexPositionNormalColorTexture, u), 3 },
+	};
+};
+
+template<>
+struct VertexLayout<VertexPackedPositionColor>
+{
+	static constexpr uint8_t Type = VERTEX_TYPE_PACKED_POSITION_COLOR;
+	static constexpr std::array Elements{
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_HALF4, offsetof(VertexPackedPositionColor, x), 0 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM, offsetof(VertexPackedPositionColor, r), 1 },
+	};
+};
+
+template<>
+struct VertexLayout<VertexPackedPositionNormalTexture>
+{
+	static constexpr uint8_t Type = VERTEX_TYPE_PACKED_POSITION_NORMAL_TEXTURE;
+	static constexpr std::array Elements{
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_HALF4, offsetof(VertexPackedPositionNormalTexture, x), 0 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_SHORT2_NORM, offsetof(VertexPackedPositionNormalTexture, nx), 1 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_HALF2, offsetof(VertexPackedPositionNormalTexture, u), 2 },
+	};
+};
+
+template<>
+struct VertexLayout<VertexPackedPositionNormalColorTexture>
+{
+	static constexpr uint8_t Type = VERTEX_TYPE_PACKED_POSITION_NORMAL_COLOR_TEXTURE;
+	static constexpr std::array Elements{
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_HALF4, offsetof(VertexPackedPositionNormalColorTexture, x), 0 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_SHORT2_NORM, offsetof(VertexPackedPositionNormalColorTexture, nx), 1 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM, offsetof(VertexPackedPositionNormalColorTexture, r), 2 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_HALF2, offsetof(VertexPackedPositionNormalColorTexture, u), 3 },
+	};
+};
+
+template<>
+struct VertexLayout<InstanceData>
+{
+	static constexpr uint8_t Type = VERTEX_TYPE_INSTANCE_DATA;
+	static constexpr uint32_t PaddingBytes = sizeof(InstanceData::padding);
+	static constexpr std::array Elements{
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4, offsetof(InstanceData, row0), 0 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4, offsetof(InstanceData, row1), 1 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4, offsetof(InstanceData, row2), 2 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4, offsetof(InstanceData, r), 3 },
+		VertexElement{ SDL_GPU_VERTEXELEMENTFORMAT_UINT, offsetof(InstanceData, id), 4 },
+	};
+};
+
+static_assert(IsValidVertexLayout<VertexPosition>());
+static_assert(IsValidVertexLayout<VertexPositionColor>());
+static_assert(IsValidVertexLayout<VertexPositionTexture>());
+static_assert(IsValidVertexLayout<VertexPositionColorTexture>());
+static_assert(IsValidVertexLayout<VertexPositionNormal>());
+static_assert(IsValidVertexLayout<VertexPositionNormalTexture>());
+static_assert(IsValidVertexLayout<VertexPositionNormalColor>());
+static_assert(IsValidVertexLayout<VertexPositionNormalColorTexture>());
+static_assert(IsValidVertexLayout<VertexPackedPositionColor>());
+static_assert(IsValidVertexLayout<VertexPackedPositionNormalTexture>());
+static_assert(IsValidVertexLayout<VertexPackedPositionNormalColorTexture>());
+static_assert(IsValidVertexLayout<InstanceData>());
+static_assert(sizeof(InstanceData) % 16 == 0, "InstanceData must keep a 16 byte std430 stride");
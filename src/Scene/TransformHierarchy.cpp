@@ -0,0 +1,297 @@
+#include "TransformHierarchy.hpp"
+#include "common.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/Profiler.hpp"
+#include <algorithm>
+#include <cstring>
+
+
+namespace
+{
+	constexpr uint32_t MAX_PARALLEL_CHUNKS = 64;
+
+	const ObjectTransform IDENTITY{ { glm::vec4(1.0f, 0.0f, 0.0f, 0.0f), glm::vec4(0.0f, 1.0f, 0.0f, 0.0f), glm::vec4(0.0f, 0.0f, 1.0f, 0.0f) } };
+
+	// Translation * rotation * scale
+	inline ObjectTransform Compose(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+	{
+		const float x = rotation.x, y = rotation.y, z = rotation.z, w = rotation.w;
+
+		ObjectTransform result;
+		result.Rows[0] = glm::vec4((1.0f - 2.0f * (y * y + z * z)) * scale.x, 2.0f * (x * y - w * z) * scale.y, 2.0f * (x * z + w * y) * scale.z, position.x);
+		result.Rows[1] = glm::vec4(2.0f * (x * y + w * z) * scale.x, (1.0f - 2.0f * (x * x + z * z)) * scale.y, 2.0f * (y * z - w * x) * scale.z, position.y);
+		result.Rows[2] = glm::vec4(2.0f * (x * z - w * y) * scale.x, 2.0f * (y * z + w * x) * scale.y, (1.0f - 2.0f * (x * x + y * y)) * scale.z, position.z);
+		return result;
+	}
+
+	// parent * local, both affine with an implicit (0, 0, 0, 1) last row
+	inline ObjectTransform Multiply(const ObjectTransform& parent, const ObjectTransform& local)
+	{
+		ObjectTransform result;
+		for (int i = 0; i < 3; i++)
+		{
+			const glm::vec4& row = parent.Rows[i];
+			result.Rows[i] = local.Rows[0] * row.x + local.Rows[1] * row.y + local.Rows[2] * row.z + glm::vec4(0.0f, 0.0f, 0.0f, row.w);
+		}
+		return result;
+	}
+
+	// order[new slot] = old slot
+	template<typename T>
+	void Permute(std::vector<T>& values, const std::vector<uint32_t>& order)
+	{
+		std::vector<T> sorted(order.size());
+		for (size_t i = 0; i < order.size(); i++)
+			sorted[i] = values[order[i]];
+		values = std::move(sorted);
+	}
+}
+
+
+
+uint32_t TransformHierarchy::Add(uint32_t parent)
+{
+	uint32_t handle;
+	if (!m_FreeHandles.empty())
+	{
+		handle = m_FreeHandles.back();
+		m_FreeHandles.pop_back();
+	}
+	else
+	{
+		handle = uint32_t(m_Slot.size());
+		m_Slot.push_back(NO_PARENT);
+	}
+
+	const uint32_t slot = GetCount();
+	m_Slot[handle] = slot;
+
+	m_Parent.push_back(parent == NO_PARENT ? NO_PARENT : m_Slot[parent]);
+	m_Position.push_back(glm::vec3(0.0f));
+	m_Rotation.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+	m_Scale.push_back(glm::vec3(1.0f));
+	m_World.push_back(IDENTITY);
+	m_LocalDirty.push_back(1);
+	m_Moved.push_back(0);
+	m_Removed.push_back(0);
+	m_Handle.push_back(handle);
+
+	// Appended at the end, which is only the right level by chance
+	m_OrderDirty = true;
+	m_AnyDirty = true;
+	return handle;
+}
+
+void TransformHierarchy::Remove(uint32_t node)
+{
+	// The subtree goes with it in the next sort
+	m_Removed[m_Slot[node]] = 1;
+	m_OrderDirty = true;
+}
+
+void TransformHierarchy::SetParent(uint32_t node, uint32_t parent)
+{
+	const uint32_t slot = m_Slot[node];
+	const uint32_t parentSlot = parent == NO_PARENT ? NO_PARENT : m_Slot[parent];
+
+	for (uint32_t ancestor = parentSlot; ancestor != NO_PARENT; ancestor = m_Parent[ancestor])
+	{
+		if (ancestor == slot)
+			SDLException("Transform parent is a descendant of the node");
+	}
+
+	m_Parent[slot] = parentSlot;
+	MarkDirty(slot);
+	m_OrderDirty = true;
+}
+
+uint32_t TransformHierarchy::GetParent(uint32_t node) const
+{
+	const uint32_t parentSlot = m_Parent[m_Slot[node]];
+	return parentSlot == NO_PARENT ? NO_PARENT : m_Handle[parentSlot];
+}
+
+void TransformHierarchy::SetLocal(uint32_t node, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+{
+	const uint32_t slot = m_Slot[node];
+	m_Position[slot] = position;
+	m_Rotation[slot] = rotation;
+	m_Scale[slot] = scale;
+	MarkDirty(slot);
+}
+
+void TransformHierarchy::SetPosition(uint32_t node, const glm::vec3& position)
+{
+	const uint32_t slot = m_Slot[node];
+	m_Position[slot] = position;
+	MarkDirty(slot);
+}
+
+void TransformHierarchy::SetRotation(uint32_t node, const glm::quat& rotation)
+{
+	const uint32_t slot = m_Slot[node];
+	m_Rotation[slot] = rotation;
+	MarkDirty(slot);
+}
+
+void TransformHierarchy::SetScale(uint32_t node, const glm::vec3& scale)
+{
+	const uint32_t slot = m_Slot[node];
+	m_Scale[slot] = scale;
+	MarkDirty(slot);
+}
+
+
+
+void TransformHierarchy::Update(ObjectTransform* output, JobSystem* jobs)
+{
+	SDLGPU_PROFILE_ZONE("TransformHierarchy::Update");
+
+	if (m_OrderDirty)
+	{
+		SortByDepth();
+		m_OrderDirty = false;
+	}
+
+	m_UpdatedCount = 0;
+	if (!m_AnyDirty)
+	{
+		if (output)
+			memcpy(output, m_World.data(), m_World.size() * sizeof(ObjectTransform));
+		return;
+	}
+
+	// A level only reads the moved flags and world transforms of earlier levels,
+	// so its nodes are independent of each other
+	for (uint32_t level = 0; level < GetLevelCount(); level++)
+	{
+		const uint32_t first = m_LevelStart[level];
+		const uint32_t end = m_LevelStart[level + 1];
+		const uint32_t chunkCount = jobs ? std::min({ jobs->GetWorkerCount() + 1, (end - first) / PARALLEL_BATCH, MAX_PARALLEL_CHUNKS }) : 1;
+
+		if (chunkCount <= 1)
+		{
+			m_UpdatedCount += UpdateRange(first, end, output);
+			continue;
+		}
+
+		uint32_t updated[MAX_PARALLEL_CHUNKS];
+		jobs->ParallelFor(chunkCount, [&](uint32_t chunk)
+		{
+			const uint32_t chunkFirst = first + uint32_t(uint64_t(end - first) * chunk / chunkCount);
+			const uint32_t chunkEnd = first + uint32_t(uint64_t(end - first) * (chunk + 1) / chunkCount);
+			updated[chunk] = UpdateRange(chunkFirst, chunkEnd, output);
+		});
+
+		for (uint32_t chunk = 0; chunk < chunkCount; chunk++)
+			m_UpdatedCount += updated[chunk];
+	}
+
+	m_AnyDirty = false;
+}
+
+uint32_t TransformHierarchy::UpdateRange(uint32_t first, uint32_t end, ObjectTransform* output)
+{
+	uint32_t updated = 0;
+	for (uint32_t slot = first; slot < end; slot++)
+	{
+		const uint32_t parent = m_Parent[slot];
+		const bool dirty = m_LocalDirty[slot] || (parent != NO_PARENT && m_Moved[parent]);
+		m_Moved[slot] = dirty;
+
+		if (dirty)
+		{
+			const ObjectTransform local = Compose(m_Position[slot], m_Rotation[slot], m_Scale[slot]);
+			m_World[slot] = parent == NO_PARENT ? local : Multiply(m_World[parent], local);
+			m_LocalDirty[slot] = 0;
+			updated++;
+		}
+
+		if (output)
+			output[slot] = m_World[slot];
+	}
+	return updated;
+}
+
+void TransformHierarchy::SortByDepth()
+{
+	SDLGPU_PROFILE_ZONE("TransformHierarchy::SortByDepth");
+
+	const uint32_t count = GetCount();
+
+	// Walk up to the first ancestor with a known depth, then assign depths on the way
+	// back down. Removal is inherited the same way.
+	std::vector<uint32_t> depth(count, UINT32_MAX);
+	std::vector<uint32_t> chain;
+	uint32_t levelCount = 0;
+	for (uint32_t slot = 0; slot < count; slot++)
+	{
+		uint32_t ancestor = slot;
+		while (ancestor != NO_PARENT && depth[ancestor] == UINT32_MAX)
+		{
+			chain.push_back(ancestor);
+			ancestor = m_Parent[ancestor];
+		}
+
+		uint32_t nextDepth = ancestor == NO_PARENT ? 0 : depth[ancestor] + 1;
+		bool removed = ancestor != NO_PARENT && m_Removed[ancestor];
+		while (!chain.empty())
+		{
+			const uint32_t node = chain.back();
+			chain.pop_back();
+
+			removed |= m_Removed[node] != 0;
+			m_Removed[node] = removed;
+			depth[node] = nextDepth++;
+		}
+
+		if (!m_Removed[slot])
+			levelCount = std::max(levelCount, depth[slot] + 1);
+	}
+
+	// Counting sort by depth, stable so untouched nodes keep their relative order
+	m_LevelStart.assign(levelCount + 1, 0);
+	for (uint32_t slot = 0; slot < count; slot++)
+	{
+		if (!m_Removed[slot])
+			m_LevelStart[depth[slot] + 1]++;
+	}
+	for (uint32_t level = 0; level < levelCount; level++)
+		m_LevelStart[level + 1] += m_LevelStart[level];
+
+	std::vector<uint32_t> next(m_LevelStart.begin(), m_LevelStart.end() - 1);
+	std::vector<uint32_t> order(m_LevelStart.back());
+	std::vector<uint32_t> newSlot(count, NO_PARENT);
+	for (uint32_t slot = 0; slot < count; slot++)
+	{
+		if (m_Removed[slot])
+		{
+			m_Slot[m_Handle[slot]] = NO_PARENT;
+			m_FreeHandles.push_back(m_Handle[slot]);
+			continue;
+		}
+
+		newSlot[slot] = next[depth[slot]]++;
+		order[newSlot[slot]] = slot;
+	}
+
+	Permute(m_Parent, order);
+	Permute(m_Position, order);
+	Permute(m_Rotation, order);
+	Permute(m_Scale, order);
+	Permute(m_World, order);
+	Permute(m_LocalDirty, order);
+	Permute(m_Handle, order);
+
+	for (uint32_t& parent : m_Parent)
+	{
+		if (parent != NO_PARENT)
+			parent = newSlot[parent];
+	}
+
+	for (uint32_t slot = 0; slot < uint32_t(order.size()); slot++)
+		m_Slot[m_Handle[slot]] = slot;
+
+	m_Moved.assign(order.size(), 0);
+	m_Removed.assign(order.size(), 0);
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+class JobSystem;
+
+
+// World transform as the vertex shaders read it, the rows of a 3x4 affine matrix.
+// Layout matches ObjectTransform in PositionColorTransform.vert.hlsl.
+struct ObjectTransform
+{
+	glm::vec4 Rows[3];
+};
+
+static_assert(sizeof(ObjectTransform) == 48);
+
+
+// Scene graph transforms, stored data-oriented.
+// Local position, rotation and scale live in one array each, sorted by depth in the
+// hierarchy, so every level is a contiguous range whose parents are all in earlier
+// ranges. Update walks the levels in order and only recomputes nodes whose local
+// transform changed or whose parent moved; large levels are split over the job system.
+//
+// Nodes are addressed by stable handles. Their object index, the position of their
+// world transform in Update's output, changes when the hierarchy is edited.
+class TransformHierarchy
+{
+	public:
+		static constexpr uint32_t NO_PARENT = UINT32_MAX;
+		static constexpr uint32_t PARALLEL_BATCH = 16u * 1024u;   // fewest nodes worth a job
+
+		// New nodes start at identity, below `parent` or as a root
+		uint32_t Add(uint32_t parent = NO_PARENT);
+
+		// Removes the node together with everything below it
+		void Remove(uint32_t node);
+
+		void SetParent(uint32_t node, uint32_t parent);
+		uint32_t GetParent(uint32_t node) const;
+
+		void SetLocal(uint32_t node, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+		void SetPosition(uint32_t node, const glm::vec3& position);
+		void SetRotation(uint32_t node, const glm::quat& rotation);
+		void SetScale(uint32_t node, const glm::vec3& scale);
+
+		const glm::vec3& GetPosition(uint32_t node) const { return m_Position[m_Slot[node]]; }
+		const glm::quat& GetRotation(uint32_t node) const { return m_Rotation[m_Slot[node]]; }
+		const glm::vec3& GetScale(uint32_t node) const { return m_Scale[m_Slot[node]]; }
+
+		// World transform as of the last Update
+		const ObjectTransform& GetWorld(uint32_t node) const { return m_World[m_Slot[node]]; }
+
+		// Recomputes the world transforms that changed since the last call. With `output`,
+		// every node's world transform is also written to output[object index], e.g. into
+		// mapped upload memory. Levels larger than PARALLEL_BATCH run on `jobs`.
+		void Update(ObjectTransform* output = nullptr, JobSystem* jobs = nullptr);
+
+		// Where the node's world transform goes in Update's output. Valid after Update,
+		// until the next Add, Remove or SetParent.
+		uint32_t GetObjectIndex(uint32_t node) const { return m_Slot[node]; }
+
+		uint32_t GetCount() const { return uint32_t(m_Parent.size()); }
+		uint32_t GetLevelCount() const { return m_LevelStart.empty() ? 0 : uint32_t(m_LevelStart.size() - 1); }
+
+		// Nodes recomputed by the last Update
+		uint32_t GetUpdatedCount() const { return m_UpdatedCount; }
+
+	private:
+		// Per slot, in depth order once sorted
+		std::vector<uint32_t> m_Parent;       // slot of the parent or NO_PARENT
+		std::vector<glm::vec3> m_Position;
+		std::vector<glm::quat> m_Rotation;
+		std::vector<glm::vec3> m_Scale;
+		std::vector<ObjectTransform> m_World;
+		std::vector<uint8_t> m_LocalDirty;    // local transform set since the last Update
+		std::vector<uint8_t> m_Moved;         // world transform changed in the last Update
+		std::vector<uint8_t> m_Removed;
+		std::vector<uint32_t> m_Handle;       // slot to handle
+
+		// Handle to slot, free handles are reused
+		std::vector<uint32_t> m_Slot;
+		std::vector<uint32_t> m_FreeHandles;
+
+		// Slot range of every level, level i is [m_LevelStart[i], m_LevelStart[i + 1])
+		std::vector<uint32_t> m_LevelStart;
+
+		bool m_OrderDirty{false};
+		bool m_AnyDirty{false};
+		uint32_t m_UpdatedCount{0};
+
+		// Drops removed nodes and sorts the slots by depth, stable within a level
+		void SortByDepth();
+
+		uint32_t UpdateRange(uint32_t first, uint32_t end, ObjectTransform* output);
+
+		void MarkDirty(uint32_t slot)
+		{
+			m_LocalDirty[slot] = 1;
+			m_AnyDirty = true;
+		}
+};
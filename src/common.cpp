@@ -0,0 +1,8 @@
+#include "common.hpp"
+
+void SDLException(const std::string& message) {
+    fprintf(stderr, "%s: %s\n", message.c_str(), SDL_GetError());
+    throw std::runtime_error(message);
+}
+
+const char* BasePath = nullptr;
@@ -8,6 +8,10 @@
 void SDLException(const std::string& message);
 extern const char* BasePath;
 
+// Number of frames the CPU may record ahead of the GPU.
+// Per-frame resources (staging memory, fences) are allocated this many times.
+constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
 
 #define VERTEX_TYPE_NONE uint8_t(0)
 
@@ -69,4 +73,50 @@ typedef struct VertexPositionNormalColorTexture
     float nx, ny, nz; // Normal vector
     float r, g, b, a; // Color components
     float u, v; // Texture coordinates
-} VertexPositionNormalColorTexture;
\ No newline at end of file
+} VertexPositionNormalColorTexture;
+
+
+
+// Packed vertex formats ----------------------------------------------------------------------
+// Quantized counterparts of the float structs above, see Mesh/VertexPacking.hpp.
+// Positions are half4 (w = 1), normals octahedral snorm16x2, colors unorm8x4, UVs half2.
+
+#define VERTEX_TYPE_PACKED_POSITION_COLOR uint8_t(9)
+typedef struct VertexPackedPositionColor
+{
+    uint16_t x, y, z, w; // Half floats
+    uint8_t r, g, b, a;
+} VertexPackedPositionColor;
+
+#define VERTEX_TYPE_PACKED_POSITION_NORMAL_TEXTURE uint8_t(10)
+typedef struct VertexPackedPositionNormalTexture
+{
+    uint16_t x, y, z, w; // Half floats
+    int16_t nx, ny;      // Octahedral encoded normal
+    uint16_t u, v;       // Half floats
+} VertexPackedPositionNormalTexture;
+
+#define VERTEX_TYPE_PACKED_POSITION_NORMAL_COLOR_TEXTURE uint8_t(11)
+typedef struct VertexPackedPositionNormalColorTexture
+{
+    uint16_t x, y, z, w; // Half floats
+    int16_t nx, ny;      // Octahedral encoded normal
+    uint8_t r, g, b, a;
+    uint16_t u, v;       // Half floats
+} VertexPackedPositionNormalColorTexture;
+
+
+// Per-instance data for instanced draws.
+// Usable both as an instance-rate vertex stream and as a std430 storage buffer
+// element indexed by SV_InstanceID, the padding keeps the array stride at 16 bytes.
+#define VERTEX_TYPE_INSTANCE_DATA uint8_t(12)
+typedef struct InstanceData
+{
+    float row0[4], row1[4], row2[4]; // Rows of a 3x4 affine transform
+    float r, g, b, a;
+    uint32_t id;                     // Object id, e.g. for picking
+    uint32_t padding[3];
+} InstanceData;
+
+// Layout matches InstanceData in PositionColorInstancedStorage.vert.hlsl
+static_assert(sizeof(InstanceData) == 80);
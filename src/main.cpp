@@ -1,16 +1,15 @@
 #include "common.hpp"
 #include <SDL3/SDL_gpu.h>
 #include <SDL3/SDL_video.h>
+#include <cstdlib>
 
 #include "Renderer/Renderer.hpp"
 #include "Renderer/VertexBuffer.hpp"
-
-void SDLException(const std::string& message) {
-    printf("%s: %s", message.c_str(), SDL_GetError());
-    throw std::runtime_error(message);
-}
-
-const char* BasePath = nullptr;
+#include "Renderer/InstanceBuffer.hpp"
+#include "Scene/TransformHierarchy.hpp"
+#include "Core/Profiler.hpp"
+#include <algorithm>
+#include <cmath>
 
 void InitializeAssetLoader()
 {
@@ -22,36 +21,82 @@ void InitializeAssetLoader()
 
 int main(int argc, char* argv[]) {
 
+	// --headless renders offscreen without a window, --frames N quits after N frames,
+	// --dynamic-resolution trades resolution for frame rate without vsync
+	bool headless = false;
+	bool dynamicResolution = false;
+	uint64_t frameLimit = 0;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		if (argument == "--headless")
+			headless = true;
+		else if (argument == "--dynamic-resolution")
+			dynamicResolution = true;
+		else if (argument == "--frames" && i + 1 < argc)
+			frameLimit = std::strtoull(argv[++i], nullptr, 10);
+	}
+
 	// Initialize SDL with video subsystem,
 	// asset loader,
-	// and create a window
+	// and create a window.
+	// Headless still needs video for the GPU backends, run it with
+	// SDL_VIDEO_DRIVER=offscreen or dummy on machines without a display.
 	if(!SDL_Init(SDL_INIT_VIDEO))
 		SDLException("Failed to initialize SDL");
 
 	InitializeAssetLoader();
 
-	SDL_Window* window = SDL_CreateWindow("SDL3 Window", 1920, 1080, SDL_WINDOW_RESIZABLE);
-	if (!window)
-		SDLException("Failed to create SDL window");
+	SDL_Window* window = nullptr;
+	if (!headless)
+	{
+		window = SDL_CreateWindow("SDL3 Window", 1920, 1080, SDL_WINDOW_RESIZABLE);
+		if (!window)
+			SDLException("Failed to create SDL window");
+	}
 
 
 	// Initialize the Renderer
 	// The renderer class will handle the GPU device and command buffer
-	Renderer renderer(window);
+	Renderer renderer(window, 1920, 1080);
+
+	// Present on vsync with two frames queued, no additional CPU cap.
+	// Dynamic resolution presents on mailbox, or immediate without it. GPU frames are
+	// timed fence to fence and under vsync that includes the wait for the display.
+	FramePacingSettings pacing{};
+	pacing.PresentMode = SDL_GPU_PRESENTMODE_VSYNC;
+	if (dynamicResolution)
+	{
+		const bool mailbox = !window || SDL_WindowSupportsGPUPresentMode(renderer.Device, window, SDL_GPU_PRESENTMODE_MAILBOX);
+		pacing.PresentMode = mailbox ? SDL_GPU_PRESENTMODE_MAILBOX : SDL_GPU_PRESENTMODE_IMMEDIATE;
+	}
+	pacing.FramesInFlight = 2;
+	renderer.SetFramePacing(pacing);
 
+	// Trade resolution for frame rate when the GPU can't keep up with the display,
+	// budgeting a little under its refresh interval
+	if (dynamicResolution && renderer.GetFramePacing().PresentMode == SDL_GPU_PRESENTMODE_VSYNC)
+	{
+		fprintf(stderr, "Dynamic resolution needs a present mode other than VSYNC, leaving it off\n");
+	}
+	else if (dynamicResolution)
+	{
+		const SDL_DisplayMode* displayMode = window ? SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(window)) : nullptr;
+		const float refreshRate = displayMode && displayMode->refresh_rate > 0.0f ? displayMode->refresh_rate : 60.0f;
 
-	// Load vertex and fragment shaders
-	// The shaders are expected to be in the "shaders" directory relative to the base path
-	SDL_GPUShader* vertexShader{renderer.LoadShader("PositionColor.vert")};
-	SDL_GPUShader* fragmentShader{renderer.LoadShader("Color.frag")};
-	if (!vertexShader || !fragmentShader)
-		SDLException("Failed to load shaders");
+		ResolutionScaleSettings scaling{};
+		scaling.Enabled = true;
+		scaling.TargetGpuMS = 0.9 * 1000.0 / refreshRate;
+		renderer.SetResolutionScaling(scaling);
+	}
 
 
-	// Create a basic graphics pipeline
-	auto pipeline = renderer.CreatePipeline(vertexShader, fragmentShader, VERTEX_TYPE_POSITION_COLOR);
-	if (!pipeline)
-		SDLException("Failed to create graphics pipeline");
+	// Load vertex and fragment shaders and create the pipeline on the worker pool
+	// The shaders are expected to be in the "shaders" directory relative to the base path
+	auto vertexShaderRequest = renderer.LoadShaderAsync("PositionColorTransform.vert", 0, 0, 1);
+	auto fragmentShaderRequest = renderer.LoadShaderAsync("Color.frag");
+	auto pipelineRequest = renderer.CreatePipelineAsync<VertexPositionColor>(vertexShaderRequest, fragmentShaderRequest);
+	SDL_GPUGraphicsPipeline* pipeline{nullptr};
 
 
 	// Create a vertex buffer with the appropriate vertex type
@@ -61,19 +106,52 @@ int main(int argc, char* argv[]) {
 		{  0.0f,  0.8f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f }  // Top center blue
 	};
 
-	VertexBuffer vertexBuffer(renderer.Device, sizeof(VertexPositionColor) * vertices.size());
+	VertexBuffer vertexBuffer(renderer.Device, renderer.Uploader.get(), sizeof(VertexPositionColor) * vertices.size());
 
 	vertexBuffer.UploadData(vertices.data(), vertices.size() * sizeof(VertexPositionColor));
 
+	// Push the initial geometry out before the first frame
+	renderer.Uploader->FlushNow();
+
+
+	// A sun with planets and moons. Every node is one instance of the triangle, placed by
+	// its world transform, which Update writes straight into this frame's instance upload.
+	constexpr uint32_t PLANET_COUNT = 6;
+	constexpr uint32_t MOONS_PER_PLANET = 3;
+
+	TransformHierarchy transforms;
+	const uint32_t sun = transforms.Add();
+	std::vector<uint32_t> planets;
+	for (uint32_t i = 0; i < PLANET_COUNT; i++)
+	{
+		const uint32_t planet = transforms.Add(sun);
+		transforms.SetScale(planet, glm::vec3(0.3f));
+		planets.push_back(planet);
+
+		for (uint32_t j = 0; j < MOONS_PER_PLANET; j++)
+		{
+			const uint32_t moon = transforms.Add(planet);
+			const float angle = 6.2831853f * float(j) / MOONS_PER_PLANET;
+			transforms.SetLocal(moon, glm::vec3(std::cos(angle), std::sin(angle), 0.0f) * 1.8f, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(0.35f));
+		}
+	}
+
+	InstanceBuffer objectTransforms(renderer.Device, renderer.Uploader.get(), transforms.GetCount(), sizeof(ObjectTransform));
+
 
 	// Main loop -----------------------------------------------------------------------------------------
-	SDL_ShowWindow(window);
+	if (window)
+		SDL_ShowWindow(window);
 	bool running = true;
+	uint64_t frameCount = 0;
 	SDL_Event event;
 
 
 	while (running)
 	{
+		// Frame rate cap and low-latency wait happen before input is sampled
+		renderer.BeginFrame();
+
 		// Process events
 		while (SDL_PollEvent(&event))
 		{
@@ -89,28 +167,74 @@ int main(int argc, char* argv[]) {
 		}
 
 
-		
+		// Animate, only the sun and the planets are set, the moons follow through the hierarchy
+		const float time = float(SDL_GetTicks()) / 1000.0f;
+		int windowWidth = 1920, windowHeight = 1080;
+		if (window)
+			SDL_GetWindowSizeInPixels(window, &windowWidth, &windowHeight);
+		const float aspect = float(windowWidth) / float(std::max(1, windowHeight));
+		transforms.SetLocal(sun, glm::vec3(0.0f), glm::angleAxis(time * 0.2f, glm::vec3(0.0f, 0.0f, 1.0f)), glm::vec3(0.2f / aspect, 0.2f, 1.0f));
+		for (uint32_t i = 0; i < PLANET_COUNT; i++)
+		{
+			const float radius = 1.5f + 0.6f * float(i);
+			const float angle = time / radius + float(i);
+			transforms.SetPosition(planets[i], glm::vec3(std::cos(angle), std::sin(angle), 0.0f) * radius);
+			transforms.SetRotation(planets[i], glm::angleAxis(time * 2.0f, glm::vec3(0.0f, 0.0f, 1.0f)));
+		}
 
 
 		// Process GPU commands ----------------------------------------------------------------------
-		renderer.InitCommandBuffer();
-		
-		renderer.RenderPassDraw(pipeline, &vertexBuffer, vertices.size(), 1, 0, 0);
+		// Skipped frames still submit, so queued uploads keep flowing
+		if (renderer.InitCommandBuffer())
+		{
+			// Block on the pipeline only when it is first needed
+			if (!pipeline)
+			{
+				pipeline = renderer.Jobs->Wait(pipelineRequest);
+				if (!pipeline)
+					SDLException("Failed to create graphics pipeline");
+
+				// The pipeline holds its own references to the shaders
+				renderer.ReleaseShader(*vertexShaderRequest.Value);
+				renderer.ReleaseShader(*fragmentShaderRequest.Value);
+			}
+
+			transforms.Update(objectTransforms.BeginFrame<ObjectTransform>(transforms.GetCount()), renderer.Jobs.get());
+			renderer.RenderPassDrawInstanced(pipeline, &vertexBuffer, &objectTransforms, InstanceInput::StorageBuffer, uint32_t(vertices.size()));
+		}
 
 		renderer.SubmitCommandBuffer();
 		// End of GPU commands ----------------------------------------------------------------------
 
-		SDL_Delay(16); // Limit to ~60 FPS for now
+		if (frameLimit && ++frameCount >= frameLimit)
+			running = false;
 	}
 
+	FrameTimeStats frameTimes = renderer.GetFrameTimeStats();
+	printf("Frame times over %u frames: avg %.2f ms, p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms, %u skipped\n",
+		frameTimes.Frames, frameTimes.AverageMS, frameTimes.P50MS, frameTimes.P95MS, frameTimes.P99MS, frameTimes.MaxMS, frameTimes.SkippedFrames);
+	printf("Render scale at exit: %.2f\n", renderer.GetResolutionScale());
+
+#if SDLGPU_TRACK_ALLOCATIONS
+	printf("Heap allocations while recording the last frame: %u\n", renderer.GetDrawStats().HotPathAllocations);
+#endif
+
+#if SDLGPU_ENABLE_PROFILER
+	Profiler::PrintSummary();
+	if (Profiler::WriteChromeTrace("sdlGPU.trace.json"))
+		printf("Wrote sdlGPU.trace.json\n");
+#endif
+
 
 	// Cleanup
+	objectTransforms.Cleanup();
 	vertexBuffer.Cleanup();
 	renderer.ReleasePipeline(pipeline);
 	renderer.Cleanup();
 
 	
-	SDL_DestroyWindow(window);
+	if (window)
+		SDL_DestroyWindow(window);
 	SDL_Quit();
 	return EXIT_SUCCESS;
 }
@@ -0,0 +1,296 @@
+// Cooks a Wavefront OBJ file into a .mesh file that MeshPool::LoadMesh uploads without parsing.
+//
+//   MeshCooker <input.obj> <output file> [--layout pnt|pn|p|packed] [--index16] [--no-optimize]
+//
+// Layouts are the vertex structs from common.hpp: pnt = VertexPositionNormalTexture (default),
+// pn = VertexPositionNormal, p = VertexPosition, packed = VertexPackedPositionNormalTexture.
+// Triangles are grouped into one submesh per material, each reordered for the vertex cache,
+// then vertices are ordered by first use. Afterwards the OBJ parse is timed against mapping
+// and copying the cooked blobs.
+
+#include "ObjImporter.hpp"
+#include "Core/MappedFile.hpp"
+#include "Mesh/MeshOptimizer.hpp"
+#include "Mesh/VertexPacking.hpp"
+#include "Renderer/CookedMeshFormat.hpp"
+#include "Renderer/VertexLayout.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+
+enum class OutputLayout
+{
+	PositionNormalTexture,
+	PositionNormal,
+	Position,
+	Packed
+};
+
+template<typename TVertex>
+static std::vector<uint8_t> WriteLayout(const TVertex* vertices, size_t count, CookedMeshHeader& header)
+{
+	header.VertexType = VertexLayout<TVertex>::Type;
+	header.VertexStride = sizeof(TVertex);
+	header.ElementCount = uint32_t(VertexLayout<TVertex>::Elements.size());
+	for (size_t i = 0; i < VertexLayout<TVertex>::Elements.size(); i++)
+	{
+		const VertexElement& element = VertexLayout<TVertex>::Elements[i];
+		header.Elements[i] = CookedMeshElement{ uint32_t(element.Format), element.Offset, element.Location };
+	}
+
+	std::vector<uint8_t> blob(count * sizeof(TVertex));
+	memcpy(blob.data(), vertices, blob.size());
+	return blob;
+}
+
+static std::vector<uint8_t> ConvertVertices(OutputLayout layout, const std::vector<VertexPositionNormalTexture>& vertices, CookedMeshHeader& header)
+{
+	switch (layout)
+	{
+	case OutputLayout::PositionNormal:
+	{
+		std::vector<VertexPositionNormal> converted(vertices.size());
+		for (size_t i = 0; i < vertices.size(); i++)
+			converted[i] = { vertices[i].x, vertices[i].y, vertices[i].z, vertices[i].nx, vertices[i].ny, vertices[i].nz };
+		return WriteLayout(converted.data(), converted.size(), header);
+	}
+	case OutputLayout::Position:
+	{
+		std::vector<VertexPosition> converted(vertices.size());
+		for (size_t i = 0; i < vertices.size(); i++)
+			converted[i] = { vertices[i].x, vertices[i].y, vertices[i].z };
+		return WriteLayout(converted.data(), converted.size(), header);
+	}
+	case OutputLayout::Packed:
+	{
+		std::vector<VertexPackedPositionNormalTexture> converted(vertices.size());
+		VertexPacking::PackVertices(converted.data(), vertices.data(), vertices.size());
+		return WriteLayout(converted.data(), converted.size(), header);
+	}
+	default:
+		return WriteLayout(vertices.data(), vertices.size(), header);
+	}
+}
+
+static void ComputeBounds(const std::vector<VertexPositionNormalTexture>& vertices, const uint32_t* indices, size_t indexCount, float minimum[3], float maximum[3])
+{
+	for (int axis = 0; axis < 3; axis++)
+	{
+		minimum[axis] = indexCount ? INFINITY : 0.0f;
+		maximum[axis] = indexCount ? -INFINITY : 0.0f;
+	}
+
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		const float position[3] = { vertices[indices[i]].x, vertices[indices[i]].y, vertices[indices[i]].z };
+		for (int axis = 0; axis < 3; axis++)
+		{
+			minimum[axis] = std::min(minimum[axis], position[axis]);
+			maximum[axis] = std::max(maximum[axis], position[axis]);
+		}
+	}
+}
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static uint64_t Align(uint64_t value, uint64_t alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		printf("Usage: %s <input.obj> <output file> [--layout pnt|pn|p|packed] [--index16] [--no-optimize]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const std::string inputPath = argv[1];
+	const fs::path outputPath = argv[2];
+
+	OutputLayout layout = OutputLayout::PositionNormalTexture;
+	bool index16 = false;
+	bool optimize = true;
+	for (int i = 3; i < argc; i++)
+	{
+		const std::string argument = argv[i];
+		if (argument == "--layout" && i + 1 < argc)
+		{
+			const std::string name = argv[++i];
+			if (name == "pnt")
+				layout = OutputLayout::PositionNormalTexture;
+			else if (name == "pn")
+				layout = OutputLayout::PositionNormal;
+			else if (name == "p")
+				layout = OutputLayout::Position;
+			else if (name == "packed")
+				layout = OutputLayout::Packed;
+			else
+			{
+				printf("Unknown layout %s\n", name.c_str());
+				return EXIT_FAILURE;
+			}
+		}
+		else if (argument == "--index16")
+			index16 = true;
+		else if (argument == "--no-optimize")
+			optimize = false;
+		else
+		{
+			printf("Unknown argument %s\n", argument.c_str());
+			return EXIT_FAILURE;
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	ObjMesh mesh;
+	std::string error;
+	if (!ImportObj(inputPath, mesh, error))
+	{
+		printf("Failed to import %s\n", error.c_str());
+		return EXIT_FAILURE;
+	}
+
+	const double importMS = MillisecondsSince(start);
+	MeshOptimizer::VertexCacheStats cacheBefore = MeshOptimizer::AnalyzeVertexCache(mesh.Indices.data(), mesh.Indices.size(), mesh.Vertices.size());
+
+	// Per submesh so triangles never move between materials
+	if (optimize)
+	{
+		for (const ObjSubmesh& submesh : mesh.Submeshes)
+		{
+			uint32_t* indices = mesh.Indices.data() + submesh.FirstIndex;
+			MeshOptimizer::OptimizeVertexCache(indices, indices, submesh.IndexCount, mesh.Vertices.size());
+		}
+
+		std::vector<uint32_t> remap(mesh.Vertices.size());
+		uint32_t usedCount = MeshOptimizer::GenerateVertexFetchRemap(remap.data(), mesh.Indices.data(), mesh.Indices.size(), mesh.Vertices.size());
+
+		std::vector<VertexPositionNormalTexture> ordered(usedCount);
+		MeshOptimizer::RemapVertexBuffer(ordered.data(), mesh.Vertices.data(), mesh.Vertices.size(), sizeof(VertexPositionNormalTexture), remap.data());
+		MeshOptimizer::RemapIndexBuffer(mesh.Indices.data(), mesh.Indices.data(), mesh.Indices.size(), remap.data());
+		mesh.Vertices.swap(ordered);
+	}
+
+	MeshOptimizer::VertexCacheStats cacheAfter = MeshOptimizer::AnalyzeVertexCache(mesh.Indices.data(), mesh.Indices.size(), mesh.Vertices.size());
+
+	if (index16 && mesh.Vertices.size() > 65536)
+	{
+		printf("%zu vertices do not fit 16-bit indices\n", mesh.Vertices.size());
+		return EXIT_FAILURE;
+	}
+
+	CookedMeshHeader header{};
+	header.Magic = COOKED_MESH_MAGIC;
+	header.Version = COOKED_MESH_VERSION;
+	header.IndexSize = index16 ? 2 : 4;
+	header.VertexCount = uint32_t(mesh.Vertices.size());
+	header.IndexCount = uint32_t(mesh.Indices.size());
+	header.SubmeshCount = uint32_t(mesh.Submeshes.size());
+	ComputeBounds(mesh.Vertices, mesh.Indices.data(), mesh.Indices.size(), header.BoundsMin, header.BoundsMax);
+
+	std::vector<uint8_t> vertexBlob = ConvertVertices(layout, mesh.Vertices, header);
+
+	std::vector<uint8_t> indexBlob;
+	if (index16)
+	{
+		std::vector<uint16_t> narrowed = MeshOptimizer::ConvertIndicesTo16(mesh.Indices);
+		indexBlob.resize(narrowed.size() * sizeof(uint16_t));
+		memcpy(indexBlob.data(), narrowed.data(), indexBlob.size());
+	}
+	else
+	{
+		indexBlob.resize(mesh.Indices.size() * sizeof(uint32_t));
+		memcpy(indexBlob.data(), mesh.Indices.data(), indexBlob.size());
+	}
+
+	std::vector<CookedSubmesh> submeshes;
+	for (const ObjSubmesh& submesh : mesh.Submeshes)
+	{
+		CookedSubmesh& cooked = submeshes.emplace_back();
+		cooked.FirstIndex = submesh.FirstIndex;
+		cooked.IndexCount = submesh.IndexCount;
+		cooked.MaterialHash = submesh.Material.empty() ? 0 : CookedMeshHash(submesh.Material);
+		ComputeBounds(mesh.Vertices, mesh.Indices.data() + submesh.FirstIndex, submesh.IndexCount, cooked.BoundsMin, cooked.BoundsMax);
+	}
+
+
+	// Header, submeshes, then the aligned blobs
+	uint64_t offset = sizeof(CookedMeshHeader);
+	header.SubmeshOffset = uint32_t(offset);
+	offset += submeshes.size() * sizeof(CookedSubmesh);
+
+	offset = Align(offset, COOKED_MESH_ALIGNMENT);
+	header.VertexOffset = uint32_t(offset);
+	offset += vertexBlob.size();
+
+	offset = Align(offset, COOKED_MESH_ALIGNMENT);
+	header.IndexOffset = uint32_t(offset);
+	offset += indexBlob.size();
+
+	if (offset > UINT32_MAX)
+	{
+		printf("Cooked mesh exceeds 4 GB\n");
+		return EXIT_FAILURE;
+	}
+	header.FileSize = offset;
+
+	std::vector<uint8_t> file(offset, 0);
+	memcpy(file.data(), &header, sizeof(header));
+	memcpy(file.data() + header.SubmeshOffset, submeshes.data(), submeshes.size() * sizeof(CookedSubmesh));
+	memcpy(file.data() + header.VertexOffset, vertexBlob.data(), vertexBlob.size());
+	memcpy(file.data() + header.IndexOffset, indexBlob.data(), indexBlob.size());
+
+	std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+	if (!output || !output.write(reinterpret_cast<const char*>(file.data()), file.size()))
+	{
+		printf("Failed to write %s\n", outputPath.string().c_str());
+		return EXIT_FAILURE;
+	}
+	output.close();
+
+
+	// The cooked load is a map plus one copy per blob, the same work MeshPool::LoadMesh does
+	// before the uploader takes over
+	double mappedMS = INFINITY;
+	std::vector<uint8_t> staging(vertexBlob.size() + indexBlob.size());
+	for (int run = 0; run < 5; run++)
+	{
+		auto mappedStart = std::chrono::steady_clock::now();
+		MappedFile mapped(outputPath.string());
+		if (mapped.IsOpen())
+		{
+			memcpy(staging.data(), mapped.GetData() + header.VertexOffset, vertexBlob.size());
+			memcpy(staging.data() + vertexBlob.size(), mapped.GetData() + header.IndexOffset, indexBlob.size());
+		}
+		mappedMS = std::min(mappedMS, MillisecondsSince(mappedStart));
+	}
+
+	std::error_code fileError;
+	printf("Cooked %s -> %s\n", inputPath.c_str(), outputPath.string().c_str());
+	printf("  %u vertices (%u bytes each), %u triangles, %u submeshes, %u-bit indices%s%s\n",
+		header.VertexCount, header.VertexStride, header.IndexCount / 3, header.SubmeshCount, header.IndexSize * 8,
+		mesh.HasNormals ? "" : ", generated normals", mesh.HasTexcoords ? "" : ", no texcoords");
+	printf("  ACMR %.3f -> %.3f\n", cacheBefore.ACMR, cacheAfter.ACMR);
+	printf("  %-8s %12s %14s\n", "path", "load ms", "file bytes");
+	printf("  %-8s %12.3f %14llu\n", "OBJ", importMS, (unsigned long long)fs::file_size(inputPath, fileError));
+	printf("  %-8s %12.3f %14llu\n", "cooked", mappedMS, (unsigned long long)file.size());
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,284 @@
+#include "ObjImporter.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+	// 1-based v/vt/vn indices of a face corner, 0 where the corner has none
+	struct Corner
+	{
+		uint32_t Position{0};
+		uint32_t Texcoord{0};
+		uint32_t Normal{0};
+
+		bool operator==(const Corner&) const = default;
+	};
+
+	struct CornerHash
+	{
+		size_t operator()(const Corner& corner) const
+		{
+			uint64_t hash = corner.Position * 0x9E3779B97F4A7C15ull;
+			hash ^= (corner.Texcoord + 0x632BE59BD9B4E019ull) + (hash << 6) + (hash >> 2);
+			hash ^= (corner.Normal + 0x8CB92BA72F3D8DD7ull) + (hash << 6) + (hash >> 2);
+			return size_t(hash);
+		}
+	};
+
+	void SkipSpaces(std::string_view& text)
+	{
+		while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+			text.remove_prefix(1);
+	}
+
+	std::string_view NextToken(std::string_view& text)
+	{
+		SkipSpaces(text);
+		size_t end = 0;
+		while (end < text.size() && text[end] != ' ' && text[end] != '\t')
+			end++;
+
+		std::string_view token = text.substr(0, end);
+		text.remove_prefix(end);
+		return token;
+	}
+
+	bool ParseFloats(std::string_view text, float* values, int count)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			std::string_view token = NextToken(text);
+			if (std::from_chars(token.data(), token.data() + token.size(), values[i]).ec != std::errc())
+				return false;
+		}
+		return true;
+	}
+
+	// OBJ indices are 1-based, negative ones count back from the last element
+	bool ResolveIndex(std::string_view token, size_t count, uint32_t& index)
+	{
+		if (token.empty())
+		{
+			index = 0;
+			return true;
+		}
+
+		int64_t value = 0;
+		if (std::from_chars(token.data(), token.data() + token.size(), value).ec != std::errc())
+			return false;
+
+		if (value < 0)
+			value += int64_t(count) + 1;
+
+		if (value < 1 || value > int64_t(count))
+			return false;
+
+		index = uint32_t(value);
+		return true;
+	}
+
+	bool ParseCorner(std::string_view token, size_t positions, size_t texcoords, size_t normals, Corner& corner)
+	{
+		size_t slash = token.find('/');
+		std::string_view position = token.substr(0, slash);
+		std::string_view texcoord;
+		std::string_view normal;
+
+		if (slash != std::string_view::npos)
+		{
+			token.remove_prefix(slash + 1);
+			slash = token.find('/');
+			texcoord = token.substr(0, slash);
+			if (slash != std::string_view::npos)
+				normal = token.substr(slash + 1);
+		}
+
+		return !position.empty() &&
+			ResolveIndex(position, positions, corner.Position) &&
+			ResolveIndex(texcoord, texcoords, corner.Texcoord) &&
+			ResolveIndex(normal, normals, corner.Normal);
+	}
+}
+
+
+
+bool ImportObj(const std::string& path, ObjMesh& mesh, std::string& error)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		error = "cannot open " + path;
+		return false;
+	}
+
+	std::string source(size_t(file.tellg()), '\0');
+	file.seekg(0);
+	if (!file.read(source.data(), source.size()))
+	{
+		error = "cannot read " + path;
+		return false;
+	}
+
+	std::vector<float> positions;
+	std::vector<float> texcoords;
+	std::vector<float> normals;
+
+	std::unordered_map<Corner, uint32_t, CornerHash> vertexIndices;
+	std::vector<Corner> vertexCorners;
+
+	// Triangles are collected per material and concatenated at the end
+	std::vector<std::string> materials{ "" };
+	std::vector<std::vector<uint32_t>> materialIndices(1);
+	size_t material = 0;
+
+	std::vector<Corner> face;
+	std::string_view text = source;
+	uint32_t lineNumber = 0;
+
+	while (!text.empty())
+	{
+		size_t end = text.find('\n');
+		std::string_view line = text.substr(0, end);
+		text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+		lineNumber++;
+
+		if (!line.empty() && line.back() == '\r')
+			line.remove_suffix(1);
+
+		std::string_view keyword = NextToken(line);
+		bool valid = true;
+
+		if (keyword == "v")
+		{
+			float value[3];
+			valid = ParseFloats(line, value, 3);
+			positions.insert(positions.end(), value, value + 3);
+		}
+		else if (keyword == "vt")
+		{
+			float value[2];
+			valid = ParseFloats(line, value, 2);
+			texcoords.insert(texcoords.end(), value, value + 2);
+		}
+		else if (keyword == "vn")
+		{
+			float value[3];
+			valid = ParseFloats(line, value, 3);
+			normals.insert(normals.end(), value, value + 3);
+		}
+		else if (keyword == "f")
+		{
+			face.clear();
+			for (std::string_view token = NextToken(line); valid && !token.empty(); token = NextToken(line))
+			{
+				Corner corner;
+				valid = ParseCorner(token, positions.size() / 3, texcoords.size() / 2, normals.size() / 3, corner);
+				face.push_back(corner);
+			}
+			valid &= face.size() >= 3;
+
+			for (size_t i = 2; valid && i < face.size(); i++)
+			{
+				for (const Corner& corner : { face[0], face[i - 1], face[i] })
+				{
+					auto [found, inserted] = vertexIndices.try_emplace(corner, uint32_t(vertexCorners.size()));
+					if (inserted)
+						vertexCorners.push_back(corner);
+					materialIndices[material].push_back(found->second);
+				}
+			}
+		}
+		else if (keyword == "usemtl")
+		{
+			std::string name(NextToken(line));
+			auto found = std::find(materials.begin(), materials.end(), name);
+			material = size_t(found - materials.begin());
+			if (found == materials.end())
+			{
+				materials.push_back(name);
+				materialIndices.emplace_back();
+			}
+		}
+
+		if (!valid)
+		{
+			error = path + ":" + std::to_string(lineNumber) + ": malformed " + std::string(keyword);
+			return false;
+		}
+	}
+
+	mesh = ObjMesh{};
+	for (size_t i = 0; i < materials.size(); i++)
+	{
+		if (materialIndices[i].empty())
+			continue;
+
+		mesh.Submeshes.push_back({ materials[i], uint32_t(mesh.Indices.size()), uint32_t(materialIndices[i].size()) });
+		mesh.Indices.insert(mesh.Indices.end(), materialIndices[i].begin(), materialIndices[i].end());
+	}
+
+	if (mesh.Indices.empty())
+	{
+		error = path + " has no faces";
+		return false;
+	}
+
+	// Area-weighted face normals per position, for corners that come without one
+	std::vector<float> generatedNormals(positions.size(), 0.0f);
+	for (size_t i = 0; i + 2 < mesh.Indices.size(); i += 3)
+	{
+		const float* p[3];
+		for (int k = 0; k < 3; k++)
+			p[k] = &positions[(vertexCorners[mesh.Indices[i + k]].Position - 1) * 3];
+
+		float e1[3] = { p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2] };
+		float e2[3] = { p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2] };
+		float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+
+		for (int k = 0; k < 3; k++)
+		{
+			float* target = &generatedNormals[(vertexCorners[mesh.Indices[i + k]].Position - 1) * 3];
+			target[0] += n[0];
+			target[1] += n[1];
+			target[2] += n[2];
+		}
+	}
+
+	mesh.Vertices.resize(vertexCorners.size());
+	for (size_t i = 0; i < vertexCorners.size(); i++)
+	{
+		const Corner& corner = vertexCorners[i];
+		VertexPositionNormalTexture& vertex = mesh.Vertices[i];
+
+		const float* position = &positions[(corner.Position - 1) * 3];
+		vertex.x = position[0];
+		vertex.y = position[1];
+		vertex.z = position[2];
+
+		const float* normal = corner.Normal ? &normals[(corner.Normal - 1) * 3] : &generatedNormals[(corner.Position - 1) * 3];
+		float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		vertex.nx = length > 0.0f ? normal[0] / length : 0.0f;
+		vertex.ny = length > 0.0f ? normal[1] / length : 0.0f;
+		vertex.nz = length > 0.0f ? normal[2] / length : 1.0f;
+
+		if (corner.Texcoord)
+		{
+			vertex.u = texcoords[(corner.Texcoord - 1) * 2];
+			vertex.v = 1.0f - texcoords[(corner.Texcoord - 1) * 2 + 1];
+		}
+		else
+		{
+			vertex.u = 0.0f;
+			vertex.v = 0.0f;
+		}
+
+		mesh.HasNormals |= corner.Normal != 0;
+		mesh.HasTexcoords |= corner.Texcoord != 0;
+	}
+
+	return true;
+}
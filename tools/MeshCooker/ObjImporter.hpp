@@ -0,0 +1,28 @@
+#pragma once
+
+#include "common.hpp"
+#include <string>
+#include <vector>
+
+
+struct ObjSubmesh
+{
+	std::string Material;   // from usemtl, empty before the first one
+	uint32_t FirstIndex{0};
+	uint32_t IndexCount{0};
+};
+
+struct ObjMesh
+{
+	std::vector<VertexPositionNormalTexture> Vertices;
+	std::vector<uint32_t> Indices;
+	std::vector<ObjSubmesh> Submeshes;   // one per material, in order of first use
+	bool HasNormals{false};
+	bool HasTexcoords{false};
+};
+
+// Reads positions, texcoords, normals, faces and usemtl from a Wavefront OBJ file.
+// Polygons are triangulated as fans and corners with the same v/vt/vn triple share a
+// vertex. Corners without a normal get the area-weighted average of the faces around
+// their position. V is flipped, OBJ puts the texture origin bottom left.
+bool ImportObj(const std::string& path, ObjMesh& mesh, std::string& error);
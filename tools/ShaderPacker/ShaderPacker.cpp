@@ -0,0 +1,231 @@
+// Packs every compiled shader in a directory into a single shaders.pack archive.
+//
+//   ShaderPacker <compiled shader directory> <output file>
+//
+// Shaders are grouped by name without the backend extension, so
+// PositionColor.vert.spv and PositionColor.vert.dxil become one entry
+// "PositionColor.vert" with two blobs. Stage and resource counts are
+// reflected from the SPIR-V blob.
+
+#include "SpirvReflect.hpp"
+#include "Renderer/ShaderArchiveFormat.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+
+struct PendingShader
+{
+	std::string Name;
+	std::array<std::vector<uint8_t>, size_t(ShaderArchiveBackend::Count)> Blobs;
+	ShaderArchiveEntry Entry{};
+};
+
+static bool ReadFile(const fs::path& path, std::vector<uint8_t>& data)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+		return false;
+
+	data.resize(size_t(file.tellg()));
+	file.seekg(0);
+	return bool(file.read(reinterpret_cast<char*>(data.data()), data.size()));
+}
+
+static bool BackendFromExtension(const fs::path& extension, ShaderArchiveBackend& backend)
+{
+	if (extension == ".spv")
+		backend = ShaderArchiveBackend::SPIRV;
+	else if (extension == ".dxil")
+		backend = ShaderArchiveBackend::DXIL;
+	else if (extension == ".msl")
+		backend = ShaderArchiveBackend::MSL;
+	else
+		return false;
+	return true;
+}
+
+static uint64_t Align(uint64_t value, uint64_t alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		printf("Usage: %s <compiled shader directory> <output file>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const fs::path inputDirectory = argv[1];
+	const fs::path outputPath = argv[2];
+
+	std::error_code error;
+	if (!fs::is_directory(inputDirectory, error))
+	{
+		printf("Not a directory: %s\n", inputDirectory.string().c_str());
+		return EXIT_FAILURE;
+	}
+
+	// Group blobs by shader name, std::map keeps the output deterministic
+	std::map<std::string, PendingShader> shaders;
+	for (const fs::directory_entry& file : fs::directory_iterator(inputDirectory))
+	{
+		ShaderArchiveBackend backend;
+		if (!file.is_regular_file() || !BackendFromExtension(file.path().extension(), backend))
+			continue;
+
+		const std::string name = file.path().stem().string();
+		PendingShader& shader = shaders[name];
+		shader.Name = name;
+
+		if (!ReadFile(file.path(), shader.Blobs[size_t(backend)]))
+		{
+			printf("Failed to read %s\n", file.path().string().c_str());
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::vector<PendingShader*> entries;
+	for (auto& [name, shader] : shaders)
+	{
+		ShaderArchiveEntry& entry = shader.Entry;
+		entry.NameHash = ShaderArchiveHash(name);
+		entry.NameLength = uint16_t(name.size());
+
+		const std::vector<uint8_t>& spirv = shader.Blobs[size_t(ShaderArchiveBackend::SPIRV)];
+		SpirvReflection reflection = ReflectSpirv(spirv.data(), spirv.size());
+		if (reflection.Valid)
+		{
+			entry.Stage = reflection.Stage;
+			entry.SamplerCount = reflection.SamplerCount;
+			entry.UniformBufferCount = reflection.UniformBufferCount;
+			entry.StorageBufferCount = reflection.StorageBufferCount;
+			entry.StorageTextureCount = reflection.StorageTextureCount;
+			entry.ReadWriteStorageBufferCount = reflection.ReadWriteStorageBufferCount;
+			entry.ReadWriteStorageTextureCount = reflection.ReadWriteStorageTextureCount;
+			for (int axis = 0; axis < 3; axis++)
+				entry.ThreadCount[axis] = uint16_t(reflection.ThreadCount[axis]);
+
+			// Graphics stages can only read storage resources in SDL
+			if (entry.Stage != ShaderArchiveStage::Compute && (entry.ReadWriteStorageBufferCount || entry.ReadWriteStorageTextureCount))
+			{
+				printf("%s writes to storage resources, which only compute shaders may do\n", name.c_str());
+				return EXIT_FAILURE;
+			}
+		}
+		else
+		{
+			// Without SPIR-V there is nothing to reflect, fall back to the naming convention
+			if (!spirv.empty())
+			{
+				printf("Invalid SPIR-V in %s\n", name.c_str());
+				return EXIT_FAILURE;
+			}
+
+			if (name.contains(".vert"))
+				entry.Stage = ShaderArchiveStage::Vertex;
+			else if (name.contains(".frag"))
+				entry.Stage = ShaderArchiveStage::Fragment;
+			else if (name.contains(".comp"))
+				entry.Stage = ShaderArchiveStage::Compute;
+			else
+			{
+				printf("Cannot determine the stage of %s\n", name.c_str());
+				return EXIT_FAILURE;
+			}
+
+			entry.ThreadCount[0] = entry.ThreadCount[1] = entry.ThreadCount[2] = 1;
+			printf("Warning: %s has no SPIR-V blob, resource counts are zero\n", name.c_str());
+		}
+
+		entries.push_back(&shader);
+	}
+
+	// Sorted by hash so the runtime can binary search the table
+	std::sort(entries.begin(), entries.end(),
+		[](const PendingShader* a, const PendingShader* b) { return a->Entry.NameHash < b->Entry.NameHash; });
+
+
+	// Lay out names and blobs behind the table
+	uint64_t offset = sizeof(ShaderArchiveHeader) + entries.size() * sizeof(ShaderArchiveEntry);
+	for (PendingShader* shader : entries)
+	{
+		shader->Entry.NameOffset = uint32_t(offset);
+		offset += shader->Name.size();
+	}
+
+	for (PendingShader* shader : entries)
+	{
+		for (size_t backend = 0; backend < shader->Blobs.size(); backend++)
+		{
+			if (shader->Blobs[backend].empty())
+				continue;
+
+			offset = Align(offset, SHADER_ARCHIVE_ALIGNMENT);
+			shader->Entry.Blobs[backend] = ShaderArchiveBlob{uint32_t(offset), uint32_t(shader->Blobs[backend].size())};
+			offset += shader->Blobs[backend].size();
+		}
+	}
+
+	if (offset > UINT32_MAX)
+	{
+		printf("Shader archive exceeds 4 GB\n");
+		return EXIT_FAILURE;
+	}
+
+	std::vector<uint8_t> archive(offset, 0);
+
+	ShaderArchiveHeader header{};
+	header.Magic = SHADER_ARCHIVE_MAGIC;
+	header.Version = SHADER_ARCHIVE_VERSION;
+	header.EntryCount = uint32_t(entries.size());
+	header.EntryOffset = sizeof(ShaderArchiveHeader);
+	header.FileSize = offset;
+	std::memcpy(archive.data(), &header, sizeof(header));
+
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		const PendingShader& shader = *entries[i];
+		std::memcpy(archive.data() + header.EntryOffset + i * sizeof(ShaderArchiveEntry), &shader.Entry, sizeof(ShaderArchiveEntry));
+		std::memcpy(archive.data() + shader.Entry.NameOffset, shader.Name.data(), shader.Name.size());
+
+		for (size_t backend = 0; backend < shader.Blobs.size(); backend++)
+		{
+			if (!shader.Blobs[backend].empty())
+				std::memcpy(archive.data() + shader.Entry.Blobs[backend].Offset, shader.Blobs[backend].data(), shader.Blobs[backend].size());
+		}
+	}
+
+	std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+	if (!output || !output.write(reinterpret_cast<const char*>(archive.data()), archive.size()))
+	{
+		printf("Failed to write %s\n", outputPath.string().c_str());
+		return EXIT_FAILURE;
+	}
+
+	for (const PendingShader* shader : entries)
+	{
+		const ShaderArchiveEntry& entry = shader->Entry;
+		printf("  %-32s samplers %u, uniform buffers %u, storage buffers %u/%u rw, storage textures %u/%u rw",
+			shader->Name.c_str(), entry.SamplerCount, entry.UniformBufferCount,
+			entry.StorageBufferCount, entry.ReadWriteStorageBufferCount, entry.StorageTextureCount, entry.ReadWriteStorageTextureCount);
+		if (entry.Stage == ShaderArchiveStage::Compute)
+			printf(", threads %ux%ux%u", entry.ThreadCount[0], entry.ThreadCount[1], entry.ThreadCount[2]);
+		printf("\n");
+	}
+	printf("Packed %zu shaders into %s (%llu bytes)\n", entries.size(), outputPath.string().c_str(), (unsigned long long)offset);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,235 @@
+#include "SpirvReflect.hpp"
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+namespace
+{
+	constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+
+	enum SpirvOp : uint16_t
+	{
+		OpEntryPoint = 15,
+		OpExecutionMode = 16,
+		OpTypeImage = 25,
+		OpTypeSampler = 26,
+		OpTypeSampledImage = 27,
+		OpTypeArray = 28,
+		OpTypeRuntimeArray = 29,
+		OpTypeStruct = 30,
+		OpTypePointer = 32,
+		OpConstant = 43,
+		OpVariable = 59,
+		OpDecorate = 71,
+		OpMemberDecorate = 72,
+	};
+
+	constexpr uint32_t ExecutionModelVertex = 0;
+	constexpr uint32_t ExecutionModelFragment = 4;
+	constexpr uint32_t ExecutionModelGLCompute = 5;
+
+	constexpr uint32_t ExecutionModeLocalSize = 17;
+
+	constexpr uint32_t DecorationBlock = 2;
+	constexpr uint32_t DecorationBufferBlock = 3;
+	constexpr uint32_t DecorationNonWritable = 24;
+
+	constexpr uint32_t StorageClassUniformConstant = 0;
+	constexpr uint32_t StorageClassUniform = 2;
+	constexpr uint32_t StorageClassStorageBuffer = 12;
+
+	struct SpirvType
+	{
+		uint16_t Op{0};
+		uint32_t Element{0};   // arrays and pointers
+		uint32_t Length{1};    // arrays, id of the length constant until resolved
+		uint32_t Sampled{0};   // images, 2 means storage image
+	};
+
+	struct SpirvVariable
+	{
+		uint32_t Id;
+		uint32_t Type;
+		uint32_t StorageClass;
+	};
+}
+
+
+SpirvReflection ReflectSpirv(const uint8_t* code, size_t size)
+{
+	SpirvReflection reflection{};
+	if (size < 20 || size % 4 != 0)
+		return reflection;
+
+	std::vector<uint32_t> words(size / 4);
+	std::memcpy(words.data(), code, size);
+	if (words[0] != SPIRV_MAGIC)
+		return reflection;
+
+	std::unordered_map<uint32_t, SpirvType> types;
+	std::unordered_map<uint32_t, uint32_t> constants;
+	std::unordered_set<uint32_t> blocks;
+	std::unordered_set<uint32_t> bufferBlocks;
+	std::unordered_set<uint32_t> nonWritable; // variables, and structs with a NonWritable member
+	std::vector<SpirvVariable> variables;
+	bool hasEntryPoint = false;
+
+	for (size_t i = 5; i < words.size();)
+	{
+		const uint16_t op = words[i] & 0xFFFF;
+		const uint16_t count = words[i] >> 16;
+		if (count == 0 || i + count > words.size())
+			return reflection;
+
+		const uint32_t* operands = &words[i + 1];
+
+		switch (op)
+		{
+			case OpEntryPoint:
+				if (!hasEntryPoint)
+				{
+					hasEntryPoint = true;
+					switch (operands[0])
+					{
+						case ExecutionModelVertex: reflection.Stage = ShaderArchiveStage::Vertex; break;
+						case ExecutionModelFragment: reflection.Stage = ShaderArchiveStage::Fragment; break;
+						case ExecutionModelGLCompute: reflection.Stage = ShaderArchiveStage::Compute; break;
+						default: return reflection;
+					}
+				}
+				break;
+
+			case OpExecutionMode:
+				if (count >= 6 && operands[1] == ExecutionModeLocalSize)
+				{
+					reflection.ThreadCount[0] = operands[2];
+					reflection.ThreadCount[1] = operands[3];
+					reflection.ThreadCount[2] = operands[4];
+				}
+				break;
+
+			case OpDecorate:
+				if (count >= 3 && operands[1] == DecorationBlock)
+					blocks.insert(operands[0]);
+				else if (count >= 3 && operands[1] == DecorationBufferBlock)
+					bufferBlocks.insert(operands[0]);
+				else if (count >= 3 && operands[1] == DecorationNonWritable)
+					nonWritable.insert(operands[0]);
+				break;
+
+			case OpMemberDecorate:
+				if (count >= 4 && operands[2] == DecorationNonWritable)
+					nonWritable.insert(operands[0]);
+				break;
+
+			case OpTypeImage:
+				if (count >= 9)
+					types[operands[0]] = SpirvType{op, 0, 1, operands[6]};
+				break;
+
+			case OpTypeSampler:
+			case OpTypeSampledImage:
+			case OpTypeStruct:
+				types[operands[0]] = SpirvType{op};
+				break;
+
+			case OpTypeArray:
+				types[operands[0]] = SpirvType{op, operands[1], operands[2]};
+				break;
+
+			case OpTypeRuntimeArray:
+				types[operands[0]] = SpirvType{op, operands[1], 1};
+				break;
+
+			case OpTypePointer:
+				types[operands[0]] = SpirvType{op, operands[2]};
+				break;
+
+			case OpConstant:
+				if (count >= 4)
+					constants[operands[1]] = operands[2];
+				break;
+
+			case OpVariable:
+				variables.push_back({operands[1], operands[0], operands[2]});
+				break;
+
+			default:
+				break;
+		}
+
+		i += count;
+	}
+
+	if (!hasEntryPoint)
+		return reflection;
+
+	for (const SpirvVariable& variable : variables)
+	{
+		if (variable.StorageClass != StorageClassUniformConstant &&
+			variable.StorageClass != StorageClassUniform &&
+			variable.StorageClass != StorageClassStorageBuffer)
+			continue;
+
+		auto pointer = types.find(variable.Type);
+		if (pointer == types.end() || pointer->second.Op != OpTypePointer)
+			continue;
+
+		// Unwrap arrays of resources
+		uint32_t typeId = pointer->second.Element;
+		uint32_t elements = 1;
+		auto type = types.find(typeId);
+		while (type != types.end() && (type->second.Op == OpTypeArray || type->second.Op == OpTypeRuntimeArray))
+		{
+			if (type->second.Op == OpTypeArray)
+			{
+				auto length = constants.find(type->second.Length);
+				elements *= length != constants.end() ? length->second : 1;
+			}
+			typeId = type->second.Element;
+			type = types.find(typeId);
+		}
+
+		if (type == types.end())
+			continue;
+
+		switch (type->second.Op)
+		{
+			case OpTypeSampledImage:
+				reflection.SamplerCount += elements;
+				break;
+
+			case OpTypeImage:
+				// Separate textures are bound together with a sampler in SDL
+				if (type->second.Sampled != 2)
+					reflection.SamplerCount += elements;
+				else if (nonWritable.contains(variable.Id))
+					reflection.StorageTextureCount += elements;
+				else
+					reflection.ReadWriteStorageTextureCount += elements;
+				break;
+
+			case OpTypeStruct:
+				if (variable.StorageClass == StorageClassStorageBuffer || bufferBlocks.contains(typeId))
+				{
+					if (nonWritable.contains(variable.Id) || nonWritable.contains(typeId))
+						reflection.StorageBufferCount += elements;
+					else
+						reflection.ReadWriteStorageBufferCount += elements;
+				}
+				else if (blocks.contains(typeId))
+				{
+					reflection.UniformBufferCount += elements;
+				}
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	reflection.Valid = true;
+	return reflection;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Renderer/ShaderArchiveFormat.hpp"
+#include <cstddef>
+#include <cstdint>
+
+
+struct SpirvReflection
+{
+	bool Valid{false};
+	ShaderArchiveStage Stage{ShaderArchiveStage::Vertex};
+	uint32_t SamplerCount{0};
+	uint32_t UniformBufferCount{0};
+	uint32_t StorageBufferCount{0};
+	uint32_t StorageTextureCount{0};
+	uint32_t ReadWriteStorageBufferCount{0};
+	uint32_t ReadWriteStorageTextureCount{0};
+	uint32_t ThreadCount[3]{1, 1, 1};
+};
+
+// Reads the entry point stage and counts the resources SDL_CreateGPUShader and
+// SDL_CreateGPUComputePipeline ask for. Arrays of resources count once per element.
+// Storage resources are read-only when decorated NonWritable, as HLSL StructuredBuffer is.
+SpirvReflection ReflectSpirv(const uint8_t* code, size_t size);
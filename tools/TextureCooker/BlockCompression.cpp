@@ -0,0 +1,412 @@
+#include "BlockCompression.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace
+{
+	// Line through the texels in `mask` along their principal axis, N = 3 for RGB and 4 for RGBA.
+	// `low` and `high` are the extreme projections onto it.
+	template<int N>
+	void FitEndpoints(const uint8_t texels[64], uint32_t mask, float low[N], float high[N])
+	{
+		float mean[N]{};
+		uint32_t count = 0;
+		for (int i = 0; i < 16; i++)
+		{
+			if (!(mask & (1u << i)))
+				continue;
+			for (int c = 0; c < N; c++)
+				mean[c] += texels[i * 4 + c];
+			count++;
+		}
+
+		if (count == 0)
+		{
+			std::fill(low, low + N, 0.0f);
+			std::fill(high, high + N, 0.0f);
+			return;
+		}
+
+		for (int c = 0; c < N; c++)
+			mean[c] /= float(count);
+
+		float covariance[N][N]{};
+		for (int i = 0; i < 16; i++)
+		{
+			if (!(mask & (1u << i)))
+				continue;
+			for (int a = 0; a < N; a++)
+			{
+				for (int b = 0; b < N; b++)
+					covariance[a][b] += (texels[i * 4 + a] - mean[a]) * (texels[i * 4 + b] - mean[b]);
+			}
+		}
+
+		// Power iteration, starting from the channel with the largest variance so the
+		// start is never orthogonal to the principal axis
+		int largest = 0;
+		for (int c = 1; c < N; c++)
+		{
+			if (covariance[c][c] > covariance[largest][largest])
+				largest = c;
+		}
+
+		float axis[N];
+		for (int c = 0; c < N; c++)
+			axis[c] = covariance[largest][c];
+
+		for (int iteration = 0; iteration < 8; iteration++)
+		{
+			float next[N]{};
+			float scale = 0.0f;
+			for (int a = 0; a < N; a++)
+			{
+				for (int b = 0; b < N; b++)
+					next[a] += covariance[a][b] * axis[b];
+				scale = std::max(scale, std::abs(next[a]));
+			}
+
+			if (scale == 0.0f)
+				break;
+			for (int c = 0; c < N; c++)
+				axis[c] = next[c] / scale;
+		}
+
+		float length = 0.0f;
+		for (int c = 0; c < N; c++)
+			length += axis[c] * axis[c];
+		length = std::sqrt(length);
+
+		// Flat block, both endpoints are the mean
+		if (length < 1e-6f)
+		{
+			std::copy(mean, mean + N, low);
+			std::copy(mean, mean + N, high);
+			return;
+		}
+
+		float minimum = 0.0f;
+		float maximum = 0.0f;
+		for (int i = 0; i < 16; i++)
+		{
+			if (!(mask & (1u << i)))
+				continue;
+
+			float t = 0.0f;
+			for (int c = 0; c < N; c++)
+				t += (texels[i * 4 + c] - mean[c]) * axis[c] / length;
+			minimum = std::min(minimum, t);
+			maximum = std::max(maximum, t);
+		}
+
+		for (int c = 0; c < N; c++)
+		{
+			low[c] = std::clamp(mean[c] + axis[c] / length * minimum, 0.0f, 255.0f);
+			high[c] = std::clamp(mean[c] + axis[c] / length * maximum, 0.0f, 255.0f);
+		}
+	}
+
+	uint16_t To565(const float color[3])
+	{
+		uint32_t r = uint32_t(std::lround(color[0] * 31.0f / 255.0f));
+		uint32_t g = uint32_t(std::lround(color[1] * 63.0f / 255.0f));
+		uint32_t b = uint32_t(std::lround(color[2] * 31.0f / 255.0f));
+		return uint16_t((r << 11) | (g << 5) | b);
+	}
+
+	// Bit replication, as the hardware expands them
+	void From565(uint16_t color, int output[3])
+	{
+		int r = (color >> 11) & 31;
+		int g = (color >> 5) & 63;
+		int b = color & 31;
+		output[0] = (r << 3) | (r >> 2);
+		output[1] = (g << 2) | (g >> 4);
+		output[2] = (b << 3) | (b >> 2);
+	}
+
+	template<int N>
+	int Distance(const uint8_t* texel, const int* color)
+	{
+		int distance = 0;
+		for (int c = 0; c < N; c++)
+			distance += (texel[c] - color[c]) * (texel[c] - color[c]);
+		return distance;
+	}
+
+	// BC1 color block. With `allowTransparent`, texels below alpha 128 switch the block
+	// to 3 color mode and use index 3, which decodes to transparent black.
+	void EncodeColorBlock(const uint8_t texels[64], bool allowTransparent, uint8_t output[8])
+	{
+		uint32_t opaque = 0xFFFF;
+		if (allowTransparent)
+		{
+			opaque = 0;
+			for (int i = 0; i < 16; i++)
+			{
+				if (texels[i * 4 + 3] >= 128)
+					opaque |= 1u << i;
+			}
+		}
+		const bool threeColor = opaque != 0xFFFF;
+
+		float low[3];
+		float high[3];
+		FitEndpoints<3>(texels, opaque, low, high);
+
+		// The endpoint order selects the mode: color0 > color1 is 4 color, otherwise 3 color
+		uint16_t color0 = To565(high);
+		uint16_t color1 = To565(low);
+		if (threeColor ? color0 > color1 : color0 < color1)
+			std::swap(color0, color1);
+
+		int palette[4][3];
+		From565(color0, palette[0]);
+		From565(color1, palette[1]);
+		for (int c = 0; c < 3; c++)
+		{
+			if (threeColor)
+			{
+				palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+				palette[3][c] = 0;
+			}
+			else
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+		}
+
+		// Equal endpoints read as 3 color mode, index 0 is the only safe choice there
+		uint32_t indices = 0;
+		if (color0 != color1 || threeColor)
+		{
+			for (int i = 0; i < 16; i++)
+			{
+				uint32_t best = 3;
+				if (opaque & (1u << i))
+				{
+					int bestDistance = INT_MAX;
+					for (uint32_t p = 0; p < (threeColor ? 3u : 4u); p++)
+					{
+						int distance = Distance<3>(texels + i * 4, palette[p]);
+						if (distance < bestDistance)
+						{
+							bestDistance = distance;
+							best = p;
+						}
+					}
+				}
+				indices |= best << (i * 2);
+			}
+		}
+
+		output[0] = uint8_t(color0);
+		output[1] = uint8_t(color0 >> 8);
+		output[2] = uint8_t(color1);
+		output[3] = uint8_t(color1 >> 8);
+		for (int i = 0; i < 4; i++)
+			output[4 + i] = uint8_t(indices >> (i * 8));
+	}
+
+	// BC3/BC4 alpha block in 8 value mode: the extremes and six steps between them
+	void EncodeAlphaBlock(const uint8_t texels[64], uint8_t output[8])
+	{
+		uint8_t minimum = 255;
+		uint8_t maximum = 0;
+		for (int i = 0; i < 16; i++)
+		{
+			minimum = std::min(minimum, texels[i * 4 + 3]);
+			maximum = std::max(maximum, texels[i * 4 + 3]);
+		}
+
+		int palette[8] = { maximum, minimum };
+		for (int i = 1; i < 7; i++)
+			palette[i + 1] = ((7 - i) * maximum + i * minimum) / 7;
+
+		uint64_t indices = 0;
+		if (maximum > minimum)
+		{
+			for (int i = 0; i < 16; i++)
+			{
+				uint64_t best = 0;
+				int bestDistance = INT_MAX;
+				for (int p = 0; p < 8; p++)
+				{
+					int distance = std::abs(texels[i * 4 + 3] - palette[p]);
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						best = uint64_t(p);
+					}
+				}
+				indices |= best << (i * 3);
+			}
+		}
+
+		output[0] = maximum;
+		output[1] = minimum;
+		for (int i = 0; i < 6; i++)
+			output[2 + i] = uint8_t(indices >> (i * 8));
+	}
+
+	// Writes fields LSB first, the order BC7 blocks are laid out in
+	class BitWriter
+	{
+		public:
+			BitWriter(uint8_t* output, size_t size)
+			{
+				m_Output = output;
+				std::memset(m_Output, 0, size);
+			}
+
+			void Write(uint32_t value, uint32_t bits)
+			{
+				for (uint32_t i = 0; i < bits; i++, m_Position++)
+					m_Output[m_Position >> 3] |= uint8_t(((value >> i) & 1) << (m_Position & 7));
+			}
+
+		private:
+			uint8_t* m_Output{nullptr};
+			uint32_t m_Position{0};
+	};
+
+	constexpr int BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+}
+
+
+
+void EncodeBC1(const uint8_t texels[64], uint8_t output[8])
+{
+	EncodeColorBlock(texels, true, output);
+}
+
+void EncodeBC3(const uint8_t texels[64], uint8_t output[16])
+{
+	EncodeAlphaBlock(texels, output);
+	EncodeColorBlock(texels, false, output + 8);
+}
+
+void EncodeBC7(const uint8_t texels[64], uint8_t output[16])
+{
+	float low[4];
+	float high[4];
+	FitEndpoints<4>(texels, 0xFFFF, low, high);
+
+	// 7 bits per channel plus one shared low bit per endpoint, pick the p-bit that lands closer
+	const float* source[2] = { low, high };
+	uint32_t quantized[2][4];
+	uint32_t pBits[2];
+	int endpoints[2][4];
+	for (int e = 0; e < 2; e++)
+	{
+		float bestError = INFINITY;
+		for (uint32_t p = 0; p < 2; p++)
+		{
+			uint32_t candidate[4];
+			float error = 0.0f;
+			for (int c = 0; c < 4; c++)
+			{
+				candidate[c] = uint32_t(std::clamp<long>(std::lround((source[e][c] - float(p)) / 2.0f), 0, 127));
+				float difference = float((candidate[c] << 1) | p) - source[e][c];
+				error += difference * difference;
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				pBits[e] = p;
+				std::copy(candidate, candidate + 4, quantized[e]);
+			}
+		}
+
+		for (int c = 0; c < 4; c++)
+			endpoints[e][c] = int((quantized[e][c] << 1) | pBits[e]);
+	}
+
+	int palette[16][4];
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < 4; c++)
+			palette[i][c] = ((64 - BC7_WEIGHTS4[i]) * endpoints[0][c] + BC7_WEIGHTS4[i] * endpoints[1][c] + 32) >> 6;
+	}
+
+	uint32_t indices[16];
+	for (int i = 0; i < 16; i++)
+	{
+		int bestDistance = INT_MAX;
+		for (uint32_t p = 0; p < 16; p++)
+		{
+			int distance = Distance<4>(texels + i * 4, palette[p]);
+			if (distance < bestDistance)
+			{
+				bestDistance = distance;
+				indices[i] = p;
+			}
+		}
+	}
+
+	// The first texel's index is stored without its top bit, swap the endpoints if it is set
+	if (indices[0] & 8)
+	{
+		std::swap(quantized[0], quantized[1]);
+		std::swap(pBits[0], pBits[1]);
+		for (uint32_t& index : indices)
+			index = 15 - index;
+	}
+
+	BitWriter writer(output, 16);
+	writer.Write(1u << 6, 7);
+	for (int c = 0; c < 4; c++)
+	{
+		writer.Write(quantized[0][c], 7);
+		writer.Write(quantized[1][c], 7);
+	}
+	writer.Write(pBits[0], 1);
+	writer.Write(pBits[1], 1);
+	writer.Write(indices[0], 3);
+	for (int i = 1; i < 16; i++)
+		writer.Write(indices[i], 4);
+}
+
+void CompressImage(CookedTextureFormat format, const uint8_t* pixels, uint32_t width, uint32_t height, uint8_t* output)
+{
+	if (!IsBlockCompressed(format))
+	{
+		std::memcpy(output, pixels, size_t(width) * height * 4);
+		return;
+	}
+
+	const uint32_t blockBytes = CookedTextureElementBytes(format);
+	const uint32_t blocksWide = (width + 3) / 4;
+	const uint32_t blocksHigh = (height + 3) / 4;
+
+	uint8_t texels[64];
+	for (uint32_t blockY = 0; blockY < blocksHigh; blockY++)
+	{
+		for (uint32_t blockX = 0; blockX < blocksWide; blockX++)
+		{
+			for (uint32_t y = 0; y < 4; y++)
+			{
+				uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+				for (uint32_t x = 0; x < 4; x++)
+				{
+					uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+					std::memcpy(texels + (y * 4 + x) * 4, pixels + (size_t(sourceY) * width + sourceX) * 4, 4);
+				}
+			}
+
+			uint8_t* block = output + (size_t(blockY) * blocksWide + blockX) * blockBytes;
+			switch (format)
+			{
+			case CookedTextureFormat::BC1: EncodeBC1(texels, block); break;
+			case CookedTextureFormat::BC3: EncodeBC3(texels, block); break;
+			case CookedTextureFormat::BC7: EncodeBC7(texels, block); break;
+			default: break;
+			}
+		}
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Renderer/CookedTextureFormat.hpp"
+#include <cstdint>
+
+
+// Block encoders for the texture cooker. Each takes the 16 RGBA8 texels of a
+// 4x4 block in row-major order.
+//
+// Endpoints are fitted along the principal axis of the block's colors, then every
+// texel picks the nearest palette entry. That is a fraction of the quality of an
+// exhaustive encoder, but fast enough to cook on every build.
+
+// 4 colors, or 3 colors plus transparent black when any texel has alpha below 128
+void EncodeBC1(const uint8_t texels[64], uint8_t output[8]);
+
+// BC4-style alpha block followed by a 4 color BC1 block
+void EncodeBC3(const uint8_t texels[64], uint8_t output[16]);
+
+// Mode 6 only: a single RGBA subset with 7.7.7.7.1 endpoints and 4-bit indices
+void EncodeBC7(const uint8_t texels[64], uint8_t output[16]);
+
+// Encodes a tightly packed RGBA8 image into `output`, which must hold
+// CookedTextureMipSize(format, width, height) bytes. Partial blocks at the
+// right and bottom edges repeat the last column and row.
+void CompressImage(CookedTextureFormat format, const uint8_t* pixels, uint32_t width, uint32_t height, uint8_t* output);
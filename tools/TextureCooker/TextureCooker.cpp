@@ -0,0 +1,311 @@
+// Cooks an image into a .ctex file that TextureManager can upload without decoding.
+//
+//   TextureCooker <input image> <output file> [--format auto|bc1|bc3|bc7|rgba8] [--linear] [--no-mips]
+//
+// The mip chain is built here with a box filter, averaging in linear space unless
+// --linear marks the image as data (normal maps, masks). "auto" picks BC1 for opaque
+// images and BC7 otherwise. Afterwards the SDL_image load path and the cooked one
+// are timed against each other on this machine.
+
+#include "BlockCompression.hpp"
+#include "Core/MappedFile.hpp"
+#include "Renderer/CookedTextureFormat.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+
+namespace fs = std::filesystem;
+
+
+struct Image
+{
+	std::vector<uint8_t> Pixels;   // tightly packed RGBA8
+	uint32_t Width{0};
+	uint32_t Height{0};
+};
+
+static bool LoadImage(const std::string& path, Image& image)
+{
+	SDL_Surface* surface = IMG_Load(path.c_str());
+	if (!surface)
+		return false;
+
+	SDL_Surface* converted = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+	SDL_DestroySurface(surface);
+	if (!converted)
+		return false;
+
+	image.Width = uint32_t(converted->w);
+	image.Height = uint32_t(converted->h);
+	const size_t rowBytes = size_t(image.Width) * 4;
+	image.Pixels.resize(rowBytes * image.Height);
+	for (uint32_t y = 0; y < image.Height; y++)
+		memcpy(image.Pixels.data() + y * rowBytes, static_cast<const uint8_t*>(converted->pixels) + size_t(y) * converted->pitch, rowBytes);
+
+	SDL_DestroySurface(converted);
+	return true;
+}
+
+static bool ParseFormat(const std::string& name, CookedTextureFormat& format, bool& automatic)
+{
+	automatic = name == "auto";
+	if (automatic || name == "bc7")
+		format = CookedTextureFormat::BC7;
+	else if (name == "bc1")
+		format = CookedTextureFormat::BC1;
+	else if (name == "bc3")
+		format = CookedTextureFormat::BC3;
+	else if (name == "rgba8")
+		format = CookedTextureFormat::RGBA8;
+	else
+		return false;
+	return true;
+}
+
+static const char* FormatName(CookedTextureFormat format)
+{
+	switch (format)
+	{
+	case CookedTextureFormat::BC1: return "BC1";
+	case CookedTextureFormat::BC3: return "BC3";
+	case CookedTextureFormat::BC7: return "BC7";
+	default: return "RGBA8";
+	}
+}
+
+static float SrgbToLinear(float value)
+{
+	return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static float LinearToSrgb(float value)
+{
+	return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+// Half size 2x2 box filter, odd edges repeat their last texel. Alpha is always linear.
+static Image Downsample(const Image& source, bool srgb)
+{
+	static float toLinear[256];
+	static bool tableReady = false;
+	if (!tableReady)
+	{
+		for (int i = 0; i < 256; i++)
+			toLinear[i] = SrgbToLinear(i / 255.0f);
+		tableReady = true;
+	}
+
+	Image result;
+	result.Width = std::max(1u, source.Width / 2);
+	result.Height = std::max(1u, source.Height / 2);
+	result.Pixels.resize(size_t(result.Width) * result.Height * 4);
+
+	for (uint32_t y = 0; y < result.Height; y++)
+	{
+		for (uint32_t x = 0; x < result.Width; x++)
+		{
+			const uint32_t x0 = std::min(x * 2, source.Width - 1);
+			const uint32_t x1 = std::min(x * 2 + 1, source.Width - 1);
+			const uint32_t y0 = std::min(y * 2, source.Height - 1);
+			const uint32_t y1 = std::min(y * 2 + 1, source.Height - 1);
+			const uint8_t* texels[4] = {
+				&source.Pixels[(size_t(y0) * source.Width + x0) * 4],
+				&source.Pixels[(size_t(y0) * source.Width + x1) * 4],
+				&source.Pixels[(size_t(y1) * source.Width + x0) * 4],
+				&source.Pixels[(size_t(y1) * source.Width + x1) * 4]
+			};
+
+			uint8_t* output = &result.Pixels[(size_t(y) * result.Width + x) * 4];
+			for (int c = 0; c < 4; c++)
+			{
+				float sum = 0.0f;
+				for (const uint8_t* texel : texels)
+					sum += (srgb && c < 3) ? toLinear[texel[c]] : texel[c] / 255.0f;
+
+				float average = sum / 4.0f;
+				if (srgb && c < 3)
+					average = LinearToSrgb(average);
+				output[c] = uint8_t(std::lround(std::clamp(average, 0.0f, 1.0f) * 255.0f));
+			}
+		}
+	}
+
+	return result;
+}
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static uint64_t Align(uint64_t value, uint64_t alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		printf("Usage: %s <input image> <output file> [--format auto|bc1|bc3|bc7|rgba8] [--linear] [--no-mips]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const std::string inputPath = argv[1];
+	const fs::path outputPath = argv[2];
+
+	CookedTextureFormat format = CookedTextureFormat::BC7;
+	bool automaticFormat = true;
+	bool srgb = true;
+	bool mipmaps = true;
+	for (int i = 3; i < argc; i++)
+	{
+		const std::string argument = argv[i];
+		if (argument == "--format" && i + 1 < argc)
+		{
+			if (!ParseFormat(argv[++i], format, automaticFormat))
+			{
+				printf("Unknown format %s\n", argv[i]);
+				return EXIT_FAILURE;
+			}
+		}
+		else if (argument == "--linear")
+			srgb = false;
+		else if (argument == "--no-mips")
+			mipmaps = false;
+		else
+		{
+			printf("Unknown argument %s\n", argument.c_str());
+			return EXIT_FAILURE;
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	std::vector<Image> mips(1);
+	if (!LoadImage(inputPath, mips[0]))
+	{
+		printf("Failed to load %s: %s\n", inputPath.c_str(), SDL_GetError());
+		return EXIT_FAILURE;
+	}
+
+	if (automaticFormat)
+	{
+		bool opaque = true;
+		for (size_t i = 3; i < mips[0].Pixels.size() && opaque; i += 4)
+			opaque = mips[0].Pixels[i] == 255;
+		format = opaque ? CookedTextureFormat::BC1 : CookedTextureFormat::BC7;
+	}
+
+	if (IsBlockCompressed(format) && (mips[0].Width % 4 != 0 || mips[0].Height % 4 != 0))
+		printf("Warning: %ux%u is not a multiple of 4, D3D12 cannot create block-compressed textures of that size\n", mips[0].Width, mips[0].Height);
+
+	while (mipmaps && mips.size() < COOKED_TEXTURE_MAX_MIPS && (mips.back().Width > 1 || mips.back().Height > 1))
+		mips.push_back(Downsample(mips.back(), srgb));
+
+
+	// Header, mip table, then the payloads
+	std::vector<CookedTextureMip> table(mips.size());
+	uint64_t offset = sizeof(CookedTextureHeader) + table.size() * sizeof(CookedTextureMip);
+	for (size_t level = 0; level < mips.size(); level++)
+	{
+		offset = Align(offset, COOKED_TEXTURE_ALIGNMENT);
+		table[level].Offset = uint32_t(offset);
+		table[level].Size = CookedTextureMipSize(format, mips[level].Width, mips[level].Height);
+		table[level].Width = mips[level].Width;
+		table[level].Height = mips[level].Height;
+		offset += table[level].Size;
+	}
+
+	if (offset > UINT32_MAX)
+	{
+		printf("Cooked texture exceeds 4 GB\n");
+		return EXIT_FAILURE;
+	}
+
+	std::vector<uint8_t> file(offset, 0);
+
+	CookedTextureHeader header{};
+	header.Magic = COOKED_TEXTURE_MAGIC;
+	header.Version = COOKED_TEXTURE_VERSION;
+	header.Format = format;
+	header.Flags = srgb ? COOKED_TEXTURE_FLAG_SRGB : 0;
+	header.Width = mips[0].Width;
+	header.Height = mips[0].Height;
+	header.MipCount = uint32_t(mips.size());
+	header.FileSize = offset;
+	memcpy(file.data(), &header, sizeof(header));
+	memcpy(file.data() + sizeof(header), table.data(), table.size() * sizeof(CookedTextureMip));
+
+	for (size_t level = 0; level < mips.size(); level++)
+		CompressImage(format, mips[level].Pixels.data(), mips[level].Width, mips[level].Height, file.data() + table[level].Offset);
+
+	std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+	if (!output || !output.write(reinterpret_cast<const char*>(file.data()), file.size()))
+	{
+		printf("Failed to write %s\n", outputPath.string().c_str());
+		return EXIT_FAILURE;
+	}
+	output.close();
+
+	const double cookMS = MillisecondsSince(start);
+
+
+	// What each path costs at load time. The SDL_image path decodes on a worker and keeps
+	// the RGBA8 pixels until they are streamed, then generates the mips on the GPU. The
+	// cooked path maps the file and copies each mip straight into staging memory.
+	constexpr int RUNS = 5;
+	double decodeMS = INFINITY;
+	double mappedMS = INFINITY;
+	const uint64_t baseBytes = uint64_t(mips[0].Width) * mips[0].Height * 4;
+	std::vector<uint8_t> staging(std::max<uint64_t>(file.size(), baseBytes));
+	for (int run = 0; run < RUNS; run++)
+	{
+		auto decodeStart = std::chrono::steady_clock::now();
+		Image decoded;
+		LoadImage(inputPath, decoded);
+		memcpy(staging.data(), decoded.Pixels.data(), decoded.Pixels.size());
+		decodeMS = std::min(decodeMS, MillisecondsSince(decodeStart));
+
+		auto mappedStart = std::chrono::steady_clock::now();
+		MappedFile mapped(outputPath.string());
+		if (mapped.IsOpen())
+		{
+			for (const CookedTextureMip& mip : table)
+				memcpy(staging.data() + mip.Offset, mapped.GetData() + mip.Offset, mip.Size);
+		}
+		mappedMS = std::min(mappedMS, MillisecondsSince(mappedStart));
+	}
+
+	uint64_t payloadBytes = 0;
+	uint64_t rgbaChainBytes = 0;
+	for (size_t level = 0; level < mips.size(); level++)
+	{
+		payloadBytes += table[level].Size;
+		rgbaChainBytes += uint64_t(mips[level].Width) * mips[level].Height * 4;
+	}
+
+	std::error_code error;
+	const uint64_t sourceBytes = fs::file_size(inputPath, error);
+
+	printf("Cooked %s -> %s in %.1f ms\n", inputPath.c_str(), outputPath.string().c_str(), cookMS);
+	printf("  %ux%u %s%s, %u mips, %llu bytes on disk (source %llu bytes)\n",
+		header.Width, header.Height, FormatName(format), srgb ? " sRGB" : "", header.MipCount,
+		(unsigned long long)file.size(), (unsigned long long)sourceBytes);
+	printf("  %-10s %12s %14s %14s\n", "path", "load ms", "CPU bytes", "GPU bytes");
+	printf("  %-10s %12.3f %14llu %14llu\n", "SDL_image", decodeMS, (unsigned long long)baseBytes, (unsigned long long)(mipmaps ? rgbaChainBytes : baseBytes));
+	printf("  %-10s %12.3f %14llu %14llu\n", "cooked", mappedMS, 0ull, (unsigned long long)payloadBytes);
+	printf("  cooked CPU memory is the file mapping, page cache the OS can drop\n");
+
+	return EXIT_SUCCESS;
+}